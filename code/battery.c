@@ -0,0 +1,112 @@
+#include "battery.h"
+#include "motor_control.h"
+
+//====================================================ȫֱ====================================================
+battery_t battery;
+
+//====================================================صѹ====================================================
+/**
+ * @brief  صѹʼ
+ * @param  
+ * @return 
+ * @note   adc_initͨVADCԶ̨ɨ裬֮תӲ
+ */
+void battery_init(void)
+{
+    memset(&battery, 0, sizeof(battery));
+    battery.voltage = BATTERY_NOMINAL_VOLTAGE;
+    battery.voltage_min = BATTERY_NOMINAL_VOLTAGE;
+    battery.compensation = 1.0f;
+    battery.derate = 1.0f;
+    
+#if BATTERY_ENABLE
+    adc_init(BATTERY_ADC_CHANNEL, BATTERY_ADC_RESOLUTION);
+#endif
+}
+
+/**
+ * @brief  صѹ£1msже
+ * @param  
+ * @return 
+ * @note   ֻȡ̨ɨһν½ʱϴֵȴתδʱȡѹֱֵ
+ */
+void battery_update(void)
+{
+#if BATTERY_ENABLE
+    uint16 raw;
+    float voltage;
+    
+    if (!adc_background_read(BATTERY_ADC_CHANNEL, &raw))
+        return;
+    
+    battery.raw = raw;
+    voltage = raw * (BATTERY_ADC_REF_VOLTAGE * BATTERY_DIVIDER_RATIO / BATTERY_ADC_FULL_SCALE);
+    if (voltage < BATTERY_MIN_VALID_VOLTAGE)
+    {
+        // δӼ·ѹ쳣
+        battery.valid = 0;
+        battery.low = 0;
+        battery.compensation = 1.0f;
+        battery.derate = 1.0f;
+        return;
+    }
+    
+    if (!battery.valid)
+    {
+        battery.valid = 1;
+        battery.voltage = voltage;
+        battery.voltage_min = voltage;
+    }
+    else
+    {
+        battery.voltage += (voltage - battery.voltage) * BATTERY_FILTER;
+    }
+    if (battery.voltage < battery.voltage_min)
+        battery.voltage_min = battery.voltage;
+    
+    battery.compensation = func_limit_ab(BATTERY_NOMINAL_VOLTAGE / battery.voltage, BATTERY_COMP_MIN, BATTERY_COMP_MAX);
+    
+    // ѹDERATE_VOLTAGECUTOFF_VOLTAGE֮ռձԽDERATE_MIN
+    if (battery.voltage >= BATTERY_DERATE_VOLTAGE)
+        battery.derate = 1.0f;
+    else if (battery.voltage <= BATTERY_CUTOFF_VOLTAGE)
+        battery.derate = BATTERY_DERATE_MIN;
+    else
+        battery.derate = BATTERY_DERATE_MIN + (1.0f - BATTERY_DERATE_MIN)
+                       * (battery.voltage - BATTERY_CUTOFF_VOLTAGE) / (BATTERY_DERATE_VOLTAGE - BATTERY_CUTOFF_VOLTAGE);
+    
+    if (battery.voltage < BATTERY_DERATE_VOLTAGE)
+        battery.low = 1;
+    else if (battery.voltage > BATTERY_DERATE_VOLTAGE + BATTERY_LOW_HYSTERESIS)
+        battery.low = 0;
+#endif
+}
+
+/**
+ * @brief  صѹ
+ * @param  duty  Ƶѹµռձ (-MOTOR_MAX_DUTY ~ MOTOR_MAX_DUTY)
+ * @return ʵռձ
+ * @note   Ȱϵ޷ٳ Ƶѹ/ʵʵѹʹͬһռձŵиͬĵ˵ѹ
+ *         ԲMOTOR_MAX_DUTYѹʱٶλǰ
+ */
+int32 battery_compensate(int32 duty)
+{
+#if BATTERY_ENABLE
+    int32 duty_max = (int32)(MOTOR_MAX_DUTY * battery.derate);
+    
+    duty = func_limit(duty, duty_max);
+    duty = (int32)(duty * battery.compensation);
+    duty = func_limit(duty, MOTOR_MAX_DUTY);
+#endif
+    return duty;
+}
+
+/**
+ * @brief  ͵ѹ¼
+ * @param  
+ * @return 
+ */
+void battery_reset_min(void)
+{
+    battery.voltage_min = battery.voltage;
+}
@@ -0,0 +1,49 @@
+#ifndef _BATTERY_H_
+#define _BATTERY_H_
+
+#include "zf_common_headfile.h"
+
+//====================================================صѹ====================================================
+// صѹVADCԶ̨ɨת1msжֻȡһνȴת
+#define BATTERY_ENABLE              0           // 1-ռձȰصѹѹ0-ⲻ
+                                                // ѹΪռλֵ·ȷϲñ궨1
+#define BATTERY_ADC_CHANNEL         ADC0_CH8_A8 // طѹţ·޸ģ
+#define BATTERY_ADC_RESOLUTION      ADC_12BIT
+#define BATTERY_ADC_FULL_SCALE      4096.0f     // 12λ
+#define BATTERY_ADC_REF_VOLTAGE     3.3f        // ADCοѹ (V)
+#define BATTERY_DIVIDER_RATIO       11.0f       // ѹȣصѹ / ADCŵѹѹ궨
+#define BATTERY_FILTER              0.02f       // 1msһ׵ͨϵʱ䳣Լ50ms˳PWMƲ
+
+#define BATTERY_NOMINAL_VOLTAGE     7.4f        // Ƶѹ (V)ռձõѹµ
+#define BATTERY_MIN_VALID_VOLTAGE   4.0f        // ڸֵΪδӼ·
+#define BATTERY_COMP_MIN            0.85f       // ϵޣʱ
+#define BATTERY_COMP_MAX            1.25f       // ϵޣʱ
+
+#define BATTERY_DERATE_VOLTAGE      6.8f        // ڸõѹʼ (V)
+#define BATTERY_CUTOFF_VOLTAGE      6.4f        // õѹʱռձ޽BATTERY_DERATE_MIN (V)
+#define BATTERY_DERATE_MIN          0.5f        // ռձޱ
+#define BATTERY_LOW_HYSTERESIS      0.1f        // ѹ־ز (V)
+
+//====================================================ݽṹ====================================================
+// صѹṹ
+typedef struct
+{
+    uint16 raw;                                 // һADC
+    uint8 valid;                                // ȡõһҵѹBATTERY_MIN_VALID_VOLTAGE
+    uint8 low;                                  // ѹ־BATTERY_DERATE_VOLTAGEز
+    float voltage;                              // ˲صѹ (V)
+    float voltage_min;                          // ͵ѹ (V)
+    float compensation;                         // ѹϵƵѹ / ʵʵѹ
+    float derate;                               // ѹϵռձޱ1Ϊ
+} battery_t;
+
+//====================================================ȫֱ====================================================
+extern battery_t battery;
+
+//========================================================================================================
+void  battery_init(void);                                       // ʼADC̨ɨ
+void  battery_update(void);                                     // 1msжеãȡһת˲²뽵ϵ
+int32 battery_compensate(int32 duty);                           // Ƶѹռձ -> ʵռձȣ޷
+void  battery_reset_min(void);                                  // ʱ͵ѹ¼
+
+#endif // _BATTERY_H_
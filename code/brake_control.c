@@ -0,0 +1,220 @@
+#include "brake_control.h"
+#include <string.h>
+
+#ifndef PID_HOST
+#include "traction_control.h"
+#include "yaw_control.h"
+#include "speed_loop.h"
+#include "smart_car.h"
+
+// ƶȫֱ
+brake_t brake;
+#endif
+
+//====================================================ƶ״̬뷴ռձ====================================================
+/**
+ * @brief  ƶ״̬
+ * @param  bc  ƶṹ
+ * @return 
+ */
+void brake_reset(brake_t *bc)
+{
+    memset(bc, 0, sizeof(*bc));
+    bc->left.cap = BRAKE_DUTY_MAX;
+    bc->right.cap = BRAKE_DUTY_MAX;
+}
+
+/**
+ * @brief  ·ƶ
+ * @param  bc      ƶṹ
+ * @param  target  Ŀ공 (mm/s)
+ * @param  decel   ٶȹ滮ڵļٶ (mm/s^2Ϊ)
+ * @return 
+ * @note   е
+ */
+void brake_set_request(brake_t *bc, float target, float decel)
+{
+    bc->target = target;
+    bc->decel_request = decel;
+}
+
+/**
+ * @brief  ַռձ
+ * @param  wheel     
+ * @param  speed      (mm/s)
+ * @param  gain      ģ (mm/s / ռձ)
+ * @param  command   ټķռձȴС
+ * @param  base      ʷĸ (mm/s)
+ * @param  reference ο (mm/s)
+ * @return 
+ * @note   תʱѹ뷴綯ͬӣԼ ռձ + /棬BRAKE_CURRENT_DUTYƣ
+ *         ްֵڣʳĿʱٰͣ͸·ռձȣ·ƶҲᱧ
+ *         ޿ɼֵ / ռձȣֱƶ
+ */
+static void brake_wheel_step(brake_wheel_t *wheel, float speed, float gain, float command, float base, float reference)
+{
+    float back_emf = speed > 0.0f ? speed / gain : 0.0f;
+    
+    wheel->slip = (reference - speed) / base;
+    wheel->cap += BRAKE_SLIP_GAIN * (BRAKE_SLIP_TARGET - wheel->slip);
+    if (wheel->cap > BRAKE_DUTY_MAX)
+        wheel->cap = BRAKE_DUTY_MAX;
+    else if (wheel->cap < -back_emf)
+        wheel->cap = -back_emf;
+    
+    float limit = wheel->cap;
+    if (wheel->slip > BRAKE_SLIP_TARGET)
+        limit -= BRAKE_SLIP_KP * (wheel->slip - BRAKE_SLIP_TARGET);
+    if (limit < -back_emf)
+        limit = -back_emf;
+    if (command > limit)
+        command = limit;
+    if (command > BRAKE_CURRENT_DUTY - back_emf)
+        command = BRAKE_CURRENT_DUTY - back_emf;
+    wheel->duty = -command;
+}
+
+/**
+ * @brief  ƶ
+ * @param  bc          ƶṹ
+ * @param  left_speed  㵽ĵĳ (mm/s)
+ * @param  right_speed 㵽ĵĳ (mm/s)
+ * @param  accel       ٶ (mm/s^2)IMUʱ-BRAKE_DECEL_MAX
+ * @param  left_gain   ģ (mm/s / ռձ)
+ * @param  right_gain  ҵģ (mm/s / ռձ)
+ * @return 
+ * @note   οȡϿһ֣½ ʵٶ + BRAKE_DECEL_MARGIN ڣ
+ *         滮ٶȴﵽBRAKE_DECEL_ENTERٳĿʱƶСBRAKE_EXIT_ERROR󽻻
+ */
+void brake_step(brake_t *bc, float left_speed, float right_speed, float accel, float left_gain, float right_gain)
+{
+    float fastest = left_speed > right_speed ? left_speed : right_speed;
+    if (fastest >= bc->reference)
+    {
+        bc->reference = fastest;
+    }
+    else
+    {
+        float fall = -accel + BRAKE_DECEL_MARGIN;
+        if (fall > BRAKE_DECEL_MAX)
+            fall = BRAKE_DECEL_MAX;
+        else if (fall < BRAKE_DECEL_MARGIN)
+            fall = BRAKE_DECEL_MARGIN;
+        fall *= BRAKE_PERIOD_MS * 0.001f;
+        bc->reference -= (bc->reference - fastest < fall) ? bc->reference - fastest : fall;
+    }
+    
+    float excess = bc->reference - bc->target;
+    switch (bc->state)
+    {
+        case BRAKE_IDLE:
+            if (excess > BRAKE_ENTER_ERROR || (bc->decel_request >= BRAKE_DECEL_ENTER && excess > BRAKE_EXIT_ERROR))
+            {
+                bc->state = BRAKE_ACTIVE;
+                bc->left.cap = BRAKE_DUTY_MAX;
+                bc->right.cap = BRAKE_DUTY_MAX;
+                bc->count++;
+            }
+            break;
+        case BRAKE_ACTIVE:
+            bc->active_ms += BRAKE_PERIOD_MS;
+            if (excess < BRAKE_EXIT_ERROR)
+            {
+                bc->state = BRAKE_HANDBACK;
+                bc->handback_ms = 0;
+            }
+            break;
+        case BRAKE_HANDBACK:
+            bc->handback_ms += BRAKE_PERIOD_MS;
+            if (excess > BRAKE_ENTER_ERROR)
+                bc->state = BRAKE_ACTIVE;
+            else if (bc->handback_ms >= BRAKE_HANDBACK_MS)
+                bc->state = BRAKE_IDLE;
+            break;
+        default:
+            bc->state = BRAKE_IDLE;
+            break;
+    }
+    
+    if (bc->state == BRAKE_IDLE)
+    {
+        bc->left.duty = 0.0f;
+        bc->right.duty = 0.0f;
+        return;
+    }
+    
+    float command = BRAKE_KP * excess;
+    if (command > BRAKE_DUTY_MAX)
+        command = BRAKE_DUTY_MAX;
+    float base = bc->reference > BRAKE_MIN_SPEED ? bc->reference : BRAKE_MIN_SPEED;
+    brake_wheel_step(&bc->left, left_speed, left_gain, command, base, bc->reference);
+    brake_wheel_step(&bc->right, right_speed, right_gain, command, base, bc->reference);
+}
+
+/**
+ * @brief  ƶٶȻϳ
+ * @param  bc      ƶṹ
+ * @param  wheel   
+ * @param  normal  ٶȻٶPIDռձ
+ * @return ʵռձ
+ * @note   ƶʱٶȻÿ֣ʱƶռձԹɵٶȻǰ + ͻ
+ */
+float brake_blend(const brake_t *bc, const brake_wheel_t *wheel, float normal)
+{
+    if (bc->state == BRAKE_IDLE)
+        return normal;
+    if (bc->state == BRAKE_ACTIVE)
+        return wheel->duty;
+    
+    float weight = 1.0f - (float)bc->handback_ms / BRAKE_HANDBACK_MS;
+    return weight * wheel->duty + (1.0f - weight) * normal;
+}
+
+#ifndef PID_HOST
+//====================================================ƶ====================================================
+/**
+ * @brief  ʼƶ
+ * @param  
+ * @return 
+ */
+void brake_init(void)
+{
+    brake_reset(&brake);
+}
+
+/**
+ * @brief  ʱƶ״̬ͳ
+ * @param  
+ * @return 
+ */
+void brake_start(void)
+{
+    brake_reset(&brake);
+}
+
+/**
+ * @brief  ƶ
+ * @param  
+ * @return 
+ * @note   1msжtraction_update()֮ٶȻ֮ǰãʹǣưת򼸺IMUٶȣ
+ *         ƵٶȻϳٶPIDֻ20msƶɱжֱ
+ */
+void brake_update(void)
+{
+    if (!BRAKE_ENABLE || smart_car.state != CAR_RUNNING)
+    {
+        brake.state = BRAKE_IDLE;
+        return;
+    }
+    
+    brake_step(&brake, traction.left.speed, traction.right.speed,
+               yaw_control.enable ? traction.accel : -BRAKE_DECEL_MAX,
+               car.left_motor.model.gain, car.right_motor.model.gain);
+    
+    if (!speed_loop.enable && brake.state == BRAKE_ACTIVE)
+    {
+        motor_set_duty(&car.left_motor, (int32)brake.left.duty);
+        motor_set_duty(&car.right_motor, (int32)brake.right.duty);
+    }
+}
+#endif
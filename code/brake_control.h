@@ -0,0 +1,95 @@
+#ifndef _BRAKE_CONTROL_H_
+#define _BRAKE_CONTROL_H_
+
+#ifdef PID_HOST
+// λԱ루tools/brake_sim.cֻƶ״̬뷴ռձȼ
+#ifndef PID_HOST_TYPES
+#define PID_HOST_TYPES
+#include <stdint.h>
+typedef uint8_t  uint8;
+typedef int8_t   int8;
+typedef uint16_t uint16;
+typedef int16_t  int16;
+typedef uint32_t uint32;
+typedef int32_t  int32;
+typedef int64_t  int64;
+#endif
+#else
+#include "zf_common_headfile.h"
+#include "motor_control.h"
+#endif
+
+//====================================================ƶ====================================================
+// ٶȹ滮ҪٶȻԸĿʱ1msжֱӸַռձȣٶȻ
+// ռձܵƶƣٽӽĿBRAKE_HANDBACK_MSԽٶȻ
+#define BRAKE_ENABLE                1           // Ƿƶ
+#define BRAKE_PERIOD_MS             1           //  (ms)ODOMETRY_PITж
+#define BRAKE_DECEL_ENTER           4000.0f     // 滮ٶȲСڸֵ (mm/s^2) ҳٸĿBRAKE_EXIT_ERRORʱ
+#define BRAKE_ENTER_ERROR           300.0f      // ٸĿֵ (mm/s) ʱ루滮ٶ޹أ
+#define BRAKE_EXIT_ERROR            80.0f       // ٸĿ겻ֵ (mm/s) ʱʼ
+#define BRAKE_HANDBACK_MS           60          // ʱ (ms)
+
+#define BRAKE_KP                    20.0f       // ռձ = KP  Ŀĳ (ռձ / (mm/s))
+#define BRAKE_DUTY_MAX              6000.0f     // ռձ
+#define BRAKE_CURRENT_DUTY          10000.0f    // ƣռձ + 綯ƵЧռձȣ/ģ棩ֵ
+                                                // ԼΪռձ𲽵1.25
+
+// ƶο٣㵽ĺȡϿһ֣ƶʱֻƫ½ʲIMUٶȼԣ
+#define BRAKE_DECEL_MARGIN          1000.0f     // ο½ʵٶ֮ϵԣ (mm/s^2)
+#define BRAKE_DECEL_MAX             12000.0f    // ο½ (mm/s^2)IMUʱֵ
+#define BRAKE_MIN_SPEED             200.0f      // ʷĸ (mm/s)
+#define BRAKE_SLIP_TARGET           0.10f       // ƶĿ
+#define BRAKE_SLIP_KP               40000.0f    // ʳĿʱ (ռձ / λ)
+#define BRAKE_SLIP_GAIN             800.0f      // ռձ޻ֵ (ռձ /  / λ)
+
+//====================================================ݽṹ====================================================
+// ƶ״̬
+typedef enum
+{
+    BRAKE_IDLE = 0,                             // ٶȻ
+    BRAKE_ACTIVE,                               // ƶУٶȻ
+    BRAKE_HANDBACK                              // 
+} brake_state_enum;
+
+// ƶ
+typedef struct
+{
+    float slip;                                 // ƶʣο - ٣/ ο
+    float cap;                                  // ռձޣʻֵڣΪռձȣ
+    float duty;                                 // ƶռձȣ
+} brake_wheel_t;
+
+// ƶṹ
+typedef struct
+{
+    brake_state_enum state;
+    uint16 handback_ms;                         // ѽʱ (ms)
+    float target;                               // Ŀ공 (mm/s)
+    float decel_request;                        // 滮ٶ (mm/s^2)
+    float reference;                            // ƶο (mm/s)
+    brake_wheel_t left;                         // 
+    brake_wheel_t right;                        // 
+    uint32 count;                               // ƶ
+    uint32 active_ms;                           // ƶۼʱ (ms)
+} brake_t;
+
+//====================================================ȫֱ====================================================
+#ifndef PID_HOST
+extern brake_t brake;
+#endif
+
+//========================================================================================================
+// ƶ״̬뷴ռձȣӲ޹أ
+void  brake_reset(brake_t *bc);                                                             // ״̬
+void  brake_set_request(brake_t *bc, float target, float decel);                            // ڣĿ공 (mm/s)滮ٶ (mm/s^2)
+void  brake_step(brake_t *bc, float left_speed, float right_speed, float accel,
+                 float left_gain, float right_gain);                                        // ÿڣ (mm/s)ٶ (mm/s^2)ģ
+float brake_blend(const brake_t *bc, const brake_wheel_t *wheel, float normal);             // ٶȻ -> ʵƶʱʱԹɣ
+
+#ifndef PID_HOST
+void  brake_init(void);                                         // ʼ
+void  brake_start(void);                                        // ʱã״̬ͳ
+void  brake_update(void);                                       // 1msжtraction_update()֮
+#endif
+
+#endif // _BRAKE_CONTROL_H_
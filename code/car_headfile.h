@@ -10,10 +10,28 @@
 // ====================================================ģͷļ====================================================
 #include "motor_control.h"
 #include "pid_control.h"
+#include "pid_batch.h"
 #include "vision_track.h"
 #include "smart_car.h"
 #include "element_recognition.h"
 #include "display_tft180.h"
 #include "show_speed.h"
+#include "lap_timer.h"
+#include "element_sequence.h"
+#include "element_cnn.h"
+#include "speed_planner.h"
+#include "yaw_control.h"
+#include "odometry.h"
+#include "lap_memory.h"
+#include "speed_loop.h"
+#include "steer_predict.h"
+#include "pure_pursuit.h"
+#include "lateral_kf.h"
+#include "servo_calib.h"
+#include "speed_autotune.h"
+#include "motor_ident.h"
+#include "battery.h"
+#include "traction_control.h"
+#include "brake_control.h"
 
 #endif // _CAR_HEADFILE_H_
@@ -0,0 +1,17 @@
+#ifndef _CAR_PARAMS_H_
+#define _CAR_PARAMS_H_
+
+// òֻ궨壬ͷļĿ壨motor_control.hλԱ루PID_HOST֤ͬһ
+
+//========================================================================================================
+#define MOTOR_MAX_DUTY      8000                // ռձ (PWM_DUTY_MAX = 10000)
+
+//====================================================β====================================================
+// λ: mm
+#define CAR_WHEELBASE       200                 //  (ǰ־)
+#define CAR_TRACK_WIDTH     160                 // ־ (־)
+
+//====================================================Ӳٲ====================================================
+#define DIFFERENTIAL_SIGN   (1)                 // 1-תʱּּ٣car_update_differential_speed()ԭʽһ£ʵ෴ʱΪ-1
+
+#endif // _CAR_PARAMS_H_
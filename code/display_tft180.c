@@ -50,6 +50,11 @@ void smart_car_display_info_tft180(void)
     // ƫʾ
     tft180_show_string(0, 88, "Error:");
     tft180_show_int(60, 88, vision_get_deviation(), 4);
+    
+    // صѹʾ
+    tft180_show_string(0, 104, "Bat:");
+    tft180_show_float(40, 104, battery.voltage, 2, 2);
+    tft180_show_string(96, 104, battery.low ? "LOW" : "   ");
 }
 
 /**
@@ -0,0 +1,211 @@
+#include "element_classifier.h"
+#include "element_tree_model.h"
+#include "IfxStm.h"
+#include <string.h>
+
+// ȫֱ
+element_classifier_t element_classifier;
+
+/**
+ * @brief  ȡSTM
+ * @param  
+ * @return STM032λʱͳʱʹã
+ */
+uint32 element_classifier_ticks(void)
+{
+    return (uint32)IfxStm_get(&MODULE_STM0);
+}
+
+/**
+ * @brief  ʼ
+ * @param  
+ * @return 
+ */
+void element_classifier_init(void)
+{
+    memset(&element_classifier, 0, sizeof(element_classifier));
+    element_classifier.result = ELEMENT_NONE;
+    element_classifier.log_enable = CLASSIFIER_FEATURE_LOG_ENABLE;
+    element_classifier.label = CLASSIFIER_LABEL_NONE;
+}
+
+/**
+ * @brief  ȡָе
+ * @param  row  к
+ * @return ȣأ߽쳣0
+ */
+static int16 feature_track_width(uint8 row)
+{
+    uint8 left = vision.track.left_edge[row];
+    uint8 right = vision.track.right_edge[row];
+    
+    return (left < right) ? (int16)(right - left) : 0;
+}
+
+/**
+ * @brief  ӵǰ֡ȡ
+ * @param  feature  FEATURE_COUNT
+ * @return 
+ * @note   ֻʹѲѵõĽУΪĿλһ
+ */
+void element_classifier_extract_features(int16 *feature)
+{
+    uint8 max_transitions = 0;
+    int16 dark = 0;
+    
+    feature[FEATURE_WIDTH_NEAR]   = feature_track_width(FEATURE_ROW_NEAR);
+    feature[FEATURE_WIDTH_MID]    = feature_track_width(FEATURE_ROW_MID);
+    feature[FEATURE_WIDTH_FAR]    = feature_track_width(FEATURE_ROW_FAR);
+    feature[FEATURE_CENTER_SHIFT] = (int16)vision.track.center_line[FEATURE_ROW_FAR] -
+                                    (int16)vision.track.center_line[FEATURE_ROW_NEAR];
+    feature[FEATURE_LEFT_LOST]    = (int16)Left_Lost_Time;
+    feature[FEATURE_RIGHT_LOST]   = (int16)Right_Lost_Time;
+    feature[FEATURE_BOTH_LOST]    = (int16)Both_Lost_Time;
+    feature[FEATURE_WHITE_LEFT]   = (int16)Longest_White_Column_Left[0];
+    feature[FEATURE_WHITE_RIGHT]  = (int16)Longest_White_Column_Right[0];
+    feature[FEATURE_COLUMN_GAP]   = (int16)(Longest_White_Column_Right[1] - Longest_White_Column_Left[1]);
+    
+    // ϡУڰߣڲڵϰ
+    for (uint8 row = FEATURE_ROW_FAR; row <= FEATURE_ROW_NEAR; row += FEATURE_ROW_STEP)
+    {
+        const uint8 *line = image_data[row];
+        uint8 transitions = 0;
+        uint8 left = vision.track.left_edge[row];
+        uint8 right = vision.track.right_edge[row];
+        
+        for (uint8 col = FEATURE_COL_START + 1; col < FEATURE_COL_END; col++)
+        {
+            transitions += (line[col] != line[col - 1]);
+            dark += (col > left && col < right && line[col] == IMG_BLACK);
+        }
+        
+        if (transitions > max_transitions)
+            max_transitions = transitions;
+    }
+    
+    feature[FEATURE_TRANSITIONS] = max_transitions;
+    feature[FEATURE_TRACK_DARK]  = dark;
+    feature[FEATURE_VALID_ROWS]  = vision.track.valid_rows;
+}
+
+/**
+ * @brief  ȡ
+ * @param  confidence  Ŷ (0-100)ΪѵʱҶжı
+ * @return 
+ * @note   洢ÿһαȽϵõ0/1ֱӼӽڵ±꣬
+ *         ѭ̶ΪELEMENT_TREE_DEPTHط֧ʱ㶨
+ */
+element_type_enum element_classifier_classify(uint8 *confidence)
+{
+    uint32 start = element_classifier_ticks();
+    int16 *feature = element_classifier.feature;
+    uint16 node = 0;
+    
+    element_classifier_extract_features(feature);
+    
+    for (uint8 level = 0; level < ELEMENT_TREE_DEPTH; level++)
+    {
+        node = 2 * node + 1 + (feature[element_tree_feature[node]] > element_tree_threshold[node]);
+    }
+    node -= ELEMENT_TREE_NODES;
+    
+    element_classifier.result = (element_type_enum)element_tree_leaf_class[node];
+    element_classifier.confidence = element_tree_leaf_confidence[node];
+    element_classifier.frame_count++;
+    element_classifier.tree_ticks = element_classifier_ticks() - start;
+    
+    if (confidence != NULL)
+        *confidence = element_classifier.confidence;
+    
+    return element_classifier.result;
+}
+
+/**
+ * @brief  
+ * @param  rule_type  ֡
+ * @return 
+ * @note   ʽFEAT,֡,ǩ,,,0,...˹עʱԱעΪǩ
+ *         ԹΪǩ tools/train_element_tree.py ȡѵ
+ */
+void element_classifier_log_features(element_type_enum rule_type)
+{
+    if (!element_classifier.log_enable)
+        return;
+    
+    uint8 label = (element_classifier.label != CLASSIFIER_LABEL_NONE) ? element_classifier.label : (uint8)rule_type;
+    
+    printf("FEAT,%lu,%d,%d,%d", (unsigned long)element_classifier.frame_count, label,
+           (int)rule_type, (int)element_classifier.result);
+    for (uint8 i = 0; i < FEATURE_COUNT; i++)
+    {
+        printf(",%d", element_classifier.feature[i]);
+    }
+    printf("\r\n");
+}
+
+/**
+ * @brief  Ա
+ * @param  rule_type   ֡
+ * @param  rule_ticks  ֡ʱSTM
+ * @return 
+ * @note   ԱȲģʽÿ֡ãоͳƽһߺʱ
+ *         ÿCLASSIFIER_BENCH_PRINT_FRAMES֡ͨһ BENCH ͳ
+ */
+void element_classifier_benchmark(element_type_enum rule_type, uint32 rule_ticks)
+{
+    element_classifier_classify(NULL);
+    element_classifier_log_features(rule_type);
+    
+    element_classifier.rule_ticks = rule_ticks;
+    element_classifier.rule_ticks_sum += rule_ticks;
+    if (rule_ticks > element_classifier.rule_ticks_max)
+        element_classifier.rule_ticks_max = rule_ticks;
+    
+    element_classifier.tree_ticks_sum += element_classifier.tree_ticks;
+    if (element_classifier.tree_ticks > element_classifier.tree_ticks_max)
+        element_classifier.tree_ticks_max = element_classifier.tree_ticks;
+    
+    element_classifier.agree_count += (element_classifier.result == rule_type);
+    element_classifier.bench_frames++;
+    
+    if (element_classifier.bench_frames >= CLASSIFIER_BENCH_PRINT_FRAMES)
+    {
+        // STMΪ
+        uint32 ns_per_tick = 1000000000UL / (uint32)IfxStm_getFrequency(&MODULE_STM0);
+        
+        printf("BENCH rule avg %lu max %lu ns, tree avg %lu max %lu ns, agree %d/%d\r\n",
+               (unsigned long)(element_classifier.rule_ticks_sum / element_classifier.bench_frames * ns_per_tick),
+               (unsigned long)(element_classifier.rule_ticks_max * ns_per_tick),
+               (unsigned long)(element_classifier.tree_ticks_sum / element_classifier.bench_frames * ns_per_tick),
+               (unsigned long)(element_classifier.tree_ticks_max * ns_per_tick),
+               element_classifier.agree_count, element_classifier.bench_frames);
+        
+        element_classifier.rule_ticks_sum = 0;
+        element_classifier.rule_ticks_max = 0;
+        element_classifier.tree_ticks_sum = 0;
+        element_classifier.tree_ticks_max = 0;
+        element_classifier.agree_count = 0;
+        element_classifier.bench_frames = 0;
+    }
+}
+
+/**
+ * @brief  ˹עǩ
+ * @param  label  ԪͣCLASSIFIER_LABEL_NONEʾȡע
+ * @return 
+ * @note   ɼѵʱɰλͨԪڼ
+ */
+void element_classifier_set_label(uint8 label)
+{
+    element_classifier.label = label;
+}
+
+/**
+ * @brief  ־
+ * @param  enable  1- 0-ر
+ * @return 
+ */
+void element_classifier_set_log(uint8 enable)
+{
+    element_classifier.log_enable = enable ? 1 : 0;
+}
@@ -0,0 +1,75 @@
+#ifndef _ELEMENT_CLASSIFIER_H_
+#define _ELEMENT_CLASSIFIER_H_
+
+#include "zf_common_headfile.h"
+#include "element_recognition.h"
+
+//========================================================================================================
+#define CLASSIFIER_FEATURE_LOG_ENABLE   0       // ϵǷĬͨ (1-, 0-ر)
+#define CLASSIFIER_BENCH_PRINT_FRAMES   100     // ԱȲģʽÿ֡һͳ
+#define CLASSIFIER_LABEL_NONE           0xFF    // ˹ע־ԹΪǩ
+
+// 
+#define FEATURE_ROW_NEAR                100     // Ȳ
+#define FEATURE_ROW_MID                 80      // вȲ
+#define FEATURE_ROW_FAR                 60      // ԶȲ
+#define FEATURE_ROW_STEP                4       // /ڵͳƵв
+#define FEATURE_COL_START               20      // ͳʼ
+#define FEATURE_COL_END                 168     // ͳƽ
+
+//========================================================================================================
+// ±꣬˳ tools/train_element_tree.py  FEATURE_NAMES һ
+typedef enum
+{
+    FEATURE_WIDTH_NEAR = 0,                     // 
+    FEATURE_WIDTH_MID,                          // в
+    FEATURE_WIDTH_FAR,                          // Զ
+    FEATURE_CENTER_SHIFT,                       // Զв̶ȣ
+    FEATURE_LEFT_LOST,                          // 
+    FEATURE_RIGHT_LOST,                         // Ҷ
+    FEATURE_BOTH_LOST,                          // ˫߶
+    FEATURE_WHITE_LEFT,                         // г
+    FEATURE_WHITE_RIGHT,                        // г
+    FEATURE_COLUMN_GAP,                         // м
+    FEATURE_TRANSITIONS,                        // ڰ
+    FEATURE_TRACK_DARK,                         // ڲڵ
+    FEATURE_VALID_ROWS,                         // Ч
+    FEATURE_COUNT
+} element_feature_enum;
+
+//====================================================ݽṹ====================================================
+// ͳ
+typedef struct
+{
+    int16 feature[FEATURE_COUNT];               // һ֡
+    element_type_enum result;                   // һ֡
+    uint8 confidence;                           // һ֡Ŷ (0-100)
+    
+    uint8 log_enable;                           // Ƿ־
+    uint8 label;                                // ˹עǩCLASSIFIER_LABEL_NONEʾ
+    uint32 frame_count;                         // Ѵ֡
+    
+    uint32 rule_ticks;                          // һ֡ʱSTM
+    uint32 rule_ticks_max;                      // ʱ
+    uint32 rule_ticks_sum;                      // ͳۼƺʱ
+    uint32 tree_ticks;                          // һ֡ʱȡ
+    uint32 tree_ticks_max;                      // ʱ
+    uint32 tree_ticks_sum;                      // ͳۼƺʱ
+    uint16 bench_frames;                        // ͳ֡
+    uint16 agree_count;                         // ͳǰ˽һµ֡
+} element_classifier_t;
+
+//====================================================ȫֱ====================================================
+extern element_classifier_t element_classifier;
+
+//========================================================================================================
+void  element_classifier_init(void);                                    // ʼ
+void  element_classifier_extract_features(int16 *feature);              // ӵǰ֡ȡ
+element_type_enum element_classifier_classify(uint8 *confidence);      // ȡ
+void  element_classifier_benchmark(element_type_enum rule_type, uint32 rule_ticks); // Աȣʱ
+void  element_classifier_log_features(element_type_enum rule_type);     // ѵݣ
+void  element_classifier_set_label(uint8 label);                        // ˹עǩ
+void  element_classifier_set_log(uint8 enable);                         // ־
+uint32 element_classifier_ticks(void);                                  // ȡSTMʱͳã
+
+#endif // _ELEMENT_CLASSIFIER_H_
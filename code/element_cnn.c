@@ -0,0 +1,304 @@
+#include "element_cnn.h"
+#include "element_cnn_weights.h"
+#include <string.h>
+#ifndef ELEMENT_CNN_HOST
+#include "IfxStm.h"
+#include <math.h>
+#endif
+
+#ifndef ELEMENT_CNN_HOST
+#pragma section all "cpu1_dsram"
+// ڴCPU1RAM
+#endif
+
+// CNN״̬
+element_cnn_t element_cnn;
+
+#ifndef ELEMENT_CNN_HOST
+// ̬ڴCPU1ռ
+static int8 element_cnn_arena[ELEMENT_CNN_ARENA_BYTES];
+// CPU0²ݴ
+static int8 element_cnn_input[ELEMENT_CNN_IN_BYTES];
+#pragma section all restore
+#endif
+
+//====================================================ں====================================================
+/**
+ * @brief  3x32ֱӾ
+ * @param  in          ͼ (HWC)
+ * @param  in_h        ߶
+ * @param  in_w        
+ * @param  in_c        ͨ
+ * @param  weight      Ȩ [out_c][3][3][in_c]
+ * @param  bias        ƫ [out_c]ѰȨΪint32
+ * @param  multiplier  
+ * @param  shift       λ
+ * @param  out         ͼ (HWC)
+ * @param  out_c       ͨ
+ * @return 
+ * @note   im2colHWC¾˵һ (3*in_c) ֱȨе
+ *          = clamp((acc*multiplier) >> shift, 0, 127)ReLUϲ
+ */
+void element_cnn_conv3x3(const int8 *in, uint8 in_h, uint8 in_w, uint8 in_c,
+                         const int8 *weight, const int32 *bias, int32 multiplier, uint8 shift,
+                         int8 *out, uint8 out_c)
+{
+    uint8 out_h = ELEMENT_CNN_OUT_SIZE(in_h);
+    uint8 out_w = ELEMENT_CNN_OUT_SIZE(in_w);
+    uint16 row_stride = (uint16)in_w * in_c;
+    uint16 kernel_row = ELEMENT_CNN_KERNEL * in_c;
+    int64 round = (int64)1 << (shift - 1);
+    
+    for (uint8 oy = 0; oy < out_h; oy++)
+    {
+        for (uint8 ox = 0; ox < out_w; ox++)
+        {
+            const int8 *patch = in + (oy * ELEMENT_CNN_STRIDE) * row_stride + (ox * ELEMENT_CNN_STRIDE) * in_c;
+            const int8 *w = weight;
+            
+            for (uint8 oc = 0; oc < out_c; oc++)
+            {
+                int32 acc = bias[oc];
+                
+                for (uint8 ky = 0; ky < ELEMENT_CNN_KERNEL; ky++)
+                {
+                    const int8 *src = patch + ky * row_stride;
+                    
+                    for (uint16 i = 0; i < kernel_row; i++)
+                    {
+                        acc += (int32)src[i] * w[i];
+                    }
+                    w += kernel_row;
+                }
+                
+                int32 y = (int32)(((int64)acc * multiplier + round) >> shift);
+                if (y < 0)
+                    y = 0;
+                if (y > 127)
+                    y = 127;
+                *out++ = (int8)y;
+            }
+        }
+    }
+}
+
+/**
+ * @brief  ȫƽػ+ȫ
+ * @param  in         ͼ (HWC)
+ * @param  positions  ͼ (H*W)
+ * @param  in_c       ͨELEMENT_CNN_C2
+ * @param  weight     ȫȨ [][in_c]
+ * @param  bias       ȫƫ []
+ * @param  logits      []
+ * @return 
+ */
+void element_cnn_pool_fc(const int8 *in, uint16 positions, uint8 in_c,
+                         const int8 *weight, const int32 *bias, int32 *logits)
+{
+    int32 pooled[ELEMENT_CNN_C2];
+    
+    memset(pooled, 0, sizeof(pooled));
+    for (uint16 p = 0; p < positions; p++)
+    {
+        for (uint8 c = 0; c < in_c; c++)
+        {
+            pooled[c] += *in++;
+        }
+    }
+    for (uint8 c = 0; c < in_c; c++)
+    {
+        pooled[c] = (pooled[c] + positions / 2) / positions;
+    }
+    
+    for (uint8 k = 0; k < ELEMENT_CNN_CLASSES; k++)
+    {
+        int32 acc = bias[k];
+        for (uint8 c = 0; c < in_c; c++)
+        {
+            acc += pooled[c] * weight[k * in_c + c];
+        }
+        logits[k] = acc;
+    }
+}
+
+/**
+ * @brief  ִһ
+ * @param  arena   ̬ڴ0Ϊint8 (ELEMENT_CNN_IN_H x ELEMENT_CNN_IN_W)
+ * @param  logits   []
+ * @return 
+ * @note   conv1: 0 -> 1conv2: 1 -> 0޶̬ڴ
+ */
+void element_cnn_infer(int8 *arena, int32 *logits)
+{
+    int8 *buf0 = arena;
+    int8 *buf1 = arena + ELEMENT_CNN_BUF0_BYTES;
+    
+    element_cnn_conv3x3(buf0, ELEMENT_CNN_IN_H, ELEMENT_CNN_IN_W, 1,
+                        element_cnn_conv1_weight, element_cnn_conv1_bias,
+                        ELEMENT_CNN_CONV1_MULT, ELEMENT_CNN_CONV1_SHIFT, buf1, ELEMENT_CNN_C1);
+    element_cnn_conv3x3(buf1, ELEMENT_CNN_C1_H, ELEMENT_CNN_C1_W, ELEMENT_CNN_C1,
+                        element_cnn_conv2_weight, element_cnn_conv2_bias,
+                        ELEMENT_CNN_CONV2_MULT, ELEMENT_CNN_CONV2_SHIFT, buf0, ELEMENT_CNN_C2);
+    element_cnn_pool_fc(buf0, ELEMENT_CNN_C2_H * ELEMENT_CNN_C2_W, ELEMENT_CNN_C2,
+                        element_cnn_fc_weight, element_cnn_fc_bias, logits);
+}
+
+#ifndef ELEMENT_CNN_HOST
+//====================================================˫˵====================================================
+/**
+ * @brief  CNNʼ
+ * @param  
+ * @return 
+ * @note   CPU1cpu_wait_event_ready()֮ǰ
+ */
+void element_cnn_init(void)
+{
+    memset(&element_cnn, 0, sizeof(element_cnn));
+}
+
+/**
+ * @brief  ύǰ֡
+ * @param  
+ * @return 
+ * @note   CPU0ѭڴͼʱãÿELEMENT_CNN_FRAME_DIVIDER֡mt9v03x_image4x4ֵ²
+ *         дݴCPU1δȡߵһֱ֡ӱǣʹͼ
+ */
+void element_cnn_submit_frame(void)
+{
+#if ELEMENT_CNN_ENABLE
+    if (++element_cnn.frame_divider < ELEMENT_CNN_FRAME_DIVIDER)
+        return;
+    element_cnn.frame_divider = 0;
+    
+    element_cnn.input_sequence++;           // д
+    __dsync();
+    
+    int8 *dst = element_cnn_input;
+    for (uint8 y = 0; y < ELEMENT_CNN_IN_H; y++)
+    {
+        for (uint8 x = 0; x < ELEMENT_CNN_IN_W; x++)
+        {
+            uint16 sum = 0;
+            for (uint8 dy = 0; dy < ELEMENT_CNN_DOWNSAMPLE; dy++)
+            {
+                const uint8 *src = &mt9v03x_image[y * ELEMENT_CNN_DOWNSAMPLE + dy][x * ELEMENT_CNN_DOWNSAMPLE];
+                sum += src[0] + src[1] + src[2] + src[3];
+            }
+            *dst++ = (int8)((sum >> 4) - 128);
+        }
+    }
+    
+    __dsync();
+    element_cnn.input_sequence++;           // żд
+#endif
+}
+
+/**
+ * @brief  element_recog
+ * @param  logits  
+ * @return 
+ * @note   softmaxΪ0-100÷֣ǰż1ȡݴжǷ
+ */
+static void element_cnn_publish(const int32 *logits)
+{
+    float prob[ELEMENT_CNN_CLASSES];
+    float sum = 0.0f;
+    int32 max_logit = logits[0];
+    uint8 top = 0;
+    
+    for (uint8 k = 1; k < ELEMENT_CNN_CLASSES; k++)
+    {
+        if (logits[k] > max_logit)
+        {
+            max_logit = logits[k];
+            top = k;
+        }
+    }
+    for (uint8 k = 0; k < ELEMENT_CNN_CLASSES; k++)
+    {
+        prob[k] = expf((float)(logits[k] - max_logit) * ELEMENT_CNN_LOGIT_SCALE);
+        sum += prob[k];
+    }
+    
+    element_recog.cnn.sequence++;
+    __dsync();
+    for (uint8 k = 0; k < ELEMENT_CNN_CLASSES; k++)
+    {
+        element_recog.cnn.score[k] = (uint8)(prob[k] * 100.0f / sum + 0.5f);
+    }
+    element_recog.cnn.top_type = (element_type_enum)top;
+    element_recog.cnn.top_score = element_recog.cnn.score[top];
+    element_recog.cnn.frame = element_cnn.run_count;
+    __dsync();
+    element_recog.cnn.sequence++;
+}
+
+/**
+ * @brief  CPU1
+ * @param  
+ * @return 
+ * @note   CPU1ѭзãƵڴִͳƺʱԤ
+ */
+void element_cnn_task(void)
+{
+#if ELEMENT_CNN_ENABLE
+    uint32 sequence = element_cnn.input_sequence;
+    
+    if ((sequence & 1) || sequence == element_cnn.taken_sequence)
+        return;
+    
+    memcpy(element_cnn_arena, element_cnn_input, ELEMENT_CNN_IN_BYTES);
+    __dsync();
+    
+    // ڼCPU0дһ֡ϣ´ѭ¸
+    if (element_cnn.input_sequence != sequence)
+        return;
+    
+    if (element_cnn.taken_sequence != 0)
+    {
+        element_cnn.drop_count += (sequence - element_cnn.taken_sequence) / 2 - 1;
+    }
+    element_cnn.taken_sequence = sequence;
+    
+    uint64 start = IfxStm_get(&MODULE_STM0);
+    element_cnn_infer(element_cnn_arena, element_cnn.logits);
+    uint64 ticks = IfxStm_get(&MODULE_STM0) - start;
+    
+    element_cnn.run_count++;
+    element_cnn.run_us = (uint32)(ticks * 1000000 / (uint64)IfxStm_getFrequency(&MODULE_STM0));
+    if (element_cnn.run_us > element_cnn.run_us_max)
+        element_cnn.run_us_max = element_cnn.run_us;
+    if (element_cnn.run_us > ELEMENT_CNN_BUDGET_US)
+        element_cnn.over_budget_count++;
+    
+    element_cnn_publish(element_cnn.logits);
+#endif
+}
+
+/**
+ * @brief  ȡ·ķ
+ * @param  type   ÷ߵ
+ * @param  score  ߵ÷ (0-100)
+ * @return 1-½ 0-ϴζȡCPU1δ½
+ * @note   CPU0ãȡڼCPU1½ضÿֻһΣ֡ʱ
+ *         δµ֡ظʱں
+ */
+uint8 element_cnn_read(element_type_enum *type, uint8 *score)
+{
+    uint32 sequence;
+    
+    do
+    {
+        sequence = element_recog.cnn.sequence;
+        *type = element_recog.cnn.top_type;
+        *score = element_recog.cnn.top_score;
+        __dsync();
+    } while ((sequence & 1) || sequence != element_recog.cnn.sequence);
+    
+    if (sequence == element_cnn.read_sequence)
+        return 0;
+    
+    element_cnn.read_sequence = sequence;
+    return 1;
+}
+#endif
@@ -0,0 +1,92 @@
+#ifndef _ELEMENT_CNN_H_
+#define _ELEMENT_CNN_H_
+
+#ifdef ELEMENT_CNN_HOST
+// λ׼Ա루tools/element_cnn_bench.cֻʹں
+#include <stdint.h>
+typedef uint8_t  uint8;
+typedef int8_t   int8;
+typedef uint16_t uint16;
+typedef int16_t  int16;
+typedef uint32_t uint32;
+typedef int32_t  int32;
+typedef int64_t  int64;
+#define ELEMENT_CNN_CLASSES         9
+#else
+#include "zf_common_headfile.h"
+#include "element_recognition.h"
+#define ELEMENT_CNN_CLASSES         ELEMENT_TYPE_MAX
+#endif
+
+//====================================================CNN====================================================
+#define ELEMENT_CNN_ENABLE          0           // ǷCPU1CNNԪط (1-, 0-ر)
+#define ELEMENT_CNN_FRAME_DIVIDER   2           // ÿ֡ύһ
+#define ELEMENT_CNN_BUDGET_US       4000        // ʱԤ (us)ӦС֡Ƶ
+
+//====================================================ṹ====================================================
+// 룺MT9V03XҶͼ4x4ֵ² (188x120 -> 47x30)128תΪint8
+// conv1: 3x3 2 1->8ͨ ReLU  (30x47 -> 14x23)
+// conv2: 3x3 2 8->16ͨ ReLU (14x23 -> 6x11)
+// ȫƽػ -> ȫ 16->int32 logits
+#define ELEMENT_CNN_DOWNSAMPLE      4
+#define ELEMENT_CNN_IN_W            47
+#define ELEMENT_CNN_IN_H            30
+#define ELEMENT_CNN_KERNEL          3
+#define ELEMENT_CNN_STRIDE          2
+#define ELEMENT_CNN_C1              8
+#define ELEMENT_CNN_C2              16
+#define ELEMENT_CNN_OUT_SIZE(n)     (((n) - ELEMENT_CNN_KERNEL) / ELEMENT_CNN_STRIDE + 1)
+#define ELEMENT_CNN_C1_W            ELEMENT_CNN_OUT_SIZE(ELEMENT_CNN_IN_W)
+#define ELEMENT_CNN_C1_H            ELEMENT_CNN_OUT_SIZE(ELEMENT_CNN_IN_H)
+#define ELEMENT_CNN_C2_W            ELEMENT_CNN_OUT_SIZE(ELEMENT_CNN_C1_W)
+#define ELEMENT_CNN_C2_H            ELEMENT_CNN_OUT_SIZE(ELEMENT_CNN_C1_H)
+
+// ̬ڴconv2û0conv1ʹû1HWCУ
+#define ELEMENT_CNN_IN_BYTES        (ELEMENT_CNN_IN_H * ELEMENT_CNN_IN_W)
+#define ELEMENT_CNN_C1_BYTES        (ELEMENT_CNN_C1_H * ELEMENT_CNN_C1_W * ELEMENT_CNN_C1)
+#define ELEMENT_CNN_C2_BYTES        (ELEMENT_CNN_C2_H * ELEMENT_CNN_C2_W * ELEMENT_CNN_C2)
+#define ELEMENT_CNN_BUF0_BYTES      (ELEMENT_CNN_IN_BYTES > ELEMENT_CNN_C2_BYTES ? ELEMENT_CNN_IN_BYTES : ELEMENT_CNN_C2_BYTES)
+#define ELEMENT_CNN_ARENA_BYTES     (ELEMENT_CNN_BUF0_BYTES + ELEMENT_CNN_C1_BYTES)
+
+// ˼ӴԤƣ
+#define ELEMENT_CNN_MACS            (ELEMENT_CNN_C1_BYTES * ELEMENT_CNN_KERNEL * ELEMENT_CNN_KERNEL + \
+                                     ELEMENT_CNN_C2_BYTES * ELEMENT_CNN_KERNEL * ELEMENT_CNN_KERNEL * ELEMENT_CNN_C1 + \
+                                     ELEMENT_CNN_C2 * ELEMENT_CNN_CLASSES)
+
+//====================================================ݽṹ====================================================
+// CNN״̬
+// CPU0дǰinput_sequence1ʾд룩CPU1Ųȡһ֡
+typedef struct
+{
+    volatile uint32 input_sequence;             // ţCPU0д
+    uint32 taken_sequence;                      // ȡߵţCPU1д
+    uint32 read_sequence;                       // ѶȡĽţCPU0д
+    uint8 frame_divider;                        // ύƵ
+    uint32 drop_count;                          // CPU1δüȡ߶ǵ֡
+    uint32 run_count;                           // 
+    uint32 run_us;                              // һʱ (us)
+    uint32 run_us_max;                          // ʱ (us)
+    uint32 over_budget_count;                   // ʱԤĴ
+    int32 logits[ELEMENT_CNN_CLASSES];          // һ
+} element_cnn_t;
+
+//====================================================ȫֱ====================================================
+extern element_cnn_t element_cnn;
+
+//========================================================================================================
+// ںˣĿλã
+void element_cnn_conv3x3(const int8 *in, uint8 in_h, uint8 in_w, uint8 in_c,
+                         const int8 *weight, const int32 *bias, int32 multiplier, uint8 shift,
+                         int8 *out, uint8 out_c);                       // 3x32ֱӾ++ReLU
+void element_cnn_pool_fc(const int8 *in, uint16 positions, uint8 in_c,
+                         const int8 *weight, const int32 *bias, int32 *logits); // ȫƽػ+ȫ
+void element_cnn_infer(int8 *arena, int32 *logits);                     // arena0еִ
+
+#ifndef ELEMENT_CNN_HOST
+void element_cnn_init(void);                                            // CNNʼCPU1ã
+void element_cnn_submit_frame(void);                                    // ύǰ֡CPU0ѭÿ֡ã
+void element_cnn_task(void);                                            // CPU1ѭãִ
+uint8 element_cnn_read(element_type_enum *type, uint8 *score);          // ȡ·ķCPU0
+#endif
+
+#endif // _ELEMENT_CNN_H_
@@ -0,0 +1,199 @@
+#ifndef _ELEMENT_CNN_WEIGHTS_H_
+#define _ELEMENT_CNN_WEIGHTS_H_
+
+// ļ tools/export_element_cnn.py ɣֹ޸
+// Ȩأ 1δѵںʱ
+
+#define ELEMENT_CNN_CONV1_MULT      21009
+#define ELEMENT_CNN_CONV1_SHIFT     23
+#define ELEMENT_CNN_CONV2_MULT      23389
+#define ELEMENT_CNN_CONV2_SHIFT     24
+#define ELEMENT_CNN_LOGIT_SCALE     1.05930571e-05f       // logitʵֵ = logit * ϵ
+
+static const int8 element_cnn_conv1_weight[ELEMENT_CNN_C1 * 9] =
+{
+    -93, 89, 67, -62, -1, -13, 39, 74, -104, -120, 86, -17, 67, -127, -14, 57,
+    -69, 114, 102, -120, -121, 11, 112, -30, -72, -20, -120, -71, -16, -1, -68, -69,
+    -72, -10, -54, -122, 86, 14, 36, -80, 126, 92, -97, -43, 56, 54, 111, -20,
+    84, 43, -50, 22, 98, 88, 1, 23, -119, -66, 76, -22, -83, 12, 52, 45,
+    -32, -16, 2, 71, 5, -27, -3, -120
+};
+
+static const int32 element_cnn_conv1_bias[ELEMENT_CNN_C1] =
+{
+    -4471, 1992, 4733, 913, -1042, -3229, 22, 4722
+};
+
+static const int8 element_cnn_conv2_weight[ELEMENT_CNN_C2 * 9 * ELEMENT_CNN_C1] =
+{
+    69, 12, 16, -39, 92, -123, -84, -79, 10, 116, -19, 10, 76, 65, -58, -99,
+    92, -126, -113, 31, 76, -64, 54, 102, -68, 72, 94, 29, 80, -99, -12, 3,
+    4, 81, 18, -11, -62, 32, -45, -74, 115, 98, -76, -120, 87, -40, -7, 27,
+    20, 61, 1, -69, 44, -109, -121, 81, -10, 79, -4, -82, -106, -87, -29, -122,
+    -59, 5, -36, 21, -123, 7, -20, -123, -90, 4, 119, -125, 52, 42, 124, 48,
+    56, -70, 95, 96, 2, -52, 72, -4, -86, 38, -49, -118, -31, 0, -41, 123,
+    52, -27, 91, 81, -39, -44, -73, -67, 45, 19, -48, 118, -75, 95, 44, 57,
+    11, -45, 112, 18, 44, 102, 86, -106, -71, 33, 62, -84, -17, -123, 110, -84,
+    121, -112, -21, 94, -78, -76, -40, 105, 76, -51, -63, 120, -101, -44, 97, -73,
+    66, 98, -40, 16, -98, 62, -102, -111, 25, -93, 29, 108, 98, -101, 39, 105,
+    87, 13, 72, -11, -117, 104, -117, 119, -34, -101, -31, -57, -66, -31, -124, 119,
+    -41, -117, 18, 73, 124, 120, 123, -99, -53, -109, -70, 83, -20, 104, -52, -72,
+    93, 93, -106, -124, -98, -52, 25, 30, 26, 73, -59, 43, -85, -63, -13, 122,
+    116, 84, 99, -104, -66, -6, -47, 11, 48, -13, 100, -109, -88, -46, -47, -87,
+    41, 39, -50, 13, 0, -100, 103, 55, -61, 36, -42, -109, 75, 4, 77, 43,
+    11, 112, 11, -108, -108, 107, 104, -63, -49, -28, 20, 34, 114, -53, 87, -111,
+    -64, -49, 24, -53, -83, 100, 63, 118, -106, -44, -65, 74, 70, -91, 48, 78,
+    -56, -47, -122, -2, 123, 104, -82, 13, 123, 88, -65, 92, 82, -119, -17, 11,
+    89, -111, -68, -1, -115, 89, -82, 4, -12, -37, -125, -5, -109, -33, -63, -85,
+    -27, -92, 7, -70, 3, 51, -72, 58, -41, -95, 0, -22, 96, 60, 18, -117,
+    -62, -61, 38, 15, -87, 24, 66, 122, -121, 84, -16, 103, 68, 91, -114, 78,
+    37, -26, 47, 106, 97, 101, 46, 33, -21, -25, 59, -57, -48, 117, 55, -59,
+    18, 29, -67, 37, 49, 18, -39, 105, 117, -30, 26, -122, -63, 18, 66, -127,
+    -92, 77, -23, 32, 47, -30, 120, -15, 70, -17, -97, 27, 74, -55, -92, -13,
+    87, -85, -52, 85, 78, -100, 0, -50, 41, -44, -64, -75, 120, 78, 18, -26,
+    51, -95, 63, -55, 12, -97, -48, 72, -14, 104, -126, 11, -2, 63, 1, 47,
+    108, 117, -79, -58, 90, 12, -36, -2, 120, -97, -16, 22, 68, 118, 7, 38,
+    -31, -10, -36, 63, 111, 95, -20, 27, -75, 85, -126, -2, 72, 11, -37, -74,
+    -126, -23, -28, 62, 88, -88, 40, -74, -57, 62, -19, 36, 68, 85, -122, 98,
+    25, 124, -24, 38, 80, -4, 2, -59, 97, -50, 92, 33, 27, -8, 113, -108,
+    84, -84, 21, -24, -38, -116, 48, 84, 3, 31, 59, 33, -60, 3, -25, 6,
+    124, 8, 101, 34, 53, 62, 48, -34, 3, 16, -119, -85, -92, -26, 52, -26,
+    60, -83, 102, 120, 55, -2, 80, -1, -84, 74, 31, -14, -35, -102, 118, -31,
+    39, 93, -47, 105, 64, -80, 29, -84, 54, -43, -17, 58, -66, -113, -40, -68,
+    80, -71, 67, 27, 55, 25, 86, 81, -59, 118, 73, -61, 56, 99, -97, -10,
+    28, 53, -79, 7, -49, -72, 49, 20, -68, 87, 32, -92, -100, -118, -103, -73,
+    55, -30, -90, -112, 47, 111, -76, 121, -43, 20, 42, 87, 88, 23, 97, -89,
+    24, 107, -113, -116, 41, -38, -19, 106, 104, -25, -31, -58, -28, 27, 41, 90,
+    126, 97, -94, -97, 33, 15, 54, 90, -115, 66, -9, -104, 119, 6, 62, -114,
+    76, -88, 86, -120, 36, -112, 56, -104, 91, 105, 103, 35, -65, -37, 64, 80,
+    -46, -123, -118, 62, -112, -22, -63, -8, -33, -121, -94, -41, 85, -102, -44, 122,
+    123, 6, 75, 72, 51, -39, 63, -5, -117, -104, 78, 116, 9, 19, 0, 105,
+    8, 76, 90, 21, 101, -116, 7, 109, -14, -105, -50, -101, 84, 80, -89, 119,
+    -95, -118, -19, 39, -53, 38, 105, 80, -27, -29, -65, -13, -87, -47, -44, 108,
+    53, 59, 15, 124, -33, -51, -44, 107, 97, -48, -43, 56, 5, -37, -110, 77,
+    -93, 36, 103, -61, -122, -19, -76, -117, 6, -25, -80, 34, -34, 45, 63, 89,
+    19, -9, -23, 7, 88, 11, 69, -11, 125, 122, 58, -107, 53, 113, 4, -79,
+    72, 8, -114, -109, -55, 76, -3, -51, 52, -84, -102, 89, 100, 57, -24, 49,
+    63, -89, 12, 36, 25, 80, 97, -126, -35, 48, -60, -83, 93, 127, 75, -97,
+    112, 16, -100, 92, 100, -62, 22, -50, 98, 115, -86, 43, -5, 91, 70, -69,
+    63, -23, 35, 101, -42, 23, -4, -121, 120, 33, 126, 108, -11, -54, 55, -63,
+    11, -49, 60, 88, -98, 127, -2, -5, 18, -50, 17, -30, -37, -62, 120, 115,
+    13, 2, -33, -9, -22, 4, 55, -26, 7, 22, -25, 75, -123, 61, -104, 57,
+    11, 13, 111, -32, -83, 49, -94, 85, 81, 121, 101, 63, -61, -17, 119, -104,
+    28, -20, 45, -100, -2, 40, -57, 28, 126, 44, -105, -29, 100, 108, 52, -89,
+    13, -97, -28, 103, 11, 119, -22, -22, 9, -60, 43, -76, -73, -59, -94, -56,
+    -39, -56, -52, 5, 66, 10, -77, 50, 113, -5, 2, -21, -41, -15, 15, -59,
+    119, 75, 103, 99, -4, 66, 25, -73, -101, 91, -98, 125, -125, 87, 117, -34,
+    13, 73, 90, -54, 124, -69, 8, -7, -41, 37, -105, -20, -40, -117, -26, -38,
+    27, 79, 10, -126, 26, -107, 110, 77, -81, 100, 52, -122, 5, 57, 35, 36,
+    97, -47, 16, -50, -121, -101, -66, 87, 49, -2, 47, 29, -43, -47, 46, 27,
+    9, -43, -70, -106, -92, -59, -58, 94, -112, -95, -76, -70, -63, -114, 4, -24,
+    -44, -92, 17, 46, 69, -119, -45, 46, 48, -62, 98, 123, 46, -92, 114, 31,
+    7, -83, -101, -49, -42, 42, 97, -7, 16, -72, -32, 46, 99, 76, -10, -118,
+    9, -17, 39, -88, -87, 26, 71, 52, -27, 12, 11, 105, 89, -125, 25, -127,
+    101, -63, 11, -91, -30, 115, -20, -116, 34, -58, 87, 96, -15, 107, 110, -99,
+    12, 8, 57, -72, -97, 36, -23, -92, -113, -7, 47, 87, 26, -31, 27, 2,
+    2, -25, -119, 89, -59, 16, -114, -37, -58, 16, 126, 34, 54, -42, -78, -120,
+    123, -36, 69, 5, 121, 119, -15, -108, 104, -87, -113, -113, -122, 40, 11, -81,
+    39, 70, -17, 44, 101, 72, 18, 68, 77, 106, -31, 100, -30, -10, 109, 43,
+    81, -47, -52, -83, 85, -7, 86, 76, -65, 97, 80, 36, -83, -2, -89, -54,
+    78, -39, -15, -3, 55, 69, -32, -88, -66, 40, 51, -40, -102, 57, -99, 120
+};
+
+static const int32 element_cnn_conv2_bias[ELEMENT_CNN_C2] =
+{
+    8629, 11825, -12736, -2738, 3541, 6248, 10921, 999,
+    -2890, -13092, 8042, 12761, 10778, 4295, -4169, -6904
+};
+
+static const int8 element_cnn_fc_weight[ELEMENT_CNN_CLASSES * ELEMENT_CNN_C2] =
+{
+    70, 111, 118, -83, 22, 3, -19, 75, 111, 57, 51, 49, 39, 9, -64, 72,
+    -97, 37, -29, 15, 36, -5, 122, -67, -125, 116, -48, -57, -22, 24, 124, 53,
+    -46, 9, -13, 0, -21, -85, -27, -28, -77, 81, -36, -89, 17, 88, 72, 31,
+    59, -42, -91, -63, -39, -57, -8, -90, -95, -63, -78, 77, 10, -77, -18, 95,
+    20, 14, -28, -78, 32, -108, 73, -113, 63, -30, 47, 23, -95, 10, -109, -66,
+    -30, -55, 41, 125, -37, 87, -70, 54, -39, 9, -105, 84, -74, -9, -54, 79,
+    24, 29, 65, -63, -113, 84, -47, 80, 117, 33, -102, 91, 34, -65, -75, 2,
+    -97, 104, 53, 82, -30, 108, -94, 55, -63, -127, -97, -76, 67, -31, -5, 29,
+    -59, 35, 44, 108, 1, 91, 120, 69, -20, -58, -103, 85, -95, 15, -12, -116
+};
+
+static const int32 element_cnn_fc_bias[ELEMENT_CNN_CLASSES] =
+{
+    0, 0, 0, 0, 0, 0, 0, 0,
+    0
+};
+
+#ifdef ELEMENT_CNN_HOST
+// λ֤ò
+static const uint8 element_cnn_test_input[ELEMENT_CNN_IN_BYTES] =
+{
+    45, 23, 24, 54, 26, 43, 57, 23, 52, 33, 182, 185, 207, 206, 184, 195, 185, 215, 207, 183, 216, 187, 194, 220,
+    220, 217, 183, 216, 217, 205, 183, 34, 22, 55, 28, 38, 46, 29, 54, 27, 56, 39, 55, 31, 26, 57, 56, 60,
+    32, 43, 26, 55, 24, 56, 23, 59, 33, 211, 214, 207, 200, 209, 217, 209, 203, 199, 195, 191, 195, 185, 216, 199,
+    213, 211, 201, 208, 198, 218, 24, 27, 52, 46, 30, 41, 29, 51, 46, 22, 24, 55, 56, 40, 41, 42, 58, 51,
+    57, 49, 24, 25, 37, 50, 24, 23, 199, 216, 208, 198, 204, 202, 181, 209, 202, 190, 219, 187, 211, 183, 193, 198,
+    188, 195, 205, 205, 211, 25, 30, 48, 45, 55, 37, 28, 47, 55, 37, 46, 42, 44, 34, 29, 25, 31, 29, 34,
+    34, 20, 51, 57, 31, 36, 38, 180, 189, 206, 214, 203, 219, 216, 200, 188, 212, 219, 183, 209, 215, 205, 205, 205,
+    205, 186, 210, 220, 45, 23, 32, 24, 33, 48, 30, 27, 41, 58, 23, 26, 20, 56, 29, 54, 26, 43, 59, 21,
+    24, 33, 59, 44, 29, 60, 196, 202, 218, 203, 210, 187, 187, 211, 209, 210, 210, 199, 185, 189, 186, 201, 196, 210,
+    190, 213, 181, 33, 53, 43, 29, 54, 21, 53, 39, 25, 36, 53, 43, 30, 42, 34, 54, 54, 52, 41, 60, 34,
+    59, 32, 35, 45, 34, 192, 213, 211, 202, 181, 181, 197, 210, 196, 192, 218, 202, 208, 202, 203, 185, 194, 186, 194,
+    210, 192, 41, 33, 50, 59, 59, 20, 50, 42, 25, 27, 44, 32, 50, 31, 47, 60, 41, 25, 45, 49, 45, 25,
+    30, 30, 28, 21, 189, 217, 209, 189, 219, 218, 210, 202, 189, 215, 215, 188, 181, 180, 186, 213, 188, 207, 192, 193,
+    181, 36, 33, 38, 52, 35, 57, 40, 36, 54, 46, 28, 23, 42, 49, 57, 53, 46, 52, 28, 54, 29, 53, 52,
+    21, 48, 31, 218, 180, 189, 191, 189, 210, 219, 187, 215, 183, 200, 213, 213, 215, 210, 186, 215, 183, 195, 192, 197,
+    22, 26, 52, 48, 55, 21, 24, 48, 40, 59, 52, 58, 52, 32, 37, 48, 52, 54, 50, 52, 35, 53, 36, 55,
+    32, 48, 188, 206, 187, 205, 208, 200, 184, 195, 207, 184, 193, 199, 187, 189, 203, 189, 196, 188, 209, 194, 186, 45,
+    51, 30, 34, 30, 47, 52, 45, 41, 46, 32, 42, 40, 25, 43, 21, 41, 55, 49, 48, 21, 44, 41, 53, 59,
+    38, 212, 184, 187, 194, 186, 185, 196, 197, 182, 191, 197, 188, 207, 196, 205, 189, 214, 212, 216, 211, 200, 25, 37,
+    23, 31, 47, 24, 37, 21, 60, 25, 36, 25, 58, 34, 24, 36, 27, 49, 20, 41, 55, 46, 37, 59, 28, 22,
+    213, 195, 187, 190, 196, 183, 191, 192, 199, 220, 199, 213, 193, 198, 208, 212, 191, 197, 202, 181, 196, 22, 20, 21,
+    52, 55, 32, 52, 50, 35, 48, 26, 47, 51, 54, 45, 52, 39, 33, 34, 41, 32, 60, 28, 45, 42, 23, 188,
+    180, 184, 220, 196, 207, 190, 183, 185, 204, 212, 198, 218, 195, 198, 182, 209, 191, 190, 197, 208, 20, 36, 43, 41,
+    55, 40, 35, 22, 39, 33, 42, 31, 20, 41, 44, 25, 50, 37, 52, 32, 35, 52, 20, 25, 36, 25, 189, 205,
+    217, 182, 205, 181, 199, 199, 220, 194, 185, 217, 213, 189, 218, 204, 200, 211, 189, 198, 219, 29, 22, 52, 60, 47,
+    52, 28, 53, 52, 56, 21, 57, 34, 25, 21, 22, 28, 60, 43, 26, 44, 48, 55, 23, 60, 21, 220, 214, 195,
+    211, 196, 180, 209, 184, 212, 214, 185, 213, 184, 210, 196, 184, 196, 195, 193, 194, 209, 51, 44, 24, 50, 38, 22,
+    59, 60, 32, 24, 58, 29, 41, 36, 39, 59, 56, 28, 20, 50, 23, 51, 37, 26, 33, 51, 198, 213, 198, 209,
+    209, 209, 187, 215, 192, 199, 185, 210, 181, 198, 209, 184, 212, 208, 197, 204, 193, 33, 24, 57, 25, 29, 53, 36,
+    43, 28, 58, 60, 52, 37, 27, 43, 34, 51, 51, 45, 21, 30, 20, 51, 48, 45, 39, 189, 206, 202, 204, 200,
+    187, 201, 180, 200, 201, 205, 187, 192, 180, 198, 196, 203, 184, 205, 204, 217, 24, 43, 47, 37, 23, 37, 26, 23,
+    38, 60, 29, 35, 37, 47, 52, 40, 32, 43, 47, 21, 60, 45, 55, 55, 33, 25, 183, 206, 208, 219, 188, 198,
+    211, 183, 215, 188, 190, 210, 206, 201, 198, 199, 196, 196, 205, 195, 199, 50, 55, 45, 27, 30, 30, 24, 33, 52,
+    51, 55, 34, 48, 41, 48, 47, 28, 55, 32, 35, 25, 31, 41, 55, 25, 40, 195, 203, 196, 216, 192, 181, 206,
+    204, 206, 213, 193, 204, 197, 201, 183, 211, 197, 216, 203, 188, 212, 53, 60, 33, 25, 37, 35, 44, 45, 48, 47,
+    39, 21, 28, 22, 47, 50, 57, 51, 20, 24, 45, 53, 49, 48, 35, 26, 194, 189, 189, 213, 186, 209, 185, 215,
+    182, 180, 188, 194, 216, 182, 199, 188, 220, 196, 213, 220, 207, 27, 26, 24, 39, 53, 57, 32, 44, 36, 34, 58,
+    20, 20, 54, 39, 49, 37, 40, 35, 50, 53, 35, 55, 35, 21, 46, 199, 183, 181, 192, 211, 206, 185, 196, 194,
+    207, 203, 194, 211, 182, 201, 206, 203, 205, 192, 180, 198, 52, 24, 33, 51, 32, 39, 32, 34, 49, 34, 36, 38,
+    26, 59, 51, 59, 31, 34, 51, 46, 23, 58, 29, 45, 23, 33, 181, 218, 189, 206, 183, 183, 191, 205, 208, 200,
+    187, 185, 190, 201, 192, 191, 213, 209, 182, 199, 204, 43, 41, 48, 30, 26, 20, 25, 37, 25, 42, 46, 27, 55,
+    33, 44, 42, 39, 47, 25, 23, 50, 32, 43, 54, 48, 32, 200, 203, 210, 181, 220, 206, 195, 220, 205, 182, 204,
+    182, 209, 184, 183, 196, 192, 184, 218, 201, 203, 37, 41, 59, 22, 36, 40, 37, 39, 20, 58, 60, 24, 21, 34,
+    26, 50, 49, 44, 36, 47, 51, 28, 51, 31, 20, 39, 189, 218, 195, 200, 200, 209, 203, 218, 185, 212, 192, 205,
+    190, 195, 206, 184, 182, 210, 215, 214, 200, 30, 47, 26, 24, 36, 59, 25, 33, 26, 46, 51, 48, 31, 34, 28,
+    46, 49, 59, 35, 54, 27, 38, 38, 37, 56, 37, 203, 196, 196, 192, 208, 195, 191, 195, 195, 189, 198, 217, 192,
+    200, 184, 205, 196, 195, 212, 213, 194, 26, 49, 22, 26, 20, 50, 34, 48, 43, 22, 38, 34, 27, 23, 32, 58,
+    57, 32, 24, 43, 52, 31, 48, 58, 36, 20, 186, 220, 218, 219, 202, 193, 182, 203, 201, 189, 182, 193, 196, 182,
+    218, 193, 180, 200, 206, 203, 191, 59, 39, 24, 33, 22, 51, 55, 50, 24, 46, 26, 45, 55, 29, 60, 54, 25,
+    30, 45, 37, 46, 38, 39, 46, 23, 39, 216, 202, 206, 206, 181, 203, 192, 205, 205, 193, 180, 207, 190, 207, 187,
+    185, 205, 216, 203, 209, 190, 28, 20, 23, 55, 29, 45, 25, 56, 59, 43, 52, 30, 29, 42, 38, 30, 53, 30,
+    24, 26, 44, 51, 32, 39, 28, 22, 210, 200, 183, 218, 220, 204, 185, 219, 190, 220, 194, 219, 205, 219, 192, 210,
+    191, 216, 193, 182, 205, 53, 30, 44, 42, 27, 29, 35, 32, 22, 55, 22, 40, 27, 44, 58, 49, 55, 60, 39,
+    46, 39, 57, 35, 47, 44, 43, 208, 212, 208, 191, 181, 180, 219, 211, 209, 195, 208, 219, 209, 191, 210, 205, 186,
+    184, 188, 202, 207, 43, 25, 48, 52, 52, 22, 22, 60, 28, 25, 40, 52, 25, 23, 52, 44, 28, 21, 24, 59,
+    27, 32, 28, 51, 38, 30, 194, 184, 202, 219, 196, 190, 200, 219, 197, 209, 189, 196, 212, 210, 193, 217, 196, 219,
+    212, 195, 200, 43, 22, 32, 31, 45, 30, 60, 37, 40, 44, 30, 36, 27, 53, 23, 60, 43, 48, 55, 53, 57,
+    26, 36, 54, 60, 45, 203, 196, 204, 203, 216, 189, 203, 201, 185, 208, 194, 191, 219, 183, 198, 213, 196, 199, 220,
+    217, 200, 20, 22, 34, 29, 38, 59, 60, 47, 46, 52, 43, 23, 28, 51, 34, 59
+};
+
+static const int32 element_cnn_test_logits[ELEMENT_CNN_CLASSES] =
+{
+    12572, 4887, -7034, -1627, 952, -3296, 2554, -6839, 6711
+};
+#endif
+
+#endif // _ELEMENT_CNN_WEIGHTS_H_
@@ -1,4 +1,9 @@
 #include "element_recognition.h"
+#include "lap_timer.h"
+#include "element_sequence.h"
+#include "element_classifier.h"
+#include "element_cnn.h"
+#include "lap_memory.h"
 #include <string.h>
 #include <math.h>
 
@@ -58,6 +63,131 @@ static int16 calculate_curvature(uint8 start_row, uint8 end_row)
         return 0;
 }
 
+//====================================================ʱںغ====================================================
+// ֡Ŷȣ5%ֵӦĶ֤ݣλ0.1 10*ln(c/(100-c))
+static const int8 fusion_evidence_table[21] =
+{
+    -50, -29, -22, -17, -14, -11,  -8,  -6,  -4,  -2,
+      0,   2,   4,   6,   8,  11,  14,  17,  22,  29,
+     50
+};
+
+/**
+ * @brief  зŶʻΪ
+ * @param  logodds  ʣλ0.1
+ * @return  (0-100)
+ */
+static uint8 fusion_logodds_to_percent(int16 logodds)
+{
+    float p = 100.0f / (1.0f + expf(-(float)logodds / 10.0f));
+    return (uint8)(p + 0.5f);
+}
+
+/**
+ * @brief  ʱں״̬λ
+ * @param  
+ * @return 
+ * @note   ֤ݴڣԪػص飻ֵñ
+ */
+void element_fusion_reset(void)
+{
+    memset(element_recog.fusion.evidence, 0, sizeof(element_recog.fusion.evidence));
+    memset(element_recog.fusion.evidence_sum, 0, sizeof(element_recog.fusion.evidence_sum));
+    memset(element_recog.fusion.active, 0, sizeof(element_recog.fusion.active));
+    element_recog.fusion.head = 0;
+    
+    for (uint8 type = 0; type < ELEMENT_TYPE_MAX; type++)
+    {
+        element_recog.fusion.logodds[type] = FUSION_PRIOR_LOGODDS;
+        element_recog.fusion.posterior[type] = fusion_logodds_to_percent(FUSION_PRIOR_LOGODDS);
+    }
+}
+
+/**
+ * @brief  ʱںϸ
+ * @param  type        ֡⵽ԪͣELEMENT_NONEʾ޼⣩
+ * @param  confidence  ֡Ŷ (0-100)
+ * @return 
+ * @note   ÿ֡һΡλFUSION_WINDOW_SIZE֤֡ݣά֤ݺͣ
+ *          =  + ֤ݺͣ/˳ֵͬγͻء
+ *         ֤֡ݲFUSION_EVIDENCE_MAX֡첻ȷϣ֤Ϊͱ֡δ⵽ʱ
+ *         FUSION_MISS_LOGODDS첻صȻڼ֤ݲΪʱۻԪزӰ죩
+ */
+void element_fusion_update(element_type_enum type, uint8 confidence)
+{
+    uint8 head = element_recog.fusion.head;
+    int8 *slot = element_recog.fusion.evidence[head];
+    
+    if (confidence > 100)
+        confidence = 100;
+    
+    for (uint8 i = 0; i < ELEMENT_TYPE_MAX; i++)
+    {
+        // ֤滻һ֡ں
+        int16 remaining = element_recog.fusion.evidence_sum[i] - slot[i];
+        int8 evidence = 0;
+        if (i == type && type != ELEMENT_NONE)
+        {
+            evidence = fusion_evidence_table[confidence / 5];
+            if (evidence > FUSION_EVIDENCE_MAX)
+                evidence = FUSION_EVIDENCE_MAX;
+        }
+        else if (remaining > 0)
+        {
+            evidence = FUSION_MISS_LOGODDS;
+        }
+        element_recog.fusion.evidence_sum[i] = remaining + evidence;
+        slot[i] = evidence;
+        
+        int16 logodds = FUSION_PRIOR_LOGODDS + element_recog.fusion.evidence_sum[i];
+        element_recog.fusion.logodds[i] = logodds;
+        element_recog.fusion.posterior[i] = fusion_logodds_to_percent(logodds);
+        
+        if (!element_recog.fusion.active[i] && logodds >= element_recog.fusion.enter_logodds)
+        {
+            element_recog.fusion.active[i] = 1;
+        }
+        else if (element_recog.fusion.active[i] && logodds < element_recog.fusion.exit_logodds)
+        {
+            element_recog.fusion.active[i] = 0;
+        }
+    }
+    
+    element_recog.fusion.head = (head + 1) % FUSION_WINDOW_SIZE;
+}
+
+/**
+ * @brief  ԪغŶǷȷ״̬
+ * @param  type  Ԫ
+ * @return 1-ȷ 0-δȷ
+ */
+uint8 element_fusion_is_active(element_type_enum type)
+{
+    if (type >= ELEMENT_TYPE_MAX)
+        return 0;
+    
+#if FUSION_ENABLE
+    return element_recog.fusion.active[type];
+#else
+    return 1;   // رںʱ˻Ϊ֡ж
+#endif
+}
+
+/**
+ * @brief  ʱںжֵ
+ * @param  enter_logodds  ֵʣλ0.1
+ * @param  exit_logodds   ˳ֵʣλ0.1Ӧڽֵ
+ * @return 
+ */
+void element_fusion_set_threshold(int16 enter_logodds, int16 exit_logodds)
+{
+    if (exit_logodds > enter_logodds)
+        exit_logodds = enter_logodds;
+    
+    element_recog.fusion.enter_logodds = enter_logodds;
+    element_recog.fusion.exit_logodds = exit_logodds;
+}
+
 //====================================================Ԫʶغ====================================================
 /**
  * @brief  Ԫʶʼ
@@ -69,6 +199,79 @@ void element_recognition_init(void)
     memset(&element_recog, 0, sizeof(element_recognition_t));
     element_recog.current_element.type = ELEMENT_NONE;
     element_recog.current_element.state = ELEMENT_STATE_NONE;
+    element_recog.fork.branch = FORK_BRANCH_DEFAULT;
+    Fork_Flag = 0;
+    
+    element_recog.fusion.enter_logodds = FUSION_ENTER_LOGODDS;
+    element_recog.fusion.exit_logodds = FUSION_EXIT_LOGODDS;
+    element_fusion_reset();
+    
+    element_recog.frontend = ELEMENT_FRONTEND_DEFAULT;
+    element_classifier_init();
+}
+
+/**
+ * @brief  ǰ
+ * @param  
+ * @return ֡⵽Ԫͣδ⵽ELEMENT_NONE
+ * @note   ȼֵֹ֡Ŷȴﵽ޵ĽΪ֤֡ݣ
+ *         ԪԤģʽֻеǰ̴ڿֵܳļֱӷ
+ */
+static element_type_enum element_detect_by_rules(void)
+{
+    element_type_enum detected_type = ELEMENT_NONE;
+    
+    if (element_sequence_is_plausible(ELEMENT_ZEBRA_CROSSING) && element_detect_zebra_crossing())
+    {
+        if (element_recog.current_element.confidence >= 70)
+        {
+            detected_type = ELEMENT_ZEBRA_CROSSING;
+        }
+    }
+    else if (element_sequence_is_plausible(ELEMENT_PARKING) && element_detect_parking())
+    {
+        if (element_recog.current_element.confidence >= 70)  // Ŷֵ
+        {
+            detected_type = ELEMENT_PARKING;
+        }
+    }
+    else if (element_sequence_is_plausible(ELEMENT_OBSTACLE) && element_detect_obstacle())
+    {
+        if (element_recog.current_element.confidence >= 60)
+        {
+            detected_type = ELEMENT_OBSTACLE;
+        }
+    }
+    else if (element_sequence_is_plausible(ELEMENT_FORK) && element_detect_fork())
+    {
+        if (element_recog.current_element.confidence >= 65)
+        {
+            detected_type = ELEMENT_FORK;
+        }
+    }
+    else if (element_sequence_is_plausible(ELEMENT_CIRCLE) && element_detect_circle())
+    {
+        if (element_recog.current_element.confidence >= 70)
+        {
+            detected_type = ELEMENT_CIRCLE;
+        }
+    }
+    else if (element_sequence_is_plausible(ELEMENT_CROSS) && element_detect_cross())
+    {
+        if (element_recog.current_element.confidence >= 65)
+        {
+            detected_type = ELEMENT_CROSS;
+        }
+    }
+    else if (element_sequence_is_plausible(ELEMENT_RAMP) && element_detect_ramp())
+    {
+        if (element_recog.current_element.confidence >= 50)
+        {
+            detected_type = ELEMENT_RAMP;
+        }
+    }
+    
+    return detected_type;
 }
 
 /**
@@ -87,6 +290,11 @@ void element_recognition_process(void)
         // Ԫ״̬ΪͨʶԪزõǰԪ
         if (element_recog.current_element.state == ELEMENT_STATE_PASSED)
         {
+            // յɰߴȦԪؼ¼ֶʱ
+            if (element_recog.current_element.type != ELEMENT_ZEBRA_CROSSING)
+            {
+                lap_timer_mark_split(element_recog.current_element.type);
+            }
             element_recog.last_element = element_recog.current_element;
             element_reset();
         }
@@ -113,66 +321,72 @@ void element_recognition_process(void)
                 case ELEMENT_OBSTACLE:
                     element_handle_obstacle();
                     break;
+                case ELEMENT_FORK:
+                    element_handle_fork();
+                    break;
+                case ELEMENT_ZEBRA_CROSSING:
+                    element_handle_zebra_crossing();
+                    break;
                 default:
                     break;
             }
+            
+            // Ԫشڼ䲻мԿ֤ƽ֡ͬ
+            element_fusion_update(ELEMENT_NONE, 0);
             return;  // ԪδͨԪ
         }
     }
     
     // ǰûʶ𵽵ԪأȼμԪ
-    // ȼ˳ͣ > ϰ > Բ > ʮ > µ > 
-    // ȼμԪ
+    // ȼ˳򣺰 > ͣ > ϰ > · > Բ > ʮ > µ > 
+    // ѡǰ˼Ȿ֡Ԫأ /  / ߶Ա
+    element_type_enum detected_type = ELEMENT_NONE;
+    uint8 detected_confidence = 0;
     
-    if (element_detect_parking())
-    {
-        if (element_recog.current_element.confidence >= 70)  // Ŷֵ
-        {
-            element_recog.current_element.type = ELEMENT_PARKING;
-            element_recog.current_element.state = ELEMENT_STATE_FOUND;
-            element_recog.current_element.detected = 1;
-            element_recog.current_element.frame_count = 1;
-        }
-    }
-    else if (element_detect_obstacle())
+    element_sequence_update();
+    
+    if (element_recog.frontend == ELEMENT_FRONTEND_CLASSIFIER || element_recog.frontend == ELEMENT_FRONTEND_CNN)
     {
-        if (element_recog.current_element.confidence >= 60)
+        if (element_recog.frontend == ELEMENT_FRONTEND_CNN)
         {
-            element_recog.current_element.type = ELEMENT_OBSTACLE;
-            element_recog.current_element.state = ELEMENT_STATE_FOUND;
-            element_recog.current_element.detected = 1;
-            element_recog.current_element.frame_count = 1;
+            // CPU1첽ֻʹñ֡·Ľû½ʱ֡Կ֤ƽ
+            if (!element_cnn_read(&detected_type, &detected_confidence))
+            {
+                detected_type = ELEMENT_NONE;
+                detected_confidence = 0;
+            }
         }
-    }
-    else if (element_detect_circle())
-    {
-        if (element_recog.current_element.confidence >= 70)
+        else
         {
-            element_recog.current_element.type = ELEMENT_CIRCLE;
-            element_recog.current_element.state = ELEMENT_STATE_FOUND;
-            element_recog.current_element.detected = 1;
-            element_recog.current_element.frame_count = 1;
+            detected_type = element_classifier_classify(&detected_confidence);
         }
+        
+        // ԪһֵԪз
+        if (detected_type != ELEMENT_NONE && !element_sequence_is_plausible(detected_type))
+            detected_type = ELEMENT_NONE;
     }
-    else if (element_detect_cross())
+    else
     {
-        if (element_recog.current_element.confidence >= 65)
-        {
-            element_recog.current_element.type = ELEMENT_CROSS;
-            element_recog.current_element.state = ELEMENT_STATE_FOUND;
-            element_recog.current_element.detected = 1;
-            element_recog.current_element.frame_count = 1;
-        }
+        uint32 start = element_classifier_ticks();
+        detected_type = element_detect_by_rules();
+        detected_confidence = element_recog.current_element.confidence;
+        
+        if (element_recog.frontend == ELEMENT_FRONTEND_BENCHMARK)
+            element_classifier_benchmark(detected_type, element_classifier_ticks() - start);
     }
-    else if (element_detect_ramp())
+    
+    // ʱںϣ֤֡ݼ뻬ڣŶԽֵȷԪأ޳֡
+    element_fusion_update(detected_type, detected_confidence);
+    
+    if (detected_type != ELEMENT_NONE && element_fusion_is_active(detected_type))
     {
-        if (element_recog.current_element.confidence >= 50)
-        {
-            element_recog.current_element.type = ELEMENT_RAMP;
-            element_recog.current_element.state = ELEMENT_STATE_FOUND;
-            element_recog.current_element.detected = 1;
-            element_recog.current_element.frame_count = 1;
-        }
+        element_recog.current_element.type = detected_type;
+        element_recog.current_element.state = ELEMENT_STATE_FOUND;
+        element_recog.current_element.detected = 1;
+        element_recog.current_element.frame_count = 1;
+        element_recog.current_element.confidence = element_recog.fusion.posterior[detected_type];
+        
+        element_sequence_on_element(detected_type);
     }
 }
 
@@ -466,49 +680,166 @@ uint8 element_detect_obstacle(void)
  * @brief  Ԫʶ
  * @param  
  * @return 1-ʶ𵽰Ԫ 0-δʶ𵽰Ԫ
+ * @note   еɨͳƺڰ䣬γ̿ںΧڵмΪУ㹻ǰ
  */
 uint8 element_detect_zebra_crossing(void)
 {
-    // δҵЧ㣬δʶ
-    uint8 stripe_count = 0;
-    uint8 last_color = 0;  // 0-ɫ 1-ɫ
+    uint8 stripe_rows = 0;
     
-    for (uint8 row = 50; row < 90; row += 2)
+    for (uint8 row = ZEBRA_ROW_START; row < ZEBRA_ROW_END && row < IMAGE_HEIGHT; row += ZEBRA_ROW_STEP)
     {
-        uint8 white_count = 0;
-        uint8 total_count = 0;
+        const uint8 *line = image_data[row];
+        uint8 transitions = 0;
+        uint8 valid_runs = 0;
+        uint8 run_start = ZEBRA_COL_START;
         
-        for (uint8 col = 40; col < 120; col++)
+        for (uint8 col = ZEBRA_COL_START + 1; col < ZEBRA_COL_END && col < IMAGE_WIDTH; col++)
         {
-            if (col < MT9V03X_W && row < MT9V03X_H)
+            // ɫ伴һγ̽
+            if (line[col] != line[col - 1])
             {
-                total_count++;
-                if (image_data[row][col] == 255)
+                uint8 run = col - run_start;
+                transitions++;
+                if (run >= ZEBRA_RUN_MIN && run <= ZEBRA_RUN_MAX)
                 {
-                    white_count++;
+                    valid_runs++;
                 }
+                run_start = col;
             }
         }
         
-        uint8 current_color = (white_count > total_count / 2) ? 1 : 0;
-        
-        if (row > 50 && current_color != last_color)
+        // 㹻Ҿγ̿Ⱥųɵܼ
+        if (transitions >= ZEBRA_TRANSITION_MIN && valid_runs * 4 >= transitions * 3)
         {
-            stripe_count++;
+            stripe_rows++;
+            if (stripe_rows >= ZEBRA_ROWS_MIN + 4)
+                break;
         }
-        
-        last_color = current_color;
     }
     
-    // ﵽֵΪʶ𵽰
-    if (stripe_count >= 4)
+    element_recog.zebra.stripe_rows = stripe_rows;
+    
+    if (stripe_rows >= ZEBRA_ROWS_MIN)
     {
+        element_recog.current_element.confidence = 60 + stripe_rows * 4;
+        if (element_recog.current_element.confidence > 95)
+            element_recog.current_element.confidence = 95;
         return 1;
     }
     
     return 0;
 }
 
+/**
+ * @brief  Ԫʶ·
+ * @param  
+ * @return 1-ʶ𵽲·Ԫ 0-δʶ𵽲·Ԫ
+ * @note   ÿа׵֮һɫШΣVΣһΪ
+ *         Longest_White_Column_Left/Rightֻȫͼвʱ֧ϣ
+ *         ШμˣڼֱҸ֧У֧ȲͬҲʶ
+ */
+uint8 element_detect_fork(void)
+{
+    int col;
+    
+    // ܴߣųʮ֣
+    if (Both_Lost_Time > FORK_BOTH_LOST_MAX)
+        return 0;
+    
+    // ڷΧҵĳ
+    int first_long = -1;
+    int last_long = -1;
+    for (col = 0; col < IMAGE_WIDTH; col++)
+    {
+        if (White_Column[col] >= FORK_LONG_COLUMN_MIN)
+        {
+            if (first_long < 0)
+                first_long = col;
+            last_long = col;
+        }
+    }
+    
+    if (first_long < 0 || last_long - first_long < FORK_COLUMN_GAP_MIN)
+        return 0;
+    
+    // Χڵ̰мШμ
+    int tip_col = first_long;
+    int tip_len = IMAGE_HEIGHT;
+    for (col = first_long + 1; col < last_long; col++)
+    {
+        if (White_Column[col] < tip_len)
+        {
+            tip_len = White_Column[col];
+            tip_col = col;
+        }
+    }
+    
+    // ֱУҷ֧
+    int left_col = first_long;
+    int left_len = 0;
+    for (col = first_long; col < tip_col; col++)
+    {
+        if (White_Column[col] > left_len)
+        {
+            left_len = White_Column[col];
+            left_col = col;
+        }
+    }
+    
+    int right_col = last_long;
+    int right_len = 0;
+    for (col = last_long; col > tip_col; col--)
+    {
+        if (White_Column[col] > right_len)
+        {
+            right_len = White_Column[col];
+            right_col = col;
+        }
+    }
+    
+    // ֧Ҫ㹻İУҪԷֿ
+    if (left_len < FORK_LONG_COLUMN_MIN || right_len < FORK_LONG_COLUMN_MIN)
+        return 0;
+    
+    if (right_col - left_col < FORK_COLUMN_GAP_MIN)
+        return 0;
+    
+    int long_len = left_len < right_len ? left_len : right_len;
+    int depth = long_len - tip_len;
+    
+    if (depth < FORK_WEDGE_DEPTH_MIN)
+        return 0;
+    
+    // Шοȣгȵڰȵ
+    int half_len = tip_len + depth / 2;
+    uint8 wedge_width = 0;
+    for (col = left_col + 1; col < right_col; col++)
+    {
+        if (White_Column[col] < half_len)
+        {
+            wedge_width++;
+        }
+    }
+    
+    if (wedge_width < FORK_WEDGE_WIDTH_MIN)
+        return 0;
+    
+    // ШӦ𽥱䳤VΣеų״ϰ
+    int mid_left = White_Column[(left_col + tip_col) / 2];
+    int mid_right = White_Column[(tip_col + right_col) / 2];
+    if (mid_left <= tip_len + depth / 4 || mid_left >= long_len - depth / 8 ||
+        mid_right <= tip_len + depth / 4 || mid_right >= long_len - depth / 8)
+        return 0;
+    
+    element_recog.fork.wedge_column = (uint8)tip_col;
+    element_recog.fork.wedge_depth = (uint8)depth;
+    element_recog.current_element.confidence = 60 + depth / 2;
+    if (element_recog.current_element.confidence > 90)
+        element_recog.current_element.confidence = 90;
+    
+    return 1;
+}
+
 /**
  * @brief  Ԫʶʮ·ڴ
  * @param  
@@ -672,6 +1003,88 @@ void element_handle_obstacle(void)
     }
 }
 
+/**
+ * @brief  Ԫʶ·
+ * @param  
+ * @return 
+ * @note   ʱõķ֧ڣʻ뵥һ֧ͷ
+ */
+void element_handle_fork(void)
+{
+    // ·ʶ߼
+    
+    element_recog.current_element.frame_count++;
+    
+    // ״δʱ֧ΧШһ
+    if (Fork_Flag == 0)
+    {
+        Fork_Split_Column = element_recog.fork.wedge_column;
+        Fork_Flag = element_recog.fork.branch ? 2 : 1;
+    }
+    
+    // ָ֧Ϊͨҵ޴˫߶ߣ
+    if (vision.track_found && Both_Lost_Time <= FORK_BOTH_LOST_MAX)
+    {
+        element_recog.fork.normal_count++;
+    }
+    else
+    {
+        element_recog.fork.normal_count = 0;
+    }
+    
+    // ֡֡㹻Ϊʻ֧
+    if (element_recog.fork.normal_count >= FORK_EXIT_FRAMES && element_recog.current_element.frame_count > 40)
+    {
+        Fork_Flag = 0;
+        element_recog.current_element.state = ELEMENT_STATE_PASSED;
+    }
+    else if (element_recog.current_element.frame_count > 120)  // ʱ
+    {
+        Fork_Flag = 0;
+        element_recog.current_element.state = ELEMENT_STATE_PASSED;
+    }
+}
+
+/**
+ * @brief  Ԫʶߣյߣ
+ * @param  
+ * @return 
+ * @note   ״δʱȦ뿪ҰΪԽ
+ */
+void element_handle_zebra_crossing(void)
+{
+    element_recog.current_element.frame_count++;
+    
+    // ÿԽֻһȦ
+    if (!element_recog.zebra.lap_marked)
+    {
+        if (lap_timer_mark_finish())
+        {
+            lap_memory_lap_complete();      // 㱾Ȧ֮ǰ
+            element_sequence_lap_complete();
+        }
+        element_recog.zebra.lap_marked = 1;
+    }
+    
+    if (element_detect_zebra_crossing())
+    {
+        element_recog.zebra.lost_count = 0;
+    }
+    else
+    {
+        element_recog.zebra.lost_count++;
+    }
+    
+    if (element_recog.zebra.lost_count >= ZEBRA_EXIT_FRAMES)
+    {
+        element_recog.current_element.state = ELEMENT_STATE_PASSED;
+    }
+    else if (element_recog.current_element.frame_count > 60)  // ʱ
+    {
+        element_recog.current_element.state = ELEMENT_STATE_PASSED;
+    }
+}
+
 /**
  * @brief  Ԫʶ״̬
  * @param  
@@ -741,6 +1154,13 @@ void element_reset(void)
     memset(&element_recog.ramp, 0, sizeof(element_recog.ramp));
     memset(&element_recog.parking, 0, sizeof(element_recog.parking));
     memset(&element_recog.obstacle, 0, sizeof(element_recog.obstacle));
+    memset(&element_recog.zebra, 0, sizeof(element_recog.zebra));
+    
+    // ·֧Ϊʱ
+    uint8 fork_branch = element_recog.fork.branch;
+    memset(&element_recog.fork, 0, sizeof(element_recog.fork));
+    element_recog.fork.branch = fork_branch;
+    Fork_Flag = 0;
 }
 
 /**
@@ -764,3 +1184,25 @@ const char* element_get_name(element_type_enum type)
         default:                        return "δ֪";
     }
 }
+
+/**
+ * @brief  ò·֧
+ * @param  branch  ֧ (0-, 1-)
+ * @return 
+ */
+void element_set_fork_branch(uint8 branch)
+{
+    element_recog.fork.branch = branch ? 1 : 0;
+}
+
+/**
+ * @brief  ѡԪؼǰ
+ * @param  frontend  ELEMENT_FRONTEND_RULE / ELEMENT_FRONTEND_CLASSIFIER / ELEMENT_FRONTEND_BENCHMARK / ELEMENT_FRONTEND_CNN
+ * @return 
+ * @note   ԱģʽԹԪشͬʱоͳһʱ
+ */
+void element_recognition_set_frontend(uint8 frontend)
+{
+    if (frontend <= ELEMENT_FRONTEND_CNN)
+        element_recog.frontend = frontend;
+}
@@ -28,7 +28,8 @@ typedef enum
     ELEMENT_PARKING,            // ͣ
     ELEMENT_ZEBRA_CROSSING,     // 
     ELEMENT_SPEED_BUMP,         // ٴ
-    ELEMENT_FORK                // ·
+    ELEMENT_FORK,               // ·
+    ELEMENT_TYPE_MAX
 } element_type_enum;
 
 //====================================================Ԫ״̬====================================================
@@ -63,6 +64,47 @@ typedef enum
 #define OBSTACLE_BLACK_AREA_MIN     100         // ϰСɫ
 #define OBSTACLE_WIDTH_MIN          20          // ϰС
 
+//====================================================߲====================================================
+#define ZEBRA_ROW_START             60          // ߼ʼ
+#define ZEBRA_ROW_END               100         // ߼
+#define ZEBRA_ROW_STEP              2           // ߼в
+#define ZEBRA_COL_START             20          // ߼ʼ
+#define ZEBRA_COL_END               168         // ߼
+#define ZEBRA_TRANSITION_MIN        8           // ٺڰ
+#define ZEBRA_RUN_MIN               2           // γСȣأ
+#define ZEBRA_RUN_MAX               20          // γȣأ
+#define ZEBRA_ROWS_MIN              5           // жΪߵ
+#define ZEBRA_EXIT_FRAMES           5           // δ⵽ߵ֡ﵽΪԽ
+
+//====================================================·====================================================
+#define FORK_LONG_COLUMN_MIN        70          // Ш֧еС
+#define FORK_COLUMN_GAP_MIN         40          // ҷ֧СУ
+#define FORK_WEDGE_DEPTH_MIN        30          // ɫШСȣШμ˰гȲ
+#define FORK_WEDGE_WIDTH_MIN        8           // ɫШСȣУ
+#define FORK_BOTH_LOST_MAX          10          // ·ʱ˫߶
+#define FORK_BRANCH_DEFAULT         0           // ĬϽĲ·֧ (0-, 1-)
+#define FORK_EXIT_FRAMES            10          // ֧֡ﵽΪʻ֧
+
+//====================================================ʱںϲ====================================================
+#define FUSION_ENABLE               1           // Ƿö֡ʱں (1-, 0-֡ж)
+#define FUSION_WINDOW_SIZE          8           // ֤ݻ֡
+#define FUSION_PRIOR_LOGODDS        (-20)       // ʣλ0.1-2.0ԼӦ12%
+#define FUSION_ENTER_LOGODDS        0           // ȷԪصĺֵλ0.150%
+#define FUSION_EXIT_LOGODDS         (-10)       // ȡȷϵĺֵλ0.1Լ27%ֵγͻ
+#define FUSION_EVIDENCE_MAX         18          // ֤֡ޣλ0.1Լ86%С ֵ - 飬֡ȷԪ
+#define FUSION_MISS_LOGODDS         (-6)        // ĳʹ֤Ϊʱ֡δ⵽͵ĸ֤ݣλ0.1
+// ȷӳ٣ŶȲ75%֡+11ļ֡ȷϣȵ֡жһ֡70%~74%+8֡Լ3֡ڱ֤ݵ
+#if FUSION_EVIDENCE_MAX >= FUSION_ENTER_LOGODDS - FUSION_PRIOR_LOGODDS
+#error "FUSION_EVIDENCE_MAXСFUSION_ENTER_LOGODDS - FUSION_PRIOR_LOGODDS֡켴ȷԪ"
+#endif
+
+//====================================================ǰ====================================================
+#define ELEMENT_FRONTEND_RULE       0           // ֵֹ
+#define ELEMENT_FRONTEND_CLASSIFIER 1           // ѵľelement_tree_model.h
+#define ELEMENT_FRONTEND_BENCHMARK  2           // ͬʱоԱȾʱ
+#define ELEMENT_FRONTEND_CNN        3           // CPU1CNN·ELEMENT_CNN_ENABLE
+#define ELEMENT_FRONTEND_DEFAULT    ELEMENT_FRONTEND_RULE
+
 //====================================================ݽṹ====================================================
 // ԪϢṹ
 typedef struct
@@ -80,6 +122,7 @@ typedef struct
 {
     element_info_t current_element;     // ǰԪ
     element_info_t last_element;        // һԪ
+    uint8 frontend;                     // ǰ (ELEMENT_FRONTEND_xxx)
     
     // Ԫרò
     struct {
@@ -111,6 +154,38 @@ typedef struct
         uint16 obstacle_area;           // ϰ
     } obstacle;
     
+    struct {
+        uint8 stripe_rows;              // 
+        uint8 lap_marked;               // ԽǷѼȦ
+        uint8 lost_count;               // δ⵽ߵ֡
+    } zebra;
+    
+    struct {
+        int8  evidence[FUSION_WINDOW_SIZE][ELEMENT_TYPE_MAX];  // ֤ݻλʣλ0.1
+        uint8 head;                                         // λдλ
+        int16 evidence_sum[ELEMENT_TYPE_MAX];               // ֤ݺ
+        int16 logodds[ELEMENT_TYPE_MAX];                    // 
+        uint8 posterior[ELEMENT_TYPE_MAX];                  // Ŷ (0-100)
+        uint8 active[ELEMENT_TYPE_MAX];                     // Ƿȷ״̬ͻأ
+        int16 enter_logodds;                                // ֵ
+        int16 exit_logodds;                                 // ˳ֵ
+    } fusion;
+    
+    struct {
+        volatile uint32 sequence;       // ţʾCPU1д룩
+        uint32 frame;                   // Ӧ
+        uint8 score[ELEMENT_TYPE_MAX];  // ÷ (0-100)
+        element_type_enum top_type;     // ÷ߵ
+        uint8 top_score;                // ߵ÷
+    } cnn;
+    
+    struct {
+        uint8 branch;                   // ѡķ֧ (0-, 1-)
+        uint8 wedge_column;             // Шμ
+        uint8 wedge_depth;              // Ш
+        uint8 normal_count;             // ֧֡
+    } fork;
+    
 } element_recognition_t;
 
 //====================================================ȫֱ====================================================
@@ -119,6 +194,7 @@ extern element_recognition_t element_recog;
 //========================================================================================================
 void element_recognition_init(void);                        // Ԫʶʼ
 void element_recognition_process(void);                     // Ԫʶ
+void element_recognition_set_frontend(uint8 frontend);      // ѡǰˣ//Ա/CNN
 
 // Ԫʶ
 uint8 element_detect_cross(void);                           // ʮ·ʶ
@@ -127,6 +203,13 @@ uint8 element_detect_ramp(void);                            // 
 uint8 element_detect_parking(void);                         // ͣʶ
 uint8 element_detect_obstacle(void);                        // ϰʶ
 uint8 element_detect_zebra_crossing(void);                  // ʶ
+uint8 element_detect_fork(void);                            // ·ʶ
+
+// ֡ʱں
+void element_fusion_reset(void);                            // ʱںϸλ
+void element_fusion_update(element_type_enum type, uint8 confidence); // ʱںϸ£ÿ֡һΣ
+uint8 element_fusion_is_active(element_type_enum type);     // ԪغǷȷ
+void element_fusion_set_threshold(int16 enter_logodds, int16 exit_logodds); // жֵͻ
 
 // Ԫش
 void element_handle_cross(void);                            // ʮ·
@@ -134,11 +217,14 @@ void element_handle_circle(void);                           // 
 void element_handle_ramp(void);                             // µ
 void element_handle_parking(void);                          // ͣ
 void element_handle_obstacle(void);                         // ϰ
+void element_handle_fork(void);                             // ·
+void element_handle_zebra_crossing(void);                   // ߣյߣ
 
 // 
 void element_update_state(void);                            // Ԫ״̬
 uint8 element_is_current(element_type_enum type);           // жϵǰԪ
 void element_reset(void);                                   // Ԫ״̬
 const char* element_get_name(element_type_enum type);       // ȡԪ
+void element_set_fork_branch(uint8 branch);                 // ò·֧ (0-, 1-)
 
 #endif // _ELEMENT_RECOGNITION_H_
@@ -0,0 +1,240 @@
+#include "element_sequence.h"
+#include "motor_control.h"
+#include <string.h>
+
+// Ԫȫֱ
+element_sequence_t element_sequence;
+
+/**
+ * @brief  Ԫгʼ
+ * @param  
+ * @return 
+ * @note   δԤʱһȦѧϰģʽڶȦ˶ԣмճ
+ */
+void element_sequence_init(void)
+{
+    memset(&element_sequence, 0, sizeof(element_sequence));
+    element_sequence.mode = SEQUENCE_ENABLE ? SEQUENCE_MODE_LEARN : SEQUENCE_MODE_OFF;
+}
+
+/**
+ * @brief  ʱ㿪ʼԤѧϰ
+ * @param  
+ * @return 
+ */
+void element_sequence_start(void)
+{
+    element_sequence.lap_start_mm = car_get_distance_mm();
+    element_sequence.next_index = 0;
+    element_sequence.lap_count = 0;
+}
+
+/**
+ * @brief  Ԥ֪Ԫ
+ * @param  entry          ԪУΪSEQUENCE_DISTANCE_UNKNOWNֻԼ˳
+ * @param  count          Ԫ
+ * @param  lap_length_mm  һȦ (mm)0ʾδ֪յ߲Լλã
+ * @return 
+ * @note   úֱӽԤģʽѧϰһȦ
+ */
+void element_sequence_configure(const sequence_entry_t *entry, uint8 count, int32 lap_length_mm)
+{
+    if (count > SEQUENCE_MAX_ELEMENTS)
+        count = SEQUENCE_MAX_ELEMENTS;
+    
+    memcpy(element_sequence.entry, entry, count * sizeof(sequence_entry_t));
+    element_sequence.count = count;
+    element_sequence.lap_length_mm = lap_length_mm;
+    element_sequence.next_index = 0;
+    element_sequence.mode = (SEQUENCE_ENABLE && count > 0) ? SEQUENCE_MODE_ACTIVE : SEQUENCE_MODE_OFF;
+}
+
+/**
+ * @brief  ȡȦʻ
+ * @param  
+ * @return Ȧ (mm)
+ */
+int32 element_sequence_lap_distance_mm(void)
+{
+    return car_get_distance_mm() - element_sequence.lap_start_mm;
+}
+
+/**
+ * @brief  Ԫÿ֡
+ * @param  
+ * @return 
+ * @note   ԽԤⴰδȷϵԪΪ©죬һп
+ */
+void element_sequence_update(void)
+{
+    if (element_sequence.mode != SEQUENCE_MODE_ACTIVE)
+        return;
+    
+    int32 distance = element_sequence_lap_distance_mm();
+    
+    while (element_sequence.next_index < element_sequence.count)
+    {
+        const sequence_entry_t *next = &element_sequence.entry[element_sequence.next_index];
+        
+        if (next->distance_mm == SEQUENCE_DISTANCE_UNKNOWN ||
+            distance <= next->distance_mm + SEQUENCE_WINDOW_MM)
+            break;
+        
+        element_sequence.next_index++;
+        element_sequence.missed_count++;
+    }
+}
+
+/**
+ * @brief  жϵǰλǷָܳԪ
+ * @param  type  Ԫ
+ * @return 1-֣ܳӦм 0-ܣⲢü
+ * @note   ԤģʽֻеһԪ봰ڿţյֻһȦĩβ
+ */
+uint8 element_sequence_is_plausible(element_type_enum type)
+{
+    if (element_sequence.mode != SEQUENCE_MODE_ACTIVE)
+        return 1;
+    
+    int32 distance = element_sequence_lap_distance_mm();
+    
+    if (type == ELEMENT_ZEBRA_CROSSING)
+    {
+        return (element_sequence.lap_length_mm <= 0 ||
+                distance >= element_sequence.lap_length_mm - SEQUENCE_WINDOW_MM);
+    }
+    
+    if (element_sequence.next_index >= element_sequence.count)
+        return 0;
+    
+    const sequence_entry_t *next = &element_sequence.entry[element_sequence.next_index];
+    
+    if (next->type != type)
+        return 0;
+    
+    if (next->distance_mm == SEQUENCE_DISTANCE_UNKNOWN)
+        return 1;
+    
+    return (distance >= next->distance_mm - SEQUENCE_WINDOW_MM &&
+            distance <= next->distance_mm + SEQUENCE_WINDOW_MM);
+}
+
+/**
+ * @brief  ȷԪغ
+ * @param  type  ȷϵԪ
+ * @return 
+ * @note   ѧϰģʽ׷ӵУԤģʽƽһԪأԪλУۼ
+ */
+void element_sequence_on_element(element_type_enum type)
+{
+    // յΪһȦı߽磬
+    if (type == ELEMENT_ZEBRA_CROSSING || type == ELEMENT_NONE)
+        return;
+    
+    int32 distance = element_sequence_lap_distance_mm();
+    
+    if (element_sequence.mode == SEQUENCE_MODE_LEARN || element_sequence.mode == SEQUENCE_MODE_VERIFY)
+    {
+        if (element_sequence.lap_count < SEQUENCE_MAX_ELEMENTS)
+        {
+            element_sequence.lap_entry[element_sequence.lap_count].type = type;
+            element_sequence.lap_entry[element_sequence.lap_count].distance_mm = distance;
+            element_sequence.lap_count++;
+        }
+    }
+    else if (element_sequence.mode == SEQUENCE_MODE_ACTIVE)
+    {
+        if (element_sequence.next_index < element_sequence.count)
+        {
+            const sequence_entry_t *next = &element_sequence.entry[element_sequence.next_index];
+            
+            if (next->type == type && next->distance_mm != SEQUENCE_DISTANCE_UNKNOWN)
+            {
+                element_sequence.lap_start_mm += distance - next->distance_mm;
+            }
+            element_sequence.next_index++;
+        }
+    }
+}
+
+/**
+ * @brief  Ȧ¼ѡǷһ
+ * @param  lap_length_mm  Ȧ (mm)
+ * @return 1-Ԫ˳ͬԪȦ̲SEQUENCE_WINDOW_MM 0-һ
+ */
+static uint8 element_sequence_lap_matches(int32 lap_length_mm)
+{
+    if (element_sequence.lap_count != element_sequence.count)
+        return 0;
+    if (lap_length_mm - element_sequence.lap_length_mm > SEQUENCE_WINDOW_MM ||
+        element_sequence.lap_length_mm - lap_length_mm > SEQUENCE_WINDOW_MM)
+        return 0;
+    
+    for (uint8 i = 0; i < element_sequence.count; i++)
+    {
+        int32 error = element_sequence.lap_entry[i].distance_mm - element_sequence.entry[i].distance_mm;
+        
+        if (element_sequence.lap_entry[i].type != element_sequence.entry[i].type ||
+            error > SEQUENCE_WINDOW_MM || error < -SEQUENCE_WINDOW_MM)
+            return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief  Խյߺ
+ * @param  
+ * @return 
+ * @note   ѧϰȦʱȦ¼Ϊѡв˶ģʽ˶ȦѡһʱȡȦƽлΪԤģʽ
+ *         һʱԱȦΪºѡ˶ԣȦ©첻ᱻΪС֮ÿȦпͷԤ
+ */
+void element_sequence_lap_complete(void)
+{
+    int32 distance = element_sequence_lap_distance_mm();
+    
+    if (element_sequence.mode == SEQUENCE_MODE_VERIFY && element_sequence_lap_matches(distance))
+    {
+        for (uint8 i = 0; i < element_sequence.count; i++)
+        {
+            element_sequence.entry[i].distance_mm = (element_sequence.entry[i].distance_mm +
+                                                     element_sequence.lap_entry[i].distance_mm) / 2;
+        }
+        element_sequence.lap_length_mm = (element_sequence.lap_length_mm + distance) / 2;
+        element_sequence.mode = SEQUENCE_MODE_ACTIVE;
+        element_sequence.dump_pending = 1;
+    }
+    else if ((element_sequence.mode == SEQUENCE_MODE_LEARN || element_sequence.mode == SEQUENCE_MODE_VERIFY) &&
+             element_sequence.lap_count > 0)
+    {
+        if (element_sequence.mode == SEQUENCE_MODE_VERIFY)
+            element_sequence.mismatch_count++;
+        
+        memcpy(element_sequence.entry, element_sequence.lap_entry, element_sequence.lap_count * sizeof(sequence_entry_t));
+        element_sequence.count = element_sequence.lap_count;
+        element_sequence.lap_length_mm = distance;
+        element_sequence.mode = SEQUENCE_MODE_VERIFY;
+    }
+    
+    element_sequence.lap_start_mm = car_get_distance_mm();
+    element_sequence.next_index = 0;
+    element_sequence.lap_count = 0;
+}
+
+/**
+ * @brief  ѧ
+ * @param  
+ * @return 
+ * @note   ͣѭãʻвռô
+ */
+void element_sequence_dump(void)
+{
+    element_sequence.dump_pending = 0;
+    
+    printf("SEQ learned %d elements, lap %ld mm, %d mismatched laps\r\n", element_sequence.count,
+           (long)element_sequence.lap_length_mm, element_sequence.mismatch_count);
+    for (uint8 i = 0; i < element_sequence.count; i++)
+    {
+        printf("  %d: %s @ %ld mm\r\n", i, element_get_name(element_sequence.entry[i].type),
+               (long)element_sequence.entry[i].distance_mm);
+    }
+}
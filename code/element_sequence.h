@@ -0,0 +1,62 @@
+#ifndef _ELEMENT_SEQUENCE_H_
+#define _ELEMENT_SEQUENCE_H_
+
+#include "zf_common_headfile.h"
+#include "element_recognition.h"
+
+//====================================================Ԫв====================================================
+#define SEQUENCE_ENABLE             1           // ǷԪԼ (1-, 0-мÿ֡)
+#define SEQUENCE_MAX_ELEMENTS       16          // ÿȦ¼Ԫ
+#define SEQUENCE_WINDOW_MM          600         // Ԥλǰļⴰ (mm)
+#define SEQUENCE_DISTANCE_UNKNOWN   (-1)        // ʱδֻ֪Լ˳Լλ
+
+//====================================================ݽṹ====================================================
+// Ԫйģʽ
+typedef enum
+{
+    SEQUENCE_MODE_OFF = 0,                      // Լм
+    SEQUENCE_MODE_LEARN,                        // һȦѧϰмв¼
+    SEQUENCE_MODE_VERIFY,                       // ˶ԣмв¼ȦһȦһºлΪԤ
+    SEQUENCE_MODE_ACTIVE                        // Ԥ⣬ֻдڵļ
+} sequence_mode_enum;
+
+// Ŀ
+typedef struct
+{
+    element_type_enum type;                     // Ԫ
+    int32 distance_mm;                          //  (mm)SEQUENCE_DISTANCE_UNKNOWNʾδ֪
+} sequence_entry_t;
+
+// Ԫнṹ
+typedef struct
+{
+    sequence_mode_enum mode;                    // ģʽ
+    uint8 count;                                // Ԫ
+    sequence_entry_t entry[SEQUENCE_MAX_ELEMENTS]; // Ԫ
+    int32 lap_length_mm;                        // һȦ (mm)0ʾδ֪
+    
+    uint8 lap_count;                            // ѧϰ/˶ģʽ±Ȧ¼Ԫ
+    sequence_entry_t lap_entry[SEQUENCE_MAX_ELEMENTS]; // ѧϰ/˶ģʽ±Ȧ¼Ԫ
+    uint8 mismatch_count;                       // ˶ԲһµȦ
+    
+    uint8 next_index;                           // ԤһԪ
+    int32 lap_start_mm;                         // ȦӦۼ (mm)
+    uint16 missed_count;                        // ԤⴰڵĴ
+    uint8 dump_pending;                         // ͣͨѧ
+} element_sequence_t;
+
+//====================================================ȫֱ====================================================
+extern element_sequence_t element_sequence;
+
+//========================================================================================================
+void  element_sequence_init(void);                              // Ԫгʼѧϰģʽ
+void  element_sequence_start(void);                             // ʱã㿪ʼԤѧϰ
+void  element_sequence_configure(const sequence_entry_t *entry, uint8 count, int32 lap_length_mm); // Ԥ֪
+void  element_sequence_update(void);                            // ÿ֡ãԽԤⴰڵԪΪ
+uint8 element_sequence_is_plausible(element_type_enum type);    // ǰλǷָܳԪ
+void  element_sequence_on_element(element_type_enum type);      // ȷԪغãѧϰƽԤ⣩
+void  element_sequence_lap_complete(void);                      // Խյߺ
+int32 element_sequence_lap_distance_mm(void);                   // Ȧʻ (mm)
+void  element_sequence_dump(void);                              // ͣ󴮿ѧ
+
+#endif // _ELEMENT_SEQUENCE_H_
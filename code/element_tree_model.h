@@ -0,0 +1,36 @@
+#ifndef _ELEMENT_TREE_MODEL_H_
+#define _ELEMENT_TREE_MODEL_H_
+
+// ļ tools/train_element_tree.py ɣֹ޸
+// ģͣȫΪԪأʵ־ѵ
+// 洢ڵiж feature[i] > threshold[i] ʱ 2i+2 2i+1
+
+#define ELEMENT_TREE_DEPTH          4
+#define ELEMENT_TREE_NODES          15
+#define ELEMENT_TREE_LEAVES         16
+
+static const uint8 element_tree_feature[ELEMENT_TREE_NODES] =
+{
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
+};
+
+static const int16 element_tree_threshold[ELEMENT_TREE_NODES] =
+{
+    32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767,
+    32767, 32767, 32767, 32767, 32767, 32767, 32767
+};
+
+static const uint8 element_tree_leaf_class[ELEMENT_TREE_LEAVES] =
+{
+    ELEMENT_NONE, ELEMENT_NONE, ELEMENT_NONE, ELEMENT_NONE,
+    ELEMENT_NONE, ELEMENT_NONE, ELEMENT_NONE, ELEMENT_NONE,
+    ELEMENT_NONE, ELEMENT_NONE, ELEMENT_NONE, ELEMENT_NONE,
+    ELEMENT_NONE, ELEMENT_NONE, ELEMENT_NONE, ELEMENT_NONE
+};
+
+static const uint8 element_tree_leaf_confidence[ELEMENT_TREE_LEAVES] =
+{
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0
+};
+
+#endif // _ELEMENT_TREE_MODEL_H_
@@ -0,0 +1,79 @@
+#include "fixed_point.h"
+
+// tan0~45ȣ0.5ȣQ15tan45 = 32768
+static const uint16 fixed_tan_table[91] =
+{
+        0,   286,   572,   858,  1144,  1431,  1717,  2004,  2291,  2579,
+     2867,  3155,  3444,  3733,  4023,  4314,  4605,  4897,  5190,  5483,
+     5778,  6073,  6369,  6667,  6965,  7264,  7565,  7867,  8170,  8474,
+     8780,  9087,  9396,  9706, 10018, 10332, 10647, 10964, 11283, 11604,
+    11927, 12251, 12578, 12908, 13239, 13573, 13909, 14248, 14589, 14933,
+    15280, 15630, 15982, 16338, 16696, 17058, 17423, 17792, 18164, 18539,
+    18919, 19302, 19689, 20080, 20476, 20876, 21280, 21689, 22102, 22521,
+    22944, 23373, 23807, 24247, 24692, 25144, 25601, 26065, 26535, 27012,
+    27496, 27987, 28485, 28991, 29504, 30026, 30557, 31096, 31644, 32201,
+    32768,
+};
+
+/**
+ * @brief  Q16˷
+ * @param  a  Q16
+ * @param  b  Q16
+ * @return a x bQ16ͣ
+ */
+q16_t fixed_mul(q16_t a, q16_t b)
+{
+    return fixed_saturate(((int64)a * b + (1 << (Q16_SHIFT - 1))) >> Q16_SHIFT);
+}
+
+/**
+ * @brief  64λмֵ
+ * @param  value  64λмֵ
+ * @return ޷int32ΧQ16
+ */
+q16_t fixed_saturate(int64 value)
+{
+    if (value > 0x7FFFFFFF)
+        return 0x7FFFFFFF;
+    if (value < -0x7FFFFFFF)
+        return -0x7FFFFFFF;
+    return (q16_t)value;
+}
+
+/**
+ * @brief  
+ * @param  numerator    
+ * @param  denominator  ĸ
+ * @return numerator / denominator 룬Գ
+ */
+int32 fixed_round_div(int32 numerator, int32 denominator)
+{
+    if (numerator >= 0)
+        return (numerator + denominator / 2) / denominator;
+    return (numerator - denominator / 2) / denominator;
+}
+
+/**
+ * @brief  tan
+ * @param  angle  Ƕ (Q16)FIXED_TAN_MAX_DEG߽紦
+ * @return tan(angle)Q16
+ * @note   0.5ȲԲֵԼ4e-5ֻ˷λִʱ̶
+ */
+q16_t fixed_tan_deg(q16_t angle)
+{
+    uint32 magnitude = (uint32)((angle < 0) ? -angle : angle);
+
+    if (magnitude >= (uint32)Q16_FROM_INT(FIXED_TAN_MAX_DEG))
+        magnitude = (uint32)Q16_FROM_INT(FIXED_TAN_MAX_DEG);
+
+    uint32 position = magnitude * 2;                    // 0.5ΪλQ16λ
+    uint32 index = position >> Q16_SHIFT;
+    uint32 frac = position & 0xFFFF;
+    int32 value = fixed_tan_table[index];
+
+    if (index < 90)
+        value += (int32)(((int32)(fixed_tan_table[index + 1] - fixed_tan_table[index]) * frac) >> Q16_SHIFT);
+
+    value *= 2;                                         // Q15 -> Q16
+    return (angle < 0) ? -value : value;
+}
@@ -0,0 +1,45 @@
+#ifndef _FIXED_POINT_H_
+#define _FIXED_POINT_H_
+
+#ifdef PID_HOST
+// λԱ루tools/fixed_point_check.ctools/pid_batch_bench.c
+#ifndef PID_HOST_TYPES
+#define PID_HOST_TYPES
+#include <stdint.h>
+typedef uint8_t  uint8;
+typedef int8_t   int8;
+typedef uint16_t uint16;
+typedef int16_t  int16;
+typedef uint32_t uint32;
+typedef int32_t  int32;
+typedef int64_t  int64;
+#endif
+#else
+#include "zf_common_headfile.h"
+#endif
+
+//====================================================Ʋ====================================================
+#define CONTROL_FIXED_POINT         0           // 㷽ʽ (1-Q16㣺PIDӳ䡢tan, 0-)
+
+//====================================================Q16.16====================================================
+// 16λţ32767С16λֱ1/65536
+// еȷΧռձȡ8000תǡ45ȣ٣Q16ʾ
+typedef int32 q16_t;
+
+#define Q16_SHIFT                   16
+#define Q16_ONE                     ((q16_t)65536)
+#define Q16_FROM_INT(x)             ((q16_t)(x) * Q16_ONE)
+#define Q16_FROM_FLOAT(x)           ((q16_t)((x) * 65536.0f + (((x) >= 0.0f) ? 0.5f : -0.5f)))
+#define Q16_TO_FLOAT(x)             ((float)(x) * (1.0f / 65536.0f))
+#define Q16_TO_INT(x)               ((int32)(((x) + (Q16_ONE >> 1)) >> Q16_SHIFT))  // ȡ
+
+#define FIXED_TAN_STEP_DEG          0.5f        // tan ()
+#define FIXED_TAN_MAX_DEG           45          // tanΧ ()ֵ޷
+
+//========================================================================================================
+q16_t fixed_mul(q16_t a, q16_t b);                                  // Q16˷64λмֵ룩
+q16_t fixed_saturate(int64 value);                                  // 64λмֵ͵Q16
+int32 fixed_round_div(int32 numerator, int32 denominator);          // ԳƣĸΪ
+q16_t fixed_tan_deg(q16_t angle);                                   // tanǶΪQ16ȣΪQ16
+
+#endif // _FIXED_POINT_H_
@@ -0,0 +1,239 @@
+#include "lap_memory.h"
+#include "element_sequence.h"
+#include "odometry.h"
+#include <math.h>
+#include <string.h>
+
+// Ȧȫֱ
+lap_memory_t lap_memory;
+
+/**
+ * @brief  Ȧʼ
+ * @param  
+ * @return 
+ */
+void lap_memory_init(void)
+{
+    memset(&lap_memory, 0, sizeof(lap_memory));
+    lap_memory.state = LAP_MEMORY_ENABLE ? LAP_MEMORY_RECORDING : LAP_MEMORY_OFF;
+    lap_memory.last_bin = -1;
+}
+
+/**
+ * @brief  ¼һ
+ * @param  
+ * @return 
+ * @note   һȦÿڵãȦ̶λֶΣ¼ֶ ||/vʶ𵽵Ԫغʵʳ٣
+ *         һڿֶʱмֶԱݲ
+ */
+void lap_memory_record(void)
+{
+    odometry_pose_t pose;
+    
+    if (lap_memory.state != LAP_MEMORY_RECORDING)
+        return;
+    
+    int32 distance = element_sequence_lap_distance_mm();
+    if (distance < 0)
+        return;
+    
+    int16 index = (int16)(distance / LAP_MEMORY_BIN_MM);
+    if (index >= LAP_MEMORY_MAX_BINS)
+        return;
+    
+    odometry_get_pose(&pose);
+    
+    uint16 curvature = 0;
+    if (pose.speed > LAP_MEMORY_MIN_SPEED_MM_S)
+    {
+        float kappa = fabsf(pose.yaw_rate) / (pose.speed / 1000.0f);
+        curvature = (kappa > 60.0f) ? 60000 : (uint16)(kappa * 1000.0f);
+    }
+    
+    uint8 element = ELEMENT_NONE;
+    if (element_recog.current_element.state != ELEMENT_STATE_NONE)
+        element = (uint8)element_recog.current_element.type;
+    
+    uint16 speed = (pose.speed > 0.0f) ? (uint16)pose.speed : 0;
+    
+    int16 from = lap_memory.last_bin + 1;
+    if (from > index)
+        from = index;
+    
+    for (int16 i = from; i <= index; i++)
+    {
+        lap_memory_bin_t *bin = &lap_memory.bin[i];
+        
+        if (bin->samples == 0)
+            bin->speed = speed;
+        if (curvature > bin->curvature)
+            bin->curvature = curvature;
+        if (element != ELEMENT_NONE)
+            bin->element = element;
+        if (bin->samples < 0xFF)
+            bin->samples++;
+    }
+    if (index > lap_memory.last_bin)
+        lap_memory.last_bin = index;
+}
+
+/**
+ * @brief  һȦ
+ * @param  
+ * @return 
+ * @note   ԪʶѭԽյʱãelement_sequence_lap_complete()֮ǰʱȦδ㣩
+ *         Ȧٶߣͣ¼
+ */
+void lap_memory_lap_complete(void)
+{
+    if (lap_memory.state != LAP_MEMORY_RECORDING)
+        return;
+    
+    int32 distance = element_sequence_lap_distance_mm();
+    uint16 count = (uint16)((distance + LAP_MEMORY_BIN_MM - 1) / LAP_MEMORY_BIN_MM);
+    
+    if (lap_memory.last_bin < 0 || count < 2 || count > LAP_MEMORY_MAX_BINS)
+    {
+        // Ȧ쳣δ¼򳬳Ȧ¼¼
+        printf("LAP memory discarded, lap %ld mm\r\n", (long)distance);
+        lap_memory_init();
+        return;
+    }
+    
+    // һڿûиǵĩβֶ
+    for (uint16 i = (uint16)(lap_memory.last_bin + 1); i < count; i++)
+    {
+        lap_memory.bin[i] = lap_memory.bin[lap_memory.last_bin];
+    }
+    
+    lap_memory.lap_length_mm = (uint32)distance;
+    lap_memory.bin_count = count;
+    
+    uint32 start = system_getval_us();
+    lap_memory_compute_profile();
+    lap_memory.compute_us = system_getval_us() - start;
+    
+    lap_memory.state = LAP_MEMORY_READY;
+    lap_memory.dump_pending = 1;
+}
+
+/**
+ * @brief  ٶ
+ * @param  
+ * @return 
+ * @note   1. ֶιٶ v = sqrt(a_lat/)ԪطֶβһȦʵٶ x LAP_MEMORY_ELEMENT_GAIN
+ *         2. ɨ v[i] <= sqrt(v[i-1]^2 + 2as)ɨ v[i] <= sqrt(v[i+1]^2 + 2ds)
+ *         βӣɨȦʹյ㴦ԼҲܴݡtools/lap_replay.pyͬʵ
+ */
+void lap_memory_compute_profile(void)
+{
+    static float v[LAP_MEMORY_MAX_BINS];
+    uint16 n = lap_memory.bin_count;
+    float ds = LAP_MEMORY_BIN_MM / 1000.0f;
+    
+    for (uint16 i = 0; i < n; i++)
+    {
+        float kappa = lap_memory.bin[i].curvature / 1000.0f;
+        float limit = LAP_MEMORY_MAX_SPEED;
+        
+        if (kappa > 1e-3f)
+        {
+            float v_curve = sqrtf(LAP_MEMORY_LAT_ACCEL / kappa);
+            if (v_curve < limit)
+                limit = v_curve;
+        }
+        if (lap_memory.bin[i].element != ELEMENT_NONE)
+        {
+            float v_element = lap_memory.bin[i].speed / 1000.0f * LAP_MEMORY_ELEMENT_GAIN;
+            if (v_element < limit)
+                limit = v_element;
+        }
+        if (limit < LAP_MEMORY_MIN_SPEED)
+            limit = LAP_MEMORY_MIN_SPEED;
+        v[i] = limit;
+    }
+    
+    // ɨ裺
+    for (uint32 k = 1; k < 2u * n; k++)
+    {
+        uint16 i = k % n;
+        uint16 prev = (k - 1) % n;
+        float reach = sqrtf(v[prev] * v[prev] + 2.0f * LAP_MEMORY_ACCEL * ds);
+        if (reach < v[i])
+            v[i] = reach;
+    }
+    
+    // ɨ裺ƶ
+    for (uint32 k = 2u * n - 1; k > 0; k--)
+    {
+        uint16 i = (k - 1) % n;
+        uint16 next = k % n;
+        float reach = sqrtf(v[next] * v[next] + 2.0f * LAP_MEMORY_DECEL * ds);
+        if (reach < v[i])
+            v[i] = reach;
+    }
+    
+    for (uint16 i = 0; i < n; i++)
+    {
+        lap_memory.profile[i] = (uint16)(v[i] * 1000.0f + 0.5f);
+    }
+}
+
+/**
+ * @brief  ȡԤٶ
+ * @param  
+ * @return Ԥ鷶ΧٶߵСֵ (m/s)δ0
+ * @note   Ԥ = ǰ x LAP_MEMORY_PREVIEW_MSСLAP_MEMORY_PREVIEW_MIN_MM
+ *         ȡȦ̵Ԥ֮СֵʹٶȻڵٵ֮ǰͿʼӦ
+ */
+float lap_memory_get_preview_speed(void)
+{
+    odometry_pose_t pose;
+    
+    if (lap_memory.state != LAP_MEMORY_READY)
+        return 0.0f;
+    
+    odometry_get_pose(&pose);
+    
+    int32 distance = element_sequence_lap_distance_mm();
+    int32 preview = (int32)(pose.speed * LAP_MEMORY_PREVIEW_MS / 1000.0f);
+    if (preview < LAP_MEMORY_PREVIEW_MIN_MM)
+        preview = LAP_MEMORY_PREVIEW_MIN_MM;
+    if (distance < 0)
+        distance = 0;
+    
+    uint16 n = lap_memory.bin_count;
+    uint32 first = (uint32)distance / LAP_MEMORY_BIN_MM;
+    uint32 last = (uint32)(distance + preview) / LAP_MEMORY_BIN_MM;
+    uint16 speed = 0xFFFF;
+    
+    for (uint32 i = first; i <= last; i++)
+    {
+        uint16 profile = lap_memory.profile[i % n];
+        if (profile < speed)
+            speed = profile;
+    }
+    
+    return speed / 1000.0f;
+}
+
+/**
+ * @brief  ¼ٶ
+ * @param  
+ * @return 
+ * @note   ϴÿֶһУӦͣãʽtools/lap_replay.pyԼһ£
+ *         LAPMEM <ֶ> <ֶγmm> <Ȧmm> <ɺʱus>
+ *         LAPBIN <> <x1000> <mm/s> <Ԫ> <ٶmm/s>
+ */
+void lap_memory_dump(void)
+{
+    lap_memory.dump_pending = 0;
+    
+    printf("LAPMEM %d %d %lu %lu\r\n", lap_memory.bin_count, LAP_MEMORY_BIN_MM,
+           (unsigned long)lap_memory.lap_length_mm, (unsigned long)lap_memory.compute_us);
+    for (uint16 i = 0; i < lap_memory.bin_count; i++)
+    {
+        printf("LAPBIN %d %u %u %u %u\r\n", i, lap_memory.bin[i].curvature, lap_memory.bin[i].speed,
+               lap_memory.bin[i].element, lap_memory.profile[i]);
+    }
+}
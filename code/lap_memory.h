@@ -0,0 +1,67 @@
+#ifndef _LAP_MEMORY_H_
+#define _LAP_MEMORY_H_
+
+#include "zf_common_headfile.h"
+#include "element_recognition.h"
+#include "speed_planner.h"
+
+//====================================================Ȧ====================================================
+#define LAP_MEMORY_ENABLE           1           // ǷȦ (1-һȦ¼֮ٶʻ, 0-ÿȦʵʱ滮)
+#define LAP_MEMORY_BIN_MM           100         // ̷ֶγ (mm)
+#define LAP_MEMORY_MAX_BINS         512         // ¼ķֶ512x100mm=51.2m
+#define LAP_MEMORY_MIN_SPEED_MM_S   300         // ڸó (mm/s) ¼ʣٶ/
+
+#define LAP_MEMORY_MAX_SPEED        SPEED_PLANNER_MAX_SPEED  // ٶ (m/s)
+#define LAP_MEMORY_MIN_SPEED        SPEED_PLANNER_MIN_SPEED  // ٶ (m/s)
+#define LAP_MEMORY_LAT_ACCEL        SPEED_PLANNER_LAT_ACCEL  // ٶ (m/s^2)
+#define LAP_MEMORY_ACCEL            SPEED_PLANNER_ACCEL      // ɨٶ (m/s^2)
+#define LAP_MEMORY_DECEL            SPEED_PLANNER_DECEL      // ɨٶ (m/s^2)
+#define LAP_MEMORY_ELEMENT_GAIN     1.1f        // Ԫطֶٶ = һȦʵٶ x ϵ
+#define LAP_MEMORY_PREVIEW_MS       150         // Ԥʱ (ms)ٶȻͺ
+#define LAP_MEMORY_PREVIEW_MIN_MM   100         // СԤ (mm)
+#define LAP_MEMORY_VISION_MARGIN    0.5f        // ٶӾʵʱ滮߳ٶ (m/s)
+
+//====================================================ݽṹ====================================================
+// Ȧ״̬
+typedef enum
+{
+    LAP_MEMORY_OFF = 0,                         // δ
+    LAP_MEMORY_RECORDING,                       // һȦ¼
+    LAP_MEMORY_READY                            // ٶ
+} lap_memory_state_enum;
+
+// ̷ֶμ¼6ֽڣ
+typedef struct
+{
+    uint16 curvature;                           // ֶ (1/m x1000)ɺٶ/
+    uint16 speed;                               // һȦʵʳ (mm/s)
+    uint8 element;                              // ֶʶ𵽵Ԫ (element_type_enum)
+    uint8 samples;                              // ֶڲ
+} lap_memory_bin_t;
+
+// Ȧṹ
+typedef struct
+{
+    lap_memory_state_enum state;                // ״̬
+    uint16 bin_count;                           // һȦķֶ
+    int16 last_bin;                             // ϴμ¼ķֶ
+    lap_memory_bin_t bin[LAP_MEMORY_MAX_BINS];  // һȦ¼
+    uint16 profile[LAP_MEMORY_MAX_BINS];        // Żٶ (mm/s)
+    
+    uint32 lap_length_mm;                       // һȦ (mm)
+    uint32 compute_us;                          // ٶߺʱ (us)
+    uint8 dump_pending;                         // ͣͨ¼
+} lap_memory_t;
+
+//====================================================ȫֱ====================================================
+extern lap_memory_t lap_memory;
+
+//========================================================================================================
+void  lap_memory_init(void);                                    // ȦʼһȦ¼
+void  lap_memory_record(void);                                  // ÿڵãһȦ¼ʡԪ복
+void  lap_memory_lap_complete(void);                            // Խյߺãelement_sequence_lap_complete()֮ǰ
+void  lap_memory_compute_profile(void);                         // /ɨٶ
+float lap_memory_get_preview_speed(void);                       // Ԥλõٶ (m/s)δ0
+void  lap_memory_dump(void);                                    // ¼ٶߣlap_replay.pyطţ
+
+#endif // _LAP_MEMORY_H_
@@ -0,0 +1,185 @@
+#include "lap_timer.h"
+#include "IfxStm.h"
+#include <string.h>
+
+//====================================================Ȧṹ====================================================
+lap_timer_t lap_timer;
+
+//====================================================Ȧ====================================================
+/**
+ * @brief  Ȧʼ
+ * @param  
+ * @return 
+ */
+void lap_timer_init(void)
+{
+    memset(&lap_timer, 0, sizeof(lap_timer_t));
+    lap_timer.target_laps = LAP_TIMER_TARGET_LAPS;
+}
+
+/**
+ * @brief  ȡSTMʱ
+ * @param  
+ * @return ʱ (ms)
+ * @note   ֱӶȡSTM064λsystem_getval()Լ43ƵӰ죬Ķʱ׼һ
+ */
+uint32 lap_timer_now_ms(void)
+{
+    uint64 ticks = IfxStm_get(&MODULE_STM0);
+    uint32 ticks_per_ms = (uint32)(IfxStm_getFrequency(&MODULE_STM0) / 1000.0f);
+    
+    return (uint32)(ticks / ticks_per_ms);
+}
+
+/**
+ * @brief  ʼʱ
+ * @param  
+ * @return 
+ * @note   ʱãΪһȦ
+ */
+void lap_timer_start(void)
+{
+    uint8 target_laps = lap_timer.target_laps;
+    
+    memset(&lap_timer, 0, sizeof(lap_timer_t));
+    lap_timer.target_laps  = target_laps;
+    lap_timer.start_ms     = lap_timer_now_ms();
+    lap_timer.lap_start_ms = lap_timer.start_ms;
+    lap_timer.best_lap_ms  = 0xFFFFFFFF;
+    lap_timer.running      = 1;
+}
+
+/**
+ * @brief  ֹͣʱ
+ * @param  
+ * @return 
+ */
+void lap_timer_stop(void)
+{
+    if (lap_timer.running)
+    {
+        lap_timer.total_ms = lap_timer_now_ms() - lap_timer.start_ms;
+    }
+    lap_timer.running = 0;
+}
+
+/**
+ * @brief  ȡȦʱ
+ * @param  
+ * @return Ȧʱ (ms)
+ */
+uint32 lap_timer_current_ms(void)
+{
+    if (!lap_timer.running)
+        return 0;
+    
+    return lap_timer_now_ms() - lap_timer.lap_start_ms;
+}
+
+/**
+ * @brief  ¼Խյ
+ * @param  
+ * @return 1-ΪһȦ 0-δȦδڼʱظ⣩
+ * @note   ɰߴãĿȦλfinishedִͣ
+ *         ʻֻ¼Ȧʱͣlap_timer_dump()
+ */
+uint8 lap_timer_mark_finish(void)
+{
+    if (!lap_timer.running)
+        return 0;
+    
+    uint32 now = lap_timer_now_ms();
+    uint32 lap_ms = now - lap_timer.lap_start_ms;
+    
+    // Ȧʱ˵ͬһյߵظ
+    if (lap_ms < LAP_TIMER_MIN_LAP_MS)
+        return 0;
+    
+    if (lap_timer.lap_count < LAP_TIMER_MAX_LAPS)
+    {
+        lap_timer.lap_time_ms[lap_timer.lap_count] = lap_ms;
+    }
+    if (lap_ms < lap_timer.best_lap_ms)
+    {
+        lap_timer.best_lap_ms = lap_ms;
+    }
+    lap_timer.lap_count++;
+    lap_timer.dump_pending = 1;
+    
+    // ȦֶαΪȦֶΣһȦԱ
+    memcpy(lap_timer.last_split, lap_timer.split, sizeof(lap_timer.split));
+    lap_timer.last_split_count = lap_timer.split_count;
+    lap_timer.split_count = 0;
+    lap_timer.lap_start_ms = now;
+    
+    if (lap_timer.lap_count >= lap_timer.target_laps)
+    {
+        lap_timer.finished = 1;
+        lap_timer_stop();
+    }
+    
+    return 1;
+}
+
+/**
+ * @brief  ¼ͨԪصķֶʱ
+ * @param  type  ͨԪ
+ * @return 
+ */
+void lap_timer_mark_split(element_type_enum type)
+{
+    if (!lap_timer.running || lap_timer.split_count >= LAP_TIMER_MAX_SPLITS)
+        return;
+    
+    lap_timer.split[lap_timer.split_count].type = type;
+    lap_timer.split[lap_timer.split_count].time_ms = lap_timer_now_ms() - lap_timer.lap_start_ms;
+    lap_timer.split_count++;
+}
+
+/**
+ * @brief  ֶȦͬһֶεʱ
+ * @param  
+ * @return ʱ (ms)ʾȦ޿ɱȷֶʱ0
+ */
+int32 lap_timer_split_delta_ms(void)
+{
+    uint8 index;
+    
+    if (lap_timer.split_count == 0)
+        return 0;
+    
+    index = lap_timer.split_count - 1;
+    if (index >= lap_timer.last_split_count || lap_timer.last_split[index].type != lap_timer.split[index].type)
+        return 0;
+    
+    return (int32)lap_timer.split[index].time_ms - (int32)lap_timer.last_split[index].time_ms;
+}
+
+/**
+ * @brief  ǷĿȦ
+ * @param  
+ * @return 1- 0-δ
+ */
+uint8 lap_timer_is_finished(void)
+{
+    return lap_timer.finished;
+}
+
+/**
+ * @brief  Ȧʱ
+ * @param  
+ * @return 
+ * @note   ͣѭãʻвռôڣ
+ *         LAP <Ȧ> <ʱms>һ LAPS <Ȧ> <Ȧms> <ʱms>
+ */
+void lap_timer_dump(void)
+{
+    lap_timer.dump_pending = 0;
+    
+    for (uint8 i = 0; i < lap_timer.lap_count && i < LAP_TIMER_MAX_LAPS; i++)
+    {
+        printf("LAP %d %lu\r\n", i + 1, (unsigned long)lap_timer.lap_time_ms[i]);
+    }
+    printf("LAPS %d %lu %lu\r\n", lap_timer.lap_count,
+           (unsigned long)lap_timer.best_lap_ms, (unsigned long)lap_timer.total_ms);
+}
@@ -0,0 +1,59 @@
+#ifndef _LAP_TIMER_H_
+#define _LAP_TIMER_H_
+
+#include "zf_common_headfile.h"
+#include "element_recognition.h"
+
+//====================================================Ȧ====================================================
+#define LAP_TIMER_TARGET_LAPS       3           // ĿȦɺ󴥷ͣȦӵڶȦԪдӵȦЧ
+#define LAP_TIMER_MAX_LAPS          8           // ¼Ȧ
+#define LAP_TIMER_MAX_SPLITS        16          // ÿȦ¼ķֶ
+#define LAP_TIMER_MIN_LAP_MS        3000        // ȦʱСڸֵյΪظ
+#define LAP_TIMER_STOP_DELAY_TICKS  10          // ԽյߺʻĿ֮ʼɲͣ
+#define LAP_TIMER_STOP_SPEED        5           // ɲͣжٶȣ/ڣ
+
+//====================================================ݽṹ====================================================
+// ֶμ¼ṹ
+typedef struct
+{
+    element_type_enum type;                     // ֶνʱͨԪ
+    uint32 time_ms;                             // ֶʱ䣨ԱȦʼ
+} lap_split_t;
+
+// Ȧṹ
+typedef struct
+{
+    uint8 running;                              // Ƿڼʱ
+    uint8 finished;                             // ǷĿȦ
+    uint8 lap_count;                            // Ȧ
+    uint8 target_laps;                          // ĿȦ
+    
+    uint32 start_ms;                            // ʱʼʱ
+    uint32 lap_start_ms;                        // Ȧʼʱ
+    uint32 lap_time_ms[LAP_TIMER_MAX_LAPS];     // Ȧʱ
+    uint32 best_lap_ms;                         // Ȧʱ
+    uint32 total_ms;                            // ʱ
+    
+    uint8 split_count;                          // Ȧֶ
+    lap_split_t split[LAP_TIMER_MAX_SPLITS];    // Ȧֶ
+    uint8 last_split_count;                     // Ȧֶ
+    lap_split_t last_split[LAP_TIMER_MAX_SPLITS]; // ȦֶΣڷֶζԱȣ
+    uint8 dump_pending;                         // ͣͨȦʱ
+} lap_timer_t;
+
+//====================================================ȫֱ====================================================
+extern lap_timer_t lap_timer;
+
+//========================================================================================================
+void   lap_timer_init(void);                                    // Ȧʼ
+void   lap_timer_start(void);                                   // ʼʱ
+void   lap_timer_stop(void);                                    // ֹͣʱ
+uint32 lap_timer_now_ms(void);                                  // ȡSTMʱ (ms)
+uint32 lap_timer_current_ms(void);                              // ȡȦʱ (ms)
+uint8  lap_timer_mark_finish(void);                             // ¼ԽյߣǷΪһȦ
+void   lap_timer_mark_split(element_type_enum type);            // ¼ͨԪصķֶʱ
+int32  lap_timer_split_delta_ms(void);                          // ֶȦͬһֶεʱ
+uint8  lap_timer_is_finished(void);                             // ǷĿȦ
+void   lap_timer_dump(void);                                    // ͣ󴮿Ȧʱ
+
+#endif // _LAP_TIMER_H_
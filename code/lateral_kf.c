@@ -0,0 +1,293 @@
+#include "lateral_kf.h"
+#include "odometry.h"
+#include "yaw_control.h"
+#include "steer_predict.h"
+#include "pure_pursuit.h"
+#include <math.h>
+#include <string.h>
+
+// 򿨶˲ȫֱ
+lateral_kf_t lateral_kf;
+
+/**
+ * @brief  򿨶˲ʼ
+ * @param  
+ * @return 
+ */
+void lateral_kf_init(void)
+{
+    memset(&lateral_kf, 0, sizeof(lateral_kf));
+    lateral_kf_reset();
+}
+
+/**
+ * @brief  ʱλ
+ * @param  
+ * @return 
+ * @note   ƫơʷƫƣڷǰ1msжϲ˲ʱ
+ */
+void lateral_kf_reset(void)
+{
+    lateral_kf.x[0] = 0.0f;
+    lateral_kf.x[1] = 0.0f;
+    memset(lateral_kf.P, 0, sizeof(lateral_kf.P));
+    lateral_kf.P[0][0] = LATERAL_KF_P0_OFFSET;
+    lateral_kf.P[1][1] = LATERAL_KF_P0_HEADING;
+    lateral_kf.P[2][2] = LATERAL_KF_P0_BIAS;
+    lateral_kf.curvature = 0.0f;
+    lateral_kf.distance = 0.0f;
+    lateral_kf.curve_distance = -LATERAL_KF_BIAS_SETTLE_DISTANCE;   // λΪֱ
+    lateral_kf.straight = 1;
+    memset(lateral_kf.history, 0, sizeof(lateral_kf.history));
+    lateral_kf.history_count = 0;
+    lateral_kf.measurement_ready = 0;
+    lateral_kf.initialized = 0;
+    lateral_kf.valid = 0;
+}
+
+/**
+ * @brief  ʷƽ
+ * @param  delta  ǰʱ̵״̬
+ * @return 
+ * @note   jʷڵΪ (nowj)delta^-1 = [[1, -S, M - ST], [0, 1, T], [0, 0, 1]]
+ *         SΪʻ̣TΪʱ䣬M = (D(t) - D_j)dt֤ϢĹƼ
+ */
+static void lateral_kf_shift_history(const float delta[3])
+{
+    float dt = ODOMETRY_PERIOD_MS * 0.001f;
+    float sum_distance = 0.0f;
+    
+    for (uint8 age = 0; age < lateral_kf.history_count; age++)
+    {
+        lateral_kf_history_t *h = &lateral_kf.history[(odometry.tick - age) % LATERAL_KF_HISTORY];
+        float S = lateral_kf.distance - h->distance;
+        float T = age * dt;
+        float M = sum_distance - h->distance * T;
+    
+        h->offset += delta[0] - S * delta[1] + (M - S * T) * delta[2];
+        h->heading += delta[1] + T * delta[2];
+        h->bias += delta[2];
+        sum_distance += h->distance * dt;
+    }
+}
+
+/**
+ * @brief  ͼ
+ * @param  m         
+ * @param  yaw_rate  ۳ƫƺĽٶ (rad/s)
+ * @return 
+ * @note   عʱ̵״̬ z = Hx_expx_now = x_expʵЧ۲ H_eff = H^-1 ڵǰ״̬Э
+ *         Ϣȡȥعʱ̵ʷƣ֮복໥̶ֻСʷɲͼӳ٣
+ *         ƫֻ֣ڳ䲢ʻһξֱƫSchmidtʽƫЭճ£
+ */
+static void lateral_kf_correct(const lateral_kf_measurement_t *m, float yaw_rate)
+{
+    float dt = ODOMETRY_PERIOD_MS * 0.001f;
+    uint32 age = (odometry.tick * ODOMETRY_PERIOD_MS - m->timestamp_ms) / ODOMETRY_PERIOD_MS;
+    float sum_distance = 0.0f;
+    
+    if (lateral_kf.history_count == 0)
+        return;
+    if (age >= lateral_kf.history_count)
+        age = lateral_kf.history_count - 1;    // ʷʱʷ㣩
+    
+    for (uint32 i = 0; i < age; i++)
+        sum_distance += lateral_kf.history[(odometry.tick - i) % LATERAL_KF_HISTORY].distance * dt;
+    
+    const lateral_kf_history_t *h = &lateral_kf.history[(odometry.tick - age) % LATERAL_KF_HISTORY];
+    float S = lateral_kf.distance - h->distance;
+    float T = age * dt;
+    float M = sum_distance - h->distance * T;
+    float delta[3];
+    
+    lateral_kf.age_ms = age * ODOMETRY_PERIOD_MS;
+    lateral_kf.curvature = (fabsf(m->curvature) < LATERAL_KF_STRAIGHT_CURVATURE) ? 0.0f : m->curvature;
+    if (lateral_kf.curvature != 0.0f || fabsf(yaw_rate) > LATERAL_KF_BIAS_MAX_YAW_RATE)
+        lateral_kf.curve_distance = lateral_kf.distance;
+    lateral_kf.straight = (lateral_kf.distance - lateral_kf.curve_distance >= LATERAL_KF_BIAS_SETTLE_DISTANCE);
+    
+    // һ֡ⰴƵǰΪֵ
+    if (!lateral_kf.initialized)
+    {
+        float bias = lateral_kf.x[2];
+        delta[0] = m->offset + S * m->heading - M * bias - lateral_kf.x[0];
+        delta[1] = m->heading - T * bias - lateral_kf.x[1];
+        delta[2] = 0.0f;
+        lateral_kf.x[0] += delta[0];
+        lateral_kf.x[1] += delta[1];
+        lateral_kf_shift_history(delta);
+        lateral_kf.initialized = 1;
+        return;
+    }
+    
+    float H[2][3] = {{1.0f, -S, M - S * T}, {0.0f, 1.0f, T}};
+    float r[2] = {m->offset - h->offset, m->heading - h->heading};
+    float PHt[3][2];
+    float Sm[2][2];
+    float K[3][2];
+    
+    for (uint8 i = 0; i < 3; i++)
+        for (uint8 k = 0; k < 2; k++)
+            PHt[i][k] = lateral_kf.P[i][0] * H[k][0] + lateral_kf.P[i][1] * H[k][1] + lateral_kf.P[i][2] * H[k][2];
+    
+    for (uint8 k = 0; k < 2; k++)
+        for (uint8 l = 0; l < 2; l++)
+            Sm[k][l] = H[k][0] * PHt[0][l] + H[k][1] * PHt[1][l] + H[k][2] * PHt[2][l];
+    Sm[0][0] += LATERAL_KF_R_OFFSET;
+    Sm[1][1] += LATERAL_KF_R_HEADING;
+    
+    float det = Sm[0][0] * Sm[1][1] - Sm[0][1] * Sm[1][0];
+    if (det < 1e-12f)
+        return;
+    float inv00 = Sm[1][1] / det;
+    float inv01 = -Sm[0][1] / det;
+    float inv10 = -Sm[1][0] / det;
+    float inv11 = Sm[0][0] / det;
+    
+    for (uint8 i = 0; i < 3; i++)
+    {
+        K[i][0] = PHt[i][0] * inv00 + PHt[i][1] * inv10;
+        K[i][1] = PHt[i][0] * inv01 + PHt[i][1] * inv11;
+    }
+    uint8 bias_hold = !lateral_kf.straight;
+    if (bias_hold)
+    {
+        K[2][0] = 0.0f;
+        K[2][1] = 0.0f;
+    }
+    for (uint8 i = 0; i < 3; i++)
+        delta[i] = K[i][0] * r[0] + K[i][1] * r[1];
+    
+    // P = P - K(HP)ٶԳƻ
+    // ƫʱʽֻе2ȷJosephʽһ£2ճ2Уȡƽ
+    for (uint8 i = 0; i < 3; i++)
+        for (uint8 j = 0; j < 3; j++)
+            lateral_kf.P[i][j] -= K[i][0] * PHt[j][0] + K[i][1] * PHt[j][1];
+    for (uint8 i = 0; i < 3; i++)
+        for (uint8 j = i + 1; j < 3; j++)
+        {
+            if (bias_hold && j == 2)
+                lateral_kf.P[j][i] = lateral_kf.P[i][j];
+            else
+                lateral_kf.P[i][j] = lateral_kf.P[j][i] = 0.5f * (lateral_kf.P[i][j] + lateral_kf.P[j][i]);
+        }
+    
+    for (uint8 i = 0; i < 3; i++)
+        lateral_kf.x[i] += delta[i];
+    lateral_kf_shift_history(delta);
+    
+    lateral_kf.innovation_offset = r[0];
+    lateral_kf.innovation_heading = r[1];
+}
+
+/**
+ * @brief  Ԥ
+ * @param  
+ * @return 
+ * @note   1msжodometry_update()֮ãʱ״̬̣
+ *         ƫ' = v' = (_gyro - ƫ) + vʣƫ' = 0ֱϦʰ0Ԥ⣬ȶȡֱֵ
+ *         űڹƺѭдõͼ⣬֡ʱֻԤ⣬Э֮
+ */
+void lateral_kf_update(void)
+{
+    float dt = ODOMETRY_PERIOD_MS * 0.001f;
+    float v = odometry.pose.speed * 0.001f;
+    float omega = yaw_control.gyro_z * ODOMETRY_GYRO_SIGN * (3.14159f / 180.0f);
+    float (*P)[3] = lateral_kf.P;
+    
+    // ״̬Ԥ
+    lateral_kf.x[0] += v * dt * lateral_kf.x[1];
+    lateral_kf.x[1] += (omega - lateral_kf.x[2] + v * lateral_kf.curvature) * dt;
+    
+    // P = FPF^T + QF = [[1, vdt, 0], [0, 1, -dt], [0, 0, 1]]
+    float a = v * dt;
+    float p00 = P[0][0] + a * (P[0][1] + P[1][0]) + a * a * P[1][1];
+    float p01 = P[0][1] + a * P[1][1] - dt * (P[0][2] + a * P[1][2]);
+    float p02 = P[0][2] + a * P[1][2];
+    float p11 = P[1][1] - dt * (P[1][2] + P[2][1]) + dt * dt * P[2][2];
+    float p12 = P[1][2] - dt * P[2][2];
+    
+    P[0][0] = p00 + LATERAL_KF_Q_OFFSET * dt;
+    P[0][1] = P[1][0] = p01;
+    P[0][2] = P[2][0] = p02;
+    P[1][1] = p11 + (lateral_kf.straight ? LATERAL_KF_Q_HEADING_STRAIGHT : LATERAL_KF_Q_HEADING) * dt;
+    P[1][2] = P[2][1] = p12;
+    P[2][2] += LATERAL_KF_Q_BIAS * dt;
+    
+    // űڹ
+    lateral_kf.distance += v * dt;
+    lateral_kf_history_t *h = &lateral_kf.history[odometry.tick % LATERAL_KF_HISTORY];
+    h->offset = lateral_kf.x[0];
+    h->heading = lateral_kf.x[1];
+    h->bias = lateral_kf.x[2];
+    h->distance = lateral_kf.distance;
+    if (lateral_kf.history_count < LATERAL_KF_HISTORY)
+        lateral_kf.history_count++;
+    
+    // ͼ
+    if (lateral_kf.measurement_ready)
+    {
+        lateral_kf_measurement_t m = lateral_kf.measurement;
+        lateral_kf.measurement_ready = 0;
+        lateral_kf_correct(&m, omega - lateral_kf.x[2]);
+    }
+    
+    lateral_kf.offset = lateral_kf.x[0];
+    lateral_kf.heading = lateral_kf.x[1];
+    lateral_kf.valid = lateral_kf.initialized && P[0][0] < LATERAL_KF_MAX_OFFSET_VAR;
+}
+
+/**
+ * @brief  ͼ
+ * @param  
+ * @return 
+ * @note   ÿ֡steer_predict_update()֮á x = a + by + cy^2ͷͶӰϵ
+ *         Ƶ y = -PURE_PURSUIT_CAMERA_OFFSET Ҳaaбbͷʱatan(b)
+ *         ʧܣߡЧв㣩ʱд⡣дǰ־жϲдһ
+ */
+void lateral_kf_measure(void)
+{
+    const steer_predict_frame_t *frame = &steer_predict.frame[steer_predict.active];
+    
+    if (!frame->valid || !frame->fit_valid)
+        return;
+    
+    float y = -PURE_PURSUIT_CAMERA_OFFSET;
+    float a = frame->fit_a + frame->fit_b * y + frame->fit_c * y * y;
+    float slope = frame->fit_b + 2.0f * frame->fit_c * y;
+    float q = 1.0f + slope * slope;
+    
+    lateral_kf.pixel_per_m = frame->pixel_per_m;
+    lateral_kf.pixel_per_rad = frame->pixel_per_rad;
+    lateral_kf.pixel_per_curvature = frame->pixel_per_curvature;
+    
+    lateral_kf.measurement_ready = 0;
+    lateral_kf.measurement.timestamp_ms = frame->timestamp_ms;
+    lateral_kf.measurement.offset = a / sqrtf(q);
+    lateral_kf.measurement.heading = atanf(slope);
+    lateral_kf.measurement.curvature = 2.0f * frame->fit_c / (q * sqrtf(q));
+    lateral_kf.measurement_ready = 1;
+}
+
+/**
+ * @brief  Чͼƫ
+ * @param  
+ * @return ǰƻƫ ()vision_get_deviation()ͬ
+ * @note   steer_predictͬȣͷ (ƫ + ͷ롤)pixel_per_m pixel_per_rad
+ *         STEER_FF_ENABLEʱʲǰתǸ𣬲ƫ
+ */
+int16 lateral_kf_deviation(void)
+{
+    float offset = lateral_kf.offset + PURE_PURSUIT_CAMERA_OFFSET * lateral_kf.heading;
+    float deviation = offset * lateral_kf.pixel_per_m + lateral_kf.heading * lateral_kf.pixel_per_rad;
+    
+#if !STEER_FF_ENABLE
+    deviation += lateral_kf.curvature * lateral_kf.pixel_per_curvature;
+#endif
+    
+    if (deviation < -80.0f)
+        deviation = -80.0f;
+    else if (deviation > 80.0f)
+        deviation = 80.0f;
+    return (int16)(deviation + ((deviation >= 0.0f) ? 0.5f : -0.5f));
+}
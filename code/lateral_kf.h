@@ -0,0 +1,92 @@
+#ifndef _LATERAL_KF_H_
+#define _LATERAL_KF_H_
+
+#include "zf_common_headfile.h"
+#include "vision_track.h"
+#include "motor_control.h"
+
+//====================================================򿨶˲====================================================
+#define LATERAL_KF_ENABLE           0           // Ƿ˲ƴͼƫΪPID (1-, 0-ֻԤ¼Ϣ)
+#define LATERAL_KF_HISTORY          64          // ʷ (ms)ͼع⵽ɵӳ
+
+// ÿ뷽
+#define LATERAL_KF_Q_OFFSET         1e-4f       // ƫ (m^2/s)໬δģ˶
+#define LATERAL_KF_Q_HEADING        2e-3f       //  (rad^2/s)ʱ仯
+#define LATERAL_KF_Q_HEADING_STRAIGHT 1e-5f     // ֱϵĺ (rad^2/s)ʰ0Ԥ⣬ֻʣδģĲ໬
+                                                // ԶСƫĺƯƣƫߣһֱڲ
+#define LATERAL_KF_Q_BIAS           1e-6f       // ƫ ((rad/s)^2/s)
+
+// ߶ϻ㵽ᴦ
+#define LATERAL_KF_R_OFFSET         2e-4f       // ƫ (m^2)Լ1.4cm
+#define LATERAL_KF_R_HEADING        1e-3f       //  (rad^2)Լ1.8
+
+// ʼʧЧж
+#define LATERAL_KF_P0_OFFSET        0.01f       // ƫƳʼ (m^2)
+#define LATERAL_KF_P0_HEADING       0.05f       // ʼ (rad^2)
+#define LATERAL_KF_P0_BIAS          3e-3f       // ƫʼ ((rad/s)^2)Լ3/sϵ궨Ĳƫ
+#define LATERAL_KF_MAX_OFFSET_VAR   0.0025f     // ƫƷֵ (5cm) ΪʧЧPIDͼƫ
+
+// ƫֱֻϿɹۣƫ
+#define LATERAL_KF_STRAIGHT_CURVATURE 0.1f      // Сڸֵ (1/m) Ϊֱʰ0Ԥ⣨ֱʵƫûᱻƫ
+#define LATERAL_KF_BIAS_MAX_YAW_RATE 0.2f       // ٶȳֵ (rad/s) ʱΪʱͷѿֱת
+#define LATERAL_KF_BIAS_SETTLE_DISTANCE 1.2f    // ʻþ (m) ƫֱɶΰ=0Ԥĺȱ
+                                                // ȡϵԶ루STEER_PREDICT_FIT_MAX_DIST
+
+//====================================================ݽṹ====================================================
+// ڹʷtickδţ
+typedef struct
+{
+    float offset;                               // ƫ (m)
+    float heading;                              //  (rad)
+    float bias;                                 // ƫ (rad/s)
+    float distance;                             //  (m)״̬תƾ
+} lateral_kf_history_t;
+
+// ͼ⣨ѭд룬1msж϶ȡ
+typedef struct
+{
+    uint32 timestamp_ms;                        // ͼعʱ̣̼ʱ
+    float offset;                               // ᴦƫ (m)
+    float heading;                              // ᴦ (rad)
+    float curvature;                            // ᴦ (1/m)Ϊ
+} lateral_kf_measurement_t;
+
+// 򿨶˲ṹ
+typedef struct
+{
+    float x[3];                                 // ״̬ƫ (mΪ) (radͷʱΪ)ƫ (rad/s)
+    float P[3][3];                              // Э
+    float curvature;                            // Ԥʹõ (1/m)Ϊֵһֱ֡Ϊ0
+    float distance;                             //  (m)
+    float curve_distance;                       // һתʱ (m)
+    uint8 straight;                             // ѳ䲢ʻLATERAL_KF_BIAS_SETTLE_DISTANCEƫȡֱֵ
+    lateral_kf_history_t history[LATERAL_KF_HISTORY];
+    uint8 history_count;                        // Ѵŵʷ
+    
+    lateral_kf_measurement_t measurement;       // ͼ
+    volatile uint8 measurement_ready;           // дãȴжϴ
+    
+    float pixel_per_m;                          // һ֡Чƫȣʱã
+    float pixel_per_rad;
+    float pixel_per_curvature;
+    
+    uint8 initialized;                          // յһ֡
+    volatile uint8 valid;                       // ЧѳʼҺ򷽲δޣ
+    float offset;                               // ĺƫ (m)
+    float heading;                              // ĺ (rad)
+    uint32 age_ms;                              // һӳ (ms)
+    float innovation_offset;                    // һĺϢ (m)
+    float innovation_heading;                   // һĺϢ (rad)
+} lateral_kf_t;
+
+//====================================================ȫֱ====================================================
+extern lateral_kf_t lateral_kf;
+
+//========================================================================================================
+void  lateral_kf_init(void);                                    // ʼ
+void  lateral_kf_reset(void);                                   // ʱã״̬ȴһ֡
+void  lateral_kf_update(void);                                  // 1msжodometry_update()֮ã복Ԥ⣬
+void  lateral_kf_measure(void);                                 // ÿ֡steer_predict_update()֮ãϻΪ
+int16 lateral_kf_deviation(void);                               // ǰƻĵЧͼƫ ()
+
+#endif // _LATERAL_KF_H_
@@ -1,9 +1,20 @@
 #include "motor_control.h"
+#include "odometry.h"
+#include "battery.h"
 #include <math.h>
+#include <string.h>
 
 //====================================================ƽṹ====================================================
 car_control_t car;
 
+// 궨Ĭֵmotor_control.h
+static const uint16 servo_lut_default[2][SERVO_LUT_POINTS] = {SERVO_LUT_LEFT_US, SERVO_LUT_RIGHT_US};
+
+#if ACTUATOR_SYNC_ENABLE
+// ͬдĵPWMͨ
+static const pwm_channel_enum motor_pwm_channel[2] = {MOTOR_LEFT_PWM, MOTOR_RIGHT_PWM};
+#endif
+
 //====================================================ʵ====================================================
 /**
  * @brief  ֵΧ
@@ -27,15 +38,18 @@ static int32 limit(int32 value, int32 min, int32 max)
  */
 void servo_init(void)
 {
-    // ʼPWMƵ50HzռձΪλ
+    // ʼPWMռձΪλãͬģʽɵһ1msжʹPWMж϶
+#if !SERVO_SYNC_ENABLE
     pwm_init(SERVO_PWM_PIN, SERVO_PWM_FREQ, SERVO_CENTER_DUTY);
+#endif
 }
 
 /**
  * @brief  öռձ
  * @param  servo  ṹָ
- * @param  duty   ռձ (500-1000, Ӧ1.0ms-2.0ms)
+ * @param  duty   ռձ (SERVO_LEFT_MAX ~ SERVO_RIGHT_MAX50Hzʱ630-800)
  * @return 
+ * @note   SERVO_SYNC_ENABLEACTUATOR_SYNC_ENABLEʱֻ¼1msжд
  */
 void servo_set_duty(servo_t *servo, uint32 duty)
 {
@@ -46,7 +60,51 @@ void servo_set_duty(servo_t *servo, uint32 duty)
         duty = SERVO_RIGHT_MAX;
     
     servo->current_duty = duty;
+#if !SERVO_SYNC_ENABLE && !ACTUATOR_SYNC_ENABLE
     pwm_set_duty(servo->pwm_pin, duty);
+#endif
+}
+
+/**
+ * @brief  ö
+ * @param  servo     ṹָ
+ * @param  pulse_us   (us)
+ * @return 
+ * @note   궨servo_calibrate()ɨʱʹ
+ */
+void servo_set_pulse_us(servo_t *servo, uint16 pulse_us)
+{
+    servo_set_duty(servo, (pulse_us * SERVO_PWM_FREQ + 50) / 100);
+}
+
+/**
+ * @brief  תǻռձ
+ * @param  servo  ṹָ
+ * @param  angle  Ƕ (Q16ȣ޷)
+ * @return ռձ
+ * @note   תǷѡ궨һ࣬ȼϵֱ±꣬Բֵ1/8usռձȣ
+ *         С12λ˻ 300us x 8 x 409632λ㲻
+ */
+static uint32 servo_angle_to_duty(const servo_t *servo, q16_t angle)
+{
+    const int32 full_scale = Q16_FROM_INT(SERVO_MAX_ANGLE);
+    const uint16 *lut = servo->lut_us[angle < 0 ? 0 : 1];
+    int32 position = (angle < 0 ? -angle : angle) * (SERVO_LUT_POINTS - 1);
+    int32 index = position / full_scale;
+    int32 pulse_q3;
+    
+    if (index >= SERVO_LUT_POINTS - 1)
+    {
+        pulse_q3 = lut[SERVO_LUT_POINTS - 1] * 8;
+    }
+    else
+    {
+        int32 fraction_q12 = (position - index * full_scale) / (SERVO_MAX_ANGLE * 16);
+        int32 diff = (int32)lut[index + 1] - (int32)lut[index];
+        pulse_q3 = lut[index] * 8 + fixed_round_div(diff * 8 * fraction_q12, 4096);
+    }
+    
+    return (uint32)((pulse_q3 * SERVO_PWM_FREQ + 400) / 800);
 }
 
 /**
@@ -60,10 +118,70 @@ void servo_set_angle(servo_t *servo, int16 angle)
     // ƷΧ
     angle = limit(angle, -SERVO_MAX_ANGLE, SERVO_MAX_ANGLE);
     servo->current_angle = angle;
+    servo->current_angle_q16 = Q16_FROM_INT(angle);
     
-    int32 duty = SERVO_CENTER_DUTY+(SERVO_RIGHT_MAX-SERVO_CENTER_DUTY)*angle/45;
+    servo_set_duty(servo, servo_angle_to_duty(servo, servo->current_angle_q16));
+}
+
+/**
+ * @brief  öǶȣ㣩
+ * @param  servo  ṹָ
+ * @param  angle  Ƕ (Q16ȣ-45 ~ 45)
+ * @return 
+ * @note   servo_set_angle()ʹͬһ궨СǶ
+ */
+void servo_set_angle_q16(servo_t *servo, q16_t angle)
+{
+    // ƷΧ
+    angle = limit(angle, -Q16_FROM_INT(SERVO_MAX_ANGLE), Q16_FROM_INT(SERVO_MAX_ANGLE));
+    servo->current_angle = (int16)Q16_TO_INT(angle);
+    servo->current_angle_q16 = angle;
     
-    servo_set_duty(servo, (uint32)duty);
+    servo_set_duty(servo, servo_angle_to_duty(servo, angle));
+}
+
+/**
+ * @brief  ͬ
+ * @param  servo  ṹָ
+ * @return 
+ * @note   actuator_output_tick()תڻ֮áSERVO_SYNC_ENABLEʱһεPWM
+ *         ˺PWMڱ߽ڹ̶жʱ̣ÿ1msдռձȣ
+ *         1msյڻͬʱһPWMڣ
+ *         ACTUATOR_SYNC_ENABLEʱÿдռձȣɶڱ߽װ
+ */
+void servo_output_tick(servo_t *servo)
+{
+#if SERVO_SYNC_ENABLE
+    if (!servo->started)
+    {
+        pwm_init(servo->pwm_pin, SERVO_PWM_FREQ, servo->current_duty);
+        servo->started = 1;
+        servo->phase = 0;
+        return;
+    }
+    
+    if (++servo->phase >= SERVO_UPDATE_PERIOD_MS)
+        servo->phase = 0;
+    if (servo->phase == SERVO_UPDATE_PERIOD_MS - 1)
+        pwm_set_duty(servo->pwm_pin, servo->current_duty);
+#elif ACTUATOR_SYNC_ENABLE
+    pwm_set_duty(servo->pwm_pin, servo->current_duty);
+#else
+    (void)servo;
+#endif
+}
+
+/**
+ * @brief  ģΪĬֵ
+ * @param  model  ģ
+ * @return 
+ */
+static void motor_model_default(motor_model_t *model)
+{
+    model->gain     = MOTOR_MODEL_GAIN;
+    model->tau      = MOTOR_MODEL_TAU;
+    model->deadtime = MOTOR_MODEL_DEADTIME;
+    model->deadband = MOTOR_MODEL_DEADBAND;
 }
 
 /**
@@ -81,7 +199,12 @@ void motor_init(void)
     car.left_motor.target_speed  = 0;
     car.left_motor.current_speed = 0;
     car.left_motor.pwm_duty      = 0;
+    car.left_motor.duty_cap      = MOTOR_MAX_DUTY;
     car.left_motor.direction     = 0;
+    car.left_motor.output_duty   = 0;
+    car.left_motor.applied_duty  = 0;
+    motor_model_default(&car.left_motor.model);
+    car.left_motor.model_speed   = 0.0f;
     
     // ========== ҵʼDRV8701ģʽ ==========
     car.right_motor.pwm_pin       = MOTOR_RIGHT_PWM;
@@ -91,12 +214,20 @@ void motor_init(void)
     car.right_motor.target_speed  = 0;
     car.right_motor.current_speed = 0;
     car.right_motor.pwm_duty      = 0;
+    car.right_motor.duty_cap      = MOTOR_MAX_DUTY;
     car.right_motor.direction     = 0;
+    car.right_motor.output_duty   = 0;
+    car.right_motor.applied_duty  = 0;
+    motor_model_default(&car.right_motor.model);
+    car.right_motor.model_speed   = 0.0f;
     
     // ========== תʼ ==========
     car.steering_servo.pwm_pin      = SERVO_PWM_PIN;
     car.steering_servo.current_angle = 0;
     car.steering_servo.current_duty  = SERVO_CENTER_DUTY;
+    car.steering_servo.started       = 0;
+    car.steering_servo.phase         = 0;
+    memcpy(car.steering_servo.lut_us, servo_lut_default, sizeof(servo_lut_default));
     
     // ========== ƽṹʼ ==========
     car.base_speed   = 0;
@@ -106,6 +237,9 @@ void motor_init(void)
     // ʼPWMDRV8701: PWMƵ17KHz
     pwm_init(MOTOR_LEFT_PWM, MOTOR_PWM_FREQ, 0);
     pwm_init(MOTOR_RIGHT_PWM, MOTOR_PWM_FREQ, 0);
+#if ACTUATOR_SYNC_ENABLE
+    pwm_phase_align(motor_pwm_channel, 2);      // PWMڱ߽룬ͬдͬһ߽Ч
+#endif
     
     // ʼƶ˿ڣDRV8701: DIR
     gpio_init(MOTOR_LEFT_DIR, GPO, GPIO_LOW, GPO_PUSH_PULL);
@@ -122,16 +256,23 @@ void motor_init(void)
 /**
  * @brief  õռձȣDRV8701: PWM+DIRģʽ
  * @param  motor  ṹָ
- * @param  duty   ռձ (-MOTOR_MAX_DUTY ~ MOTOR_MAX_DUTY)
+ * @param  duty   Ƶѹµռձ (-MOTOR_MAX_DUTY ~ MOTOR_MAX_DUTY)
  * @return 
- * @note   DRV8701ģʽDIRſƷPWMſռձ
+ * @note   DRV8701ģʽDIRſƷPWMſռձȣ
+ *         ռձȲduty_capǣƣ
+ *         BATTERY_ENABLEʱռձȰصѹѹpwm_duty¼ǰ
+ *         ACTUATOR_SYNC_ENABLEʱֻ¼actuator_output_tick()д
  */
 void motor_set_duty(motor_t *motor, int32 duty)
 {
     // ƷΧ
-    duty = limit(duty, -MOTOR_MAX_DUTY, MOTOR_MAX_DUTY);
+    duty = limit(duty, -MOTOR_MAX_DUTY, motor->duty_cap);
     motor->pwm_duty = duty;
+    duty = battery_compensate(duty);
     
+#if ACTUATOR_SYNC_ENABLE
+    motor->output_duty = duty;
+#else
     if (duty > 0)
     {
         // ת: DIR=0, PWM=duty
@@ -151,27 +292,115 @@ void motor_set_duty(motor_t *motor, int32 duty)
         // ֹͣ: PWM=0 (رյ)
         pwm_set_duty(motor->pwm_pin, 0);
     }
+#endif
+}
+
+#if ACTUATOR_SYNC_ENABLE
+/**
+ * @brief  дӰӼĴ
+ * @param  motor  ṹָ
+ * @return 
+ * @note   pwm_update_hold()pwm_update_commit()֮áתϴʱ
+ *         ֻдռձȣһ1msPWMѳΪͣлDIRдռձȣDIRPWMߵƽڼ䷭ת
+ */
+static void motor_output(motor_t *motor)
+{
+    int32 duty = motor->output_duty;
+    uint8 direction = duty < 0 ? 1 : 0;
+    
+    if (duty != 0 && direction != motor->direction)
+    {
+        if (motor->applied_duty != 0)
+        {
+            motor->applied_duty = 0;
+            pwm_set_duty(motor->pwm_pin, 0);
+            return;
+        }
+        gpio_set_level(motor->dir_pin, direction ? GPIO_HIGH : GPIO_LOW);
+        motor->direction = direction;
+    }
+    
+    motor->applied_duty = (uint32)(duty < 0 ? -duty : duty);
+    pwm_set_duty(motor->pwm_pin, motor->applied_duty);
+}
+#endif
+
+/**
+ * @brief  ִͳһ
+ * @param  
+ * @return 
+ * @note   ODOMETRY_PIT 1msжĩβãmotor_set_duty()֮󣩡ACTUATOR_SYNC_ENABLEʱ
+ *         ͣͨӰӼĴװأдһηſͬһPWMڱ߽Ч
+ *         Զڵڱ߽װأͣ
+ */
+void actuator_output_tick(void)
+{
+#if ACTUATOR_SYNC_ENABLE
+    pwm_update_hold(motor_pwm_channel, 2);
+    motor_output(&car.left_motor);
+    motor_output(&car.right_motor);
+    servo_output_tick(&car.steering_servo);
+    pwm_update_commit(motor_pwm_channel, 2);
+#else
+    servo_output_tick(&car.steering_servo);
+#endif
+}
+
+/**
+ * @brief  ģǰ
+ * @param  model  ģ
+ * @param  speed  Ŀ공 (mm/s)
+ * @param  accel  Ŀٶ (mm/s^2)
+ * @return ǰռձȣ(v + ӡa) / gain + sign(v)
+ * @note   ӳٲ棬ɵ÷ѷοӳͬʱ䣨speed_loopֻģͲв
+ */
+float motor_model_feedforward(const motor_model_t *model, float speed, float accel)
+{
+    float duty = (speed + model->tau * accel) / model->gain;
+    
+    if (speed > MOTOR_MODEL_FF_MIN_SPEED)
+        duty += model->deadband;
+    else if (speed < -MOTOR_MODEL_FF_MIN_SPEED)
+        duty -= model->deadband;
+    return duty;
+}
+
+/**
+ * @brief  ģͲο
+ * @param  motor   
+ * @param  target  Ŀ공٣ⵥλ
+ * @param  dt       (s)
+ * @return ģͶĿһԤӦtargetͬλ
+ * @note   ǰĿֱӸ̬ռձʱٰʱ䳣ӱƽĿꣻٸԤֵǽԾĿ꣬
+ *         ֻģͲвǰɳڴڴӳ٣Դӳ
+ */
+float motor_model_reference(motor_t *motor, float target, float dt)
+{
+    motor->model_speed += (target - motor->model_speed) * (1.0f - expf(-dt / motor->model.tau));
+    return motor->model_speed;
 }
 
 /**
  * @brief  µٶȣڱ10msһ
  * @param  
  * @return 
- * @note   10msһΣڱµٶ
+ * @note   ̼1msжжȡ㲢ۼƣȡε֮ۼƼĲֵΪٶȣ
+ *         ֻ32λۼֵҪж
  */
 void motor_update_speed(void)
 {
-    // ȡ
-    car.left_motor.encoder_count = encoder_get_count(car.left_motor.encoder);
-    car.right_motor.encoder_count = -encoder_get_count(car.right_motor.encoder);
+    int32 left_total = odometry.left_total;
+    int32 right_total = odometry.right_total;
+    
+    // ȡڱ
+    car.left_motor.encoder_count = (int16)(left_total - car.left_motor.encoder_last);
+    car.right_motor.encoder_count = (int16)(right_total - car.right_motor.encoder_last);
+    car.left_motor.encoder_last = left_total;
+    car.right_motor.encoder_last = right_total;
     
     // µǰٶ
     car.left_motor.current_speed = car.left_motor.encoder_count;
     car.right_motor.current_speed = car.right_motor.encoder_count;
-    
-    // 
-    encoder_clear_count(car.left_motor.encoder);
-    encoder_clear_count(car.right_motor.encoder);
 }
 
 /**
@@ -256,33 +485,42 @@ void car_turn(int16 speed, int16 angle)
  */
 void car_update_differential_speed(int16 base_speed, int16 angle)
 {
-    if (angle == 0)
-    {
-        car_set_speed(base_speed, base_speed);
-        return;
-    }
-
-    // Ƕת
-    float theta = (float)angle * 3.14159f / 180.0f;
-    float tan_theta = tanf(theta);
-    
-    // ת뾶 R = L / tan(theta)
-    // 㣬Ȼangle!=0жϣtan_thetaܼС
-    if (fabsf(tan_theta) < 0.001f)
-    {
-        car_set_speed(base_speed, base_speed);
-        return;
-    }
-    
-    // βٹʽ
-    // V_left  = V_center * (1 - W * tan(theta) / (2 * L))
-    // V_right = V_center * (1 + W * tan(theta) / (2 * L))
-    //  W = CAR_TRACK_WIDTH, L = CAR_WHEELBASE
-    
-    float ratio = (float)CAR_TRACK_WIDTH * tan_theta / (2.0f * (float)CAR_WHEELBASE);
-    
-    int16 left_speed = (int16)((float)base_speed * (1.0f - ratio));
-    int16 right_speed = (int16)((float)base_speed * (1.0f + ratio));
+    int16 left_speed;
+    int16 right_speed;
     
+    car_differential_speed(base_speed, Q16_FROM_INT(angle), &left_speed, &right_speed);
     car_set_speed(left_speed, right_speed);
 }
+
+/**
+ * @brief  ٶ (ת򼸺)
+ * @param  base_speed   ٶ
+ * @param  angle        תǶ (Q16)
+ * @param  left_speed   ٶ
+ * @param  right_speed  ٶ
+ * @return 
+ * @note   V_left  = V_center * (1 - s * k * W * tan(theta) / (2 * L))
+ *         V_right = V_center * (1 + s * k * W * tan(theta) / (2 * L))
+ *          W = CAR_TRACK_WIDTH, L = CAR_WHEELBASE, k = DIFFERENTIAL_GAIN, s = DIFFERENTIAL_SIGN
+ *         tanQ16㣬tanf()ȡʽ븡ǿתͬ㣩
+ */
+void car_differential_speed(int16 base_speed, q16_t angle, int16 *left_speed, int16 *right_speed)
+{
+    q16_t ratio = fixed_tan_deg(angle) * CAR_TRACK_WIDTH / (2 * CAR_WHEELBASE);
+    ratio = fixed_mul(ratio, Q16_FROM_FLOAT(DIFFERENTIAL_GAIN)) * DIFFERENTIAL_SIGN;
+    
+    q16_t base = Q16_FROM_INT(base_speed);
+    *left_speed = (int16)(fixed_mul(base, Q16_ONE - ratio) / Q16_ONE);
+    *right_speed = (int16)(fixed_mul(base, Q16_ONE + ratio) / Q16_ONE);
+}
+
+/**
+ * @brief  ȡۼʻ
+ * @param  
+ * @return ʻ (mm)ʱ
+ * @note   ̼1msжл֣ȡodometry_calibrate_start/finish()ı궨
+ */
+int32 car_get_distance_mm(void)
+{
+    return odometry_get_distance_mm();
+}
@@ -2,6 +2,8 @@
 #define _MOTOR_CONTROL_H_
 
 #include "zf_common_headfile.h"
+#include "fixed_point.h"
+#include "car_params.h"
 
 //====================================================ҵƶ˿ڶ====================================================
 // ҵƶ˿ - DRV8701PWM+ģʽ
@@ -21,22 +23,61 @@
 #define ENCODER_RIGHT       TIM6_ENCODER            // ҵ
 #define ENCODER_RIGHT_CH1   TIM6_ENCODER_CH1_P20_3  // ҵͨ1
 #define ENCODER_RIGHT_CH2   TIM6_ENCODER_CH2_P20_0  // ҵͨ2
+#define ENCODER_COUNT_PER_METER 5000                // ÿױ谴־ݱʵ궨
 // DRV8701
 #define MOTOR_PWM_FREQ      17000               // PWMƵ 17KHzDRV8701Ƽ10-25KHz
-#define MOTOR_MAX_DUTY      8000                // ռձ (PWM_DUTY_MAX = 10000)
+// MOTOR_MAX_DUTY  car_params.h
 #define MOTOR_MIN_DUTY      500                 // Сռձȣֹʱֹͣ
+
+// ģͣһ׹+ӳ+ = GAIN(duty - DEADBANDsign) DEADTIMEӳTAUһͺٶǰ
+// ĬֵΪֵmotor_identʶָǲճĺ
+#define MOTOR_MODEL_GAIN        0.4f            // ̬ (mm/s / ռձ)ԼΪռձȿس / PWM_DUTY_MAX
+#define MOTOR_MODEL_TAU         0.10f           // еʱ䳣 (s)
+#define MOTOR_MODEL_DEADTIME    0.004f          // ӳ (s)
+#define MOTOR_MODEL_DEADBAND    300.0f          // ռձȣĦһСMOTOR_MIN_DUTY
+#define MOTOR_MODEL_FF_MIN_SPEED 20.0f          // Ŀٶȵڸֵ (mm/s) ʱ
 // 
-#define SERVO_PWM_FREQ      50                  // PWMƵ 50Hz (20ms)
-#define SERVO_CENTER_DUTY   715                 // ռձ (1.5ms/20ms * 10000 = 750)
-#define SERVO_LEFT_MAX      630                 // ռձ (1.0ms)
-#define SERVO_RIGHT_MAX     800                // ռձ (2.0ms)
+#define SERVO_PWM_FREQ      50                  // PWMƵ (Hz)ģ50ֶ200/250/333ȷ϶֧֣
+#define SERVO_SYNC_ENABLE   0                   // 1-PWM1msжÿPWMڽǰ1msдһΣתڻͬ0-üд
+#define ACTUATOR_SYNC_ENABLE 1                  // 1-ֻ¼1msжͳһдGTMӰӼĴͬһPWMڱ߽Ч
+                                                //   DIRתʱ1msռձлDIR0-üд
+#define SERVO_CENTER_US     1430                //  (us)
+#define SERVO_LEFT_MAX_US   1260                // תһ༫ (us)
+#define SERVO_RIGHT_MAX_US  1600                // תһ༫ (us)
 #define SERVO_MAX_ANGLE     45                  // ת (+-45)
 
-// β (λ: mm)
-#define CAR_WHEELBASE       200                 //  (ǰ־)
-#define CAR_TRACK_WIDTH     160                 // ־ (־)
+#define SERVO_US_TO_DUTY(us)    ((uint32)(us) * SERVO_PWM_FREQ / 100)   // ռձ (PWM_DUTY_MAX = 10000)
+#define SERVO_CENTER_DUTY   SERVO_US_TO_DUTY(SERVO_CENTER_US)           // ռձ (50Hzʱ715)
+#define SERVO_LEFT_MAX      SERVO_US_TO_DUTY(SERVO_LEFT_MAX_US)         // תһ༫ռձ (50Hzʱ630)
+#define SERVO_RIGHT_MAX     SERVO_US_TO_DUTY(SERVO_RIGHT_MAX_US)        // תһ༫ռձ (50Hzʱ800)
+#define SERVO_UPDATE_PERIOD_MS  ((1000 + SERVO_PWM_FREQ / 2) / SERVO_PWM_FREQ) // PWM (msȡ333Hzʱ3msԼÿƯ1ms)
+
+#if (SERVO_RIGHT_MAX_US * SERVO_PWM_FREQ >= 1000000) || (SERVO_PWM_FREQ > 333)
+#error "PWMڣSERVO_PWM_FREQ"
+#endif
+
+// 궨ת ->  (us)ÿSERVO_LUT_POINTS㣬Ӧ 0 ~ SERVO_MAX_ANGLE ȼתǣԲֵ
+// Ĭֵԭӳͬservo_calibrate()󰴴滻
+#define SERVO_LUT_POINTS    7
+#define SERVO_LUT_LEFT_US   {1430, 1402, 1373, 1345, 1317, 1288, 1260}  // ת 0, -7.5, ..., -45
+#define SERVO_LUT_RIGHT_US  {1430, 1458, 1487, 1515, 1543, 1572, 1600}  // ת 0, 7.5, ..., 45
+
+// β CAR_WHEELBASE/CAR_TRACK_WIDTH  car_params.h
+
+// ӲٲDIFFERENTIAL_SIGN  car_params.h
+#define DIFFERENTIAL_ENABLE 1                   // ǷʵʶתǸַٶĿ
+#define DIFFERENTIAL_GAIN   1.0f                // ϵ1Ϊֲֵ໬ʱʵС
 
 //====================================================ݽṹ====================================================
+// ģ
+typedef struct
+{
+    float gain;                                 // ̬ (mm/s / ռձ)
+    float tau;                                  // еʱ䳣 (s)
+    float deadtime;                             // ӳ (s)
+    float deadband;                             // ռձ
+} motor_model_t;
+
 // ṹ嶨壨DRV8701ģʽ
 typedef struct
 {
@@ -44,10 +85,16 @@ typedef struct
     gpio_pin_enum dir_pin;                      // ƶ˿
     encoder_index_enum encoder;                 // 
     int16 encoder_count;                        // 
+    int32 encoder_last;                         // ϴζȡ̼ۼƼ
     int16 target_speed;                         // ĿٶȣλΪÿ
     int16 current_speed;                        // ǰٶȣλΪÿ
     int32 pwm_duty;                             // ǰPWMռձȣٶȻƶ
+    int32 duty_cap;                             // ռձޣǣд룬δʱΪMOTOR_MAX_DUTY
     uint8 direction;                            // ǰ0=ǰ1=
+    int32 output_duty;                          // ACTUATOR_SYNC_ENABLEʱдռձȣز󣬴
+    uint32 applied_duty;                        // ACTUATOR_SYNC_ENABLEʱдӰӼĴռձ
+    motor_model_t model;                        // ģͣٶǰã
+    float model_speed;                          // ģͲο٣ģͶĿԤӦĿͬλ
 } motor_t;
 
 // ṹ嶨
@@ -55,7 +102,11 @@ typedef struct
 {
     pwm_channel_enum pwm_pin;                   // PWMͨ
     int16 current_angle;                        // ǰǶ (-SERVO_MAX_ANGLE ~ SERVO_MAX_ANGLE)
+    q16_t current_angle_q16;                    // ʵ·Ƕ (Q16ȣ޷)
     uint32 current_duty;                        // ǰռձ
+    uint16 lut_us[2][SERVO_LUT_POINTS];         // 궨 [0]תǲ [1]תǲ (us)
+    uint8 started;                              // SERVO_SYNC_ENABLEʱPWM1msж
+    uint8 phase;                                // SERVO_SYNC_ENABLEʱPWMڵĺ
 } servo_t;
 
 // ƽṹ嶨壨++ٶ+Ƕȣ
@@ -75,9 +126,15 @@ extern car_control_t car;
 void motor_init(void);                                          // ͱʼ
 void motor_set_duty(motor_t *motor, int32 duty);               // õռձ
 void motor_update_speed(void);                                  // ٶȴ
+float motor_model_feedforward(const motor_model_t *model, float speed, float accel); // ģǰռձ
+float motor_model_reference(motor_t *motor, float target, float dt);   // ģͲο٣һӦ
 void servo_init(void);                                          // ʼ
 void servo_set_angle(servo_t *servo, int16 angle);             // öǶ (-45 ~ 45)
+void servo_set_angle_q16(servo_t *servo, q16_t angle);         // öǶ (Q16ȣ)
 void servo_set_duty(servo_t *servo, uint32 duty);              // öռձ
+void servo_set_pulse_us(servo_t *servo, uint16 pulse_us);       // ö (us)궨
+void servo_output_tick(servo_t *servo);                         // SERVO_SYNC_ENABLEʱPWMд루actuator_output_tick()ã
+void actuator_output_tick(void);                                // 1msжĩβãͳһ
 void car_set_speed(int16 left_speed, int16 right_speed);        // ҵٶ
 void car_set_angle(int16 angle);                                // תǶ
 void car_stop(void);                                            // ֹͣ
@@ -85,5 +142,7 @@ void car_forward(int16 speed);                                  // ǰ
 void car_backward(int16 speed);                                 // 
 void car_turn(int16 speed, int16 angle);                        // תspeed: ٶ, angle: תǶ
 void car_update_differential_speed(int16 base_speed, int16 angle); // תǶȸ²
+void car_differential_speed(int16 base_speed, q16_t angle, int16 *left_speed, int16 *right_speed); // ٶ
+int32 car_get_distance_mm(void);                                // ȡۼʻ (mm)
 
 #endif // _MOTOR_CONTROL_H_
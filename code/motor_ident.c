@@ -0,0 +1,392 @@
+#include "motor_ident.h"
+#include <math.h>
+#ifndef PID_HOST
+#include "smart_car.h"
+#endif
+
+#define MOTOR_IDENT_DT              (MOTOR_IDENT_SAMPLE_MS * 0.001f)
+#define MOTOR_IDENT_STEADY_SAMPLES  (MOTOR_IDENT_STEADY_MS / MOTOR_IDENT_SAMPLE_MS)
+
+static const int16 motor_ident_levels[MOTOR_IDENT_SEGMENTS] = MOTOR_IDENT_LEVELS;
+
+//====================================================Ծʶ㷨====================================================
+/**
+ * @brief  λֱʶ״̬ʼԾ
+ * @param  wheel  ֱʶṹָ
+ * @return 
+ */
+void motor_ident_wheel_reset(motor_ident_wheel_t *wheel)
+{
+    wheel->phase = MOTOR_IDENT_RUN;
+    wheel->error = MOTOR_IDENT_OK;
+    wheel->started = 0;
+    wheel->segment = 0;
+    wheel->index = 0;
+    wheel->fit_rms = 0.0f;
+}
+
+/**
+ * @brief  ֱʶ
+ * @param  wheel  ֱʶṹָ
+ * @param  speed  һƽ (mm/s)
+ * @return һռձȣʧʱΪ0
+ * @note   kǶ [kdt, (k+1)dt] ƽ٣Ӧеʱ (k+0.5)dt
+ */
+int32 motor_ident_wheel_step(motor_ident_wheel_t *wheel, float speed)
+{
+    if (wheel->phase != MOTOR_IDENT_RUN)
+        return 0;
+    
+    if (speed > MOTOR_IDENT_MAX_SPEED || speed < -MOTOR_IDENT_MAX_SPEED)
+    {
+        wheel->phase = MOTOR_IDENT_FAILED;
+        wheel->error = MOTOR_IDENT_ERR_OVERSPEED;
+        return 0;
+    }
+    
+    if (!wheel->started)
+    {
+        wheel->started = 1;
+        return motor_ident_levels[0];
+    }
+    
+    wheel->speed[wheel->segment][wheel->index] = (int16)speed;
+    if (++wheel->index >= MOTOR_IDENT_SAMPLES)
+    {
+        wheel->index = 0;
+        if (++wheel->segment >= MOTOR_IDENT_SEGMENTS)
+        {
+            wheel->phase = MOTOR_IDENT_DONE;
+            return 0;
+        }
+    }
+    return motor_ident_levels[wheel->segment];
+}
+
+/**
+ * @brief  ԾӦﵽָʱ
+ * @param  samples  ڳ
+ * @param  y0       Ծǰ̬
+ * @param  delta    ̬ٱ仯
+ * @param  ratio     (0~1)
+ * @return ʱ (sռձȱ仯)δﵽظֵ
+ * @note   㻬ƽУʱƣеʱ̼Բֵt=0 ӦΪ0
+ */
+static float motor_ident_crossing(const int16 *samples, float y0, float delta, float ratio)
+{
+    float last_t = 0.0f;
+    float last_r = 0.0f;
+    
+    for (uint16 k = 0; k < MOTOR_IDENT_SAMPLES; k++)
+    {
+        float y = samples[k];
+        if (k > 0 && k < MOTOR_IDENT_SAMPLES - 1)
+            y = (samples[k - 1] + samples[k] + samples[k + 1]) / 3.0f;
+        float t = (k + 0.5f) * MOTOR_IDENT_DT;
+        float r = (y - y0) / delta;
+        if (r >= ratio)
+            return last_t + (t - last_t) * (ratio - last_r) / (r - last_r);
+        last_t = t;
+        last_r = r;
+    }
+    return -1.0f;
+}
+
+/**
+ * @brief  ģͰռձиֳ٣¼RMS
+ * @param  wheel  ֱʶṹָ
+ * @return RMS (mm/s)
+ * @note   1msŷ֣ӾֹʼĦΪ0ռձȲʱ־ֹ
+ */
+static float motor_ident_fit_error(const motor_ident_wheel_t *wheel)
+{
+    const motor_model_t *model = &wheel->model;
+    uint16 steps = MOTOR_IDENT_SAMPLE_MS;
+    float v = 0.0f;
+    float error_sq = 0.0f;
+    uint32 ms = 0;
+    
+    for (uint8 s = 0; s < MOTOR_IDENT_SEGMENTS; s++)
+    {
+        for (uint16 k = 0; k < MOTOR_IDENT_SAMPLES; k++)
+        {
+            float sum = 0.0f;
+            for (uint16 i = 0; i < steps; i++, ms++)
+            {
+                // ӳ٣ȡ deadtime ֮ǰڶεռձ
+                float t = ms * 0.001f - model->deadtime;
+                int32 seg = (t < 0.0f) ? -1 : (int32)(t / (MOTOR_IDENT_HOLD_MS * 0.001f));
+                float duty = (seg < 0) ? 0.0f : motor_ident_levels[seg < MOTOR_IDENT_SEGMENTS ? seg : MOTOR_IDENT_SEGMENTS - 1];
+                float drive = duty - model->deadband;
+                if (v < 1.0f && drive <= 0.0f)
+                {
+                    v = 0.0f;
+                    drive = 0.0f;
+                }
+                v += (model->gain * drive - v) / model->tau * 0.001f;
+                sum += v;
+            }
+            float e = sum / steps - wheel->speed[s][k];
+            error_sq += e * e;
+        }
+    }
+    return sqrtf(error_sq / (MOTOR_IDENT_SEGMENTS * MOTOR_IDENT_SAMPLES));
+}
+
+/**
+ * @brief  ϵֵģ
+ * @param  wheel  ֱʶṹָ루phaseΪDONE
+ * @return 1-ɹwheel->model 0-ʧܣԭwheel->error
+ * @note   ̬̬ٶռձԻع v = gain(duty - deadband)
+ *         ̬1ÿԾ㷨Smith = 1.5(t63 - t28) = t63 - ӣȡƽ
+ *         иֳ٣ʱΪʧ
+ */
+uint8 motor_ident_wheel_fit(motor_ident_wheel_t *wheel)
+{
+    if (wheel->phase != MOTOR_IDENT_DONE)
+        return 0;
+    
+    // ̬
+    float max_speed = 0.0f;
+    for (uint8 s = 0; s < MOTOR_IDENT_SEGMENTS; s++)
+    {
+        int32 sum = 0;
+        for (uint16 k = MOTOR_IDENT_SAMPLES - MOTOR_IDENT_STEADY_SAMPLES; k < MOTOR_IDENT_SAMPLES; k++)
+            sum += wheel->speed[s][k];
+        wheel->steady[s] = (float)sum / MOTOR_IDENT_STEADY_SAMPLES;
+        if (wheel->steady[s] > max_speed)
+            max_speed = wheel->steady[s];
+    }
+    if (wheel->steady[0] < MOTOR_IDENT_MIN_SPEED)
+    {
+        wheel->phase = MOTOR_IDENT_FAILED;
+        wheel->error = MOTOR_IDENT_ERR_STALL;
+        return 0;
+    }
+    
+    // 
+    float mean_u = 0.0f, mean_v = 0.0f;
+    for (uint8 s = 0; s < MOTOR_IDENT_SEGMENTS; s++)
+    {
+        mean_u += motor_ident_levels[s];
+        mean_v += wheel->steady[s];
+    }
+    mean_u /= MOTOR_IDENT_SEGMENTS;
+    mean_v /= MOTOR_IDENT_SEGMENTS;
+    float suv = 0.0f, suu = 0.0f;
+    for (uint8 s = 0; s < MOTOR_IDENT_SEGMENTS; s++)
+    {
+        float du = motor_ident_levels[s] - mean_u;
+        suv += du * (wheel->steady[s] - mean_v);
+        suu += du * du;
+    }
+    float gain = (suu > 0.0f) ? suv / suu : 0.0f;
+    
+    // ʱ䳣봿ӳ
+    float tau_sum = 0.0f, deadtime_sum = 0.0f;
+    uint8 steps = 0;
+    for (uint8 s = 1; s < MOTOR_IDENT_SEGMENTS; s++)
+    {
+        float delta = wheel->steady[s] - wheel->steady[s - 1];
+        if (fabsf(delta) < 0.1f * max_speed)
+            continue;
+        float t28 = motor_ident_crossing(wheel->speed[s], wheel->steady[s - 1], delta, 0.283f);
+        float t63 = motor_ident_crossing(wheel->speed[s], wheel->steady[s - 1], delta, 0.632f);
+        if (t28 < 0.0f || t63 <= t28)
+            continue;
+        float tau = 1.5f * (t63 - t28);
+        tau_sum += tau;
+        deadtime_sum += (t63 > tau) ? t63 - tau : 0.0f;
+        steps++;
+    }
+    
+    if (gain <= 0.0f || steps == 0)
+    {
+        wheel->phase = MOTOR_IDENT_FAILED;
+        wheel->error = MOTOR_IDENT_ERR_FIT;
+        return 0;
+    }
+    
+    wheel->model.gain = gain;
+    wheel->model.deadband = mean_u - mean_v / gain;
+    if (wheel->model.deadband < 0.0f)
+        wheel->model.deadband = 0.0f;
+    wheel->model.tau = tau_sum / steps;
+    wheel->model.deadtime = deadtime_sum / steps;
+    
+    wheel->fit_rms = motor_ident_fit_error(wheel);
+    if (wheel->fit_rms > MOTOR_IDENT_MAX_FIT_ERROR * max_speed)
+    {
+        wheel->phase = MOTOR_IDENT_FAILED;
+        wheel->error = MOTOR_IDENT_ERR_FIT;
+        return 0;
+    }
+    return 1;
+}
+
+#ifndef PID_HOST
+//====================================================ʶ====================================================
+motor_ident_t motor_ident;
+
+/**
+ * @brief  ʼ
+ * @param  
+ * @return 
+ */
+void motor_ident_init(void)
+{
+    motor_ident.active = 0;
+    motor_ident.finished = 0;
+    motor_ident.divider = 0;
+    motor_ident.left.phase = MOTOR_IDENT_IDLE;
+    motor_ident.right.phase = MOTOR_IDENT_IDLE;
+}
+
+/**
+ * @brief  ʼʶ
+ * @param  
+ * @return 1-ѿʼ 0-Сڱʶ
+ * @note   գԼ SEGMENTS x HOLD_MS (2) 
+ */
+uint8 motor_ident_start(void)
+{
+    if (smart_car.state == CAR_RUNNING || motor_ident.active || speed_autotune.active)
+        return 0;
+    
+    motor_ident_wheel_reset(&motor_ident.left);
+    motor_ident_wheel_reset(&motor_ident.right);
+    motor_ident.left_last = odometry.left_total;
+    motor_ident.right_last = odometry.right_total;
+    motor_ident.divider = 0;
+    motor_ident.finished = 0;
+    motor_ident.active = 1;
+    return 1;
+}
+
+/**
+ * @brief  Ƿѽ
+ */
+static uint8 motor_ident_wheel_ended(const motor_ident_wheel_t *wheel)
+{
+    return wheel->phase == MOTOR_IDENT_DONE || wheel->phase == MOTOR_IDENT_FAILED;
+}
+
+/**
+ * @brief  ʶжϸ
+ * @param  
+ * @return 
+ * @note   1msжodometry_update()֮ãδʶʱֱӷء MOTOR_IDENT_SAMPLE_MS Ƶ
+ *         ̼ۼƼ㳵١ֽʱֹͣʱֱӽѭ
+ */
+void motor_ident_update(void)
+{
+    if (!motor_ident.active)
+        return;
+    
+    if (smart_car.state == CAR_RUNNING)
+    {
+        // ѷѭ
+        if (!motor_ident_wheel_ended(&motor_ident.left))
+        {
+            motor_ident.left.phase = MOTOR_IDENT_FAILED;
+            motor_ident.left.error = MOTOR_IDENT_ERR_ABORTED;
+        }
+        if (!motor_ident_wheel_ended(&motor_ident.right))
+        {
+            motor_ident.right.phase = MOTOR_IDENT_FAILED;
+            motor_ident.right.error = MOTOR_IDENT_ERR_ABORTED;
+        }
+        motor_ident.active = 0;
+        motor_ident.finished = 1;
+        return;
+    }
+    
+    if (++motor_ident.divider < MOTOR_IDENT_SAMPLE_MS)
+        return;
+    motor_ident.divider = 0;
+    
+    int32 left_total = odometry.left_total;
+    int32 right_total = odometry.right_total;
+    float left_speed = (left_total - motor_ident.left_last) * odometry.mm_per_count_left / MOTOR_IDENT_DT;
+    float right_speed = (right_total - motor_ident.right_last) * odometry.mm_per_count_right / MOTOR_IDENT_DT;
+    motor_ident.left_last = left_total;
+    motor_ident.right_last = right_total;
+    
+    int32 left_duty = motor_ident_wheel_step(&motor_ident.left, left_speed);
+    int32 right_duty = motor_ident_wheel_step(&motor_ident.right, right_speed);
+    
+    if (motor_ident_wheel_ended(&motor_ident.left) && motor_ident_wheel_ended(&motor_ident.right))
+    {
+        motor_set_duty(&car.left_motor, 0);
+        motor_set_duty(&car.right_motor, 0);
+        motor_ident.active = 0;
+        motor_ident.finished = 1;
+        return;
+    }
+    
+    motor_set_duty(&car.left_motor, left_duty);
+    motor_set_duty(&car.right_motor, right_duty);
+}
+
+/**
+ * @brief  ϲֽ
+ */
+static uint8 motor_ident_report(const char *name, motor_ident_wheel_t *wheel)
+{
+    uint8 ok = motor_ident_wheel_fit(wheel);
+    
+    if (ok)
+        printf("IDENT %s gain=%f tau=%f deadtime=%f deadband=%f rms=%f\r\n", name,
+               wheel->model.gain, wheel->model.tau, wheel->model.deadtime, wheel->model.deadband, wheel->fit_rms);
+    else
+        printf("IDENT %s failed: %d\r\n", name, wheel->error);
+    return ok;
+}
+
+/**
+ * @brief  ʶ
+ * @param  
+ * @return 1-־ɹдģ 0-δʧ
+ * @note   ѭеáģͷֱд car.left_motor.model / car.right_motor.modelٶȻٶPIDǰʹã
+ *         ƽ MOTOR_MODEL_* 깩д motor_control.h
+ */
+uint8 motor_ident_poll(void)
+{
+    if (!motor_ident.finished)
+        return 0;
+    motor_ident.finished = 0;
+    
+    uint8 left_ok = motor_ident_report("L", &motor_ident.left);
+    uint8 right_ok = motor_ident_report("R", &motor_ident.right);
+    if (!left_ok || !right_ok)
+        return 0;
+    
+    car.left_motor.model = motor_ident.left.model;
+    car.right_motor.model = motor_ident.right.model;
+    
+    printf("#define MOTOR_MODEL_GAIN        %ff\r\n", 0.5f * (motor_ident.left.model.gain + motor_ident.right.model.gain));
+    printf("#define MOTOR_MODEL_TAU         %ff\r\n", 0.5f * (motor_ident.left.model.tau + motor_ident.right.model.tau));
+    printf("#define MOTOR_MODEL_DEADTIME    %ff\r\n", 0.5f * (motor_ident.left.model.deadtime + motor_ident.right.model.deadtime));
+    printf("#define MOTOR_MODEL_DEADBAND    %ff\r\n", 0.5f * (motor_ident.left.model.deadband + motor_ident.right.model.deadband));
+    return 1;
+}
+
+/**
+ * @brief  еģͱʶ
+ * @param  
+ * @return 1-־ɹдģ 0-δܿʼʶʧ
+ * @note   ǰѭеãMOTOR_IDENT_ON_BOOT1msжѿգ
+ *         Լ MOTOR_IDENT_SEGMENTS x MOTOR_IDENT_HOLD_MS봮ͬmotor_ident_poll()
+ */
+uint8 motor_ident_run(void)
+{
+    if (!motor_ident_start())
+    {
+        printf("IDENT busy or car running\r\n");
+        return 0;
+    }
+    while (motor_ident.active)
+        system_delay_ms(10);
+    return motor_ident_poll();
+}
+#endif
@@ -0,0 +1,109 @@
+#ifndef _MOTOR_IDENT_H_
+#define _MOTOR_IDENT_H_
+
+#ifdef PID_HOST
+// λԱ루tools/motor_ident_sim.cֻԾʶ㷨
+#ifndef PID_HOST_TYPES
+#define PID_HOST_TYPES
+#include <stdint.h>
+typedef uint8_t  uint8;
+typedef int8_t   int8;
+typedef uint16_t uint16;
+typedef int16_t  int16;
+typedef uint32_t uint32;
+typedef int32_t  int32;
+typedef int64_t  int64;
+#endif
+typedef struct
+{
+    float gain;
+    float tau;
+    float deadtime;
+    float deadband;
+} motor_model_t;
+#else
+#include "zf_common_headfile.h"
+#include "motor_control.h"
+#endif
+
+//====================================================ʶ====================================================
+#define MOTOR_IDENT_ON_BOOT         0           // ϵ󷢳ǰһεģͱʶ (1-, 0-)
+#define MOTOR_IDENT_BOOT_DELAY_MS   5000        // ϵʶĵȴʱ (ms)SPEED_AUTOTUNE_ON_BOOTͬʱʱȴ
+// ԾʶգͬʱռձиHOLD_MS¼٣
+// ĩβƽٶռձԻعμԾӦ28.3%/63.2%ʱ̵ʱ䳣봿ӳ
+#define MOTOR_IDENT_SAMPLE_MS       5           // ٲ (ms)/
+#define MOTOR_IDENT_HOLD_MS         500         // ÿαʱ (ms)5ʱ䳣
+#define MOTOR_IDENT_STEADY_MS       150         // ÿĩβȡƽΪ̬ٵʱ (ms)
+#define MOTOR_IDENT_SEGMENTS        4           // 
+#define MOTOR_IDENT_LEVELS          {2000, 3500, 5000, 2000}    // ռձȣ0δӾֹ𲽣ΪԾһ½
+#define MOTOR_IDENT_SAMPLES         (MOTOR_IDENT_HOLD_MS / MOTOR_IDENT_SAMPLE_MS)
+#define MOTOR_IDENT_MAX_SPEED       4000.0f     // ٳֵ (mm/s) ֹͣ
+#define MOTOR_IDENT_MIN_SPEED       100.0f      // 0̬ٵڸֵ (mm/s) Ϊת쳣
+#define MOTOR_IDENT_MAX_FIT_ERROR   0.10f       // ģ͸RMS̬ٵĸñʱ
+
+//====================================================ݽṹ====================================================
+// ֱʶ״̬
+typedef enum
+{
+    MOTOR_IDENT_IDLE = 0,                       // δ
+    MOTOR_IDENT_RUN,                            // нԾ
+    MOTOR_IDENT_DONE,                           // ¼ɣȴ
+    MOTOR_IDENT_FAILED                          // ʧܣerror
+} motor_ident_phase_enum;
+
+// ʧԭ
+typedef enum
+{
+    MOTOR_IDENT_OK = 0,
+    MOTOR_IDENT_ERR_STALL,                      // 𲽳ٹ
+    MOTOR_IDENT_ERR_OVERSPEED,                  // ٳ
+    MOTOR_IDENT_ERR_FIT,                        // ʧܣԾӦ
+    MOTOR_IDENT_ERR_ABORTED                     // ֹ
+} motor_ident_error_enum;
+
+// ֱʶ
+typedef struct
+{
+    motor_ident_phase_enum phase;
+    motor_ident_error_enum error;
+    uint8 started;                              // 0ռձȣǰĳ¼
+    uint8 segment;                              // ǰ
+    uint16 index;                               // 
+    int16 speed[MOTOR_IDENT_SEGMENTS][MOTOR_IDENT_SAMPLES]; //  (mm/s)
+    float steady[MOTOR_IDENT_SEGMENTS];         // ̬ (mm/s)
+    motor_model_t model;                        // ʶ
+    float fit_rms;                              // ģͰͬһռձиֵĳRMS (mm/s)
+} motor_ident_wheel_t;
+
+#ifndef PID_HOST
+// ʶṹ
+typedef struct
+{
+    volatile uint8 active;                      // ڱʶ1msж
+    volatile uint8 finished;                    // ־ѽȴѭ
+    uint8 divider;                              // жϷƵ
+    int32 left_last;                            // ϴβ̼ۼƼ
+    int32 right_last;
+    motor_ident_wheel_t left;                   // 
+    motor_ident_wheel_t right;                  // 
+} motor_ident_t;
+
+//====================================================ȫֱ====================================================
+extern motor_ident_t motor_ident;
+#endif
+
+//========================================================================================================
+// Ծʶ㷨Ӳ޹أ
+void  motor_ident_wheel_reset(motor_ident_wheel_t *wheel);
+int32 motor_ident_wheel_step(motor_ident_wheel_t *wheel, float speed);  // ÿ복 (mm/s)ռձ
+uint8 motor_ident_wheel_fit(motor_ident_wheel_t *wheel);               // ¼ɺģͣɹ1
+
+#ifndef PID_HOST
+void  motor_ident_init(void);                                   // ʼ
+uint8 motor_ident_start(void);                                  // ͣʱʼʶգɹ1
+void  motor_ident_update(void);                                 // 1msжеãԾռձ
+uint8 motor_ident_poll(void);                                   // ѭеãϡдֵģͲɹ1
+uint8 motor_ident_run(void);                                    // һαʶǰãɹ1
+#endif
+
+#endif // _MOTOR_IDENT_H_
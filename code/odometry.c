@@ -0,0 +1,209 @@
+#include "odometry.h"
+#include "yaw_control.h"
+#include <string.h>
+
+// ̼ȫֱ
+odometry_t odometry;
+
+/**
+ * @brief  ̼Ƴʼ
+ * @param  
+ * @return 
+ * @note   ÿ̰ENCODER_COUNT_PER_METERʼodometry_calibrate_start/finish()ʵ
+ */
+void odometry_init(void)
+{
+    memset(&odometry, 0, sizeof(odometry));
+    odometry.cos_heading = 1.0f;
+    odometry.mm_per_count_left = 1000.0f / ENCODER_COUNT_PER_METER;
+    odometry.mm_per_count_right = 1000.0f / ENCODER_COUNT_PER_METER;
+}
+
+/**
+ * @brief  ̼ƻ
+ * @param  
+ * @return 
+ * @note   ODOMETRY_PITжÿODOMETRY_PERIOD_MSһΣyaw_control_sample()֮󣩣̼ƶռ
+ *         ȡۼӵleft_total/right_totalmotor_update_speed()ֵٶȡ
+ *          = ǻٰODOMETRY_ENCODER_YAW_WEIGHTȨ
+ *         cos/sinСǶתһţٹһǺ
+ *         λð벽֡ǰż1ȡݴжǷ
+ */
+void odometry_update(void)
+{
+    int16 left = encoder_get_count(car.left_motor.encoder);
+    int16 right = -encoder_get_count(car.right_motor.encoder);
+    encoder_clear_count(car.left_motor.encoder);
+    encoder_clear_count(car.right_motor.encoder);
+    
+    odometry.left_total += left;
+    odometry.right_total += right;
+    
+    float dt = ODOMETRY_PERIOD_MS / 1000.0f;
+    float dl = (float)left * odometry.mm_per_count_left;
+    float dr = (float)right * odometry.mm_per_count_right;
+    float ds = (dl + dr) * 0.5f;
+    float dtheta = (dr - dl) / ODOMETRY_TRACK_WIDTH_MM;
+    
+    if (yaw_control.enable)
+    {
+        float gyro = yaw_control.gyro_z * ODOMETRY_GYRO_SIGN * (3.14159f / 180.0f) * dt;
+        dtheta = gyro + (dtheta - gyro) * ODOMETRY_ENCODER_YAW_WEIGHT;
+    }
+    
+    float c = odometry.cos_heading;
+    float s = odometry.sin_heading;
+    
+    if (odometry.reset_request)
+    {
+        c = 1.0f;
+        s = 0.0f;
+    }
+    
+    odometry.sequence++;                    // д
+    __dsync();
+    
+    if (odometry.reset_request)
+    {
+        odometry.pose.x = 0.0f;
+        odometry.pose.y = 0.0f;
+        odometry.pose.heading = 0.0f;
+        odometry.reset_request = 0;
+    }
+    
+    odometry.pose.x += ds * (c - s * dtheta * 0.5f);
+    odometry.pose.y += ds * (s + c * dtheta * 0.5f);
+    odometry.pose.heading += dtheta;
+    odometry.pose.distance += ds;
+    odometry.pose.speed += (ds / dt - odometry.pose.speed) * ODOMETRY_SPEED_FILTER;
+    odometry.pose.yaw_rate = dtheta / dt;
+    
+    odometry.tick++;
+    odometry.pose.timestamp_ms = odometry.tick * ODOMETRY_PERIOD_MS;
+    odometry.history[odometry.tick % ODOMETRY_HISTORY_SIZE] = odometry.pose;
+    
+    __dsync();
+    odometry.sequence++;                    // żд
+    
+    // cos(d)  1 - d^2/2, sin(d)  dȣٰ 1.5 - 0.5(c^2+s^2) һ
+    float half_sq = dtheta * dtheta * 0.5f;
+    float nc = c * (1.0f - half_sq) - s * dtheta;
+    float ns = s * (1.0f - half_sq) + c * dtheta;
+    float norm = 1.5f - 0.5f * (nc * nc + ns * ns);
+    
+    odometry.cos_heading = nc * norm;
+    odometry.sin_heading = ns * norm;
+}
+
+/**
+ * @brief  λ뺽
+ * @param  
+ * @return 
+ * @note   жһִУۼ̲㣨Ԫе
+ */
+void odometry_reset(void)
+{
+    odometry.reset_request = 1;
+}
+
+/**
+ * @brief  ȡλ˿
+ * @param  pose  λ
+ * @return 
+ * @note   ȡ/ĵãȡڼжϷλض
+ */
+void odometry_get_pose(odometry_pose_t *pose)
+{
+    uint32 sequence;
+    
+    do
+    {
+        sequence = odometry.sequence;
+        __dsync();
+        *pose = odometry.pose;
+        __dsync();
+    } while ((sequence & 1) || sequence != odometry.sequence);
+}
+
+/**
+ * @brief  ȡָʱ̵ʷλ
+ * @param  timestamp_ms  ʱ (ms)ͼعʱ
+ * @param  pose          λ
+ * @return 1-ҵʱ 0-ʷΧλˣ
+ * @note   ӳٲʱ̵ǰλ˱仯
+ */
+uint8 odometry_get_pose_at(uint32 timestamp_ms, odometry_pose_t *pose)
+{
+    uint32 sequence;
+    uint8 found;
+    
+    do
+    {
+        sequence = odometry.sequence;
+        __dsync();
+        
+        uint32 tick = odometry.tick;
+        uint32 want = timestamp_ms / ODOMETRY_PERIOD_MS;
+        uint32 age = tick - want;
+        
+        found = 1;
+        if (want > tick)
+        {
+            age = 0;
+            found = 0;
+        }
+        else if (age > ODOMETRY_HISTORY_SIZE - 1)
+        {
+            age = ODOMETRY_HISTORY_SIZE - 1;
+            found = 0;
+        }
+        *pose = odometry.history[(tick - age) % ODOMETRY_HISTORY_SIZE];
+        __dsync();
+    } while ((sequence & 1) || sequence != odometry.sequence);
+    
+    return found;
+}
+
+/**
+ * @brief  ȡۼ
+ * @param  
+ * @return ۼ (mm)ʱ
+ */
+int32 odometry_get_distance_mm(void)
+{
+    odometry_pose_t pose;
+    
+    odometry_get_pose(&pose);
+    return (int32)pose.distance;
+}
+
+/**
+ * @brief  ʼ̱궨
+ * @param  
+ * @return 
+ * @note   ͣãȻֱлʻһ֪
+ */
+void odometry_calibrate_start(void)
+{
+    odometry.calib_left_start = odometry.left_total;
+    odometry.calib_right_start = odometry.right_total;
+}
+
+/**
+ * @brief  ̱궨
+ * @param  actual_mm  ʵʻ (mm)
+ * @return 
+ * @note   ֱַ ʵ/ ỵ̈ͬʱ־
+ */
+void odometry_calibrate_finish(float actual_mm)
+{
+    int32 left = odometry.left_total - odometry.calib_left_start;
+    int32 right = odometry.right_total - odometry.calib_right_start;
+    
+    if (left > 0)
+        odometry.mm_per_count_left = actual_mm / (float)left;
+    if (right > 0)
+        odometry.mm_per_count_right = actual_mm / (float)right;
+    
+    printf("ODOM calib L %.4f R %.4f mm/count\r\n", odometry.mm_per_count_left, odometry.mm_per_count_right);
+}
@@ -0,0 +1,63 @@
+#ifndef _ODOMETRY_H_
+#define _ODOMETRY_H_
+
+#include "zf_common_headfile.h"
+#include "motor_control.h"
+
+//====================================================̼Ʋ====================================================
+#define ODOMETRY_PIT                CCU60_CH1   // жͨٶڻã
+#define ODOMETRY_PERIOD_MS          1           // ̼ƻ (ms)
+#define ODOMETRY_TRACK_WIDTH_MM     ((float)CAR_TRACK_WIDTH) // ־ (mm)ڲٺ
+#define ODOMETRY_GYRO_SIGN          (1)         // ZᳯʱʱΪװʱΪ-1
+#define ODOMETRY_ENCODER_YAW_WEIGHT 0.02f       // ںбٵȨأΪǣʱΪ1
+#define ODOMETRY_SPEED_FILTER       0.1f        // һ׵ͨϵ
+#define ODOMETRY_HISTORY_SIZE       64          // λʷȣڰʱز
+
+//====================================================ݽṹ====================================================
+// λ˿
+typedef struct
+{
+    float x;                        // Ϊx (mm)
+    float y;                        // Ϊy (mm)
+    float heading;                  //  (rad)ʱΪۼƲ
+    float distance;                 // ۼʻ (mm)ʱ
+    float speed;                    //  (mm/s)
+    float yaw_rate;                 // ٶ (rad/s)
+    uint32 timestamp_ms;            // ʱ (ms)
+} odometry_pose_t;
+
+// ̼ƽṹ
+typedef struct
+{
+    volatile uint32 sequence;       // ţʾд
+    odometry_pose_t pose;           // λ
+    odometry_pose_t history[ODOMETRY_HISTORY_SIZE]; // λʷtickδţ
+    
+    float cos_heading;              // ңתάÿǺ
+    float sin_heading;              // 
+    
+    int32 left_total;               // ۼƱжд
+    int32 right_total;              // ۼƱжд
+    float mm_per_count_left;        // ÿ (mm)ɱ궨
+    float mm_per_count_right;       // ÿ (mm)ɱ궨
+    int32 calib_left_start;         // 궨ּ
+    int32 calib_right_start;        // 궨ּ
+    
+    uint8 reset_request;            // һλ뺽
+    uint32 tick;                    // ڼ
+} odometry_t;
+
+//====================================================ȫֱ====================================================
+extern odometry_t odometry;
+
+//========================================================================================================
+void  odometry_init(void);                                          // ̼Ƴʼ
+void  odometry_update(void);                                        // жеãȡλ
+void  odometry_reset(void);                                         // λ뺽̲㣩
+void  odometry_get_pose(odometry_pose_t *pose);                     // ȡλ˿
+uint8 odometry_get_pose_at(uint32 timestamp_ms, odometry_pose_t *pose); // ȡָʱ̵ʷλ
+int32 odometry_get_distance_mm(void);                               // ȡۼ (mm)
+void  odometry_calibrate_start(void);                               // ʼ̱궨ֱʻǰã
+void  odometry_calibrate_finish(float actual_mm);                   // 궨ʵÿ
+
+#endif // _ODOMETRY_H_
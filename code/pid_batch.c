@@ -0,0 +1,212 @@
+#include "pid_batch.h"
+#include <string.h>
+
+/**
+ * @brief  տ
+ * @param  batch  PID
+ * @return 
+ */
+void pid_batch_init(pid_batch_t *batch)
+{
+    memset(batch, 0, sizeof(*batch));
+}
+
+/**
+ * @brief  ӿ
+ * @param  batch       PID
+ * @param  kp          ϵ
+ * @param  ki          ϵ
+ * @param  kd          ΢ϵ
+ * @param  output_max  ֵ
+ * @param  output_min  Сֵ
+ * @return ±꣬-1
+ * @note   Ĭpid_init()һ£λʽ΢Ҳ˲޷㡢޷Ϊֵ80%
+ *         ʱpid_batch_calculate()pid_calculate()Ľλͬ
+ */
+int8 pid_batch_add(pid_batch_t *batch, float kp, float ki, float kd, float output_max, float output_min)
+{
+    if (batch->count >= PID_BATCH_MAX)
+        return -1;
+
+    uint8 i = batch->count++;
+
+    batch->mode[i] = PID_BATCH_POSITIONAL;
+    batch->d_on_measurement[i] = 0;
+    batch->d_alpha[i] = 1.0f;
+    batch->kt[i] = 0.0f;
+    batch->output_max[i] = output_max;
+    batch->output_min[i] = output_min;
+    batch->integral_max[i] = output_max * 0.8f;
+    pid_batch_set_gains(batch, i, kp, ki, kd);
+    pid_batch_reset(batch, i);
+
+    return (int8)i;
+}
+
+/**
+ * @brief  PID
+ * @param  batch  PID
+ * @param  index  ±
+ * @param  kp     ϵ
+ * @param  ki     ϵ
+ * @param  kd     ΢ϵ
+ * @return 
+ */
+void pid_batch_set_gains(pid_batch_t *batch, uint8 index, float kp, float ki, float kd)
+{
+    batch->kp[index] = kp;
+    batch->ki[index] = ki;
+    batch->kd[index] = kd;
+    batch->kt_over_ki[index] = (ki > 0.0f) ? batch->kt[index] / ki : 0.0f;
+}
+
+/**
+ * @brief  üʽ
+ * @param  batch  PID
+ * @param  index  ±
+ * @param  mode   λʽ/ʽ
+ * @return 
+ * @note   л״̬
+ */
+void pid_batch_set_mode(pid_batch_t *batch, uint8 index, pid_batch_mode_enum mode)
+{
+    batch->mode[index] = (uint8)mode;
+    pid_batch_reset(batch, index);
+}
+
+/**
+ * @brief  ΢ֶ˲
+ * @param  batch           PID
+ * @param  index           ±
+ * @param  on_measurement  1-Բֵ΢֣Ŀͻ䲻΢ֳ, 0-΢
+ * @param  alpha           һ׵ͨϵ (0~1]1Ϊ˲
+ * @return 
+ */
+void pid_batch_set_derivative(pid_batch_t *batch, uint8 index, uint8 on_measurement, float alpha)
+{
+    if (alpha <= 0.0f || alpha > 1.0f)
+        alpha = 1.0f;
+
+    batch->d_on_measurement[index] = on_measurement;
+    batch->d_alpha[index] = alpha;
+}
+
+/**
+ * @brief  ÷㿹ϵ
+ * @param  batch  PID
+ * @param  index  ±
+ * @param  kt     ÿڴӻıͳ (0~1)0Ϊ޷
+ * @return 
+ * @note   ֻλʽЧʽ޷Ϊ´㣬ֱ
+ */
+void pid_batch_set_antiwindup(pid_batch_t *batch, uint8 index, float kt)
+{
+    batch->kt[index] = kt;
+    pid_batch_set_gains(batch, index, batch->kp[index], batch->ki[index], batch->kd[index]);
+}
+
+/**
+ * @brief  û޷
+ * @param  batch  PID
+ * @param  index  ±
+ * @param  limit  ޷ۼֵ
+ * @return 
+ */
+void pid_batch_set_integral_limit(pid_batch_t *batch, uint8 index, float limit)
+{
+    batch->integral_max[index] = limit;
+}
+
+/**
+ * @brief  ״̬
+ * @param  batch  PID
+ * @param  index  ±
+ * @return 
+ */
+void pid_batch_reset(pid_batch_t *batch, uint8 index)
+{
+    batch->error[index] = 0.0f;
+    batch->last_error[index] = 0.0f;
+    batch->last_measurement[index] = 0.0f;
+    batch->integral[index] = 0.0f;
+    batch->derivative[index] = 0.0f;
+    batch->last_feedforward[index] = 0.0f;
+    batch->primed[index] = 0;
+    batch->output[index] = 0.0f;
+}
+
+/**
+ * @brief  ȫ
+ * @param  batch  PID
+ * @return 
+ * @note   һεñп״̬ţʡȥpid_calculate()ĺṹѰַ
+ *         λʽۼӲ޷ -> u = Kpe + KiI + D + FF -> ޷ -> ktѳӻлˣ
+ *         ʽu = u[k-1] + Kpe + Kie + D + FF -> ޷
+ *         ΢ D = Kde  -Kdyپһ׵ͨ
+ */
+void pid_batch_calculate(pid_batch_t *batch)
+{
+    for (uint8 i = 0; i < batch->count; i++)
+    {
+        float measurement = batch->measurement[i];
+        float error = batch->target[i] - measurement;
+        float feedforward = batch->feedforward[i];
+
+        // ΢
+        float d_raw;
+        if (!batch->d_on_measurement[i])
+            d_raw = batch->kd[i] * (error - batch->last_error[i]);
+        else if (batch->primed[i])
+            d_raw = -batch->kd[i] * (measurement - batch->last_measurement[i]);
+        else
+            d_raw = 0.0f;
+
+        float d_last = batch->derivative[i];
+        float d_out = (batch->d_alpha[i] >= 1.0f) ? d_raw : d_last + batch->d_alpha[i] * (d_raw - d_last);
+
+        float output;
+        if (batch->mode[i] == PID_BATCH_POSITIONAL)
+        {
+            // ޷
+            float integral = batch->integral[i] + error;
+            if (integral > batch->integral_max[i])
+                integral = batch->integral_max[i];
+            else if (integral < -batch->integral_max[i])
+                integral = -batch->integral_max[i];
+
+            float unclamped = batch->kp[i] * error + batch->ki[i] * integral + d_out + feedforward;
+
+            output = unclamped;
+            if (output > batch->output_max[i])
+                output = batch->output_max[i];
+            else if (output < batch->output_min[i])
+                output = batch->output_min[i];
+
+            // 㿹ͣʱѳktӻп۳
+            if (output != unclamped)
+                integral += batch->kt_over_ki[i] * (output - unclamped);
+            batch->integral[i] = integral;
+        }
+        else
+        {
+            output = batch->output[i]
+                   + batch->kp[i] * (error - batch->last_error[i])
+                   + batch->ki[i] * error
+                   + (d_out - d_last)
+                   + (feedforward - batch->last_feedforward[i]);
+
+            if (output > batch->output_max[i])
+                output = batch->output_max[i];
+            else if (output < batch->output_min[i])
+                output = batch->output_min[i];
+        }
+
+        batch->error[i] = error;
+        batch->last_error[i] = error;
+        batch->last_measurement[i] = measurement;
+        batch->last_feedforward[i] = feedforward;
+        batch->derivative[i] = d_out;
+        batch->primed[i] = 1;
+        batch->output[i] = output;
+    }
+}
@@ -0,0 +1,80 @@
+#ifndef _PID_BATCH_H_
+#define _PID_BATCH_H_
+
+#ifdef PID_HOST
+// λԱ루tools/pid_batch_bench.c
+#ifndef PID_HOST_TYPES
+#define PID_HOST_TYPES
+#include <stdint.h>
+typedef uint8_t  uint8;
+typedef int8_t   int8;
+typedef uint16_t uint16;
+typedef int16_t  int16;
+typedef uint32_t uint32;
+typedef int32_t  int32;
+typedef int64_t  int64;
+#endif
+#else
+#include "zf_common_headfile.h"
+#endif
+
+//====================================================PID====================================================
+#define PID_BATCH_MAX               8           // ÿ
+
+//====================================================ݽṹ====================================================
+// ʽ
+typedef enum
+{
+    PID_BATCH_POSITIONAL = 0,                   // λʽu = P + I + D + FF
+    PID_BATCH_INCREMENTAL                       // ʽu += P + Kie + D + FFͺΪ´㣬Ȼͣ
+} pid_batch_mode_enum;
+
+// PIDṹʽͬһ±Ϊͬһ
+// ÿɵд target[] / measurement[] / feedforward[]pid_batch_calculate() ȡ output[]
+typedef struct
+{
+    uint8 count;                                // 
+    uint8 mode[PID_BATCH_MAX];                  // ʽ (pid_batch_mode_enum)
+    uint8 d_on_measurement[PID_BATCH_MAX];      // ΢ֶ (1-ֵĿͻ䲻, 0-pid_tһ)
+
+    // 
+    float kp[PID_BATCH_MAX];                    // ϵ
+    float ki[PID_BATCH_MAX];                    // ϵ
+    float kd[PID_BATCH_MAX];                    // ΢ϵ
+    float d_alpha[PID_BATCH_MAX];               // ΢һ׵ͨϵ (0~1]1Ϊ˲
+    float kt[PID_BATCH_MAX];                    // 㿹ϵ (0~1)ÿͳı0Ϊ޷
+    float kt_over_ki[PID_BATCH_MAX];            // kt/kiΪۼֵʱķ
+    float integral_max[PID_BATCH_MAX];          // ޷ۼֵ
+    float output_max[PID_BATCH_MAX];            // ֵ
+    float output_min[PID_BATCH_MAX];            // Сֵ
+
+    // 
+    float target[PID_BATCH_MAX];                // Ŀֵ
+    float measurement[PID_BATCH_MAX];           // ֵ
+    float feedforward[PID_BATCH_MAX];           // ǰֱӵӵ޷뿹ͣ
+
+    // ״̬
+    float error[PID_BATCH_MAX];                 // ǰ
+    float last_error[PID_BATCH_MAX];            // ϴ
+    float last_measurement[PID_BATCH_MAX];      // ϴβֵ
+    float integral[PID_BATCH_MAX];              // ۻۼӣpid_tһ£
+    float derivative[PID_BATCH_MAX];            // ˲΢
+    float last_feedforward[PID_BATCH_MAX];      // ϴǰʽ
+    uint8 primed[PID_BATCH_MAX];                // ϴβֵλһ΢Ϊ0
+
+    // 
+    float output[PID_BATCH_MAX];                // ֵ
+} pid_batch_t;
+
+//========================================================================================================
+void  pid_batch_init(pid_batch_t *batch);                                                   // տ
+int8  pid_batch_add(pid_batch_t *batch, float kp, float ki, float kd, float output_max, float output_min); // ӿ±꣨-1
+void  pid_batch_set_gains(pid_batch_t *batch, uint8 index, float kp, float ki, float kd);   // PID
+void  pid_batch_set_mode(pid_batch_t *batch, uint8 index, pid_batch_mode_enum mode);        // üʽ
+void  pid_batch_set_derivative(pid_batch_t *batch, uint8 index, uint8 on_measurement, float alpha); // ΢ֶ˲
+void  pid_batch_set_antiwindup(pid_batch_t *batch, uint8 index, float kt);                  // ÷㿹ϵ
+void  pid_batch_set_integral_limit(pid_batch_t *batch, uint8 index, float limit);           // û޷
+void  pid_batch_reset(pid_batch_t *batch, uint8 index);                                     // ״̬
+void  pid_batch_calculate(pid_batch_t *batch);                                              // ȫ
+
+#endif // _PID_BATCH_H_
@@ -46,6 +46,12 @@ void pid_init(pid_t *pid, float kp, float ki, float kd, float output_max, float
     
     // ޷Ϊֵ80%
     pid->integral_max = output_max * 0.8f;
+    
+    // ״̬
+    pid->integral_q16 = 0;
+    pid->last_error_q = 0;
+    pid->output_q16   = 0;
+    pid_sync_q16(pid);
 }
 
 /**
@@ -112,6 +118,66 @@ void pid_reset(pid_t *pid)
     pid->last_error = 0;
     pid->integral = 0;
     pid->output = 0;
+    
+    pid->integral_q16 = 0;
+    pid->last_error_q = 0;
+    pid->output_q16 = 0;
+}
+
+/**
+ * @brief  PID
+ * @param  pid      PIDṹָ
+ * @param  target   ĿֵӾƫ
+ * @param  current  ǰֵ
+ * @return PIDֵ (Q16)
+ * @note   pid_calculate()ͬλʽ㷨ΪΪQ16ۼӣ
+ *         64λۼӺ޷ֻ˼λִʱ̶
+ *         븡ĲֻԲQ16
+ */
+q16_t pid_calculate_q16(pid_t *pid, int32 target, int32 current)
+{
+    int32 error = target - current;
+    
+    // ޷
+    int64 integral = (int64)pid->integral_q16 + Q16_FROM_INT(error);
+    if (integral > pid->integral_max_q16)
+        integral = pid->integral_max_q16;
+    else if (integral < -pid->integral_max_q16)
+        integral = -pid->integral_max_q16;
+    pid->integral_q16 = (q16_t)integral;
+    
+    int64 output = (int64)pid->kp_q16 * error
+                 + (((int64)pid->ki_q16 * pid->integral_q16) >> Q16_SHIFT)
+                 + (int64)pid->kd_q16 * (error - pid->last_error_q);
+    
+    // ޷
+    if (output > pid->output_max_q16)
+        output = pid->output_max_q16;
+    else if (output < pid->output_min_q16)
+        output = pid->output_min_q16;
+    
+    pid->last_error_q = error;
+    pid->output_q16 = (q16_t)output;
+    
+    return pid->output_q16;
+}
+
+/**
+ * @brief  ͬ
+ * @param  pid  PIDṹָ
+ * @return 
+ * @note   úڲѵãֱֻдkp/ki/kdֶʱλΣҪֶ
+ */
+void pid_sync_q16(pid_t *pid)
+{
+    pid->kp_q16 = Q16_FROM_FLOAT(pid->kp);
+    pid->ki_q16 = Q16_FROM_FLOAT(pid->ki);
+    pid->kd_q16 = Q16_FROM_FLOAT(pid->kd);
+    pid->output_max_q16 = Q16_FROM_FLOAT(pid->output_max);
+    pid->output_min_q16 = Q16_FROM_FLOAT(pid->output_min);
+    
+    // ޷Q16ʾΧʱ޴
+    pid->integral_max_q16 = (pid->integral_max < 32767.0f) ? Q16_FROM_FLOAT(pid->integral_max) : Q16_FROM_INT(32767);
 }
 
 //====================================================PID̬====================================================
@@ -128,6 +194,46 @@ void pid_set_params(pid_t *pid, float kp, float ki, float kd)
     pid->kp = kp;
     pid->ki = ki;
     pid->kd = kd;
+    pid_sync_q16(pid);
+}
+
+/**
+ * @brief  лPID
+ * @param  pid  PIDṹָ
+ * @param  kp   ϵ
+ * @param  ki   ϵ
+ * @param  kd   ΢ϵ
+ * @return 
+ * @note    ki_old/ki_new Żۻʹл˲ ki*integral ֲ䣻
+ *         KiΪ0ʱãۻ㣬֮KiָʱʱĻ֣
+ *         ԭKiΪ0ʱΪ0źۻͬΪ0
+ */
+void pid_set_params_bumpless(pid_t *pid, float kp, float ki, float kd)
+{
+    if (ki < 1e-6f && ki > -1e-6f)
+    {
+        pid->integral = 0.0f;
+        pid->integral_q16 = 0;
+    }
+    else if (ki != pid->ki)
+    {
+        pid->integral = pid->integral * pid->ki / ki;
+        if (pid->integral > pid->integral_max)
+            pid->integral = pid->integral_max;
+        else if (pid->integral < -pid->integral_max)
+            pid->integral = -pid->integral_max;
+        
+        pid->integral_q16 = (q16_t)((float)pid->integral_q16 * pid->ki / ki);
+        if (pid->integral_q16 > pid->integral_max_q16)
+            pid->integral_q16 = pid->integral_max_q16;
+        else if (pid->integral_q16 < -pid->integral_max_q16)
+            pid->integral_q16 = -pid->integral_max_q16;
+    }
+    
+    pid->kp = kp;
+    pid->ki = ki;
+    pid->kd = kd;
+    pid_sync_q16(pid);
 }
 
 /**
@@ -139,6 +245,7 @@ void pid_set_params(pid_t *pid, float kp, float ki, float kd)
 void pid_set_kp(pid_t *pid, float kp)
 {
     pid->kp = kp;
+    pid_sync_q16(pid);
 }
 
 /**
@@ -150,6 +257,7 @@ void pid_set_kp(pid_t *pid, float kp)
 void pid_set_ki(pid_t *pid, float ki)
 {
     pid->ki = ki;
+    pid_sync_q16(pid);
 }
 
 /**
@@ -161,6 +269,7 @@ void pid_set_ki(pid_t *pid, float ki)
 void pid_set_kd(pid_t *pid, float kd)
 {
     pid->kd = kd;
+    pid_sync_q16(pid);
 }
 
 /**
@@ -174,6 +283,7 @@ void pid_set_output_limit(pid_t *pid, float max, float min)
 {
     pid->output_max = max;
     pid->output_min = min;
+    pid_sync_q16(pid);
 }
 
 /**
@@ -185,6 +295,7 @@ void pid_set_output_limit(pid_t *pid, float max, float min)
 void pid_set_integral_limit(pid_t *pid, float limit)
 {
     pid->integral_max = limit;
+    pid_sync_q16(pid);
 }
 
 //====================================================PIDȡ====================================================
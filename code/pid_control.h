@@ -14,7 +14,7 @@
 #ifndef _PID_CONTROL_H_
 #define _PID_CONTROL_H_
 
-#include "zf_common_headfile.h"
+#include "fixed_point.h"
 
 //====================================================ݽṹ====================================================
 // PIDṹ
@@ -36,6 +36,17 @@ typedef struct
     float output_min;           // Сֵ
     
     float integral_max;         // ޷
+    
+    // 㣨CONTROL_FIXED_POINTɲúͬ
+    q16_t kp_q16;               // ϵ (Q16)
+    q16_t ki_q16;               // ϵ (Q16)
+    q16_t kd_q16;               // ΢ϵ (Q16)
+    q16_t output_max_q16;       // ֵ (Q16)
+    q16_t output_min_q16;       // Сֵ (Q16)
+    q16_t integral_max_q16;     // ޷ (Q16)
+    q16_t integral_q16;         // ۻ (Q16ۼӣлźС)
+    int32 last_error_q;         // ϴ
+    q16_t output_q16;           // ֵ (Q16)
 } pid_t;
 
 //========================================================================================================
@@ -44,9 +55,12 @@ void  pid_init(pid_t *pid, float kp, float ki, float kd, float output_max, float
 void  pid_set_target(pid_t *pid, float target);
 float pid_calculate(pid_t *pid, float current);
 void  pid_reset(pid_t *pid);
+q16_t pid_calculate_q16(pid_t *pid, int32 target, int32 current);  // PID㣨룬Q16
+void  pid_sync_q16(pid_t *pid);                                     // ֱ޸Ĳֶκͬ
 
 // PID̬
 void  pid_set_params(pid_t *pid, float kp, float ki, float kd);        // PID
+void  pid_set_params_bumpless(pid_t *pid, float kp, float ki, float kd); // PID
 void  pid_set_kp(pid_t *pid, float kp);                                // Kp
 void  pid_set_ki(pid_t *pid, float ki);                                // Ki
 void  pid_set_kd(pid_t *pid, float kd);                                // Kd
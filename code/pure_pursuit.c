@@ -0,0 +1,263 @@
+#include "pure_pursuit.h"
+#include "odometry.h"
+#include "steer_predict.h"
+#include "smart_car.h"
+#include <math.h>
+#include <string.h>
+
+// ȫֱ
+pure_pursuit_t pure_pursuit;
+
+/**
+ * @brief  ٳʼ
+ * @param  
+ * @return 
+ */
+void pure_pursuit_init(void)
+{
+    memset(&pure_pursuit, 0, sizeof(pure_pursuit));
+}
+
+/**
+ * @brief  ʶӦת
+ * @param  curvature   (1/m)Ϊ
+ * @return ת ()뷽PIDͬ
+ * @note    = atan(L)
+ */
+static float pure_pursuit_steer(float curvature)
+{
+    float delta = atanf(CAR_WHEELBASE / 1000.0f * curvature) * 180.0f / 3.14159f;
+    delta *= PURE_PURSUIT_GAIN * PURE_PURSUIT_SIGN;
+    
+    if (delta > SERVO_MAX_ANGLE)
+        delta = SERVO_MAX_ANGLE;
+    else if (delta < -SERVO_MAX_ANGLE)
+        delta = -SERVO_MAX_ANGLE;
+    
+    return delta;
+}
+
+/**
+ * @brief  ȡԤ
+ * @param  path       
+ * @param  dx         ǰ (m)
+ * @param  dy          (m)
+ * @param  dpsi       ת (rad)
+ * @param  lookahead  Ԥ (m)
+ * @param  target_x   Ԥ (m)
+ * @param  target_y   Ԥǰ (m)
+ * @return ԲԤ  = 2x / (x^2 + y^2) (1/m)Ϊ
+ * @note   ߵȻ㵽ǰϵԽԶҵһĲСԤĵ㣬ǰһ㰴Բֵ
+ *         ɼΧԤʱȡԶ
+ */
+static float pure_pursuit_track(const pure_pursuit_path_t *path, float dx, float dy, float dpsi, float lookahead,
+                                float *target_x, float *target_y)
+{
+    float c = cosf(dpsi);
+    float s = sinf(dpsi);
+    float last_x = 0.0f;
+    float last_y = 0.0f;
+    float last_r = 0.0f;
+    
+    for (uint8 i = 0; i < path->count; i++)
+    {
+        // عʱϵxҡyǰ -> ǰϵƽ(dxǰ, dy)ת-d
+        float forward = path->y[i] - dx;
+        float left = -path->x[i] - dy;
+        float y = c * forward + s * left;
+        float x = -(-s * forward + c * left);
+        float r = sqrtf(x * x + y * y);
+    
+        if (r >= lookahead)
+        {
+            if (i > 0 && r > last_r)
+            {
+                float t = (lookahead - last_r) / (r - last_r);
+                x = last_x + (x - last_x) * t;
+                y = last_y + (y - last_y) * t;
+            }
+            last_x = x;
+            last_y = y;
+            break;
+        }
+    
+        last_x = x;
+        last_y = y;
+        last_r = r;
+    }
+    
+    *target_x = last_x;
+    *target_y = last_y;
+    
+    float distance_sq = last_x * last_x + last_y * last_y;
+    if (distance_sq < 1e-4f)
+        return 0.0f;
+    return 2.0f * last_x / distance_sq;
+}
+
+/**
+ * @brief  Ԥ
+ * @param  speed   (mm/s)
+ * @return Ԥ (m)Ld = MIN + TIMEv޷ [MIN, MAX]
+ * @note   Ԥ복ٳʱջ̬ưʻʱչͬһڲͬ
+ */
+static float pure_pursuit_lookahead(float speed)
+{
+    float lookahead = PURE_PURSUIT_LOOKAHEAD_MIN + PURE_PURSUIT_LOOKAHEAD_TIME * fabsf(speed) * 0.001f;
+    
+    if (lookahead > PURE_PURSUIT_LOOKAHEAD_MAX)
+        lookahead = PURE_PURSUIT_LOOKAHEAD_MAX;
+    return lookahead;
+}
+
+/**
+ * @brief  ¼֡־
+ * @param  path  ֡
+ * @param  pose  ǰλ
+ * @return 
+ */
+static void pure_pursuit_log_frame(const pure_pursuit_path_t *path, const odometry_pose_t *pose)
+{
+#if PURE_PURSUIT_LOG_ENABLE
+    if (!pure_pursuit.log_enable || smart_car.state != CAR_RUNNING || pure_pursuit.log_count >= PURE_PURSUIT_LOG_FRAMES)
+        return;
+    if (++pure_pursuit.log_divider < PURE_PURSUIT_LOG_DECIMATE)
+        return;
+    pure_pursuit.log_divider = 0;
+    
+    pure_pursuit_log_t *log = &pure_pursuit.log[pure_pursuit.log_count++];
+    
+    log->timestamp_ms = path->timestamp_ms;
+    log->speed = (int16)pose->speed;
+    log->yaw_rate = (int16)(pose->yaw_rate * 1000.0f);
+    log->steer = (int16)(car.steering_servo.current_angle_q16 * 10 / Q16_ONE);
+    log->frame_output = (int16)(pure_pursuit.frame_output * 10.0f);
+    log->mode = smart_car.lateral_mode;
+    log->stop_line = (uint8)Search_Stop_Line;
+    
+    for (uint8 i = 0; i < PURE_PURSUIT_LOG_ROWS; i++)
+    {
+        uint8 row = PURE_PURSUIT_LOG_ROW_TOP + i;
+        uint8 valid = vision.track.track_width[row] >= TRACK_WIDTH_MIN && vision.track.track_width[row] <= TRACK_WIDTH_MAX;
+        log->center[i] = valid ? vision.track.center_line[row] : 0xFF;
+    }
+#endif
+}
+
+/**
+ * @brief  ÿ֡
+ * @param  
+ * @return 
+ * @note   vision_image_process()֮áٶȹ滮ͬķʽֻ߲ȡֹ£
+ *         ÿе㵽ϵдǻ֡л±ꣻͬʱǰ֡תǹ־ʹ
+ */
+void pure_pursuit_update(void)
+{
+    pure_pursuit_path_t *path = &pure_pursuit.path[pure_pursuit.active ^ 1];
+    int top_row = IMAGE_HEIGHT - Search_Stop_Line;
+    uint8 count = 0;
+    odometry_pose_t pose;
+    
+    path->timestamp_ms = steer_predict_frame_timestamp();
+    
+    if (vision.track_found)
+    {
+        for (int row = IMAGE_HEIGHT - 1; row >= top_row && row >= 0 && count < PURE_PURSUIT_MAX_POINTS;
+             row -= PURE_PURSUIT_ROW_STEP)
+        {
+            if (Row_Distance[row] <= 0.0f)
+                break;
+            if (vision.track.track_width[row] < TRACK_WIDTH_MIN || vision.track.track_width[row] > TRACK_WIDTH_MAX)
+                continue;
+    
+            vision_pixel_to_world((uint8)row, vision.track.center_line[row], &path->x[count], &path->y[count]);
+            path->y[count] += PURE_PURSUIT_CAMERA_OFFSET;
+            count++;
+        }
+    }
+    path->count = count;
+    
+    odometry_get_pose(&pose);
+    if (count > 0)
+    {
+        float x, y;
+        float curvature = pure_pursuit_track(path, 0.0f, 0.0f, 0.0f, pure_pursuit_lookahead(pose.speed), &x, &y);
+        pure_pursuit.frame_output = pure_pursuit_steer(curvature);
+    }
+    pure_pursuit_log_frame(path, &pose);
+    
+    pure_pursuit.active ^= 1;
+}
+
+/**
+ * @brief  ת
+ * @param  
+ * @return ת ()뷽PIDͬ
+ * @note   ڵáSTEER_PREDICT_ENABLEʱ߰عʱ̵ǰλ˱仯㵽ǰϵӳٲ
+ *         Ԥ泵ӣʱϴ
+ */
+float pure_pursuit_compute(void)
+{
+    const pure_pursuit_path_t *path = &pure_pursuit.path[pure_pursuit.active];
+    float dx = 0.0f, dy = 0.0f, dpsi = 0.0f;
+    odometry_pose_t pose;
+    
+    if (path->count == 0)
+        return pure_pursuit.output;
+    
+    odometry_get_pose(&pose);
+#if STEER_PREDICT_ENABLE
+    steer_predict_motion(path->timestamp_ms, &dx, &dy, &dpsi);
+#endif
+    
+    pure_pursuit.lookahead = pure_pursuit_lookahead(pose.speed);
+    pure_pursuit.curvature = pure_pursuit_track(path, dx, dy, dpsi, pure_pursuit.lookahead,
+                                                &pure_pursuit.target_x, &pure_pursuit.target_y);
+    pure_pursuit.output = pure_pursuit_steer(pure_pursuit.curvature);
+    
+    return pure_pursuit.output;
+}
+
+/**
+ * @brief  ʼ¼֡־
+ * @param  
+ * @return 
+ * @note   ¼PURE_PURSUIT_LOG_FRAMES֡ͣΪֹͣѭ
+ */
+void pure_pursuit_log_start(void)
+{
+    pure_pursuit.log_enable = PURE_PURSUIT_LOG_ENABLE;
+    pure_pursuit.log_divider = 0;
+    pure_pursuit.log_count = 0;
+    pure_pursuit.dump_pending = 0;
+}
+
+/**
+ * @brief  ֡־
+ * @param  
+ * @return 
+ * @note   PPLOG <֡> <> <> <ͷƫmm>
+ *         PPFRAME <> <ʱms> <mm/s> <ٶmrad/s> <0.1> <0.1> <ʽ> <ֹ> <ʮ>
+ */
+void pure_pursuit_log_dump(void)
+{
+    pure_pursuit.dump_pending = 0;
+    pure_pursuit.log_enable = 0;
+    
+    printf("PPLOG %d %d %d %d\r\n", pure_pursuit.log_count, PURE_PURSUIT_LOG_ROW_TOP, PURE_PURSUIT_LOG_ROWS,
+           (int)(PURE_PURSUIT_CAMERA_OFFSET * 1000.0f));
+#if PURE_PURSUIT_LOG_ENABLE
+    for (uint16 i = 0; i < pure_pursuit.log_count; i++)
+    {
+        const pure_pursuit_log_t *log = &pure_pursuit.log[i];
+    
+        printf("PPFRAME %d %lu %d %d %d %d %d %d ", i, (unsigned long)log->timestamp_ms, log->speed, log->yaw_rate,
+               log->steer, log->frame_output, log->mode, log->stop_line);
+        for (uint8 j = 0; j < PURE_PURSUIT_LOG_ROWS; j++)
+        {
+            printf("%02X", log->center[j]);
+        }
+        printf("\r\n");
+    }
+#endif
+}
@@ -0,0 +1,89 @@
+#ifndef _PURE_PURSUIT_H_
+#define _PURE_PURSUIT_H_
+
+#include "zf_common_headfile.h"
+#include "vision_track.h"
+#include "motor_control.h"
+
+//====================================================ٲ====================================================
+#define PURE_PURSUIT_DEFAULT        0           // ϵʱĺƷʽ (1-, 0-ƫPID)пλͨ6л
+#define PURE_PURSUIT_LOOKAHEAD_MIN  0.35f       // СԤ (m)Ӻ
+#define PURE_PURSUIT_LOOKAHEAD_MAX  1.00f       // Ԥ (m)
+#define PURE_PURSUIT_LOOKAHEAD_TIME 0.20f       // Ԥ泵ӵʱ (s)Ld = MIN + TIMEv
+#define PURE_PURSUIT_CAMERA_OFFSET  0.12f       // ͷͶӰںǰľ (m)ʵ
+#define PURE_PURSUIT_GAIN           1.0f        // תϵ1Ϊֵ
+#define PURE_PURSUIT_SIGN           (-1)        // 뷽PIDͬԤҲʱ"ƫΪ"ʱķPIDͬ
+
+#define PURE_PURSUIT_ROW_STEP       2           // ߲в
+#define PURE_PURSUIT_MAX_POINTS     45          // 
+
+// ֡־¼ͣ󴮿tools/lateral_replay.py
+#define PURE_PURSUIT_LOG_ENABLE     0           // Ƿ¼֡־ռԼ20.8KB RAMͣԶ߶Աʱ1
+#define PURE_PURSUIT_LOG_FRAMES     200         // ¼֡
+#define PURE_PURSUIT_LOG_DECIMATE   2           // ÿ֡¼һ֡
+#define PURE_PURSUIT_LOG_ROW_TOP    30          // ¼һУ¼ ROW_TOP ~ IMAGE_HEIGHT-1 еߣ
+#define PURE_PURSUIT_LOG_ROWS       (IMAGE_HEIGHT - PURE_PURSUIT_LOG_ROW_TOP)
+
+//====================================================ݽṹ====================================================
+// Ʒʽ
+typedef enum
+{
+    LATERAL_MODE_PID = 0,                       // ƫPIDǰӳٲ
+    LATERAL_MODE_PURE_PURSUIT                   // 
+} lateral_mode_enum;
+
+// ֡ߣعʱ̺ϵxңyǰλm
+typedef struct
+{
+    uint32 timestamp_ms;                        // ͼعʱ̣̼ʱ
+    uint8 count;                                // ЧԽԶ
+    float x[PURE_PURSUIT_MAX_POINTS];
+    float y[PURE_PURSUIT_MAX_POINTS];
+} pure_pursuit_path_t;
+
+// ֡־¼104ֽڣ
+typedef struct
+{
+    uint32 timestamp_ms;                        // ͼعʱ (ms)
+    int16 speed;                                //  (mm/s)
+    int16 yaw_rate;                             // ٶ (mrad/s)ʱΪ
+    int16 steer;                                // ֡ʱʵת (0.1)
+    int16 frame_output;                         // ֡ת (0.1ȣδӳٲ)
+    uint8 mode;                                 // Ʒʽ (lateral_mode_enum)
+    uint8 stop_line;                            // Search_Stop_Line
+    uint8 center[PURE_PURSUIT_LOG_ROWS];        // кţЧΪ0xFF
+} pure_pursuit_log_t;
+
+// ٽṹ
+typedef struct
+{
+    pure_pursuit_path_t path[2];                // ˫壬ѭдǻ֡л
+    volatile uint8 active;                      // ڶȡ֡±
+    
+    float lookahead;                            // Ԥ (m)
+    float target_x;                             // Ԥ (m)Ϊ
+    float target_y;                             // Ԥǰ (m)
+    float curvature;                            // ԤԲ (1/m)Ϊ
+    float output;                               // ת ()
+    float frame_output;                         // ֡߰ǰõת ()ӳٲ
+    
+    uint8 log_enable;                           // ڼ¼֡־
+    uint8 log_divider;                          // ֡־Ƶ
+    uint16 log_count;                           // Ѽ¼֡
+    uint8 dump_pending;                         // ͣͨ֡־
+#if PURE_PURSUIT_LOG_ENABLE
+    pure_pursuit_log_t log[PURE_PURSUIT_LOG_FRAMES];
+#endif
+} pure_pursuit_t;
+
+//====================================================ȫֱ====================================================
+extern pure_pursuit_t pure_pursuit;
+
+//========================================================================================================
+void  pure_pursuit_init(void);                                  // ʼ
+void  pure_pursuit_update(void);                                // ÿ֡ͼã߻㵽ϵ¼֡־
+float pure_pursuit_compute(void);                               // ڵãת ()뷽PIDͬ
+void  pure_pursuit_log_start(void);                             // ʱãʼ¼֡־
+void  pure_pursuit_log_dump(void);                              // ֡־ͣѭã
+
+#endif // _PURE_PURSUIT_H_
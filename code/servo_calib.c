@@ -0,0 +1,130 @@
+#include "servo_calib.h"
+#include "odometry.h"
+#include <math.h>
+
+#define SERVO_CALIB_POINTS  (SERVO_CALIB_STEPS * 2 + 1)
+
+/**
+ * @brief  ǰµʵת
+ * @param  pulse_us   (us)
+ * @param  angle     ת ()ʱתΪ
+ * @return 1-ɹ 0-ٹ
+ * @note   ٿȦȶ̼Ƴ뺽ٶȡƽ޲໬ʱ  = atan(L/v)
+ */
+static uint8 servo_calib_measure(uint16 pulse_us, float *angle)
+{
+    odometry_pose_t pose;
+    float sum_speed = 0.0f;
+    float sum_rate = 0.0f;
+    uint16 count = 0;
+    
+    servo_set_pulse_us(&car.steering_servo, pulse_us);
+    system_delay_ms(SERVO_CALIB_SETTLE_MS);
+    
+    for (uint16 t = 0; t < SERVO_CALIB_SAMPLE_MS; t += SERVO_CALIB_SAMPLE_PERIOD)
+    {
+        odometry_get_pose(&pose);
+        sum_speed += pose.speed;
+        sum_rate += pose.yaw_rate;
+        count++;
+        system_delay_ms(SERVO_CALIB_SAMPLE_PERIOD);
+    }
+    
+    float speed = sum_speed / count;
+    if (speed < SERVO_CALIB_MIN_SPEED)
+        return 0;
+    
+    *angle = atanf(CAR_WHEELBASE * (sum_rate / count) / speed) * 180.0f / 3.14159f;
+    return 1;
+}
+
+/**
+ * @brief  ʵָתǵ
+ * @param  pulse   ʵ
+ * @param  angle   ʵתǣ
+ * @param  target  Ŀת ()
+ * @return  (us)ʵⷶΧʱȡ˵㣨еޣ
+ */
+static uint16 servo_calib_interpolate(const uint16 *pulse, const float *angle, float target)
+{
+    float direction = (angle[SERVO_CALIB_POINTS - 1] > angle[0]) ? 1.0f : -1.0f;
+    
+    if ((target - angle[0]) * direction <= 0.0f)
+        return pulse[0];
+    for (uint8 i = 1; i < SERVO_CALIB_POINTS; i++)
+    {
+        if ((target - angle[i]) * direction <= 0.0f)
+        {
+            float t = (target - angle[i - 1]) / (angle[i] - angle[i - 1]);
+            return (uint16)(pulse[i - 1] + (pulse[i] - pulse[i - 1]) * t + 0.5f);
+        }
+    }
+    return pulse[SERVO_CALIB_POINTS - 1];
+}
+
+/**
+ * @brief  궨
+ * @param  
+ * @return 1-ɹѸ±궨 0-ʧܣԭ궨
+ * @note   ǰѭеãԼ (SETTLE+SAMPLE) x (2STEPS+1) msԵٿȦ
+ *         Ӹ༫޾ɨ赽༫ޣʵתÿఴȼתǷɱ궨
+ *         ĵȡʵתΪ0ͬʱλ SERVOCAL <us> <ת0.1> ճı궨
+ */
+uint8 servo_calibrate(void)
+{
+    uint16 pulse[SERVO_CALIB_POINTS];
+    float angle[SERVO_CALIB_POINTS];
+    uint8 ok = 1;
+    
+    motor_set_duty(&car.left_motor, SERVO_CALIB_MOTOR_DUTY);
+    motor_set_duty(&car.right_motor, SERVO_CALIB_MOTOR_DUTY);
+    
+    for (uint8 i = 0; i < SERVO_CALIB_POINTS && ok; i++)
+    {
+        pulse[i] = (uint16)(SERVO_LEFT_MAX_US + (int32)(SERVO_RIGHT_MAX_US - SERVO_LEFT_MAX_US) * i / (SERVO_CALIB_POINTS - 1));
+        if (i == SERVO_CALIB_STEPS)
+            pulse[i] = SERVO_CENTER_US;
+        ok = servo_calib_measure(pulse[i], &angle[i]);
+        if (ok)
+            printf("SERVOCAL %d %d\r\n", pulse[i], (int)(angle[i] * 10.0f));
+    }
+    
+    car_stop();
+    
+    if (!ok)
+    {
+        printf("SERVOCAL failed: speed too low\r\n");
+        return 0;
+    }
+    
+    // ת
+    float direction = (angle[SERVO_CALIB_POINTS - 1] > angle[0]) ? 1.0f : -1.0f;
+    for (uint8 i = 1; i < SERVO_CALIB_POINTS; i++)
+    {
+        if ((angle[i] - angle[i - 1]) * direction <= 0.0f)
+        {
+            printf("SERVOCAL failed: angle not monotonic at %dus\r\n", pulse[i]);
+            return 0;
+        }
+    }
+    
+    for (uint8 j = 0; j < SERVO_LUT_POINTS; j++)
+    {
+        float target = (float)SERVO_MAX_ANGLE * j / (SERVO_LUT_POINTS - 1);
+        car.steering_servo.lut_us[0][j] = servo_calib_interpolate(pulse, angle, -target);
+        car.steering_servo.lut_us[1][j] = servo_calib_interpolate(pulse, angle, target);
+    }
+    servo_set_angle(&car.steering_servo, 0);
+    
+    for (uint8 side = 0; side < 2; side++)
+    {
+        printf("#define %s {", side ? "SERVO_LUT_RIGHT_US " : "SERVO_LUT_LEFT_US  ");
+        for (uint8 j = 0; j < SERVO_LUT_POINTS; j++)
+            printf(j ? ", %d" : "%d", car.steering_servo.lut_us[side][j]);
+        printf("}\r\n");
+    }
+    if (fabsf(angle[0]) < SERVO_MAX_ANGLE || fabsf(angle[SERVO_CALIB_POINTS - 1]) < SERVO_MAX_ANGLE)
+        printf("SERVOCAL note: measured range %d ~ %d (0.1deg) is smaller than SERVO_MAX_ANGLE, table clamped\r\n",
+               (int)(angle[0] * 10.0f), (int)(angle[SERVO_CALIB_POINTS - 1] * 10.0f));
+    return 1;
+}
@@ -0,0 +1,19 @@
+#ifndef _SERVO_CALIB_H_
+#define _SERVO_CALIB_H_
+
+#include "zf_common_headfile.h"
+#include "motor_control.h"
+
+//====================================================궨====================================================
+#define SERVO_CALIB_ON_BOOT         0           // ϵ󷢳ǰһζ궨 (1-, 0-)ڿտ
+#define SERVO_CALIB_STEPS           6           // ÿɨģ
+#define SERVO_CALIB_MOTOR_DUTY      1200        // 궨ʱռձȣȦ
+#define SERVO_CALIB_SETTLE_MS       800         // ÿȶʱ (ms)
+#define SERVO_CALIB_SAMPLE_MS       1000        // ÿʱ (ms)
+#define SERVO_CALIB_SAMPLE_PERIOD   10          //  (ms)
+#define SERVO_CALIB_MIN_SPEED       150.0f      // ƽٵڸֵ (mm/s) ʱ궨ʧ
+
+//========================================================================================================
+uint8 servo_calibrate(void);                                    // ж궨ɹ1±궨
+
+#endif // _SERVO_CALIB_H_
@@ -42,36 +42,41 @@ void controller_by_uart(void){
                 {
                 case 0: // ͨ0 Ƶٶ
                     smart_car.pid_configs[smart_car.current_pid_scene].base_speed = (int16)(seekfree_assistant_parameter[i]);
-                    /* code */
                     break;
                 case 1: // ͨ1 Ƶkp
                     smart_car.pid_configs[smart_car.current_pid_scene].speed.kp = seekfree_assistant_parameter[i];
-                    smart_car.speed_pid_left.kp = seekfree_assistant_parameter[i];
-                    smart_car.speed_pid_right.kp = seekfree_assistant_parameter[i];
                     break;
                 case 2: // ͨ2 Ƶki
                     smart_car.pid_configs[smart_car.current_pid_scene].speed.ki = seekfree_assistant_parameter[i];
-                    smart_car.speed_pid_left.ki = seekfree_assistant_parameter[i];
-                    smart_car.speed_pid_right.ki = seekfree_assistant_parameter[i];
                     break;
                 case 3: // ͨ3 Ƶkd
                     smart_car.pid_configs[smart_car.current_pid_scene].speed.kd = seekfree_assistant_parameter[i];
-                    smart_car.speed_pid_left.kd = seekfree_assistant_parameter[i];
-                    smart_car.speed_pid_right.kd = seekfree_assistant_parameter[i];
                     break;
                 case 4: // ͨ4 ƶkp
                     smart_car.pid_configs[smart_car.current_pid_scene].direction.kp = seekfree_assistant_parameter[i];
-                    smart_car.direction_pid.kp = seekfree_assistant_parameter[i];
-                    /* code */
                     break;
                 case 5: // ͨ5 ƶkd
                     smart_car.pid_configs[smart_car.current_pid_scene].direction.kd = seekfree_assistant_parameter[i];
-                    smart_car.direction_pid.kd = seekfree_assistant_parameter[i];
-                    /* code */
+                    break;
+                case 6: // ͨ6 Ʒʽ (0-PID, 1-)
+                    smart_car_set_lateral_mode(seekfree_assistant_parameter[i] > 0.5f ? LATERAL_MODE_PURE_PURSUIT : LATERAL_MODE_PID);
+                    break;
+                case 7: // ͨ7 ͣʱգ1-ٶPIDд뵱ǰٶPID2-ģͱʶдǰģ
+                    if (seekfree_assistant_parameter[i] > 1.5f)
+                    {
+                        if (!motor_ident_start())
+                            printf("IDENT busy or car running\r\n");
+                    }
+                    else if (seekfree_assistant_parameter[i] > 0.5f && !speed_autotune_start())
+                        printf("AUTOTUNE busy or car running\r\n");
                     break;
                 default:
                     break;
                 }
+                // ͨ0~5޸ĵǵǰã¼أͬPIDٶ볡Ч
+                // ֮ĳлӵĲʼ
+                if (i <= 5)
+                    smart_car_load_pid_config(smart_car.current_pid_scene);
         }
     }
 }
@@ -1,12 +1,15 @@
-#ifdef __SHOW_SPEED_H__
+#ifndef __SHOW_SPEED_H__
 #define __SHOW_SPEED_H__
 
 #include "seekfree_assistant.h"
+
+#define CONTROLLER_UART_ENABLE      1           // ѭн·Ĳ (1-, 0-ر)ͨ0~5Σ6лƷʽ7ͣʱ
+
 extern seekfree_assistant_oscilloscope_struct oscilloscope_data;
 void show_speed_init(void);
 void show_speed_by_uart(void);
 
 void controller_init(void);
-void controller_by_uart(void);
+void controller_by_uart(void);                                  // ѭеãλд루ڴӡжеã
 
 #endif // __SHOW_SPEED_H__
@@ -1,5 +1,6 @@
 #include "smart_car.h"
 #include <math.h>
+#include <string.h>
 
 smart_car_t smart_car;
 //====================================================PIDóʼ====================================================
@@ -37,8 +38,205 @@ static void init_pid_scene_configs(void)
     smart_car.pid_configs[PID_SCENE_CURVE].direction.kd = DIRECTION_PID_KD_CURVE;
     smart_car.pid_configs[PID_SCENE_CURVE].base_speed = BASE_SPEED * 0.8f;
     
+    // Բ
+    smart_car.pid_configs[PID_SCENE_CIRCLE].speed.kp = SPEED_PID_KP_CIRCLE;
+    smart_car.pid_configs[PID_SCENE_CIRCLE].speed.ki = SPEED_PID_KI_CIRCLE;
+    smart_car.pid_configs[PID_SCENE_CIRCLE].speed.kd = SPEED_PID_KD_CIRCLE;
+    smart_car.pid_configs[PID_SCENE_CIRCLE].direction.kp = DIRECTION_PID_KP_CIRCLE;
+    smart_car.pid_configs[PID_SCENE_CIRCLE].direction.ki = DIRECTION_PID_KI_CIRCLE;
+    smart_car.pid_configs[PID_SCENE_CIRCLE].direction.kd = DIRECTION_PID_KD_CIRCLE;
+    smart_car.pid_configs[PID_SCENE_CIRCLE].base_speed = BASE_SPEED * 0.8f;
+    
+    // µ
+    smart_car.pid_configs[PID_SCENE_RAMP].speed.kp = SPEED_PID_KP_RAMP;
+    smart_car.pid_configs[PID_SCENE_RAMP].speed.ki = SPEED_PID_KI_RAMP;
+    smart_car.pid_configs[PID_SCENE_RAMP].speed.kd = SPEED_PID_KD_RAMP;
+    smart_car.pid_configs[PID_SCENE_RAMP].direction.kp = DIRECTION_PID_KP_RAMP;
+    smart_car.pid_configs[PID_SCENE_RAMP].direction.ki = DIRECTION_PID_KI_RAMP;
+    smart_car.pid_configs[PID_SCENE_RAMP].direction.kd = DIRECTION_PID_KD_RAMP;
+    smart_car.pid_configs[PID_SCENE_RAMP].base_speed = BASE_SPEED * 0.9f;
+    
     // ϳ
-    // ʼPID
+    smart_car.pid_configs[PID_SCENE_OBSTACLE].speed.kp = SPEED_PID_KP_OBSTACLE;
+    smart_car.pid_configs[PID_SCENE_OBSTACLE].speed.ki = SPEED_PID_KI_OBSTACLE;
+    smart_car.pid_configs[PID_SCENE_OBSTACLE].speed.kd = SPEED_PID_KD_OBSTACLE;
+    smart_car.pid_configs[PID_SCENE_OBSTACLE].direction.kp = DIRECTION_PID_KP_OBSTACLE;
+    smart_car.pid_configs[PID_SCENE_OBSTACLE].direction.ki = DIRECTION_PID_KI_OBSTACLE;
+    smart_car.pid_configs[PID_SCENE_OBSTACLE].direction.kd = DIRECTION_PID_KD_OBSTACLE;
+    smart_car.pid_configs[PID_SCENE_OBSTACLE].base_speed = BASE_SPEED * 0.6f;
+    
+    // ͣ
+    smart_car.pid_configs[PID_SCENE_PARKING].speed.kp = SPEED_PID_KP_PARKING;
+    smart_car.pid_configs[PID_SCENE_PARKING].speed.ki = SPEED_PID_KI_PARKING;
+    smart_car.pid_configs[PID_SCENE_PARKING].speed.kd = SPEED_PID_KD_PARKING;
+    smart_car.pid_configs[PID_SCENE_PARKING].direction.kp = DIRECTION_PID_KP_PARKING;
+    smart_car.pid_configs[PID_SCENE_PARKING].direction.ki = DIRECTION_PID_KI_PARKING;
+    smart_car.pid_configs[PID_SCENE_PARKING].direction.kd = DIRECTION_PID_KD_PARKING;
+    smart_car.pid_configs[PID_SCENE_PARKING].base_speed = BASE_SPEED * 0.5f;
+    
+    // Գʼͬsmart_car_save_pid_config()д
+    smart_car.pid_configs[PID_SCENE_DEBUG] = smart_car.pid_configs[PID_SCENE_NORMAL];
+}
+
+//====================================================PIDԶл====================================================
+/**
+ * @brief  ֱ/ѡ񳡾
+ * @param  
+ * @return ѡ
+ * @note   ٶȹ滮õǰհʣ˳ֵͬγͻأʱֵǰ
+ */
+static pid_scene_enum pid_scene_classify_road(void)
+{
+    pid_scene_enum current = smart_car.current_pid_scene;
+    float kappa = speed_planner.curvature_max;
+    
+    if (current != PID_SCENE_STRAIGHT && current != PID_SCENE_CURVE)
+        current = PID_SCENE_NORMAL;
+    
+    if (!vision.track_found)
+        return current;
+    
+    if (current == PID_SCENE_STRAIGHT)
+    {
+        if (kappa <= PID_SCENE_STRAIGHT_EXIT)
+            return PID_SCENE_STRAIGHT;
+        return (kappa > PID_SCENE_CURVE_ENTER) ? PID_SCENE_CURVE : PID_SCENE_NORMAL;
+    }
+    if (current == PID_SCENE_CURVE)
+    {
+        if (kappa >= PID_SCENE_CURVE_EXIT)
+            return PID_SCENE_CURVE;
+        return (kappa < PID_SCENE_STRAIGHT_ENTER) ? PID_SCENE_STRAIGHT : PID_SCENE_NORMAL;
+    }
+    
+    if (kappa > PID_SCENE_CURVE_ENTER)
+        return PID_SCENE_CURVE;
+    if (kappa < PID_SCENE_STRAIGHT_ENTER)
+        return PID_SCENE_STRAIGHT;
+    return PID_SCENE_NORMAL;
+}
+
+/**
+ * @brief  Ԫ״̬ѡ񳡾
+ * @param  
+ * @return ѡ
+ * @note   ɱΪͣʶԲ/µ/ٴ/ϰ/ͣʱʹöӦ
+ *         ʮ֡·߼Ԫʱʷ
+ */
+static pid_scene_enum pid_scene_select(void)
+{
+    if (lap_timer_is_finished())
+        return PID_SCENE_PARKING;
+    
+    if (smart_car.element_recognition_enable &&
+        element_recog.current_element.state != ELEMENT_STATE_NONE)
+    {
+        switch (element_recog.current_element.type)
+        {
+            case ELEMENT_CIRCLE:        return PID_SCENE_CIRCLE;
+            case ELEMENT_RAMP:
+            case ELEMENT_SPEED_BUMP:    return PID_SCENE_RAMP;
+            case ELEMENT_OBSTACLE:      return PID_SCENE_OBSTACLE;
+            case ELEMENT_PARKING:       return PID_SCENE_PARKING;
+            default:                    break;
+        }
+    }
+    
+    return pid_scene_classify_road();
+}
+
+/**
+ * @brief  дPID
+ * @param  config  
+ * @return 
+ * @note   ۻKi仯ţлʱ
+ */
+static void pid_scene_apply(const pid_scene_config_t *config)
+{
+    pid_set_params_bumpless(&smart_car.speed_pid_left,
+                            config->speed.kp, config->speed.ki, config->speed.kd);
+    pid_set_params_bumpless(&smart_car.speed_pid_right,
+                            config->speed.kp, config->speed.ki, config->speed.kd);
+    pid_set_params_bumpless(&smart_car.direction_pid,
+                            config->direction.kp, config->direction.ki, config->direction.kd);
+    smart_car.scene.active = *config;
+}
+
+/**
+ * @brief  Բֵ
+ * @param  from   ʼֵ
+ * @param  to     Ŀֵ
+ * @param  alpha  ֵϵ (0-1)
+ * @return ֵ
+ */
+static float pid_scene_lerp(float from, float to, float alpha)
+{
+    return from + (to - from) * alpha;
+}
+
+/**
+ * @brief  ƽһڵĲ
+ * @param  
+ * @return 
+ * @note   PID_SCENE_BLEND_CYCLESлʱ̵ЧԹɵ³
+ */
+static void pid_scene_blend_step(void)
+{
+    const pid_scene_config_t *from = &smart_car.scene.blend_from;
+    const pid_scene_config_t *to = &smart_car.pid_configs[smart_car.current_pid_scene];
+    pid_scene_config_t blend;
+    
+    if (smart_car.scene.blend_tick >= PID_SCENE_BLEND_CYCLES)
+        return;
+    
+    smart_car.scene.blend_tick++;
+    float alpha = (float)smart_car.scene.blend_tick / PID_SCENE_BLEND_CYCLES;
+    
+    blend.speed.kp = pid_scene_lerp(from->speed.kp, to->speed.kp, alpha);
+    blend.speed.ki = pid_scene_lerp(from->speed.ki, to->speed.ki, alpha);
+    blend.speed.kd = pid_scene_lerp(from->speed.kd, to->speed.kd, alpha);
+    blend.direction.kp = pid_scene_lerp(from->direction.kp, to->direction.kp, alpha);
+    blend.direction.ki = pid_scene_lerp(from->direction.ki, to->direction.ki, alpha);
+    blend.direction.kd = pid_scene_lerp(from->direction.kd, to->direction.kd, alpha);
+    blend.base_speed = (int16)pid_scene_lerp(from->base_speed, to->base_speed, alpha);
+    
+    pid_scene_apply(&blend);
+}
+
+/**
+ * @brief  ÿڸPID
+ * @param  
+ * @return 
+ * @note   Զģʽѡѡֱ/ͨ/֮лڵǰפPID_SCENE_DWELL_MIN_TICKS
+ *         ԪسͳפʱлƵʲƽ
+ */
+static void pid_scene_update(void)
+{
+    if (smart_car.scene.auto_enable)
+    {
+        pid_scene_enum current = smart_car.current_pid_scene;
+        pid_scene_enum candidate = pid_scene_select();
+        uint8 road_change = (current == PID_SCENE_NORMAL || current == PID_SCENE_STRAIGHT || current == PID_SCENE_CURVE) &&
+                            (candidate == PID_SCENE_NORMAL || candidate == PID_SCENE_STRAIGHT || candidate == PID_SCENE_CURVE);
+        
+        if (candidate != current && (!road_change || smart_car.scene.dwell_ticks >= PID_SCENE_DWELL_MIN_TICKS))
+        {
+            smart_car_set_pid_scene(candidate);
+        }
+    }
+    
+    if (smart_car.scene.dwell_ticks < 0xFFFF)
+        smart_car.scene.dwell_ticks++;
+    smart_car.scene.dwell_total[smart_car.current_pid_scene]++;
+    
+    if (++smart_car.scene.window_tick >= PID_SCENE_RATE_WINDOW_TICKS)
+    {
+        smart_car.scene.switch_rate = smart_car.scene.window_switches;
+        smart_car.scene.window_switches = 0;
+        smart_car.scene.window_tick = 0;
+    }
+    
+    pid_scene_blend_step();
 }
 
 //====================================================Сʼ====================================================
@@ -50,11 +248,26 @@ static void init_pid_scene_configs(void)
 void smart_car_init(void)
 {
     // ========== ʼӲ豸 ==========
+    battery_init();                 // صѹ̨ɨ裨ռձȲ
     motor_init();                   // ʼ
+    odometry_init();                // ̼ƣ1msжϻ֣
+    speed_loop_init();              // ƵٶȻ2msٹ۲+ǰ+PI
     vision_init();                  // ʼӾ
+    yaw_control_init();             // ǽٶڻϵ뾲ֹ
     system_start();
     // ========== ʼģ ==========
     element_recognition_init();     // Ԫʶ
+    lap_timer_init();               // Ȧ
+    element_sequence_init();        // ԪУһȦѧϰ
+    speed_planner_init();           // ٶȹ滮
+    steer_predict_init();           // תǰӳٲ
+    pure_pursuit_init();            // ٺ
+    lateral_kf_init();              // 򿨶˲ͼںϣ
+    speed_autotune_init();          // ٶPID̵ͣʱλͨ7
+    motor_ident_init();             // ģͽԾʶͣʱλͨ7
+    traction_init();                // ǣ𲽿
+    brake_init();                   // ƶ
+    lap_memory_init();              // Ȧ䣨һȦ¼
     
     // ========== ʼPID ==========
     // ʼٶPID
@@ -75,15 +288,20 @@ void smart_car_init(void)
     // ========== ʼPID ==========
     init_pid_scene_configs();           // ʼPID
     smart_car.current_pid_scene = PID_SCENE_NORMAL;  // ǰPIDΪ
+    smart_car_load_pid_config(PID_SCENE_NORMAL);
+    smart_car.scene.auto_enable = PID_SCENE_AUTO_DEFAULT;
     
     // ========== ʼС״̬ ==========
     smart_car.state                      = CAR_STOP;
     smart_car.element_recognition_enable = 1;  // Ԫʶʹ
+    smart_car.path_planning_enable       = SPEED_PLANNER_DEFAULT;  // ٶȹ滮ʹܣ궨
+    smart_car.lateral_mode               = PURE_PURSUIT_DEFAULT ? LATERAL_MODE_PURE_PURSUIT : LATERAL_MODE_PID;
     
     // ========== ʼ״̬ ==========
     smart_car.avoid_state                = AVOID_IDLE;
     smart_car.avoid_start_distance       = 0.0f;
     smart_car.avoid_direction            = 0;
+    smart_car.finish_tick                = 0;
 }
 
 /**
@@ -102,46 +320,179 @@ void smart_car_control(void)
     // µٶ
     motor_update_speed();
     
+    // ѡ
+    pid_scene_update();
+    
     // ֶرʼ
-    car.base_speed = (int16)smart_car.pid_configs[smart_car.current_pid_scene].base_speed;
+    // һȦ¼ʡԪ복
+    lap_memory_record();
+    
+    if (smart_car.path_planning_enable)
+    {
+        // ǰʹ滮ٶȣӼб£ڶȦȦٶԤ
+        speed_planner.profile_speed = lap_memory_get_preview_speed();
+        car.base_speed = speed_planner_get_target();
+    }
+    else
+    {
+        car.base_speed = smart_car.scene.active.base_speed;
+    }
     int16 target_speed_left = car.base_speed;
     int16 target_speed_right = car.base_speed;
     int16 manual_steer_angle = 0;       // ֶƷǶ
     uint8 use_manual_steer = 0;         // Ƿʹֶ
     // Ĭ״ֵ̬ǰٶȺͷ
     
-    // ========== ٶPID ==========
-    // ٶPIDĿ
-    pid_set_target(&smart_car.speed_pid_left, (float)target_speed_left);
-    pid_set_target(&smart_car.speed_pid_right, (float)target_speed_right);
+#if DIFFERENTIAL_ENABLE
+    // ========== Ӳ ==========
+    // ʵ·תǣڻڷĿ꣬ڲּ١ּ٣ϻ
+    car_differential_speed(car.base_speed, car.steering_servo.current_angle_q16, &target_speed_left, &target_speed_right);
+#endif
+    
+    // ========== յͣ ==========
+    // ĿȦԽյ߼ʻڣȻĿٶɲͣͣȺͣ
+    if (lap_timer_is_finished())
+    {
+        if (smart_car.finish_tick < LAP_TIMER_STOP_DELAY_TICKS)
+        {
+            smart_car.finish_tick++;
+        }
+        else
+        {
+            target_speed_left = 0;
+            target_speed_right = 0;
+            
+            if (abs(car.left_motor.current_speed) < LAP_TIMER_STOP_SPEED &&
+                abs(car.right_motor.current_speed) < LAP_TIMER_STOP_SPEED)
+            {
+                smart_car_stop();
+                return;
+            }
+        }
+    }
     
-    // ٶPID - 
-    float left_pwm = pid_calculate(&smart_car.speed_pid_left, (float)car.left_motor.current_speed);
+    // ========== ƶ ==========
+    // 滮ٶȴﵽֵԸĿʱ1msжܵ뻬ƵķռձȴٶȻ
+    brake_set_request(&brake, speed_loop_counts_to_mm_s((target_speed_left + target_speed_right) / 2),
+                      smart_car.path_planning_enable ? speed_planner.decel * 1000.0f : 0.0f);
     
-    // ٶPID - 
-    float right_pwm = pid_calculate(&smart_car.speed_pid_right, (float)car.right_motor.current_speed);
+    // ========== ٶPID ==========
+    int32 left_pwm = 0;
+    int32 right_pwm = 0;
+    
+    if (speed_loop.enable)
+    {
+        // ƵٶȻֻ·Ŀٶȣ1msжϷƵɹ۲⡢ǰPI
+        speed_loop_set_target(speed_loop_counts_to_mm_s(target_speed_left),
+                              speed_loop_counts_to_mm_s(target_speed_right));
+    }
+    else
+    {
+        int16 reference_left = target_speed_left;
+        int16 reference_right = target_speed_right;
+#if SPEED_PID_FEEDFORWARD
+        // ģǰĿ공ٶӦ̬ռձȣPIDģͶĿԤӦֻв
+        left_pwm = (int32)motor_model_feedforward(&car.left_motor.model, speed_loop_counts_to_mm_s(target_speed_left), 0.0f);
+        right_pwm = (int32)motor_model_feedforward(&car.right_motor.model, speed_loop_counts_to_mm_s(target_speed_right), 0.0f);
+        reference_left = (int16)lroundf(motor_model_reference(&car.left_motor, target_speed_left, SPEED_LOOP_CONTROL_MS * 0.001f));
+        reference_right = (int16)lroundf(motor_model_reference(&car.right_motor, target_speed_right, SPEED_LOOP_CONTROL_MS * 0.001f));
+#endif
+#if CONTROL_FIXED_POINT
+        // ٶPIDΪQ16ռձ
+        left_pwm += Q16_TO_INT(pid_calculate_q16(&smart_car.speed_pid_left, reference_left, car.left_motor.current_speed));
+        right_pwm += Q16_TO_INT(pid_calculate_q16(&smart_car.speed_pid_right, reference_right, car.right_motor.current_speed));
+#else
+        // ٶPIDĿ
+        pid_set_target(&smart_car.speed_pid_left, (float)reference_left);
+        pid_set_target(&smart_car.speed_pid_right, (float)reference_right);
+        
+        // ٶPID - 
+        left_pwm += (int32)pid_calculate(&smart_car.speed_pid_left, (float)car.left_motor.current_speed);
+        
+        // ٶPID - 
+        right_pwm += (int32)pid_calculate(&smart_car.speed_pid_right, (float)car.right_motor.current_speed);
+#endif
+        // ƶٶPID֣ʱƶռձȹɵǰ + 
+        left_pwm = (int32)brake_blend(&brake, &brake.left, (float)left_pwm);
+        right_pwm = (int32)brake_blend(&brake, &brake.right, (float)right_pwm);
+        if (brake.state == BRAKE_ACTIVE)
+        {
+            pid_reset(&smart_car.speed_pid_left);
+            pid_reset(&smart_car.speed_pid_right);
+        }
+    }
     
     // ========== PID ==========
-    float steer_angle;
+#if CONTROL_FIXED_POINT
+    q16_t steer_angle;                  // ת (Q16)
+#else
+    float steer_angle;                  // ת ()
+#endif
     
     if (use_manual_steer)
     {
         // ֶƷֱʹֶתǶ
+#if CONTROL_FIXED_POINT
+        steer_angle = Q16_FROM_INT(manual_steer_angle);
+#else
         steer_angle = (float)manual_steer_angle;
+#endif
+    }
+    else if (smart_car.lateral_mode == LATERAL_MODE_PURE_PURSUIT)
+    {
+        // ٣ϵϰȡԤ㣬ת
+#if CONTROL_FIXED_POINT
+        steer_angle = Q16_FROM_FLOAT(pure_pursuit_compute());
+#else
+        steer_angle = pure_pursuit_compute();
+#endif
     }
     else
     {
         // ԶƷʹ÷PID
         int16 deviation = vision_get_deviation();
+        
+        // ͼƫ̼㵽ǰʱ̣ʸǰתǣʹתǰͺ
+        deviation = steer_predict_compute(deviation);
+#if LATERAL_KF_ENABLE
+        // ˲ÿ1ms복㣬֡ʱǵǰֵʧЧʱ˻ͼƫ
+        if (lateral_kf.valid)
+            deviation = lateral_kf_deviation();
+#endif
+#if CONTROL_FIXED_POINT
+        steer_angle = pid_calculate_q16(&smart_car.direction_pid, 0, deviation);
+        steer_angle += Q16_FROM_FLOAT(steer_predict.feedforward);
+#else
         pid_set_target(&smart_car.direction_pid, 0);  // ÷PIDĿΪ0ʾƫΪ0
         steer_angle = pid_calculate(&smart_car.direction_pid, (float)deviation);
+        steer_angle += steer_predict.feedforward;
+#endif
         printf("%d",deviation);
     }
     // ========== PWM ==========
     // ÷PWM
-    motor_set_duty(&car.left_motor, (int32)left_pwm);
-    motor_set_duty(&car.right_motor, (int32)right_pwm);
-    servo_set_angle(&car.steering_servo, (int16)steer_angle);
+    if (!speed_loop.enable)
+    {
+        motor_set_duty(&car.left_motor, left_pwm);
+        motor_set_duty(&car.right_motor, right_pwm);
+    }
+    if (yaw_control.enable)
+    {
+        // PIDΪתǣ1msٶڻ
+#if CONTROL_FIXED_POINT
+        yaw_control_set_target(Q16_TO_FLOAT(steer_angle), (car.left_motor.current_speed + car.right_motor.current_speed) / 2);
+#else
+        yaw_control_set_target(steer_angle, (car.left_motor.current_speed + car.right_motor.current_speed) / 2);
+#endif
+    }
+    else
+    {
+#if CONTROL_FIXED_POINT
+        servo_set_angle_q16(&car.steering_servo, steer_angle);
+#else
+        servo_set_angle(&car.steering_servo, (int16)steer_angle);
+#endif
+    }
 }
 
 /**
@@ -155,6 +506,33 @@ void smart_car_start(void)
     pid_reset(&smart_car.speed_pid_left);
     pid_reset(&smart_car.speed_pid_right);
     pid_reset(&smart_car.direction_pid);
+    yaw_control_reset();
+    speed_loop_reset();
+    lateral_kf_reset();
+    car.left_motor.model_speed = 0.0f;
+    car.right_motor.model_speed = 0.0f;
+    battery_reset_min();
+    traction_start();
+    brake_start();
+    
+    // ʼȦ
+    smart_car.finish_tick = 0;
+    lap_timer_start();
+    element_sequence_start();
+    pure_pursuit_log_start();
+    
+    // ٶȹ滮Ӿֹʼ
+    speed_planner_reset(0.0f);
+    
+    // ͳƴӷʼ
+    smart_car.scene.switch_count = 0;
+    smart_car.scene.dwell_ticks = 0;
+    smart_car.scene.last_dwell_ticks = 0;
+    smart_car.scene.min_dwell_ticks = 0xFFFF;
+    smart_car.scene.window_tick = 0;
+    smart_car.scene.window_switches = 0;
+    smart_car.scene.switch_rate = 0;
+    memset(smart_car.scene.dwell_total, 0, sizeof(smart_car.scene.dwell_total));
     
     // С
     smart_car.state = CAR_RUNNING;
@@ -167,11 +545,15 @@ void smart_car_start(void)
  */
 void smart_car_stop(void)
 {
+    // л״̬ͣ1msٶȻcar_stop()֮ռձ
+    smart_car.state = CAR_STOP;
+    
     // ֹͣС
     car_stop();
     
-    // ֹͣС
-    smart_car.state = CAR_STOP;
+    // ͣѭ֡־
+    if (pure_pursuit.log_count > 0)
+        pure_pursuit.dump_pending = 1;
 }
 
 /**
@@ -181,9 +563,9 @@ void smart_car_stop(void)
  */
 void smart_car_pause(void)
 {
-    // ֹͣС
-    car_stop();
+    // л״̬ͣ1msٶȻcar_stop()֮ռձ
     smart_car.state = CAR_PAUSE;
+    car_stop();
 }
 
 /**
@@ -225,6 +607,64 @@ void smart_car_disable_element_recognition(void)
     smart_car.element_recognition_enable = 0;
 }
 
+/**
+ * @brief  ٶȹ滮
+ * @param  
+ * @return 
+ */
+void smart_car_enable_path_planning(void)
+{
+    smart_car.path_planning_enable = 1;
+}
+
+/**
+ * @brief  ٶȹ滮
+ * @param  
+ * @return 
+ * @note   úʹõǰPIDĻٶ
+ */
+void smart_car_disable_path_planning(void)
+{
+    smart_car.path_planning_enable = 0;
+}
+
+/**
+ * @brief  лƷʽ
+ * @param  mode  LATERAL_MODE_PID  LATERAL_MODE_PURE_PURSUIT
+ * @return 
+ * @note   лطPIDʱλ΢ʷлǰ״̬
+ */
+void smart_car_set_lateral_mode(lateral_mode_enum mode)
+{
+    if (mode == smart_car.lateral_mode)
+        return;
+    
+    if (mode == LATERAL_MODE_PID)
+        pid_reset(&smart_car.direction_pid);
+    smart_car.lateral_mode = mode;
+}
+
+/**
+ * @brief  PIDԶл
+ * @param  
+ * @return 
+ */
+void smart_car_enable_pid_scene_auto(void)
+{
+    smart_car.scene.auto_enable = 1;
+}
+
+/**
+ * @brief  PIDԶл
+ * @param  
+ * @return 
+ * @note   ú󱣳ֵǰsmart_car_set_pid_scene()ֶл
+ */
+void smart_car_disable_pid_scene_auto(void)
+{
+    smart_car.scene.auto_enable = 0;
+}
+
 /**
  * @brief  ȡǰʶԪ
  * @param  
@@ -239,13 +679,30 @@ element_type_enum smart_car_get_current_element(void)
  * @brief  PID
  * @param  scene  PID
  * @return 
+ * @note   л¼лʱ̵Ч֮ÿ³Թɣ
+ *         ٴлӵǰֵɣͬʱ¼פʱл
+ *         ٶPIDֻSPEED_LOOP_ENABLEΪ0ʱЧٶֻٶȹ滮رʱЧ
+ *         PIDֻںΪPIDʱЧ
  */
 void smart_car_set_pid_scene(pid_scene_enum scene)
 {
-    if (scene >= PID_SCENE_MAX) return;
+    if (scene >= PID_SCENE_MAX || scene == smart_car.current_pid_scene) return;
+    
+    smart_car.scene.last_dwell_ticks = smart_car.scene.dwell_ticks;
+    if (smart_car.scene.dwell_ticks < smart_car.scene.min_dwell_ticks)
+        smart_car.scene.min_dwell_ticks = smart_car.scene.dwell_ticks;
+    smart_car.scene.dwell_ticks = 0;
+    smart_car.scene.switch_count++;
+    if (smart_car.scene.window_switches < 0xFF)
+        smart_car.scene.window_switches++;
     
     smart_car.current_pid_scene = scene;
-    smart_car_load_pid_config(scene);
+    smart_car.scene.blend_from = smart_car.scene.active;
+    smart_car.scene.blend_tick = 0;
+    
+#if PID_SCENE_BLEND_CYCLES == 0
+    pid_scene_apply(&smart_car.pid_configs[scene]);
+#endif
 }
 
 /**
@@ -288,6 +745,10 @@ void smart_car_load_pid_config(pid_scene_enum scene)
     
     // ûٶ
     car.base_speed = config->base_speed;
+    
+    // ЧڽеĲ
+    smart_car.scene.active = *config;
+    smart_car.scene.blend_tick = PID_SCENE_BLEND_CYCLES;
 }
 
 /**
@@ -323,11 +784,15 @@ void smart_car_save_pid_config(pid_scene_enum scene)
  * @param  ki  ϵ
  * @param  kd  ΢ϵ
  * @return 
+ * @note   ͬʱд볡Ч´γлӸòʼɣ޸ĳñ
  */
 void smart_car_set_speed_pid(float kp, float ki, float kd)
 {
     pid_set_params(&smart_car.speed_pid_left, kp, ki, kd);
     pid_set_params(&smart_car.speed_pid_right, kp, ki, kd);
+    smart_car.scene.active.speed.kp = kp;
+    smart_car.scene.active.speed.ki = ki;
+    smart_car.scene.active.speed.kd = kd;
 }
 
 /**
@@ -336,10 +801,14 @@ void smart_car_set_speed_pid(float kp, float ki, float kd)
  * @param  ki  ϵ
  * @param  kd  ΢ϵ
  * @return 
+ * @note   ͬʱд볡Ч´γлӸòʼɣ޸ĳñ
  */
 void smart_car_set_direction_pid(float kp, float ki, float kd)
 {
     pid_set_params(&smart_car.direction_pid, kp, ki, kd);
+    smart_car.scene.active.direction.kp = kp;
+    smart_car.scene.active.direction.ki = ki;
+    smart_car.scene.active.direction.kd = kd;
 }
 
 /**
@@ -6,9 +6,25 @@
 #include "pid_control.h"
 #include "vision_track.h"
 #include "element_recognition.h"
+#include "lap_timer.h"
+#include "element_sequence.h"
+#include "speed_planner.h"
+#include "yaw_control.h"
+#include "odometry.h"
+#include "lap_memory.h"
+#include "speed_loop.h"
+#include "steer_predict.h"
+#include "pure_pursuit.h"
+#include "lateral_kf.h"
+#include "speed_autotune.h"
+#include "motor_ident.h"
+#include "battery.h"
+#include "traction_control.h"
+#include "brake_control.h"
 
 #define BASE_SPEED              600        // ٶ/10ms
 #define MAX_STEER_ANGLE         45          // תǶ
+#define SPEED_PID_FEEDFORWARD   1           // ٶPIDSPEED_LOOP_ENABLEΪ0ʱӵģǰPIDֻв
 
 //====================================================PID====================================================
 // PIDö
@@ -41,6 +57,26 @@ typedef struct
     int16 base_speed;           // ٶ/10ms
 } pid_scene_config_t;
 
+// PIDл״̬ṹ
+typedef struct
+{
+    uint8 auto_enable;                          // ǷԪԶл
+    
+    pid_scene_config_t blend_from;              // лʱЧĲ
+    pid_scene_config_t active;                  // ǰʵЧĲΪֵ
+    uint8 blend_tick;                           // ѹɵĿ
+    
+    uint16 dwell_ticks;                         // ǰפĿ
+    uint16 last_dwell_ticks;                    // һפ
+    uint16 min_dwell_ticks;                     // ̵פ
+    uint32 dwell_total[PID_SCENE_MAX];          // ۼפ
+    
+    uint32 switch_count;                        // лܴ
+    uint16 window_tick;                         // ƵͳƴѹĿ
+    uint8 window_switches;                      // Ƶͳƴڵл
+    uint8 switch_rate;                          // һͳƴڵл/룩
+} pid_scene_switch_t;
+
 //========================================================================================================
 #define SPEED_PID_KP_NORMAL         3.0f       // ٶPIDϵ
 #define SPEED_PID_KI_NORMAL         0.0f        // ٶPIDϵ
@@ -66,6 +102,52 @@ typedef struct
 #define DIRECTION_PID_KP_CURVE      2.5f        // ߳PIDϵ
 #define DIRECTION_PID_KI_CURVE      0.08f       // ߳PIDϵ
 #define DIRECTION_PID_KD_CURVE      6.0f        // ߳PID΢ϵ
+
+// ԲPID
+#define SPEED_PID_KP_CIRCLE         45.0f       // ԲٶPIDϵ
+#define SPEED_PID_KI_CIRCLE         1.8f        // ԲٶPIDϵ
+#define SPEED_PID_KD_CIRCLE         4.5f        // ԲٶPID΢ϵ
+
+#define DIRECTION_PID_KP_CIRCLE     2.8f        // ԲPIDϵ
+#define DIRECTION_PID_KI_CIRCLE     0.05f       // ԲPIDϵ
+#define DIRECTION_PID_KD_CIRCLE     6.5f        // ԲPID΢ϵ
+
+// µPID
+#define SPEED_PID_KP_RAMP           55.0f       // µٶPIDϵ
+#define SPEED_PID_KI_RAMP           3.0f        // µٶPIDϵ¸ر仯
+#define SPEED_PID_KD_RAMP           5.0f        // µٶPID΢ϵ
+
+#define DIRECTION_PID_KP_RAMP       1.2f        // µPIDϵ
+#define DIRECTION_PID_KI_RAMP       0.0f        // µPIDϵ
+#define DIRECTION_PID_KD_RAMP       3.0f        // µPID΢ϵ
+
+// ϰﳡPID
+#define SPEED_PID_KP_OBSTACLE       40.0f       // ϰﳡٶPIDϵ
+#define SPEED_PID_KI_OBSTACLE       1.5f        // ϰﳡٶPIDϵ
+#define SPEED_PID_KD_OBSTACLE       4.0f        // ϰﳡٶPID΢ϵ
+
+#define DIRECTION_PID_KP_OBSTACLE   2.0f        // ϰﳡPIDϵ
+#define DIRECTION_PID_KI_OBSTACLE   0.0f        // ϰﳡPIDϵ
+#define DIRECTION_PID_KD_OBSTACLE   5.0f        // ϰﳡPID΢ϵ
+
+// ͣPID
+#define SPEED_PID_KP_PARKING        40.0f       // ͣٶPIDϵ
+#define SPEED_PID_KI_PARKING        1.0f        // ͣٶPIDϵ
+#define SPEED_PID_KD_PARKING        3.0f        // ͣٶPID΢ϵ
+
+#define DIRECTION_PID_KP_PARKING    2.0f        // ͣPIDϵ
+#define DIRECTION_PID_KI_PARKING    0.0f        // ͣPIDϵ
+#define DIRECTION_PID_KD_PARKING    5.0f        // ͣPID΢ϵ
+
+//====================================================Զл====================================================
+#define PID_SCENE_AUTO_DEFAULT      1           // ϵĬǷԶл (1-Զ, 0-ֶ)
+#define PID_SCENE_BLEND_CYCLES      10          // лԹɵĿ0Ϊл
+#define PID_SCENE_DWELL_MIN_TICKS   15          // ֱ/ͨ/֮лǰפڣ
+#define PID_SCENE_STRAIGHT_ENTER    0.15f       // ǰհʵڸֱֵ (1/m)
+#define PID_SCENE_STRAIGHT_EXIT     0.30f       // ǰհʸڸֵ˳ֱ (1/m)
+#define PID_SCENE_CURVE_ENTER       0.80f       // ǰհʸڸֵ (1/m)
+#define PID_SCENE_CURVE_EXIT        0.50f       // ǰհʵڸֵ˳ (1/m)
+#define PID_SCENE_RATE_WINDOW_TICKS 50          // лƵͳƴڣڣ50x20ms=1s
 //====================================================ϰò====================================================
 #define OBSTACLE_AVOID_ANGLE    25          // ϰתǶ
 #define OBSTACLE_AVOID_DISTANCE 0.3f        // ϰþ
@@ -101,15 +183,19 @@ typedef struct
     
     pid_scene_enum current_pid_scene;           // ǰPID
     pid_scene_config_t pid_configs[PID_SCENE_MAX]; // PID
+    pid_scene_switch_t scene;                   // PIDл״̬
     
     uint8 display_enable;                       // ʾʹ
     uint8 position_control_enable;              // λÿʹ
     uint8 element_recognition_enable;           // Ԫʶʹ
     uint8 path_planning_enable;                 // ·滮ʹ
+    uint8 lateral_mode;                         // Ʒʽ (lateral_mode_enum)
     
     obstacle_avoid_state_enum avoid_state;      // ϰ״̬
     float avoid_start_distance;                 // ϰʼ
     uint8 avoid_direction;                      // ϰ÷0=ת1=ת
+    
+    uint16 finish_tick;                         // ԽյߺĿڼ
 } smart_car_t;
 
 //====================================================Сṹ====================================================
@@ -129,12 +215,21 @@ void smart_car_enable_element_recognition(void);                // Ԫ
 void smart_car_disable_element_recognition(void);               // Ԫʶʹ
 element_type_enum smart_car_get_current_element(void);          // ȡǰԪ
 
+// ٶȹ滮ʹ
+void smart_car_enable_path_planning(void);                      // ٶȹ滮
+void smart_car_disable_path_planning(void);                     // ٶȹ滮ʹóٶȣ
+
+// Ʒʽ
+void smart_car_set_lateral_mode(lateral_mode_enum mode);        // лƫPID/
+
 
 // PID
 void smart_car_set_pid_scene(pid_scene_enum scene);             // PID
 pid_scene_enum smart_car_get_pid_scene(void);                   // ȡǰPID
 void smart_car_load_pid_config(pid_scene_enum scene);           // PID
 void smart_car_save_pid_config(pid_scene_enum scene);           // PID
+void smart_car_enable_pid_scene_auto(void);                     // óԶл
+void smart_car_disable_pid_scene_auto(void);                    // óԶлֵǰ
 
 // PID
 void smart_car_set_speed_pid(float kp, float ki, float kd);    // ٶPID
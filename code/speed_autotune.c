@@ -0,0 +1,372 @@
+#include "speed_autotune.h"
+#include <math.h>
+#ifndef PID_HOST
+#include "smart_car.h"
+#endif
+
+#define SPEED_AUTOTUNE_SPINUP_SAMPLES   (SPEED_AUTOTUNE_SPINUP_MS / SPEED_AUTOTUNE_PERIOD_MS)
+
+// ϵKp = aKu, Ti = bTu, Td = cTu
+static const float speed_autotune_rule[4][3] =
+{
+    {0.45f,   0.833f, 0.0f},                    // Z-N PI
+    {0.6f,    0.5f,   0.125f},                  // Z-N PID
+    {0.3125f, 2.2f,   0.0f},                    // Tyreus-Luyben PI
+    {0.4545f, 2.2f,   0.1587f},                 // Tyreus-Luyben PID
+};
+
+//====================================================̵㷨====================================================
+/**
+ * @brief  λ״̬ת׶
+ * @param  relay  ṹָ
+ * @return 
+ */
+void speed_autotune_relay_reset(speed_autotune_relay_t *relay)
+{
+    relay->phase = SPEED_AUTOTUNE_SPINUP;
+    relay->error = SPEED_AUTOTUNE_OK;
+    relay->tick = 0;
+    relay->spin_sum = 0;
+    relay->spin_count = 0;
+    relay->setpoint = 0.0f;
+    relay->relay = 1;
+    relay->switches = 0;
+    relay->count = 0;
+    relay->ku = 0.0f;
+    relay->tu = 0.0f;
+}
+
+/**
+ * @brief  ɼڵٽٽ
+ * @param  relay  ṹָ
+ * @return 
+ * @note   ǡø SPEED_AUTOTUNE_CYCLES ڣɵи֮䣩Գ̵Ƶʴ
+ *         DFTKu = |U1|/|Y1| 4d/(a) ķֵƸ׼ϡʱֵᱻ͹ֵҲӰ
+ */
+static void speed_autotune_relay_finish(speed_autotune_relay_t *relay)
+{
+    float w = 2.0f * 3.14159265f * SPEED_AUTOTUNE_CYCLES / relay->count;
+    float yr = 0.0f, yi = 0.0f, ur = 0.0f, ui = 0.0f;
+    
+    for (uint16 k = 0; k < relay->count; k++)
+    {
+        float c = cosf(w * k);
+        float s = sinf(w * k);
+        yr += relay->speed[k] * c;
+        yi -= relay->speed[k] * s;
+        ur += relay->relay_log[k] * c;
+        ui -= relay->relay_log[k] * s;
+    }
+    
+    float y1 = sqrtf(yr * yr + yi * yi);
+    if (y1 < 1e-3f * relay->count)
+    {
+        relay->phase = SPEED_AUTOTUNE_FAILED;
+        relay->error = SPEED_AUTOTUNE_ERR_NO_OSCILLATION;
+        return;
+    }
+    
+    relay->ku = SPEED_AUTOTUNE_RELAY_DUTY * sqrtf(ur * ur + ui * ui) / y1;
+    relay->tu = (float)relay->count / SPEED_AUTOTUNE_CYCLES * SPEED_AUTOTUNE_PERIOD_MS * 0.001f;
+    relay->phase = SPEED_AUTOTUNE_DONE;
+}
+
+/**
+ * @brief  ̵ּ
+ * @param  relay  ṹָ
+ * @param  speed  ڳ (/)
+ * @return һռձȣʧʱΪ0
+ * @note   ת׶ƫռձȣȡƽΪģ֮ٸ+ͻʱе͡-ͻʱиߡ
+ *         ǰ SKIP_CYCLES ڣټ¼ CYCLES ںKu/Tu
+ */
+int32 speed_autotune_relay_step(speed_autotune_relay_t *relay, int16 speed)
+{
+    if (relay->phase == SPEED_AUTOTUNE_SPINUP)
+    {
+        relay->tick++;
+        if (relay->tick > SPEED_AUTOTUNE_SPINUP_SAMPLES / 2)
+        {
+            relay->spin_sum += speed;
+            relay->spin_count++;
+        }
+        if (relay->tick < SPEED_AUTOTUNE_SPINUP_SAMPLES)
+            return SPEED_AUTOTUNE_BIAS_DUTY;
+    
+        relay->setpoint = (float)relay->spin_sum / relay->spin_count;
+        if (relay->setpoint < SPEED_AUTOTUNE_MIN_SPEED)
+        {
+            relay->phase = SPEED_AUTOTUNE_FAILED;
+            relay->error = SPEED_AUTOTUNE_ERR_STALL;
+            return 0;
+        }
+        relay->phase = SPEED_AUTOTUNE_RELAY;
+        relay->tick = 0;
+        relay->relay = 1;
+    }
+    else if (relay->phase == SPEED_AUTOTUNE_RELAY)
+    {
+        relay->tick++;
+        if (speed > SPEED_AUTOTUNE_MAX_SPEED || speed < -SPEED_AUTOTUNE_MAX_SPEED)
+        {
+            relay->phase = SPEED_AUTOTUNE_FAILED;
+            relay->error = SPEED_AUTOTUNE_ERR_OVERSPEED;
+            return 0;
+        }
+    
+        // ¼ļ̵лǰ״̬
+        if (relay->switches > SPEED_AUTOTUNE_SKIP_CYCLES)
+        {
+            if (relay->count >= SPEED_AUTOTUNE_BUFFER)
+            {
+                relay->phase = SPEED_AUTOTUNE_FAILED;
+                relay->error = SPEED_AUTOTUNE_ERR_NO_OSCILLATION;
+                return 0;
+            }
+            relay->speed[relay->count] = speed;
+            relay->relay_log[relay->count] = relay->relay;
+            relay->count++;
+        }
+    
+        if (relay->relay > 0 && speed > relay->setpoint + SPEED_AUTOTUNE_HYSTERESIS)
+        {
+            relay->relay = -1;
+        }
+        else if (relay->relay < 0 && speed < relay->setpoint - SPEED_AUTOTUNE_HYSTERESIS)
+        {
+            relay->relay = 1;
+            relay->switches++;
+            if (relay->switches == SPEED_AUTOTUNE_SKIP_CYCLES + 1 + SPEED_AUTOTUNE_CYCLES)
+            {
+                speed_autotune_relay_finish(relay);
+                return 0;
+            }
+        }
+    }
+    else
+    {
+        return 0;
+    }
+    
+    return SPEED_AUTOTUNE_BIAS_DUTY + relay->relay * SPEED_AUTOTUNE_RELAY_DUTY;
+}
+
+/**
+ * @brief  ٶPID
+ * @param  ku     ٽ (ռձ / (/))
+ * @param  tu     ٽ (s)
+ * @param  gains  pid_calculate()һ£Ϊÿۼӣ΢Ϊ
+ * @return 
+ */
+void speed_autotune_gains(float ku, float tu, speed_autotune_gains_t *gains)
+{
+    const float *rule = speed_autotune_rule[SPEED_AUTOTUNE_RULE];
+    float period = SPEED_AUTOTUNE_PERIOD_MS * 0.001f;
+    
+    gains->kp = rule[0] * ku;
+    gains->ki = gains->kp * period / (rule[1] * tu);
+    gains->kd = gains->kp * rule[2] * tu / period;
+}
+
+#ifndef PID_HOST
+//========================================================================================================
+speed_autotune_t speed_autotune;
+
+/**
+ * @brief  ʼ
+ * @param  
+ * @return 
+ */
+void speed_autotune_init(void)
+{
+    speed_autotune.active = 0;
+    speed_autotune.finished = 0;
+    speed_autotune.divider = 0;
+    speed_autotune.elapsed_ms = 0;
+    speed_autotune_relay_reset(&speed_autotune.left);
+    speed_autotune_relay_reset(&speed_autotune.right);
+    speed_autotune.left.phase = SPEED_AUTOTUNE_IDLE;
+    speed_autotune.right.phase = SPEED_AUTOTUNE_IDLE;
+}
+
+/**
+ * @brief  ʼٶPID
+ * @param  
+ * @return 1-ѿʼ 0-л
+ * @note   գָԿռձ񵴣Լ SPINUP + (SKIP+CYCLES)Tuͨ1~2
+ */
+uint8 speed_autotune_start(void)
+{
+    if (smart_car.state == CAR_RUNNING || speed_autotune.active || motor_ident.active)
+        return 0;
+    
+    speed_autotune_relay_reset(&speed_autotune.left);
+    speed_autotune_relay_reset(&speed_autotune.right);
+    speed_autotune.left_last = odometry.left_total;
+    speed_autotune.right_last = odometry.right_total;
+    speed_autotune.divider = 0;
+    speed_autotune.elapsed_ms = 0;
+    speed_autotune.finished = 0;
+    speed_autotune.active = 1;
+    return 1;
+}
+
+/**
+ * @brief  Ƿѽ
+ */
+static uint8 speed_autotune_relay_ended(const speed_autotune_relay_t *relay)
+{
+    return relay->phase == SPEED_AUTOTUNE_DONE || relay->phase == SPEED_AUTOTUNE_FAILED;
+}
+
+/**
+ * @brief  δĵֱΪֹ
+ */
+static void speed_autotune_relay_abort(speed_autotune_relay_t *relay)
+{
+    if (!speed_autotune_relay_ended(relay))
+    {
+        relay->phase = SPEED_AUTOTUNE_FAILED;
+        relay->error = SPEED_AUTOTUNE_ERR_ABORTED;
+    }
+}
+
+/**
+ * @brief  жϸ
+ * @param  
+ * @return 
+ * @note   1msжodometry_update()֮ãδʱֱӷء SPEED_AUTOTUNE_PERIOD_MS Ƶ
+ *         ̼ۼƼΪ٣motor_update_speed()һ£ֽʱʱֹͣʱֱӽѭ
+ */
+void speed_autotune_update(void)
+{
+    if (!speed_autotune.active)
+        return;
+    
+    if (smart_car.state == CAR_RUNNING)
+    {
+        // ѷѭ
+        speed_autotune_relay_abort(&speed_autotune.left);
+        speed_autotune_relay_abort(&speed_autotune.right);
+        speed_autotune.active = 0;
+        speed_autotune.finished = 1;
+        return;
+    }
+    
+    speed_autotune.elapsed_ms++;
+    if (++speed_autotune.divider < SPEED_AUTOTUNE_PERIOD_MS)
+        return;
+    speed_autotune.divider = 0;
+    
+    int32 left_total = odometry.left_total;
+    int32 right_total = odometry.right_total;
+    int16 left_speed = (int16)(left_total - speed_autotune.left_last);
+    int16 right_speed = (int16)(right_total - speed_autotune.right_last);
+    speed_autotune.left_last = left_total;
+    speed_autotune.right_last = right_total;
+    
+    int32 left_duty = speed_autotune_relay_step(&speed_autotune.left, left_speed);
+    int32 right_duty = speed_autotune_relay_step(&speed_autotune.right, right_speed);
+    
+    if (speed_autotune.elapsed_ms >= SPEED_AUTOTUNE_TIMEOUT_MS)
+    {
+        speed_autotune_relay_abort(&speed_autotune.left);
+        speed_autotune_relay_abort(&speed_autotune.right);
+    }
+    
+    if (speed_autotune_relay_ended(&speed_autotune.left) && speed_autotune_relay_ended(&speed_autotune.right))
+    {
+        motor_set_duty(&car.left_motor, 0);
+        motor_set_duty(&car.right_motor, 0);
+        speed_autotune.active = 0;
+        speed_autotune.finished = 1;
+        return;
+    }
+    
+    motor_set_duty(&car.left_motor, left_duty);
+    motor_set_duty(&car.right_motor, right_duty);
+}
+
+/**
+ * @brief  
+ */
+static void speed_autotune_report(const char *name, const speed_autotune_relay_t *relay, const speed_autotune_gains_t *gains)
+{
+    if (relay->phase == SPEED_AUTOTUNE_DONE)
+        printf("AUTOTUNE %s ku=%f tu=%f setpoint=%f kp=%f ki=%f kd=%f\r\n",
+               name, relay->ku, relay->tu, relay->setpoint, gains->kp, gains->ki, gains->kd);
+    else
+        printf("AUTOTUNE %s failed: %d\r\n", name, relay->error);
+}
+
+/**
+ * @brief  
+ * @param  
+ * @return 1-־ɹд뵱ǰٶPID 0-δʧ
+ * @note   ѭеáֹһȡƽд pid_configs[current_pid_scene] ¼أ
+ *         λͨ1~3޸ĵͬһKu30%ʱʾе
+ *         øƵٶȻʱٶPIDƣͬʱKpKiΪmm/sλٶȻдٶȻPI
+ *         ٶȻֻPIKdʹãɵģǰ
+ */
+uint8 speed_autotune_poll(void)
+{
+    if (!speed_autotune.finished)
+        return 0;
+    speed_autotune.finished = 0;
+    
+    speed_autotune_relay_t *left = &speed_autotune.left;
+    speed_autotune_relay_t *right = &speed_autotune.right;
+    speed_autotune_gains_t left_gains = {0};
+    speed_autotune_gains_t right_gains = {0};
+    
+    if (left->phase == SPEED_AUTOTUNE_DONE)
+        speed_autotune_gains(left->ku, left->tu, &left_gains);
+    if (right->phase == SPEED_AUTOTUNE_DONE)
+        speed_autotune_gains(right->ku, right->tu, &right_gains);
+    speed_autotune_report("L", left, &left_gains);
+    speed_autotune_report("R", right, &right_gains);
+    
+    if (left->phase != SPEED_AUTOTUNE_DONE || right->phase != SPEED_AUTOTUNE_DONE)
+        return 0;
+    
+    if (fabsf(left->ku - right->ku) > 0.3f * fminf(left->ku, right->ku))
+        printf("AUTOTUNE warning: left/right ku differ, check mechanics and encoders\r\n");
+    
+    pid_params_t *speed = &smart_car.pid_configs[smart_car.current_pid_scene].speed;
+    speed->kp = 0.5f * (left_gains.kp + right_gains.kp);
+    speed->ki = 0.5f * (left_gains.ki + right_gains.ki);
+    speed->kd = 0.5f * (left_gains.kd + right_gains.kd);
+    smart_car_load_pid_config(smart_car.current_pid_scene);
+    printf("AUTOTUNE scene %d speed kp=%f ki=%f kd=%f\r\n", smart_car.current_pid_scene, speed->kp, speed->ki, speed->kd);
+    
+    if (speed_loop.enable)
+    {
+        // / -> mm/sְÿٶȻۼӣλʱۼӴΪڵ PERIOD/SPEED_LOOP_PERIOD 
+        float mm_s_per_count = speed_loop_counts_to_mm_s(1);
+        float loop_kp = speed->kp / mm_s_per_count;
+        float loop_ki = speed->ki / mm_s_per_count * SPEED_LOOP_PERIOD_MS / SPEED_AUTOTUNE_PERIOD_MS;
+    
+        speed_loop_set_gains(loop_kp, loop_ki);
+        printf("AUTOTUNE speed loop kp=%f ki=%f (kd unused)\r\n", loop_kp, loop_ki);
+    }
+    return 1;
+}
+
+/**
+ * @brief  ٶPID
+ * @param  
+ * @return 1-־ɹд뵱ǰٶPID 0-δܿʼʧ
+ * @note   ǰѭеãSPEED_AUTOTUNE_ON_BOOT1msжѿգ
+ *          SPEED_AUTOTUNE_TIMEOUT_MS봮ͬspeed_autotune_poll()
+ */
+uint8 speed_autotune_run(void)
+{
+    if (!speed_autotune_start())
+    {
+        printf("AUTOTUNE busy or car running\r\n");
+        return 0;
+    }
+    while (speed_autotune.active)
+        system_delay_ms(10);
+    return speed_autotune_poll();
+}
+#endif
@@ -0,0 +1,120 @@
+#ifndef _SPEED_AUTOTUNE_H_
+#define _SPEED_AUTOTUNE_H_
+
+#ifdef PID_HOST
+// λԱ루tools/speed_autotune_sim.c̵ֻ㷨
+#ifndef PID_HOST_TYPES
+#define PID_HOST_TYPES
+#include <stdint.h>
+typedef uint8_t  uint8;
+typedef int8_t   int8;
+typedef uint16_t uint16;
+typedef int16_t  int16;
+typedef uint32_t uint32;
+typedef int32_t  int32;
+typedef int64_t  int64;
+#endif
+#else
+#include "zf_common_headfile.h"
+#endif
+
+//====================================================ٶPID====================================================
+#define SPEED_AUTOTUNE_ON_BOOT      0           // ϵ󷢳ǰһٶPID (1-, 0-)
+#define SPEED_AUTOTUNE_BOOT_DELAY_MS 5000       // ϵĵȴʱ (ms)ڰѳŻ
+// ̵Astrom-Hagglundգÿ ƫáֵ ռձΧתԼ񵴣
+// 񵴻ٽKuٽTuٰΪٶPID
+#define SPEED_AUTOTUNE_PERIOD_MS    20          // ̵л (ms)ٶPIDһ£ٵλ/ڣ
+#define SPEED_AUTOTUNE_SPINUP_MS    600         // תʱ (ms)ƽΪ
+#define SPEED_AUTOTUNE_BIAS_DUTY    2000        // ת̵ռձ
+#define SPEED_AUTOTUNE_RELAY_DUTY   1000        // ̵ֵ (ռձ)
+#define SPEED_AUTOTUNE_HYSTERESIS   2.0f        // ̵ͻ (/)ڱ
+#define SPEED_AUTOTUNE_SKIP_CYCLES  2           // 
+#define SPEED_AUTOTUNE_CYCLES       4           // 
+#define SPEED_AUTOTUNE_BUFFER       160         //  ()δΪʧ
+#define SPEED_AUTOTUNE_TIMEOUT_MS   6000        // ܳʱ (ms)
+#define SPEED_AUTOTUNE_MIN_SPEED    10          // תٵڸֵ (/) Ϊת쳣
+#define SPEED_AUTOTUNE_MAX_SPEED    300         // ٳֵ (/) ֹͣ
+
+// 0-Z-N PI, 1-Z-N PID, 2-Tyreus-Luyben PI, 3-Tyreus-Luyben PID
+#define SPEED_AUTOTUNE_RULE         3
+
+//====================================================ݽṹ====================================================
+// ״̬
+typedef enum
+{
+    SPEED_AUTOTUNE_IDLE = 0,                    // δ
+    SPEED_AUTOTUNE_SPINUP,                      // ת
+    SPEED_AUTOTUNE_RELAY,                       // ̵
+    SPEED_AUTOTUNE_DONE,                        // ɣKu/TuЧ
+    SPEED_AUTOTUNE_FAILED                       // ʧܣerror
+} speed_autotune_phase_enum;
+
+// ʧԭ
+typedef enum
+{
+    SPEED_AUTOTUNE_OK = 0,
+    SPEED_AUTOTUNE_ERR_STALL,                   // תٹ
+    SPEED_AUTOTUNE_ERR_OVERSPEED,               // ٳ
+    SPEED_AUTOTUNE_ERR_NO_OSCILLATION,          // δɼ
+    SPEED_AUTOTUNE_ERR_ABORTED                  // ʱ򷢳ֹ
+} speed_autotune_error_enum;
+
+// ̵ּ
+typedef struct
+{
+    speed_autotune_phase_enum phase;
+    speed_autotune_error_enum error;
+    uint16 tick;                                // ׶β
+    int32 spin_sum;                             // תγۼ
+    uint16 spin_count;
+    float setpoint;                             // ĳ (/)
+    int8 relay;                                 // ̵״̬ (+1/-1)
+    uint8 switches;                             // ̵ɵиߴ
+    uint16 count;                               // SKIP_CYCLESɵиߺʼ¼
+    int16 speed[SPEED_AUTOTUNE_BUFFER];         // 
+    int8 relay_log[SPEED_AUTOTUNE_BUFFER];      // Ӧļ̵״̬
+    float ku;                                   // ٽ (ռձ / (/))
+    float tu;                                   // ٽ (s)
+} speed_autotune_relay_t;
+
+// 
+typedef struct
+{
+    float kp;
+    float ki;
+    float kd;
+} speed_autotune_gains_t;
+
+#ifndef PID_HOST
+// ٶPIDṹ
+typedef struct
+{
+    volatile uint8 active;                      // 1msж
+    volatile uint8 finished;                    // ־ѽȴѭ
+    uint8 divider;                              // жϷƵ
+    uint16 elapsed_ms;                          // ʱ (ms)
+    int32 left_last;                            // ϴβ̼ۼƼ
+    int32 right_last;
+    speed_autotune_relay_t left;                // 
+    speed_autotune_relay_t right;               // 
+} speed_autotune_t;
+
+//====================================================ȫֱ====================================================
+extern speed_autotune_t speed_autotune;
+#endif
+
+//========================================================================================================
+// ̵㷨Ӳ޹أ
+void  speed_autotune_relay_reset(speed_autotune_relay_t *relay);
+int32 speed_autotune_relay_step(speed_autotune_relay_t *relay, int16 speed);   // ÿ복٣ռձ
+void  speed_autotune_gains(float ku, float tu, speed_autotune_gains_t *gains);  // PID
+
+#ifndef PID_HOST
+void  speed_autotune_init(void);                                // ʼ
+uint8 speed_autotune_start(void);                               // ͣʱʼգɹ1
+void  speed_autotune_update(void);                              // 1msжеã̵ռձ
+uint8 speed_autotune_poll(void);                                // ѭеãд뵱ǰٶPIDɹ1
+uint8 speed_autotune_run(void);                                 // һǰãɹ1
+#endif
+
+#endif // _SPEED_AUTOTUNE_H_
@@ -0,0 +1,228 @@
+#include "speed_loop.h"
+#include "speed_planner.h"
+#include "brake_control.h"
+#include <math.h>
+#include <string.h>
+
+// ƵٶȻȫֱ
+speed_loop_t speed_loop;
+
+#define SPEED_LOOP_OBSERVER_DT      (ODOMETRY_PERIOD_MS / 1000.0f)
+#define SPEED_LOOP_DT               (SPEED_LOOP_PERIOD_MS / 1000.0f)
+#define SPEED_LOOP_OBSERVER_W       (2.0f * 3.14159f * SPEED_LOOP_OBSERVER_HZ)
+#define SPEED_LOOP_OBSERVER_KP      (2.0f * SPEED_LOOP_OBSERVER_ZETA * SPEED_LOOP_OBSERVER_W)
+#define SPEED_LOOP_OBSERVER_KI      (SPEED_LOOP_OBSERVER_W * SPEED_LOOP_OBSERVER_W)
+
+/**
+ * @brief  ٶȻʼ
+ * @param  wheel  ٶȻ
+ * @param  total  ̼ƵǰۼƼ
+ * @return 
+ */
+static void speed_loop_wheel_init(speed_loop_wheel_t *wheel, int32 total)
+{
+    memset(wheel, 0, sizeof(*wheel));
+    wheel->last_total = total;
+}
+
+/**
+ * @brief  ƵٶȻʼ
+ * @param  
+ * @return 
+ * @note   odometry_init()֮
+ */
+void speed_loop_init(void)
+{
+    memset(&speed_loop, 0, sizeof(speed_loop));
+    speed_loop_wheel_init(&speed_loop.left, odometry.left_total);
+    speed_loop_wheel_init(&speed_loop.right, odometry.right_total);
+    
+    pid_batch_init(&speed_loop.pi);
+    for (uint8 i = 0; i < 2; i++)
+    {
+        pid_batch_add(&speed_loop.pi, SPEED_LOOP_KP, SPEED_LOOP_KI, 0.0f, MOTOR_MAX_DUTY, -MOTOR_MAX_DUTY);
+        pid_batch_set_integral_limit(&speed_loop.pi, i, SPEED_LOOP_INTEGRAL_MAX);
+        pid_batch_set_antiwindup(&speed_loop.pi, i, SPEED_LOOP_ANTIWINDUP_KT);
+    }
+    speed_loop.enable = SPEED_LOOP_ENABLE;
+}
+
+/**
+ * @brief  PIĿ
+ * @param  
+ * @return 
+ * @note   ʱã۲״̬ٹƲж
+ */
+void speed_loop_reset(void)
+{
+    speed_loop.steps_left = 0;
+    speed_loop.stats_count = 0;
+    
+    speed_loop.left.target = 0.0f;
+    speed_loop.left.target_step = 0.0f;
+    speed_loop.left.error_sq_sum = 0.0f;
+    memset(speed_loop.left.target_history, 0, sizeof(speed_loop.left.target_history));
+    pid_batch_reset(&speed_loop.pi, 0);
+    
+    speed_loop.right.target = 0.0f;
+    speed_loop.right.target_step = 0.0f;
+    speed_loop.right.error_sq_sum = 0.0f;
+    memset(speed_loop.right.target_history, 0, sizeof(speed_loop.right.target_history));
+    pid_batch_reset(&speed_loop.pi, 1);
+}
+
+/**
+ * @brief  ַPI
+ * @param  kp  ϵ (duty / (mm/s))
+ * @param  ki  ϵ (duty / (mm/sٶȻ))
+ * @return 
+ * @note   ͣʱãٶPIDд룩ʱspeed_loop_reset()
+ */
+void speed_loop_set_gains(float kp, float ki)
+{
+    pid_batch_set_gains(&speed_loop.pi, 0, kp, ki, 0.0f);
+    pid_batch_set_gains(&speed_loop.pi, 1, kp, ki, 0.0f);
+}
+
+/**
+ * @brief  ָٹ۲
+ * @param  wheel        ٶȻ
+ * @param  total        ̼ۼƼ
+ * @param  mm_per_count ÿ (mm)
+ * @return 
+ * @note   ʽٻֻλλãʱҲʧ㾫ȣ
+ *         һڵļٶȷֱʲ1/ڣûаڵƽͺ
+ */
+static void speed_loop_wheel_observe(speed_loop_wheel_t *wheel, int32 total, float mm_per_count)
+{
+    wheel->observer_error += (float)(total - wheel->last_total);
+    wheel->last_total = total;
+    
+    wheel->observer_integrator += SPEED_LOOP_OBSERVER_KI * wheel->observer_error * SPEED_LOOP_OBSERVER_DT;
+    float velocity = wheel->observer_integrator + SPEED_LOOP_OBSERVER_KP * wheel->observer_error;
+    wheel->observer_error -= velocity * SPEED_LOOP_OBSERVER_DT;
+    
+    wheel->speed = velocity * mm_per_count;
+}
+
+/**
+ * @brief  ٹ۲
+ * @param  
+ * @return 
+ * @note   1msжodometry_update()֮ãͣʱҲ
+ */
+void speed_loop_observe(void)
+{
+    speed_loop_wheel_observe(&speed_loop.left, odometry.left_total, odometry.mm_per_count_left);
+    speed_loop_wheel_observe(&speed_loop.right, odometry.right_total, odometry.mm_per_count_right);
+}
+
+/**
+ * @brief  ǰPI
+ * @param  wheel  ٶȻ
+ * @param  index  PI±
+ * @param  accel  Ŀٶ (mm/s^2)
+ * @param  model  ֵģ
+ * @return 
+ */
+static void speed_loop_wheel_input(speed_loop_wheel_t *wheel, uint8 index, float accel, const motor_model_t *model)
+{
+    wheel->feedforward = motor_model_feedforward(model, wheel->target, accel);
+    
+    // PIοȡӳ֮ǰĿ꣺ǰҪӳٲſʼ仯
+    uint8 delay = (uint8)(model->deadtime / SPEED_LOOP_DT + 0.5f);
+    if (delay >= SPEED_LOOP_DELAY_MAX)
+        delay = SPEED_LOOP_DELAY_MAX - 1;
+    wheel->history_index = (wheel->history_index + 1) % SPEED_LOOP_DELAY_MAX;
+    wheel->target_history[wheel->history_index] = wheel->target;
+    wheel->reference = wheel->target_history[(wheel->history_index + SPEED_LOOP_DELAY_MAX - delay) % SPEED_LOOP_DELAY_MAX];
+    
+    speed_loop.pi.target[index] = wheel->reference;
+    speed_loop.pi.measurement[index] = wheel->speed;
+    speed_loop.pi.feedforward[index] = wheel->feedforward;
+    
+    float error = wheel->reference - wheel->speed;
+    wheel->error_sq_sum += error * error;
+}
+
+/**
+ * @brief  ٶȻ
+ * @param  
+ * @return 
+ * @note   1msжspeed_loop_observe()֮СʱãÿSPEED_LOOP_PERIOD_MSִһΣ
+ *         Ŀٶ·ԲֵֵбΪٶǰ = ǰ + PI
+ */
+void speed_loop_control(void)
+{
+    if (!speed_loop.enable)
+        return;
+    
+    if (++speed_loop.divider < SPEED_LOOP_PERIOD_MS / ODOMETRY_PERIOD_MS)
+        return;
+    speed_loop.divider = 0;
+    
+    float accel_left = 0.0f;
+    float accel_right = 0.0f;
+    
+    if (speed_loop.steps_left > 0)
+    {
+        speed_loop.left.target += speed_loop.left.target_step;
+        speed_loop.right.target += speed_loop.right.target_step;
+        accel_left = speed_loop.left.target_step / SPEED_LOOP_DT;
+        accel_right = speed_loop.right.target_step / SPEED_LOOP_DT;
+        speed_loop.steps_left--;
+    }
+    
+    speed_loop_wheel_input(&speed_loop.left, 0, accel_left, &car.left_motor.model);
+    speed_loop_wheel_input(&speed_loop.right, 1, accel_right, &car.right_motor.model);
+    speed_loop.pi.output_max[0] = (float)car.left_motor.duty_cap;   // ǣ޲뷴㿹
+    speed_loop.pi.output_max[1] = (float)car.right_motor.duty_cap;
+    pid_batch_calculate(&speed_loop.pi);
+    speed_loop.left.output = brake_blend(&brake, &brake.left, speed_loop.pi.output[0]);
+    speed_loop.right.output = brake_blend(&brake, &brake.right, speed_loop.pi.output[1]);
+    if (brake.state == BRAKE_ACTIVE)
+    {
+        // ƶPIʱƶռձȹɵǰ + 
+        pid_batch_reset(&speed_loop.pi, 0);
+        pid_batch_reset(&speed_loop.pi, 1);
+    }
+    
+    motor_set_duty(&car.left_motor, (int32)speed_loop.left.output);
+    motor_set_duty(&car.right_motor, (int32)speed_loop.right.output);
+    
+    if (++speed_loop.stats_count >= SPEED_LOOP_STATS_SAMPLES)
+    {
+        speed_loop.left.error_rms = sqrtf(speed_loop.left.error_sq_sum / speed_loop.stats_count);
+        speed_loop.right.error_rms = sqrtf(speed_loop.right.error_sq_sum / speed_loop.stats_count);
+        speed_loop.left.error_sq_sum = 0.0f;
+        speed_loop.right.error_sq_sum = 0.0f;
+        speed_loop.stats_count = 0;
+    }
+}
+
+/**
+ * @brief  ·Ŀٶ
+ * @param  left   Ŀٶ (mm/s)
+ * @param  right  Ŀٶ (mm/s)
+ * @return 
+ * @note   еãɱ1msжռֵдٶȻһµĿ
+ */
+void speed_loop_set_target(float left, float right)
+{
+    uint8 steps = SPEED_LOOP_CONTROL_MS / SPEED_LOOP_PERIOD_MS;
+    
+    speed_loop.steps_left = 0;
+    speed_loop.left.target_step = (left - speed_loop.left.target) / steps;
+    speed_loop.right.target_step = (right - speed_loop.right.target) / steps;
+    speed_loop.steps_left = steps;
+}
+
+/**
+ * @brief  תΪ
+ * @param  counts  /
+ * @return  (mm/s)
+ */
+float speed_loop_counts_to_mm_s(int16 counts)
+{
+    return (float)counts * 1000.0f * 1000.0f / (SPEED_PLANNER_PERIOD_MS * (float)ENCODER_COUNT_PER_METER);
+}
@@ -0,0 +1,75 @@
+#ifndef _SPEED_LOOP_H_
+#define _SPEED_LOOP_H_
+
+#include "zf_common_headfile.h"
+#include "pid_batch.h"
+#include "motor_control.h"
+#include "odometry.h"
+
+//====================================================ƵٶȻ====================================================
+#define SPEED_LOOP_ENABLE           1           // ǷøƵٶȻ (1-2msٶȻ, 0-ٶPID)
+#define SPEED_LOOP_PERIOD_MS        2           // ٶȻ (ms)ODOMETRY_PITжϷƵ
+#define SPEED_LOOP_CONTROL_MS       20          // Ŀٶ· (ms)CCU60_CH0һ
+
+// ٹ۲e = ʵλ - ۲λãv = Kie + KpeKp = 2ƦأKi = ^2
+#define SPEED_LOOP_OBSERVER_HZ      25.0f       // ۲ (Hz)ԽӦԽ졢Խ
+#define SPEED_LOOP_OBSERVER_ZETA    1.0f        // ۲
+
+// ǰֵģͣcar.xxx_motor.model棬duty = (v + ӡa)/gain + sign(v)
+// PIοΪӳģʹӳٵĿ꣬ǰЧǰȶ
+#define SPEED_LOOP_DELAY_MAX        8           // οӳٻ (ٶȻ)ӳٳʱֵ
+
+// PIÿٶȻڼһΣ
+#define SPEED_LOOP_KP               8.0f        // ϵ (duty / (mm/s))
+#define SPEED_LOOP_KI               0.16f       // ϵ (duty / (mm/s))
+#define SPEED_LOOP_INTEGRAL_MAX     25000.0f    // ޷ۻ
+#define SPEED_LOOP_ANTIWINDUP_KT    0.5f        // 㿹ϵʱÿڴӻĳ
+
+#define SPEED_LOOP_STATS_SAMPLES    500         // RMSͳƴڣٶȻ
+
+//====================================================ݽṹ====================================================
+// ٶȻ
+typedef struct
+{
+    int32 last_total;               // ϴζȡ̼ۼƼ
+    float observer_error;           // ۲λ (counts)
+    float observer_integrator;      // ۲ (counts/s)
+    float speed;                    // ۲⳵ (mm/s)
+    
+    float target;                   // ǰĿٶ (mm/s)·Բֵ
+    float reference;                // PIο (mm/s)Ŀӳٵģʹӳ
+    float target_history[SPEED_LOOP_DELAY_MAX]; // ĿʷΣ
+    uint8 history_index;            // Ŀ±
+    float target_step;              // ÿٶȻڵĿ (mm/s)
+    float feedforward;              // ǰ (duty)
+    float output;                   //  (duty)
+    
+    float error_sq_sum;             // ƽ
+    float error_rms;                // һͳƴڵĸRMS (mm/s)
+} speed_loop_wheel_t;
+
+// ƵٶȻṹ
+typedef struct
+{
+    uint8 enable;                   // ǷɸƵٶȻ
+    uint8 divider;                  // жϷƵ
+    uint8 steps_left;               // Ŀֵʣಽ
+    uint16 stats_count;             // ͳƴ
+    speed_loop_wheel_t left;        // 
+    speed_loop_wheel_t right;       // 
+    pid_batch_t pi;                 // ַPI±0-, 1-֣ǰΪ޷뿹
+} speed_loop_t;
+
+//====================================================ȫֱ====================================================
+extern speed_loop_t speed_loop;
+
+//========================================================================================================
+void  speed_loop_init(void);                                    // ٶȻʼ
+void  speed_loop_reset(void);                                   // PIĿ꣨ʱã
+void  speed_loop_set_gains(float kp, float ki);                 // ַPImm/sλ
+void  speed_loop_observe(void);                                 // 1msжϣٹ۲³٣ͣʱҲУ
+void  speed_loop_control(void);                                 // 1msжϣÿSPEED_LOOP_PERIOD_MSǰ+PI
+void  speed_loop_set_target(float left, float right);           // ·Ŀٶ (mm/s)
+float speed_loop_counts_to_mm_s(int16 counts);                  // / תΪ mm/s
+
+#endif // _SPEED_LOOP_H_
@@ -0,0 +1,169 @@
+#include "speed_planner.h"
+#include "lap_memory.h"
+#include <math.h>
+#include <string.h>
+
+// ٶȹ滮ȫֱ
+speed_planner_t speed_planner;
+
+/**
+ * @brief  ٶȹ滮ʼ
+ * @param  
+ * @return 
+ */
+void speed_planner_init(void)
+{
+    memset(&speed_planner, 0, sizeof(speed_planner));
+    speed_planner.limit_speed = SPEED_PLANNER_MIN_SPEED;
+}
+
+/**
+ * @brief  λĿٶ
+ * @param  speed  ʼĿٶ (m/s)
+ * @return 
+ */
+void speed_planner_reset(float speed)
+{
+    speed_planner.target_speed = speed;
+}
+
+/**
+ * @brief  m/s תΪ /
+ * @param  speed  ٶ (m/s)
+ * @return /ڣmotor_update_speed()ٶȵλһ£
+ */
+int16 speed_planner_to_counts(float speed)
+{
+    return (int16)(speed * ENCODER_COUNT_PER_METER * SPEED_PLANNER_PERIOD_MS / 1000.0f + 0.5f);
+}
+
+/**
+ * @brief  Բ
+ * @param  i  м±꣬ǰȡSPEED_PLANNER_CURVE_SPAN
+ * @return  (1/m)
+ * @note    = 2|ABAC| / (|AB||BC||CA|)
+ */
+static float planner_curvature(uint8 i)
+{
+    float ax = speed_planner.point_x[i - SPEED_PLANNER_CURVE_SPAN];
+    float ay = speed_planner.point_y[i - SPEED_PLANNER_CURVE_SPAN];
+    float bx = speed_planner.point_x[i];
+    float by = speed_planner.point_y[i];
+    float cx = speed_planner.point_x[i + SPEED_PLANNER_CURVE_SPAN];
+    float cy = speed_planner.point_y[i + SPEED_PLANNER_CURVE_SPAN];
+    
+    float cross = (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+    float ab = sqrtf((bx - ax) * (bx - ax) + (by - ay) * (by - ay));
+    float bc = sqrtf((cx - bx) * (cx - bx) + (cy - by) * (cy - by));
+    float ca = sqrtf((ax - cx) * (ax - cx) + (ay - cy) * (ay - cy));
+    float denom = ab * bc * ca;
+    
+    if (denom < 1e-6f)
+        return 0.0f;
+    
+    return 2.0f * fabsf(cross) / denom;
+}
+
+/**
+ * @brief  ÿ֡ٶ
+ * @param  
+ * @return 
+ * @note   ӽԶ߲Ϊ꣬   d
+ *         ٶ v = sqrt(a_lat / )Ϊ d  vǰٶ = sqrt(v^2 + 2a_decd)
+ *         ͬʱҪڿɼǰհͣ¡ȡԼСֵ
+ */
+void speed_planner_update(void)
+{
+    uint8 count = 0;
+    int top_row = IMAGE_HEIGHT - Search_Stop_Line;
+    
+    // ߲¶ϣ
+    for (int row = IMAGE_HEIGHT - 1; row >= top_row && row >= 0 && count < SPEED_PLANNER_MAX_POINTS;
+         row -= SPEED_PLANNER_ROW_STEP)
+    {
+        if (Row_Distance[row] <= 0.0f)
+            break;
+        if (vision.track.track_width[row] < TRACK_WIDTH_MIN || vision.track.track_width[row] > TRACK_WIDTH_MAX)
+            continue;
+        
+        vision_pixel_to_world((uint8)row, vision.track.center_line[row],
+                              &speed_planner.point_x[count], &speed_planner.point_y[count]);
+        count++;
+    }
+    speed_planner.point_count = count;
+    
+    speed_planner.curvature_max = 0.0f;
+    speed_planner.curvature_distance = 0.0f;
+    
+    if (!vision.track_found || count < 2 * SPEED_PLANNER_CURVE_SPAN + 1)
+    {
+        speed_planner.lookahead = 0.0f;
+        speed_planner.limit_speed = SPEED_PLANNER_MIN_SPEED;
+        return;
+    }
+    
+    float limit = SPEED_PLANNER_MAX_SPEED;
+    speed_planner.lookahead = speed_planner.point_y[count - 1];
+    
+    // ǰհڱͣ
+    float visible = sqrtf(2.0f * SPEED_PLANNER_DECEL * speed_planner.lookahead);
+    if (visible < limit)
+        limit = visible;
+    
+    for (uint8 i = SPEED_PLANNER_CURVE_SPAN; i + SPEED_PLANNER_CURVE_SPAN < count; i++)
+    {
+        float kappa = planner_curvature(i);
+        
+        if (kappa > speed_planner.curvature_max)
+        {
+            speed_planner.curvature_max = kappa;
+            speed_planner.curvature_distance = speed_planner.point_y[i];
+        }
+        if (kappa < SPEED_PLANNER_CURVATURE_MIN)
+            continue;
+        
+        float v_curve = sqrtf(SPEED_PLANNER_LAT_ACCEL / kappa);
+        float v_allow = sqrtf(v_curve * v_curve + 2.0f * SPEED_PLANNER_DECEL * speed_planner.point_y[i]);
+        
+        if (v_allow < limit)
+            limit = v_allow;
+    }
+    
+    if (limit < SPEED_PLANNER_MIN_SPEED)
+        limit = SPEED_PLANNER_MIN_SPEED;
+    
+    speed_planner.limit_speed = limit;
+}
+
+/**
+ * @brief  ȡбºĿٶ
+ * @param  
+ * @return Ŀٶȣ/ڣ
+ * @note   ÿڵһΣĿٶSPEED_PLANNER_ACCEL/SPEED_PLANNER_DECELٶޱƽ
+ *         ǰǰ٣𲽼١profile_speedʱȦٶΪޣ
+ *         Ӿʵʱ滮߳LAP_MEMORY_VISION_MARGIN
+ */
+int16 speed_planner_get_target(void)
+{
+    float dt = SPEED_PLANNER_PERIOD_MS / 1000.0f;
+    float limit = speed_planner.limit_speed;
+    
+    if (speed_planner.profile_speed > 0.0f)
+    {
+        limit = speed_planner.profile_speed;
+        if (limit > speed_planner.limit_speed + LAP_MEMORY_VISION_MARGIN)
+            limit = speed_planner.limit_speed + LAP_MEMORY_VISION_MARGIN;
+    }
+    
+    float error = limit - speed_planner.target_speed;
+    
+    if (error > SPEED_PLANNER_ACCEL * dt)
+        error = SPEED_PLANNER_ACCEL * dt;
+    else if (error < -SPEED_PLANNER_DECEL * dt)
+        error = -SPEED_PLANNER_DECEL * dt;
+    
+    speed_planner.target_speed += error;
+    speed_planner.decel = error < 0.0f ? -error / dt : 0.0f;
+    
+    return speed_planner_to_counts(speed_planner.target_speed);
+}
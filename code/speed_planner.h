@@ -0,0 +1,54 @@
+#ifndef _SPEED_PLANNER_H_
+#define _SPEED_PLANNER_H_
+
+#include "zf_common_headfile.h"
+#include "vision_track.h"
+#include "motor_control.h"
+#include "brake_control.h"
+
+//====================================================ٶȹ滮====================================================
+#define SPEED_PLANNER_DEFAULT       0           // ϵǷٶȹ滮 (1-, 0-ٶ)ȱ궨ENCODER_COUNT_PER_METERͷͶӰ
+#define SPEED_PLANNER_PERIOD_MS     20          //  (ms)CCU60_CH0һ
+#define SPEED_PLANNER_MAX_SPEED     3.0f        // ٶ (m/s)
+#define SPEED_PLANNER_MIN_SPEED     0.8f        // ٶ (m/s)ʱʹ
+#define SPEED_PLANNER_LAT_ACCEL     4.0f        // ٶ (m/s^2)
+#define SPEED_PLANNER_ACCEL         3.0f        // б (m/s^2)
+#if BRAKE_ENABLE
+#define SPEED_PLANNER_DECEL         8.0f        // б (m/s^2)Ҳǰƶ㣻ƶʵڣɽӽż
+#else
+#define SPEED_PLANNER_DECEL         6.0f        // б (m/s^2)Ҳǰƶ
+#endif
+#define SPEED_PLANNER_CURVATURE_MIN 0.05f       // СڸΪֱ (1/m)
+
+#define SPEED_PLANNER_ROW_STEP      6           // ߲в
+#define SPEED_PLANNER_MAX_POINTS    20          // 
+#define SPEED_PLANNER_CURVE_SPAN    2           // ʱڵ
+
+//====================================================ݽṹ====================================================
+// ٶȹ滮ṹ
+typedef struct
+{
+    uint8 point_count;                          // ֡Ч
+    float point_x[SPEED_PLANNER_MAX_POINTS];    // ߲ (m)
+    float point_y[SPEED_PLANNER_MAX_POINTS];    // ߲ǰ (m)
+    
+    float curvature_max;                        // ǰհΧ (1/m)
+    float curvature_distance;                   // ʴľ (m)
+    float lookahead;                            // ɼǰհ (m)
+    float limit_speed;                          // ֡滮ٶ (m/s)
+    float target_speed;                         // ӼбºĿٶ (m/s)
+    float decel;                                // Ŀٶȵļٶ (m/s^2Ϊ)ƶж
+    float profile_speed;                        // ȦٶߵԤٶ (m/s)0ʾʹ
+} speed_planner_t;
+
+//====================================================ȫֱ====================================================
+extern speed_planner_t speed_planner;
+
+//========================================================================================================
+void  speed_planner_init(void);                                 // ٶȹ滮ʼ
+void  speed_planner_reset(float speed);                         // λĿٶȣʱã
+void  speed_planner_update(void);                               // ÿ֡ʼٶ
+int16 speed_planner_get_target(void);                           // ÿڵãбºĿٶȣ/ڣ
+int16 speed_planner_to_counts(float speed);                     // m/s תΪ /
+
+#endif // _SPEED_PLANNER_H_
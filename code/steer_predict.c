@@ -0,0 +1,271 @@
+#include "steer_predict.h"
+#include "odometry.h"
+#include <math.h>
+#include <string.h>
+
+// תǰӳٲȫֱ
+steer_predict_t steer_predict;
+
+/**
+ * @brief  תǰӳٲʼ
+ * @param  
+ * @return 
+ */
+void steer_predict_init(void)
+{
+    memset(&steer_predict, 0, sizeof(steer_predict));
+}
+
+/**
+ * @brief  ¼ͬʱ
+ * @param  
+ * @return 
+ * @note   ͷͬⲿжеãʱΪ̼ƻڼ
+ */
+void steer_predict_capture_start(void)
+{
+    steer_predict.vsync_ms = odometry.tick * ODOMETRY_PERIOD_MS;
+}
+
+/**
+ * @brief  汾֡ʱ
+ * @param  
+ * @return 
+ * @note   ͷDMAжеãͼǰһ֡ĳͬǱ֡ʱ
+ */
+void steer_predict_capture_done(void)
+{
+    steer_predict.capture_ms = steer_predict.vsync_ms;
+}
+
+/**
+ * @brief  ߶
+ * @param  frame  ֡
+ * @return 
+ * @note   ٶȹ滮ͬķʽ߲Ϊ꣬С x = a + by + cy^2
+ *         3x3淽ÿĬ
+ */
+static void steer_predict_fit(steer_predict_frame_t *frame)
+{
+    float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f, s4 = 0.0f;
+    float t0 = 0.0f, t1 = 0.0f, t2 = 0.0f;
+    float far = 0.0f;
+    uint8 count = 0;
+    int top_row = IMAGE_HEIGHT - Search_Stop_Line;
+    
+    frame->fit_valid = 0;
+    
+    for (int row = IMAGE_HEIGHT - 1; row >= top_row && row >= 0; row -= STEER_PREDICT_ROW_STEP)
+    {
+        if (Row_Distance[row] <= 0.0f || Row_Distance[row] > STEER_PREDICT_FIT_MAX_DIST)
+            break;
+        if (vision.track.track_width[row] < TRACK_WIDTH_MIN || vision.track.track_width[row] > TRACK_WIDTH_MAX)
+            continue;
+    
+        float x, y;
+        vision_pixel_to_world((uint8)row, vision.track.center_line[row], &x, &y);
+    
+        float y2 = y * y;
+        s0 += 1.0f;
+        s1 += y;
+        s2 += y2;
+        s3 += y2 * y;
+        s4 += y2 * y2;
+        t0 += x;
+        t1 += x * y;
+        t2 += x * y2;
+        far = y;
+        count++;
+    }
+    
+    if (count < STEER_PREDICT_FIT_MIN_POINTS)
+        return;
+    
+    float det = s0 * (s2 * s4 - s3 * s3) - s1 * (s1 * s4 - s3 * s2) + s2 * (s1 * s3 - s2 * s2);
+    if (fabsf(det) < 1e-9f)
+        return;
+    
+    frame->fit_a = (t0 * (s2 * s4 - s3 * s3) - s1 * (t1 * s4 - s3 * t2) + s2 * (t1 * s3 - s2 * t2)) / det;
+    frame->fit_b = (s0 * (t1 * s4 - s3 * t2) - t0 * (s1 * s4 - s3 * s2) + s2 * (s1 * t2 - t1 * s2)) / det;
+    frame->fit_c = (s0 * (s2 * t2 - t1 * s3) - s1 * (s1 * t2 - t1 * s2) + t0 * (s1 * s3 - s2 * s2)) / det;
+    frame->fit_far = far;
+    frame->fit_valid = 1;
+}
+
+/**
+ * @brief  ǰ֡عʱ
+ * @param  
+ * @return عʱ (ms̼ʱ)
+ * @note   ͼڼãΪһ֡ɼʱĳͬʱ̼ȥعǰ
+ */
+uint32 steer_predict_frame_timestamp(void)
+{
+    return steer_predict.capture_ms - STEER_PREDICT_EXPOSURE_MS;
+}
+
+/**
+ * @brief  ָʱ̵ǰĳλ˱仯
+ * @param  timestamp_ms  ʼʱ̣ͼعʱ̣
+ * @param  dx            ǰ (m)
+ * @param  dy             (m)
+ * @param  dpsi          ת (rad)
+ * @return 
+ * @note   ̼ʷʼʱ̵ǰλ˱仯㵽ʼʱ̳ϵ
+ *         ٰǰ뺽ٶSTEER_PREDICT_LEAD_MSӦ̼ʷʱʷλˣ㣩
+ */
+void steer_predict_motion(uint32 timestamp_ms, float *dx, float *dy, float *dpsi)
+{
+    odometry_pose_t now;
+    odometry_pose_t then;
+    
+    odometry_get_pose(&now);
+    odometry_get_pose_at(timestamp_ms, &then);
+    
+    float c0 = cosf(then.heading);
+    float s0 = sinf(then.heading);
+    float wx = (now.x - then.x) * 0.001f;
+    float wy = (now.y - then.y) * 0.001f;
+    float forward = c0 * wx + s0 * wy;
+    float left = -s0 * wx + c0 * wy;
+    float turn = now.heading - then.heading;
+    
+    // ƶӦʱ
+    float lead = STEER_PREDICT_LEAD_MS / 1000.0f;
+    float step = now.speed * 0.001f * lead;
+    float mid = turn + now.yaw_rate * lead * 0.5f;
+    
+    *dx = forward + step * cosf(mid);
+    *dy = left + step * sinf(mid);
+    *dpsi = turn + now.yaw_rate * lead;
+}
+
+/**
+ * @brief  ÿ֡
+ * @param  
+ * @return 
+ * @note   vision_image_process()֮ávision_get_deviation()ͬȨƫԳƺתȣ
+ *         dʱr d/scale[r] أתʱ סdist[r]/scale[r] أ
+ *         ʦʵʻʱrп ʡdist[r]^2/2/scale[r] أȨƽƫı仯
+ *         дǻ֡л±꣬жʼնһ֡
+ */
+void steer_predict_update(void)
+{
+    steer_predict_frame_t *frame = &steer_predict.frame[steer_predict.active ^ 1];
+    float sum_weight = 0.0f;
+    float sum_shift = 0.0f;
+    float sum_turn = 0.0f;
+    float sum_curve = 0.0f;
+    
+    frame->timestamp_ms = steer_predict_frame_timestamp();
+    frame->valid = vision.track_found;
+    frame->fit_valid = 0;
+    frame->pixel_per_m = 0.0f;
+    frame->pixel_per_rad = 0.0f;
+    frame->pixel_per_curvature = 0.0f;
+    
+    if (frame->valid)
+    {
+        for (uint8 row = SCAN_START_ROW; row > SCAN_END_ROW; row -= SCAN_STEP)
+        {
+            if (vision.track.track_width[row] < TRACK_WIDTH_MIN || vision.track.track_width[row] > TRACK_WIDTH_MAX)
+                continue;
+            if (Row_Scale[row] <= 0.0f)
+                continue;
+    
+            float weight = (float)vision_row_weight(row);
+            sum_weight += weight;
+            sum_shift += weight / Row_Scale[row];
+            sum_turn += weight * Row_Distance[row] / Row_Scale[row];
+            sum_curve += weight * Row_Distance[row] * Row_Distance[row] * 0.5f / Row_Scale[row];
+        }
+    
+        if (sum_weight > 0.0f)
+        {
+            frame->pixel_per_m = sum_shift / sum_weight;
+            frame->pixel_per_rad = sum_turn / sum_weight;
+            frame->pixel_per_curvature = sum_curve / sum_weight;
+        }
+    
+        steer_predict_fit(frame);
+    }
+    
+    steer_predict.active ^= 1;
+}
+
+/**
+ * @brief  ӳٲǰ
+ * @param  deviation  vision_get_deviation()ͼƫ ()
+ * @return 㵽ǰʱ̣STEER_PREDICT_LEAD_MS۳ǰֵƫ ()
+ * @note   ڵásteer_predict_motion()عʱ̵ǰλ˱仯ǰdxdyתdףǰƺͬһпϸԶdxĵ㣬СǶȽ
+ *         ƫ = dypixel_per_m + dסpixel_per_rad + dx(bpixel_per_m + 2cpixel_per_rad) + cdx^2pixel_per_m
+ *         ǰȡﴦy = dx  = 2c / (1 + (b + 2cy)^2)^1.5 = atan(L)
+ *         ǰѸתǣʴƫп۳ظʻʱӦ ʡpixel_per_curvature
+ *         PIDֻߵλǰظת
+ */
+int16 steer_predict_compute(int16 deviation)
+{
+    const steer_predict_frame_t *frame = &steer_predict.frame[steer_predict.active];
+    float dx, dy, dpsi;
+    
+    steer_predict.deviation = deviation;
+    steer_predict.curvature = 0.0f;
+    steer_predict.feedforward = 0.0f;
+    
+    if (!frame->valid)
+        return deviation;
+    
+    // ʵӳ
+    steer_predict.latency_ms = odometry.tick * ODOMETRY_PERIOD_MS - frame->timestamp_ms;
+    steer_predict.latency_avg_ms += ((float)steer_predict.latency_ms - steer_predict.latency_avg_ms) * STEER_PREDICT_LATENCY_FILTER;
+    
+    // عʱ̵ǰλ˱仯عʱ̳ϵm
+    steer_predict_motion(frame->timestamp_ms, &dx, &dy, &dpsi);
+    
+    steer_predict.shift_m = dy;
+    steer_predict.shift_rad = dpsi;
+    
+    float predicted = (float)deviation;
+    
+#if STEER_PREDICT_ENABLE
+    predicted += dy * frame->pixel_per_m + dpsi * frame->pixel_per_rad;
+    if (frame->fit_valid)
+    {
+        predicted += dx * (frame->fit_b * frame->pixel_per_m + 2.0f * frame->fit_c * frame->pixel_per_rad)
+                   + frame->fit_c * dx * dx * frame->pixel_per_m;
+    }
+#endif
+    
+#if STEER_FF_ENABLE
+    if (frame->fit_valid)
+    {
+        float y = dx;
+        if (y < 0.0f)
+            y = 0.0f;
+        else if (y > frame->fit_far)
+            y = frame->fit_far;
+    
+        float slope = frame->fit_b + 2.0f * frame->fit_c * y;
+        float q = 1.0f + slope * slope;
+        float kappa = 2.0f * frame->fit_c / (q * sqrtf(q));
+        float delta = atanf(CAR_WHEELBASE / 1000.0f * kappa) * 180.0f / 3.14159f;
+    
+        delta *= STEER_FF_GAIN * STEER_FF_SIGN;
+        if (delta > SERVO_MAX_ANGLE)
+            delta = SERVO_MAX_ANGLE;
+        else if (delta < -SERVO_MAX_ANGLE)
+            delta = -SERVO_MAX_ANGLE;
+    
+        steer_predict.curvature = kappa;
+        steer_predict.feedforward = delta;
+        predicted -= kappa * frame->pixel_per_curvature;
+    }
+#endif
+    
+    if (predicted < -80.0f)
+        predicted = -80.0f;
+    else if (predicted > 80.0f)
+        predicted = 80.0f;
+    steer_predict.deviation = (int16)(predicted + ((predicted >= 0.0f) ? 0.5f : -0.5f));
+    
+    return steer_predict.deviation;
+}
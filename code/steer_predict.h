@@ -0,0 +1,69 @@
+#ifndef _STEER_PREDICT_H_
+#define _STEER_PREDICT_H_
+
+#include "zf_common_headfile.h"
+#include "vision_track.h"
+#include "motor_control.h"
+
+//====================================================תǰӳٲ====================================================
+// ͷͶӰENCODER_COUNT_PER_METERʵ궨ǰֹرգӳͳճУ
+#define STEER_PREDICT_ENABLE        0           // Ƿͼƫ㵽ǰʱ (1-̼λ˱仯, 0-ֱʹͼƫ)
+#define STEER_FF_ENABLE             0           // Ƿǰת  = atan(L)
+#define STEER_FF_GAIN               1.0f        // ǰϵ1Ϊֲֵ໬ʱʵӴ
+#define STEER_FF_SIGN               (-1)        // 뷽PIDͬʱ"ƫΪ"ʱķPIDͬ
+
+#define STEER_PREDICT_EXPOSURE_MS   2           // عеڳͬʱ (ms)
+#define STEER_PREDICT_LEAD_MS       15          // ڵǰʱ֮Ƶʱ (ms)Ӧ
+#define STEER_PREDICT_LATENCY_FILTER 0.1f       // ӳͳһ׵ͨϵ
+
+#define STEER_PREDICT_ROW_STEP      4           // ϲв
+#define STEER_PREDICT_FIT_MIN_POINTS 6          // ٵ
+#define STEER_PREDICT_FIT_MAX_DIST  1.2f        // ʹõԶǰ (m)Զ
+
+//====================================================ݽṹ====================================================
+// ֡ͼд룬ڶȡ
+typedef struct
+{
+    uint32 timestamp_ms;                        // ͼعʱ̣̼ʱ
+    uint8 valid;                                // ֡ҵ
+    uint8 fit_valid;                            // ϳɹ
+    float pixel_per_m;                          // ƫԺƽƵ (/m)
+    float pixel_per_rad;                        // ƫԺ仯 (/rad)
+    float pixel_per_curvature;                  // ʦʵڳϿƫ (ءm)
+    float fit_a;                                //  x = a + by + cy^2xңyǰλm
+    float fit_b;
+    float fit_c;
+    float fit_far;                              // ϵԶǰ (m)
+} steer_predict_frame_t;
+
+// תǰӳٲṹ
+typedef struct
+{
+    steer_predict_frame_t frame[2];             // ˫壬ѭдǻ֡л
+    volatile uint8 active;                      // ڶȡ֡±
+    
+    volatile uint32 vsync_ms;                   // һγͬʱ̣жд
+    volatile uint32 capture_ms;                 // һ֡ɼʱӦĳͬʱ̣жд
+    
+    uint32 latency_ms;                          // ڲõͼ񵽿Ƶӳ (ms)
+    float latency_avg_ms;                       // ӳ˲ֵ (ms)
+    float shift_m;                              // ӳڼĺƽ (m)Ϊ
+    float shift_rad;                            // ӳڼĺ仯 (rad)ʱΪ
+    float curvature;                            // ǰʹõ (1/m)Ϊ
+    int16 deviation;                            // 㵽ǰʱ̲۳ǰֵƫ ()
+    float feedforward;                          // ǰת ()
+} steer_predict_t;
+
+//====================================================ȫֱ====================================================
+extern steer_predict_t steer_predict;
+
+//========================================================================================================
+void  steer_predict_init(void);                                 // ʼ
+void  steer_predict_capture_start(void);                        // ͷͬжеã¼ʱ
+void  steer_predict_capture_done(void);                         // ͷDMAжеã汾֡ʱ
+void  steer_predict_update(void);                               // ÿ֡ͼãƫ߶
+int16 steer_predict_compute(int16 deviation);                   // ڵã㵽ǰʱ̵ƫǰת
+void  steer_predict_motion(uint32 timestamp_ms, float *dx, float *dy, float *dpsi); // ָʱ̵ǰLEADĳλ˱仯
+uint32 steer_predict_frame_timestamp(void);                     // ǰ֡عʱ̣̼ʱ
+
+#endif // _STEER_PREDICT_H_
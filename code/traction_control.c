@@ -0,0 +1,192 @@
+#include "traction_control.h"
+#include <math.h>
+#include <string.h>
+
+#ifndef PID_HOST
+#include "yaw_control.h"
+#include "speed_loop.h"
+#include "smart_car.h"
+
+// ǣȫֱ
+traction_t traction;
+#endif
+
+#define TRACTION_DT     (TRACTION_PERIOD_MS * 0.001f)
+
+//====================================================򻬹ռձ޵====================================================
+/**
+ * @brief  ǣ״̬
+ * @param  tc      ǣƽṹ
+ * @param  launch  1-𲽿ƣռձ޴TRACTION_LAUNCH_DUTYʼ0-
+ * @return 
+ */
+void traction_reset(traction_t *tc, uint8 launch)
+{
+    float accel_bias = tc->accel_bias;
+    
+    memset(tc, 0, sizeof(*tc));
+    tc->accel_bias = accel_bias;
+    tc->launch = launch;
+    tc->left.engaged = launch;
+    tc->right.engaged = launch;
+    tc->left.duty_cap = launch ? TRACTION_LAUNCH_DUTY : MOTOR_MAX_DUTY;
+    tc->right.duty_cap = tc->left.duty_cap;
+}
+
+/**
+ * @brief  򻬹
+ * @param  tc           ǣƽṹ
+ * @param  left_speed   ٶ (mm/s)
+ * @param  right_speed  ٶ (mm/s)
+ * @param  steer_deg    ת ()
+ * @param  accel        ٶ (mm/s^2)IMUʱTRACTION_ACCEL_MAX
+ * @return 
+ * @note   תĵٶȱΪ  1 - Wtan/(2L) 1 + Wtan/(2L)Ȱ㵽ٱȽϣ
+ *         οȡһ֣ ʵٶ + TRACTION_ACCEL_MARGIN 
+ */
+void traction_estimate(traction_t *tc, float left_speed, float right_speed, float steer_deg, float accel)
+{
+    float k = tanf(steer_deg * 3.14159f / 180.0f) * CAR_TRACK_WIDTH / (2.0f * CAR_WHEELBASE) * DIFFERENTIAL_SIGN;
+    
+    tc->left.speed = left_speed / (1.0f - k);
+    tc->right.speed = right_speed / (1.0f + k);
+    
+    float slowest = tc->left.speed < tc->right.speed ? tc->left.speed : tc->right.speed;
+    if (slowest <= tc->reference)
+    {
+        tc->reference = slowest;
+    }
+    else
+    {
+        float rise = accel + TRACTION_ACCEL_MARGIN;
+        if (rise > TRACTION_ACCEL_MAX)
+            rise = TRACTION_ACCEL_MAX;
+        else if (rise < TRACTION_ACCEL_MARGIN)
+            rise = TRACTION_ACCEL_MARGIN;
+        rise *= TRACTION_DT;
+        tc->reference += (slowest - tc->reference < rise) ? slowest - tc->reference : rise;
+    }
+    
+    float base = tc->reference > TRACTION_MIN_SPEED ? tc->reference : TRACTION_MIN_SPEED;
+    tc->left.slip = (tc->left.speed - tc->reference) / base;
+    tc->right.slip = (tc->right.speed - tc->reference) / base;
+}
+
+/**
+ * @brief  ռձ޵
+ * @param  tc     ǣƽṹ
+ * @param  wheel  
+ * @param  duty   ʵռձ
+ * @return 
+ * @note   ʳTRACTION_SLIP_MAXʱ룬Ƚǰ֮ (Ŀ껬 - ) ֵڣ
+ *         𲽿ƽ޻صֵ˳
+ */
+static void traction_regulate_wheel(traction_t *tc, traction_wheel_t *wheel, float duty)
+{
+    if (wheel->slip > TRACTION_SLIP_MAX)
+    {
+        wheel->engaged = 1;
+        if (duty < wheel->duty_cap)
+            wheel->duty_cap = duty;
+    }
+    if (!wheel->engaged)
+        return;
+    
+    wheel->duty_cap += TRACTION_SLIP_GAIN * (TRACTION_SLIP_TARGET - wheel->slip);
+    if (wheel->duty_cap < TRACTION_DUTY_MIN)
+        wheel->duty_cap = TRACTION_DUTY_MIN;
+    if (wheel->duty_cap >= MOTOR_MAX_DUTY)
+    {
+        wheel->duty_cap = MOTOR_MAX_DUTY;
+        if (!tc->launch)
+            wheel->engaged = 0;
+    }
+}
+
+/**
+ * @brief  ռձ޵
+ * @param  tc          ǣƽṹ
+ * @param  left_duty   ʵռձ
+ * @param  right_duty  ʵռձ
+ * @return 
+ * @note   traction_estimate()֮ã𲽿ڲοٴﵽTRACTION_LAUNCH_SPEEDʱ
+ */
+void traction_regulate(traction_t *tc, float left_duty, float right_duty)
+{
+    if (tc->launch)
+    {
+        tc->launch_ms += TRACTION_PERIOD_MS;
+        if (tc->reference >= TRACTION_LAUNCH_SPEED || tc->launch_ms >= TRACTION_LAUNCH_MS)
+            tc->launch = 0;
+    }
+    
+    traction_regulate_wheel(tc, &tc->left, left_duty);
+    traction_regulate_wheel(tc, &tc->right, right_duty);
+    
+    if (tc->left.engaged || tc->right.engaged)
+        tc->intervention_ms += TRACTION_PERIOD_MS;
+}
+
+#ifndef PID_HOST
+//====================================================ǣ====================================================
+/**
+ * @brief  ʼǣ
+ * @param  
+ * @return 
+ * @note   yaw_control_init()֮ãٶƫͣʱtraction_update()
+ */
+void traction_init(void)
+{
+    memset(&traction, 0, sizeof(traction));
+    traction_reset(&traction, 0);
+    car.left_motor.duty_cap = MOTOR_MAX_DUTY;
+    car.right_motor.duty_cap = MOTOR_MAX_DUTY;
+}
+
+/**
+ * @brief  ʱ𲽿
+ * @param  
+ * @return 
+ */
+void traction_start(void)
+{
+    traction_reset(&traction, TRACTION_ENABLE);
+}
+
+/**
+ * @brief  ǣƸ
+ * @param  
+ * @return 
+ * @note   1msжspeed_loop_observe()֮ٶȻ֮ǰã
+ *         ͣʱƼٶƫޣʱƻʣƶ٣ռձдmotor_t
+ *         motor_set_duty()޷ٶȻͬʱΪPI޲뿹
+ */
+void traction_update(void)
+{
+    float accel = TRACTION_ACCEL_MAX;
+    
+    if (yaw_control.enable)
+    {
+        imu660ra_get_acc();
+        float raw = imu660ra_acc_transition(imu660ra_acc_x) * TRACTION_ACC_SIGN;
+        if (smart_car.state != CAR_RUNNING)
+            traction.accel_bias += (raw - traction.accel_bias) * TRACTION_ACC_BIAS_FILTER;
+        traction.accel += ((raw - traction.accel_bias) * 9810.0f - traction.accel) * TRACTION_ACC_FILTER;
+        accel = traction.accel;
+    }
+    
+    car.left_motor.duty_cap = MOTOR_MAX_DUTY;
+    car.right_motor.duty_cap = MOTOR_MAX_DUTY;
+    if (smart_car.state != CAR_RUNNING)
+        return;
+    
+    traction_estimate(&traction, speed_loop.left.speed, speed_loop.right.speed,
+                      Q16_TO_FLOAT(car.steering_servo.current_angle_q16), accel);
+    if (!TRACTION_ENABLE)
+        return;
+    traction_regulate(&traction, (float)car.left_motor.pwm_duty, (float)car.right_motor.pwm_duty);
+    
+    car.left_motor.duty_cap = (int32)traction.left.duty_cap;
+    car.right_motor.duty_cap = (int32)traction.right.duty_cap;
+}
+#endif
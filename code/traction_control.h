@@ -0,0 +1,87 @@
+#ifndef _TRACTION_CONTROL_H_
+#define _TRACTION_CONTROL_H_
+
+#ifdef PID_HOST
+// λԱ루tools/traction_sim.cֻ򻬹ռձ޵
+#ifndef PID_HOST_TYPES
+#define PID_HOST_TYPES
+#include <stdint.h>
+typedef uint8_t  uint8;
+typedef int8_t   int8;
+typedef uint16_t uint16;
+typedef int16_t  int16;
+typedef uint32_t uint32;
+typedef int32_t  int32;
+typedef int64_t  int64;
+#endif
+#include "car_params.h"
+#else
+#include "zf_common_headfile.h"
+#include "motor_control.h"
+#endif
+
+//====================================================ǣƲ====================================================
+// ٲοְת򼸺㵽ĺȡһ֣ʱֻƫ죩
+// ٵڲοʱ棬ڲοʱʲIMUٶȼԣͬʱʱο԰ʵʼٶ
+// ֻ = ( - ο) / ο٣ֵ󰴻ڸռձ
+#define TRACTION_ENABLE             1           // Ƿǣ𲽿
+#define TRACTION_PERIOD_MS          1           //  (ms)ODOMETRY_PITж
+#define TRACTION_ACC_SIGN           (1)         // IMU XᳯͷʱΪ1װΪ-1
+#define TRACTION_ACC_BIAS_FILTER    0.01f       // ͣʱٶƫһ׵ͨϵ
+#define TRACTION_ACC_FILTER         0.1f        // ٶһ׵ͨϵ
+
+#define TRACTION_ACCEL_MARGIN       2000.0f     // οʵٶ֮ϵԣ (mm/s^2)ƫ븩
+#define TRACTION_ACCEL_MAX          12000.0f    // ο (mm/s^2)ԼΪ̥żޣIMUʱֵ
+#define TRACTION_MIN_SPEED          200.0f      // ʷĸ (mm/s)ʱ
+
+#define TRACTION_SLIP_TARGET        0.12f       // Ŀ껬ʣϵֵ
+#define TRACTION_SLIP_MAX           0.25f       // ûʱ
+#define TRACTION_SLIP_GAIN          300.0f      // ռձ޵ (ռձ /  / λ)
+#define TRACTION_DUTY_MIN           1000        // ռձ
+
+// 𲽿ƣʱռձ޴LAUNCH_DUTYʼʵοٴﵽLAUNCH_SPEEDʱ
+#define TRACTION_LAUNCH_DUTY        3000        // 𲽳ʼռձ
+#define TRACTION_LAUNCH_SPEED       1500.0f     // 𲽽 (mm/s)
+#define TRACTION_LAUNCH_MS          1500        // 𲽿ʱ (ms)
+
+//====================================================ݽṹ====================================================
+// ǣ
+typedef struct
+{
+    float speed;                                // ת򼸺㵽ĵ (mm/s)
+    float slip;                                 // 
+    float duty_cap;                             // ռձ
+    uint8 engaged;                              // ڵռձ
+} traction_wheel_t;
+
+// ǣƽṹ
+typedef struct
+{
+    uint8 launch;                               // 𲽿
+    uint16 launch_ms;                           // ѽʱ (ms)
+    float accel_bias;                           // ٶƫ (g)
+    float accel;                                // ȥƫٶ (mm/s^2)
+    float reference;                            // ο (mm/s)
+    traction_wheel_t left;                      // 
+    traction_wheel_t right;                     // 
+    uint32 intervention_ms;                     // һֽۼʱ (ms)
+} traction_t;
+
+//====================================================ȫֱ====================================================
+#ifndef PID_HOST
+extern traction_t traction;
+#endif
+
+//========================================================================================================
+// 򻬹ռձ޵ڣӲ޹أ
+void traction_reset(traction_t *tc, uint8 launch);                                              // ״̬launchΪ1ʱ𲽿
+void traction_estimate(traction_t *tc, float left_speed, float right_speed, float steer_deg, float accel); // ÿڣ (mm/s)ת ()ٶ (mm/s^2)
+void traction_regulate(traction_t *tc, float left_duty, float right_duty);                     // ÿڣʸռձޣΪʵ
+
+#ifndef PID_HOST
+void traction_init(void);                                       // ʼ
+void traction_start(void);                                      // ʱã״̬𲽿
+void traction_update(void);                                     // 1msжеãƴ򻬲дռձ
+#endif
+
+#endif // _TRACTION_CONTROL_H_
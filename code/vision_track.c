@@ -21,6 +21,12 @@ int Search_Stop_Line;                // 
 uint8 Right_Island_Flag;             // һ־
 uint8 Left_Island_Flag;              // 󻷵־
 uint8 Island_State;                  // ״̬
+// ·ر־
+uint8 Fork_Flag;                     // ·־ (0-, 1-֧, 2-ҷ֧)
+int Fork_Split_Column;               // ·ָУШμкţ
+// 
+float Row_Distance[IMAGE_HEIGHT];    // ÿжӦĵǰ (m)
+float Row_Scale[IMAGE_HEIGHT];       // ÿкÿضӦĵ (m/)
 vision_track_t vision;
 
 uint8 image_data[IMAGE_HEIGHT][IMAGE_WIDTH];
@@ -246,6 +252,9 @@ void vision_init(void)
     vision.image_ready = 0;
     vision.track.valid_rows = 0;
     
+    // ɵ
+    vision_ground_table_init();
+    
     // ʼMT9V03Xͷ
     mt9v03x_init();
 }
@@ -305,6 +314,16 @@ void vision_find_track_edge(void)
         }
     }
 
+    // ·Χ޶ֻѡ֧һͳưУ߽Ȼڸ÷֧
+    if (Fork_Flag == 1 && Fork_Split_Column > start_column)
+    {
+        end_column = Fork_Split_Column;
+    }
+    else if (Fork_Flag == 2 && Fork_Split_Column < end_column)
+    {
+        start_column = Fork_Split_Column;
+    }
+
     // ͳÿа׵
     for (j = start_column; j <= end_column; j++)
     {
@@ -603,6 +622,22 @@ void centerline_least_square_fit(void)
     }
 }
 
+/**
+ * @brief  ƫиеȨ
+ * @param  row  к
+ * @return ȨأȨش
+ */
+uint8 vision_row_weight(uint8 row)
+{
+    uint16 distance_from_bottom = SCAN_START_ROW - row;
+    
+    if (distance_from_bottom < 30)
+        return 3;
+    if (distance_from_bottom < 60)
+        return 2;
+    return 1;
+}
+
 /**
  * @brief  ȡƫֵʹȨŻ棩
  * @param  
@@ -626,15 +661,7 @@ int16 vision_get_deviation(void)
         if (vision.track.track_width[row] >= TRACK_WIDTH_MIN && 
             vision.track.track_width[row] <= TRACK_WIDTH_MAX)
         {
-            uint8 weight;
-            uint16 distance_from_bottom = SCAN_START_ROW - row;
-            
-            if (distance_from_bottom < 30)
-                weight = 3;
-            else if (distance_from_bottom < 60)
-                weight = 2;
-            else
-                weight = 1;
+            uint8 weight = vision_row_weight(row);
             
             if (vision.track.center_line[row] < IMAGE_WIDTH)
             {
@@ -699,3 +726,49 @@ void vision_image_process(void)
     vision.image_ready = 0;
 }
 
+/**
+ * @brief  ÿе/
+ * @param  
+ * @return 
+ * @note   ƽģͣrow߸ = ḩ + (row - ) * ÿнǶȣ
+ *         ǰ = ߶ / tan() = б * 2tan(ˮƽӳ) / ͼȣ
+ *         ǲ0ڵƽϣΪ0
+ */
+void vision_ground_table_init(void)
+{
+    float row_angle = CAMERA_VFOV_DEG / IMAGE_HEIGHT * PI / 180.0f;
+    float pitch = CAMERA_PITCH_DEG * PI / 180.0f;
+    float half_hfov_tan = tanf(CAMERA_HFOV_DEG * 0.5f * PI / 180.0f);
+    
+    for (int row = 0; row < IMAGE_HEIGHT; row++)
+    {
+        float angle = pitch + ((float)row - (IMAGE_HEIGHT - 1) * 0.5f) * row_angle;
+        
+        if (angle <= 0.01f)
+        {
+            Row_Distance[row] = 0.0f;
+            Row_Scale[row] = 0.0f;
+            continue;
+        }
+        
+        Row_Distance[row] = CAMERA_HEIGHT_M / tanf(angle);
+        Row_Scale[row] = (CAMERA_HEIGHT_M / sinf(angle)) * 2.0f * half_hfov_tan / IMAGE_WIDTH;
+    }
+}
+
+/**
+ * @brief  תΪ
+ * @param  row     к
+ * @param  col     к
+ * @param  real_x   (m)Ϊ
+ * @param  real_y  ǰ (m)ƽϵΪ0
+ * @return 
+ */
+void vision_pixel_to_world(uint8 row, uint8 col, float *real_x, float *real_y)
+{
+    if (row >= IMAGE_HEIGHT)
+        row = IMAGE_HEIGHT - 1;
+    
+    *real_x = ((float)col - (IMAGE_WIDTH - 1) * 0.5f) * Row_Scale[row];
+    *real_y = Row_Distance[row];
+}
@@ -63,6 +63,13 @@ extern vision_track_t vision;
 #define LOST_LINE_REPAIR_ENABLE    1           // ߲ʹ
 #define SLOPE_LIMIT             0.5f        // бƣֹͻ䣩
 
+//====================================================ͷװ====================================================
+// ƽģͣÿеĵ/谴ʵװʵ
+#define CAMERA_HEIGHT_M         0.20f       // ͷظ߶ (m)
+#define CAMERA_PITCH_DEG        35.0f       // ḩ ()
+#define CAMERA_VFOV_DEG         45.0f       // ֱӳ ()
+#define CAMERA_HFOV_DEG         60.0f       // ˮƽӳ ()
+
 //====================================================˫㷨ض====================================================
 // ͼֵɫ
 #define IMG_WHITE 255
@@ -84,6 +91,13 @@ extern int Search_Stop_Line;                // 
 extern uint8 Right_Island_Flag;             // һ־
 extern uint8 Left_Island_Flag;              // 󻷵־
 extern uint8 Island_State;                  // ״̬
+// ·ر־
+extern uint8 Fork_Flag;                     // ·־ (0-, 1-֧, 2-ҷ֧)
+extern int Fork_Split_Column;               // ·ָУШμкţ
+
+// vision_init()ɣ
+extern float Row_Distance[IMAGE_HEIGHT];    // ÿжӦĵǰ (m)0ʾڵƽ
+extern float Row_Scale[IMAGE_HEIGHT];       // ÿкÿضӦĵ (m/)
 
 // ֵͼ飨˫㷨
 extern uint8 image_data[IMAGE_HEIGHT][IMAGE_WIDTH];
@@ -93,11 +107,13 @@ void vision_init(void);                                     // 
 void vision_image_process(void);                            // Ӿ
 void vision_find_track_edge(void);                          // Ѱҹ켣Ե
 int16 vision_get_deviation(void);                           // ȡƫֵ
+uint8 vision_row_weight(uint8 row);                         // ƫиеȨ
 void vision_show_image(void);                               // ʾͼ
 // ͼֵֵ
 uint8 otsu_threshold(uint8 *image, uint32 size);           // OTSUֵ
 void image_binarization(uint8 threshold);                   // ͼֵ
 void vision_pixel_to_world(uint8 row, uint8 col, float *real_x, float *real_y); // תΪʵ
+void vision_ground_table_init(void);                        // ÿе/
 
 // ϺŻ㷨
 void edge_smooth_filter(void);                              // Եƽ˲
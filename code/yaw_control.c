@@ -0,0 +1,119 @@
+#include "yaw_control.h"
+#include "speed_planner.h"
+#include <math.h>
+#include <string.h>
+
+// תȫֱ
+yaw_control_t yaw_control;
+
+/**
+ * @brief  ʼת
+ * @param  
+ * @return 
+ * @note   ϵʱ뾲ֹIMUʼƫ
+ *         IMUʼʧʱڻЧPIDֱ
+ */
+void yaw_control_init(void)
+{
+    memset(&yaw_control, 0, sizeof(yaw_control));
+    pid_init(&yaw_control.rate_pid, YAW_RATE_PID_KP, YAW_RATE_PID_KI, YAW_RATE_PID_KD,
+             SERVO_MAX_ANGLE, -SERVO_MAX_ANGLE);
+    pid_set_integral_limit(&yaw_control.rate_pid, YAW_RATE_PID_INTEGRAL_MAX);
+
+#if YAW_CONTROL_ENABLE
+    if (imu660ra_init())
+        return;
+    
+    int32 sum = 0;
+    for (uint16 i = 0; i < YAW_CONTROL_BIAS_SAMPLES; i++)
+    {
+        sum += imu660ra_get_gyro_z();
+        system_delay_ms(1);
+    }
+    yaw_control.gyro_bias = (float)sum / YAW_CONTROL_BIAS_SAMPLES;
+    
+    yaw_control.enable = 1;
+#endif
+}
+
+/**
+ * @brief  ڻ״̬
+ * @param  
+ * @return 
+ */
+void yaw_control_reset(void)
+{
+    pid_reset(&yaw_control.rate_pid);
+    yaw_control.steer_feedforward = 0.0f;
+    yaw_control.target_rate = 0.0f;
+    yaw_control.output = 0.0f;
+}
+
+/**
+ * @brief  ⻷ֵ
+ * @param  steer_angle  PIDӾƫת ()
+ * @param  speed        ƽٶȣ/ڣ
+ * @return 
+ * @note   гģͰתǻΪٶ  = vtan()/LΪڻĿꣻ
+ *         תͬʱΪڻǰ
+ */
+void yaw_control_set_target(float steer_angle, int16 speed)
+{
+    float v = (float)speed * 1000.0f / (SPEED_PLANNER_PERIOD_MS * (float)ENCODER_COUNT_PER_METER);
+    float delta = steer_angle * 3.14159f / 180.0f;
+    
+    yaw_control.steer_feedforward = steer_angle;
+    yaw_control.speed = v;
+    yaw_control.target_rate = v * tanf(delta) / (CAR_WHEELBASE / 1000.0f) * 180.0f / 3.14159f;
+}
+
+/**
+ * @brief  ǲ
+ * @param  
+ * @return 
+ * @note   1msж̼ƵãֻͻȡZֽڣȥƫ̼ƻֺ
+ *         YAW_CONTROL_GYRO_SIGN򲢵ͨ˲ڻʹ
+ */
+void yaw_control_sample(void)
+{
+    if (!yaw_control.enable)
+        return;
+    
+    yaw_control.gyro_z = imu660ra_gyro_transition((float)imu660ra_get_gyro_z() - yaw_control.gyro_bias);
+    yaw_control.yaw_rate += (yaw_control.gyro_z * YAW_CONTROL_GYRO_SIGN - yaw_control.yaw_rate) * YAW_CONTROL_GYRO_FILTER;
+}
+
+/**
+ * @brief  ڻ
+ * @param  
+ * @return 
+ * @note   1msжyaw_control_sample()֮ãٶȣ
+ *         Ƕ = ǰת + ٶPIDʱ޺ٶȣֻǰ
+ */
+void yaw_control_update(void)
+{
+    if (!yaw_control.enable)
+        return;
+    
+    yaw_control.tick++;
+    
+    float output = yaw_control.steer_feedforward;
+    
+    if (fabsf(yaw_control.speed) >= YAW_CONTROL_MIN_SPEED)
+    {
+        pid_set_target(&yaw_control.rate_pid, yaw_control.target_rate);
+        output += pid_calculate(&yaw_control.rate_pid, yaw_control.yaw_rate);
+    }
+    else
+    {
+        pid_reset(&yaw_control.rate_pid);
+    }
+    
+    if (output > SERVO_MAX_ANGLE)
+        output = SERVO_MAX_ANGLE;
+    else if (output < -SERVO_MAX_ANGLE)
+        output = -SERVO_MAX_ANGLE;
+    
+    yaw_control.output = output;
+    servo_set_angle_q16(&car.steering_servo, Q16_FROM_FLOAT(output));   // С֣궨
+}
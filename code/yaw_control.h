@@ -0,0 +1,51 @@
+#ifndef _YAW_CONTROL_H_
+#define _YAW_CONTROL_H_
+
+#include "zf_common_headfile.h"
+#include "pid_control.h"
+#include "motor_control.h"
+
+//====================================================ת====================================================
+#define YAW_CONTROL_ENABLE          1           // Ƿǽٶڻ (1-, 0-PIDֱ)
+#define YAW_CONTROL_PERIOD_MS       1           // ڻ (ms)ODOMETRY_PITж
+#define YAW_CONTROL_GYRO_SIGN       (1)         // Z᷽ʹٶתתһ (1  -1)
+#define YAW_CONTROL_BIAS_SAMPLES    200         // ϵ羲ֹƫ궨
+#define YAW_CONTROL_GYRO_FILTER     0.5f        // ٶһ׵ͨϵ (0-1ԽԽֵ)
+#define YAW_CONTROL_MIN_SPEED       0.3f        // ڸó (m/s) ʱٶȼΪ㣬ڻֻǰ
+
+// ڻٶPID/sǶȣ
+#define YAW_RATE_PID_KP             0.15f       // ٶȻϵ
+#define YAW_RATE_PID_KI             0.002f      // ٶȻϵ
+#define YAW_RATE_PID_KD             0.0f        // ٶȻ΢ϵ
+#define YAW_RATE_PID_INTEGRAL_MAX   2000.0f     // ٶȻ޷ۻ/sڣ
+
+//====================================================ݽṹ====================================================
+// תṹ
+typedef struct
+{
+    uint8 enable;                   // ڻǷЧIMUʼɹYAW_CONTROL_ENABLE
+    
+    float gyro_bias;                // Zƫԭʼֵ
+    float gyro_z;                   // ȥƫZٶ (/s)ϵ̼ʹ
+    float yaw_rate;                 // ˲ĺٶ (/s)
+    
+    float steer_feedforward;        // ⻷ת ()
+    float speed;                    // ⻷ʱĳ (m/s)
+    float target_rate;              // ٶ (/s)
+    
+    pid_t rate_pid;                 // ٶȻPID
+    float output;                   // ڻǶ ()
+    uint32 tick;                    // ڻд
+} yaw_control_t;
+
+//====================================================ȫֱ====================================================
+extern yaw_control_t yaw_control;
+
+//========================================================================================================
+void yaw_control_init(void);                                    // ʼIMU궨ƫ
+void yaw_control_sample(void);                                  // 1msжжȡZᣨͣʱҲ
+void yaw_control_reset(void);                                   // ڻ֣ʱã
+void yaw_control_set_target(float steer_angle, int16 speed);    // ⻷ڣת복
+void yaw_control_update(void);                                  // ڻ1msжϣٶȲ
+
+#endif // _YAW_CONTROL_H_
@@ -204,6 +204,22 @@ void imu660ra_get_gyro (void)
     imu660ra_gyro_z = (int16)(((uint16)dat[5] << 8 | dat[4]));
 }
 
+//-------------------------------------------------------------------------------------------------------------------
+//      ȡ IMU660RA  Z 
+// ˵     void
+// ز     int16           Z  ͬʱ imu660ra_gyro_z
+// ʹʾ     int16 gyro_z = imu660ra_get_gyro_z();
+// עϢ     ֻȡ Z ֽ ʺڸƵжֻҪٶȵĳ
+//-------------------------------------------------------------------------------------------------------------------
+int16 imu660ra_get_gyro_z (void)
+{
+    uint8 dat[2];
+
+    imu660ra_read_registers(IMU660RA_GYRO_ADDRESS + 4, dat, 2);
+    imu660ra_gyro_z = (int16)(((uint16)dat[1] << 8 | dat[0]));
+    return imu660ra_gyro_z;
+}
+
 //-------------------------------------------------------------------------------------------------------------------
 //      ʼ IMU660RA
 // ˵     void
@@ -129,6 +129,7 @@ extern float imu660ra_transition_factor[2];
 
 void  imu660ra_get_acc              (void);                                     // ȡ IMU660RA ٶȼ
 void  imu660ra_get_gyro             (void);                                     // ȡ IMU660RA 
+int16 imu660ra_get_gyro_z           (void);                                     // ȡ IMU660RA  Z 
 
 //-------------------------------------------------------------------------------------------------------------------
 //       IMU660RA ٶȼתΪʵ
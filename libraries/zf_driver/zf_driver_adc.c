@@ -62,6 +62,32 @@ uint16 adc_convert (adc_channel_enum vadc_chn)
 	return((result.U&0x0fff)>>temp);
 }
 
+//-------------------------------------------------------------------------------------------------------------------
+//      ȡ ADC ̨ɨһת ȴ
+// ˵     ch              ѡ ADC ͨ ( zf_driver_adc.h ö adc_channel_enum )
+// ˵     *value          ת ADC ֵ ½ʱд
+// ز     uint8           1-½ 0-ϴζȡ½
+// ʹʾ     if(adc_background_read(ADC0_CH8_A8, &value)) {...}
+// עϢ     adc_init ѽͨԶ̨ɨ Ĵˢ
+//              жڵʱ adc_convert ȴת
+//-------------------------------------------------------------------------------------------------------------------
+uint8 adc_background_read (adc_channel_enum vadc_chn, uint16 *value)
+{
+	Ifx_VADC_RES result;
+	uint8 temp;
+
+	result = IfxVadc_getResult(&MODULE_VADC.G[(vadc_chn / 16)], vadc_chn%16);
+	if(!result.B.VF)
+	{
+		return 0;
+	}
+
+	temp = 4 - (adc_resolution[vadc_chn] * 2);
+	*value = (result.U&0x0fff)>>temp;
+
+	return 1;
+}
+
 //-------------------------------------------------------------------------------------------------------------------
 //      ADC ֵ˲ת
 // ˵     ch              ѡ ADC ͨ ( zf_driver_adc.h ö adc_channel_enum )
@@ -88,6 +88,7 @@ typedef enum        // ö
 //====================================================ADC ====================================================
 uint16  adc_convert             (adc_channel_enum vadc_chn);                                    // ADCתһ
 uint16  adc_mean_filter_convert (adc_channel_enum vadc_chn, uint8 count);                       // ADCֵ˲
+uint8   adc_background_read     (adc_channel_enum vadc_chn, uint16 *value);                     // ADCȡ̨ɨ(ȴ)
 void    adc_init                (adc_channel_enum vadc_chn, adc_resolution_enum resolution);    // ADCʼ
 //====================================================ADC ====================================================
 
@@ -36,6 +36,7 @@
 #include "IfxGtm_Atom_Pwm.h"
 #include "ifxGtm_PinMap.h"
 #include "zf_common_debug.h"
+#include "zf_common_interrupt.h"
 #include "zf_driver_pwm.h"
 
 #define CMU_CLK_FREQ           20000000.0f                       // CMUʱƵ
@@ -382,4 +383,99 @@ void pwm_init (pwm_channel_enum pwmch, uint32 freq, uint32 duty)
     IfxGtm_Atom_Pwm_start(&g_atomDriver, TRUE);
 }
 
+//-------------------------------------------------------------------------------------------------------------------
+//       ATOM ģͨ
+// ˵     pwmch           PWM ͨ
+// ˵     count           ͨ
+// ˵     mask             ÿ ATOM ģͨ (bit n Ӧͨ n)
+// ز     void
+// ʹʾ     pwm_get_atom_mask(pwmch, count, mask);
+// עϢ     ڲ
+//-------------------------------------------------------------------------------------------------------------------
+static void pwm_get_atom_mask (const pwm_channel_enum *pwmch, uint8 count, uint16 *mask)
+{
+    IfxGtm_Atom_ToutMap *atom_channel;
+    uint8 i;
+
+    for(i = 0; i < 4; i++)
+    {
+        mask[i] = 0;
+    }
+    for(i = 0; i < count; i++)
+    {
+        atom_channel = get_pwm_pin(pwmch[i]);
+        mask[atom_channel->atom] |= (uint16)(1 << atom_channel->channel);
+    }
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+//      ͬƵ PWM ͨλ
+// ˵     pwmch           PWM ͨ  pwm_init ͬƵʳʼ
+// ˵     count           ͨ
+// ز     void
+// ʹʾ     pwm_phase_align(channel, 2);
+// עϢ     жϺͨ ͨڱ߽ CMU ʱ
+//              ʱڻᱻһ ռձΪ 0 ʱ
+//-------------------------------------------------------------------------------------------------------------------
+void pwm_phase_align (const pwm_channel_enum *pwmch, uint8 count)
+{
+    IfxGtm_Atom_ToutMap *atom_channel;
+    uint32 primask;
+    uint8 i;
+
+    primask = interrupt_global_disable();
+    for(i = 0; i < count; i++)
+    {
+        atom_channel = get_pwm_pin(pwmch[i]);
+        IfxGtm_Atom_Ch_setCounterValue(&MODULE_GTM.ATOM[atom_channel->atom], atom_channel->channel, 0);
+    }
+    interrupt_global_enable(primask);
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+//      ͣ PWM ͨӰӼĴװ
+// ˵     pwmch           PWM ͨ
+// ˵     count           ͨ
+// ز     void
+// ʹʾ     pwm_update_hold(channel, 2);
+// עϢ     ֮ pwm_set_duty ֻдӰӼĴ ڱ߽粻װ ֱ pwm_update_commit
+//              ÿ ATOM ģֻдһ AGC GLB_CTRL ͨӰ
+//-------------------------------------------------------------------------------------------------------------------
+void pwm_update_hold (const pwm_channel_enum *pwmch, uint8 count)
+{
+    uint16 mask[4];
+    uint8 index;
+
+    pwm_get_atom_mask(pwmch, count, mask);
+    for(index = 0; index < 4; index++)
+    {
+        if(mask[index])
+        {
+            IfxGtm_Atom_Agc_enableChannelsUpdate(&MODULE_GTM.ATOM[index].AGC, 0, mask[index]);
+        }
+    }
+}
 
+//-------------------------------------------------------------------------------------------------------------------
+//      ſ PWM ͨӰӼĴװ
+// ˵     pwmch           PWM ͨ
+// ˵     count           ͨ
+// ز     void
+// ʹʾ     pwm_update_commit(channel, 2);
+// עϢ      pwm_update_hold ʹ ڼдռձڸͨһڱ߽ͬʱЧ
+//              ͬһ ATOM ģͨһ AGC GLB_CTRL дͬʱſ λͬһڱ߽װ
+//-------------------------------------------------------------------------------------------------------------------
+void pwm_update_commit (const pwm_channel_enum *pwmch, uint8 count)
+{
+    uint16 mask[4];
+    uint8 index;
+
+    pwm_get_atom_mask(pwmch, count, mask);
+    for(index = 0; index < 4; index++)
+    {
+        if(mask[index])
+        {
+            IfxGtm_Atom_Agc_enableChannelsUpdate(&MODULE_GTM.ATOM[index].AGC, mask[index], 0);
+        }
+    }
+}
@@ -86,4 +86,10 @@ void pwm_init                   (pwm_channel_enum pwmch, uint32 freq, uint32 dut
 void pwm_set_duty               (pwm_channel_enum pwmch, uint32 duty);
 //====================================================PWM ====================================================
 
+//====================================================PWM ͬº====================================================
+void pwm_phase_align            (const pwm_channel_enum *pwmch, uint8 count);
+void pwm_update_hold            (const pwm_channel_enum *pwmch, uint8 count);
+void pwm_update_commit          (const pwm_channel_enum *pwmch, uint8 count);
+//====================================================PWM ͬº====================================================
+
 #endif
@@ -0,0 +1,199 @@
+/*
+ * ƶλ
+ *
+ * 룺gcc -std=c99 -O2 -DPID_HOST -Icode tools/brake_sim.c code/brake_control.c -lm -o brake_sim
+ * У./brake_sim [ֵϵ] [ϵ] [ʱ䳣s]
+ *
+ * ģ tools/traction_sim.c ͬһ׵ + -ϵߣIMU
+ * ʱ䳣ȡֵٶȻձʶĵģͣʱ䳣0.1sǰ + ƵٶȻһ¡
+ * ǰ3m/s䳵1.2m/sĿ갴ٶȹ滮ļб½
+ * 1. ͬΪб8m/s^2ʱٶȻƶ1.3m/s루гرƶʱĬб6m/s^2ο
+ * 2. ƶеЧ|ռձ - /|BRAKE_CURRENT_DUTYƶʵ0.3͸·ò 0.6 0.4 ֤
+ * 3. ٶȻٲԵڹ䳵
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "brake_control.h"
+#include "car_params.h"
+
+#define SIM_DT              0.00001             // 沽 (s)
+#define CONTROL_STEPS       100                 //  (沽) = 1ms
+#define PLANNER_MS          20                  // ٶȹ滮 (ms)
+#define GAIN                0.4                 //  (mm/s / ռձ)
+#define MODEL_TAU           0.10                // ٶȻǰʹõıʶʱ䳣 (s)
+#define LOOP_KP             8.0                 // SPEED_LOOP_KP
+#define GRAVITY             9810.0              // mm/s^2
+#define WHEEL_INERTIA       0.15                // ת / ÿֵַ
+#define SLIP_PEAK           0.12                // ϵֵ
+#define SLIP_SLIDE          0.5                 // ʳֵΪϵ
+#define ACC_NOISE           0.02                // IMUٶ (g)
+#define SPEED_NOISE         20.0                //  (mm/s)
+#define START_SPEED         3000.0              // ʼ (mm/s)
+#define CURVE_SPEED         1200.0              // 䳵 (mm/s)
+
+typedef struct
+{
+    double mu_peak;                             // ֵϵ
+    double mu_slide;                            // ϵ
+    double tau;                                 // ʱ䳣 (s)
+    double v;                                   //  (mm/s)
+    double x;                                   //  (mm)
+    double w[2];                                //  (mm/s)
+    double a;                                   // ٶ (mm/s^2)
+    double slip_max;                            // ƶ
+    double current_max;                         // Чռձȵλ
+} sim_car_t;
+
+static int failures = 0;
+
+static void check(int ok, const char *name)
+{
+    printf("%-52s %s\n", name, ok ? "OK" : "FAIL");
+    if (!ok)
+        failures++;
+}
+
+static double noise(double amplitude)
+{
+    return amplitude * (2.0 * rand() / RAND_MAX - 1.0);
+}
+
+// -ϵߣֵǰԣ֮Խϵ
+static double tire_mu(double slip, double peak, double slide)
+{
+    double s = fabs(slip);
+    double mu;
+    if (s <= SLIP_PEAK)
+        mu = peak * s / SLIP_PEAK;
+    else if (s >= SLIP_SLIDE)
+        mu = slide;
+    else
+        mu = peak - (peak - slide) * (s - SLIP_PEAK) / (SLIP_SLIDE - SLIP_PEAK);
+    return slip >= 0.0 ? mu : -mu;
+}
+
+static void sim_car_init(sim_car_t *car, double mu, double slide, double tau)
+{
+    car->mu_peak = mu;
+    car->mu_slide = slide;
+    car->tau = tau;
+    car->v = START_SPEED;
+    car->x = 0.0;
+    car->w[0] = START_SPEED;
+    car->w[1] = START_SPEED;
+    car->a = 0.0;
+    car->slip_max = 0.0;
+    car->current_max = 0.0;
+}
+
+// ռձһ
+static void sim_car_run(sim_car_t *car, const double duty[2])
+{
+    for (int i = 0; i < 2; i++)
+    {
+        double current = fabs(duty[i] - car->w[i] / GAIN);
+        if (current > car->current_max)
+            car->current_max = current;
+    }
+    for (int step = 0; step < CONTROL_STEPS; step++)
+    {
+        double accel = 0.0;
+        for (int i = 0; i < 2; i++)
+        {
+            double base = fmax(fmax(fabs(car->w[i]), fabs(car->v)), 50.0);
+            double slip = (car->w[i] - car->v) / base;
+            double tire = tire_mu(slip, car->mu_peak, car->mu_slide) * GRAVITY;
+            double drive = (GAIN * duty[i] - car->w[i]) / car->tau;
+            car->w[i] += (drive - tire) / WHEEL_INERTIA * SIM_DT;
+            accel += 0.5 * tire;
+            if (car->v > 100.0 && -slip > car->slip_max)
+                car->slip_max = -slip;
+        }
+        car->a = accel;
+        car->v += accel * SIM_DT;
+        car->x += car->v * SIM_DT;
+    }
+}
+
+// ǰ٣سٽCURVE_SPEED+100 (mm)min_speed֮1sڵͳ
+// planner_decel Ϊٶȹ滮б (m/s^2)
+static double run(sim_car_t *car, double planner_decel, int use_brake, double *min_speed, brake_t *bc)
+{
+    double target = START_SPEED;
+    double duty[2] = {0.0, 0.0};
+    double distance = -1.0;
+    double accel_filtered = 0.0;
+    
+    brake_reset(bc);
+    *min_speed = START_SPEED;
+    for (int t = 0; t < 1500; t++)
+    {
+        double decel = 0.0;
+        if (t % PLANNER_MS == 0)
+        {
+            double step = planner_decel * 1000.0 * PLANNER_MS * 0.001;
+            double next = target - step < CURVE_SPEED ? CURVE_SPEED : target - step;
+            decel = (target - next) / (PLANNER_MS * 0.001);
+            target = next;
+            brake_set_request(bc, target, decel);
+        }
+        
+        // ٶȻʶģǰĿбΪٶȣ + 
+        double ramp = target > CURVE_SPEED ? -planner_decel * 1000.0 : 0.0;
+        for (int i = 0; i < 2; i++)
+        {
+            double normal = (target + MODEL_TAU * ramp) / GAIN + LOOP_KP * (target - (car->w[i] + noise(SPEED_NOISE)));
+            duty[i] = fmax(-MOTOR_MAX_DUTY, fmin(MOTOR_MAX_DUTY, normal));
+        }
+        if (use_brake)
+        {
+            accel_filtered += (car->a + noise(ACC_NOISE) * GRAVITY - accel_filtered) * 0.1;
+            brake_step(bc, car->w[0] + noise(SPEED_NOISE), car->w[1] + noise(SPEED_NOISE), accel_filtered, GAIN, GAIN);
+            duty[0] = brake_blend(bc, &bc->left, duty[0]);
+            duty[1] = brake_blend(bc, &bc->right, duty[1]);
+        }
+        sim_car_run(car, duty);
+        
+        if (distance < 0.0 && car->v <= CURVE_SPEED + 100.0)
+            distance = car->x;
+        if (distance >= 0.0 && car->v < *min_speed)
+            *min_speed = car->v;
+    }
+    return distance;
+}
+
+int main(int argc, char **argv)
+{
+    double mu = argc > 1 ? atof(argv[1]) : 0.9;
+    double slide = argc > 2 ? atof(argv[2]) : 0.6;
+    double tau = argc > 3 ? atof(argv[3]) : 0.3;
+    sim_car_t car;
+    brake_t bc;
+    double min_old, min_loop, min_brake;
+    
+    srand(1);
+    printf("mu peak %.2f slide %.2f, loaded tau %.2f s, %.0f -> %.0f mm/s\n", mu, slide, tau, START_SPEED, CURVE_SPEED);
+    
+    sim_car_init(&car, mu, slide, tau);
+    double d_old = run(&car, 6.0, 0, &min_old, &bc);
+    double slip_old = car.slip_max, current_old = car.current_max;
+    sim_car_init(&car, mu, slide, tau);
+    double d_loop = run(&car, 8.0, 0, &min_loop, &bc);
+    double slip_loop = car.slip_max, current_loop = car.current_max;
+    sim_car_init(&car, mu, slide, tau);
+    double d_brake = run(&car, 8.0, 1, &min_brake, &bc);
+    
+    printf("speed loop, ramp 6 m/s^2: %4.0f mm  slip max %.2f  current max %5.0f  min speed %4.0f\n", d_old, slip_old, current_old, min_old);
+    printf("speed loop, ramp 8 m/s^2: %4.0f mm  slip max %.2f  current max %5.0f  min speed %4.0f\n", d_loop, slip_loop, current_loop, min_loop);
+    printf("brake,      ramp 8 m/s^2: %4.0f mm  slip max %.2f  current max %5.0f  min speed %4.0f  (brake %u ms)\n",
+           d_brake, car.slip_max, car.current_max, min_brake, bc.active_ms);
+    
+    check(d_brake > 0.0 && d_brake < 0.85 * d_loop, "braking distance at least 15% shorter, same ramp");
+    check(car.current_max <= BRAKE_CURRENT_DUTY * 1.05, "brake current within BRAKE_CURRENT_DUTY");
+    check(car.slip_max < 0.3, "brake slip below 0.3");
+    check(min_brake > CURVE_SPEED - 100.0, "hand-back undershoot below 100 mm/s");
+    
+    printf("\n%s\n", failures ? "FAILED" : "ALL OK");
+    return failures ? 1 : 0;
+}
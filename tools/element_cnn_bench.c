@@ -0,0 +1,65 @@
+/*
+ * ԪʶCNNλ׼
+ *
+ * 룺gcc -O2 -DELEMENT_CNN_HOST -Icode tools/element_cnn_bench.c code/element_cnn.c -o element_cnn_bench
+ * У./element_cnn_bench [] [ÿγ˼] [CPUƵMHz]
+ *
+ * 1.  element_cnn_weights.h еĲ֤ں export_element_cnn.py οʵλһ
+ * 2. λʱ
+ * 3. ˼ӴTC264ϵڣ ELEMENT_CNN_BUDGET_US Ƚ
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "element_cnn.h"
+#include "element_cnn_weights.h"
+
+static int8 arena[ELEMENT_CNN_ARENA_BYTES];
+
+static void load_input(void)
+{
+    for (int i = 0; i < ELEMENT_CNN_IN_BYTES; i++)
+    {
+        arena[i] = (int8)(element_cnn_test_input[i] - 128);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int runs = argc > 1 ? atoi(argv[1]) : 2000;
+    double cycles_per_mac = argc > 2 ? atof(argv[2]) : 1.5;
+    double cpu_mhz = argc > 3 ? atof(argv[3]) : 200.0;
+    int32 logits[ELEMENT_CNN_CLASSES];
+    int mismatch = 0;
+    
+    load_input();
+    element_cnn_infer(arena, logits);
+    for (int k = 0; k < ELEMENT_CNN_CLASSES; k++)
+    {
+        if (logits[k] != element_cnn_test_logits[k])
+        {
+            printf("logit %d: got %ld expected %ld\n", k, (long)logits[k], (long)element_cnn_test_logits[k]);
+            mismatch++;
+        }
+    }
+    printf("reference check: %s\n", mismatch ? "FAIL" : "OK");
+    
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int i = 0; i < runs; i++)
+    {
+        load_input();
+        element_cnn_infer(arena, logits);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double host_us = ((t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec)) / 1e3 / runs;
+    
+    double target_us = ELEMENT_CNN_MACS * cycles_per_mac / cpu_mhz;
+    printf("arena %d bytes, %d MACs\n", ELEMENT_CNN_ARENA_BYTES, ELEMENT_CNN_MACS);
+    printf("host: %.1f us/inference\n", host_us);
+    printf("target estimate: %.0f cycles, %.0f us @ %.0f MHz (budget %d us) %s\n",
+           ELEMENT_CNN_MACS * cycles_per_mac, target_us, cpu_mhz, ELEMENT_CNN_BUDGET_US,
+           target_us <= ELEMENT_CNN_BUDGET_US ? "OK" : "OVER BUDGET");
+    
+    return mismatch ? 1 : 0;
+}
@@ -0,0 +1,285 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+元素识别CNN权重导出工具
+
+读取训练好的浮点模型（JSON，键名同PyTorch state_dict，卷积权重为OIHW排列）：
+    conv1.weight [8][1][3][3]   conv1.bias [8]
+    conv2.weight [16][8][3][3]  conv2.bias [16]
+    fc.weight    [类别][16]      fc.bias    [类别]
+按层对称量化为int8权重/int32偏置，用校准图像统计激活范围确定重量化乘数与移位，
+生成 code/element_cnn_weights.h（卷积权重转为 [out][ky][kx][in] 以匹配HWC直接卷积）。
+
+同时用与 element_cnn.c 逐位一致的整数参考实现计算一组测试向量写入头文件，
+供 tools/element_cnn_bench.c 在上位机验证内核并测量耗时；并报告量化前后top-1一致率。
+
+校准文件为若干张47x30的uint8下采样灰度图顺序拼接的二进制文件（每张1410字节）。
+
+用法：
+    python3 tools/export_element_cnn.py model.json --calib calib.bin
+    python3 tools/export_element_cnn.py --random 1      # 随机权重，仅用于基准测试
+"""
+
+import argparse
+import json
+import math
+import random
+import sys
+
+IN_W, IN_H = 47, 30
+KERNEL, STRIDE = 3, 2
+C1, C2 = 8, 16
+CLASSES = 9         # 与 element_type_enum 中 ELEMENT_TYPE_MAX 一致
+MULT_BITS = 15
+
+
+def out_size(n):
+    return (n - KERNEL) // STRIDE + 1
+
+
+# ---------------------------------------------------------------- 参考实现
+def conv_float(x, h, w, c, weight, bias):
+    """x: HWC列表，weight: OIHW嵌套列表，返回ReLU后的HWC列表"""
+    oh, ow = out_size(h), out_size(w)
+    out = []
+    for oy in range(oh):
+        for ox in range(ow):
+            for o in range(len(weight)):
+                acc = bias[o]
+                for ky in range(KERNEL):
+                    for kx in range(KERNEL):
+                        base = ((oy * STRIDE + ky) * w + ox * STRIDE + kx) * c
+                        for i in range(c):
+                            acc += x[base + i] * weight[o][i][ky][kx]
+                out.append(max(0.0, acc))
+    return out, oh, ow
+
+
+def forward_float(model, image):
+    x = [(p - 128) / 128.0 for p in image]
+    a1, h1, w1 = conv_float(x, IN_H, IN_W, 1, model["conv1.weight"], model["conv1.bias"])
+    a2, h2, w2 = conv_float(a1, h1, w1, C1, model["conv2.weight"], model["conv2.bias"])
+    n = h2 * w2
+    pooled = [sum(a2[p * C2 + c] for p in range(n)) / n for c in range(C2)]
+    logits = [model["fc.bias"][k] + sum(pooled[c] * model["fc.weight"][k][c] for c in range(C2))
+              for k in range(CLASSES)]
+    return a1, a2, logits
+
+
+def conv_int(x, h, w, c, weight, bias, mult, shift, out_c):
+    """与 element_cnn_conv3x3() 一致：weight为 [out][ky][kx][in] 展平"""
+    oh, ow = out_size(h), out_size(w)
+    row = w * c
+    krow = KERNEL * c
+    rnd = 1 << (shift - 1)
+    out = []
+    for oy in range(oh):
+        for ox in range(ow):
+            patch = oy * STRIDE * row + ox * STRIDE * c
+            wi = 0
+            for o in range(out_c):
+                acc = bias[o]
+                for ky in range(KERNEL):
+                    src = patch + ky * row
+                    for i in range(krow):
+                        acc += x[src + i] * weight[wi + i]
+                    wi += krow
+                y = (acc * mult + rnd) >> shift
+                out.append(min(127, max(0, y)))
+    return out, oh, ow
+
+
+def forward_int(q, image):
+    x = [p - 128 for p in image]
+    a1, h1, w1 = conv_int(x, IN_H, IN_W, 1, q["w1"], q["b1"], q["m1"], q["s1"], C1)
+    a2, h2, w2 = conv_int(a1, h1, w1, C1, q["w2"], q["b2"], q["m2"], q["s2"], C2)
+    n = h2 * w2
+    pooled = [(sum(a2[p * C2 + c] for p in range(n)) + n // 2) // n for c in range(C2)]
+    return [q["bf"][k] + sum(pooled[c] * q["wf"][k * C2 + c] for c in range(C2)) for k in range(CLASSES)]
+
+
+# ---------------------------------------------------------------- 量化
+def weight_scale(values):
+    peak = max(abs(v) for v in values)
+    return peak / 127.0 if peak > 0 else 1.0
+
+
+def flatten_conv(weight):
+    """OIHW -> [out][ky][kx][in]"""
+    flat = []
+    for o in range(len(weight)):
+        for ky in range(KERNEL):
+            for kx in range(KERNEL):
+                for i in range(len(weight[o])):
+                    flat.append(weight[o][i][ky][kx])
+    return flat
+
+
+def requant(real):
+    """real ≈ mult / 2^shift，mult取MULT_BITS位有效数字"""
+    shift = 0
+    while real * (1 << (shift + 1)) < (1 << MULT_BITS) and shift < 62:
+        shift += 1
+    return max(1, int(round(real * (1 << shift)))), max(1, shift)
+
+
+def quantize(model, calib):
+    s_in = 1.0 / 128.0
+    peak1 = peak2 = 1e-6
+    for image in calib:
+        a1, a2, _ = forward_float(model, image)
+        peak1 = max(peak1, max(a1))
+        peak2 = max(peak2, max(a2))
+    s1, s2 = peak1 / 127.0, peak2 / 127.0
+
+    w1 = flatten_conv(model["conv1.weight"])
+    w2 = flatten_conv(model["conv2.weight"])
+    wf = [v for row in model["fc.weight"] for v in row]
+    sw1, sw2, swf = weight_scale(w1), weight_scale(w2), weight_scale(wf)
+
+    q = {}
+    q["w1"] = [int(round(v / sw1)) for v in w1]
+    q["b1"] = [int(round(v / (s_in * sw1))) for v in model["conv1.bias"]]
+    q["m1"], q["s1"] = requant(s_in * sw1 / s1)
+    q["w2"] = [int(round(v / sw2)) for v in w2]
+    q["b2"] = [int(round(v / (s1 * sw2))) for v in model["conv2.bias"]]
+    q["m2"], q["s2"] = requant(s1 * sw2 / s2)
+    q["wf"] = [int(round(v / swf)) for v in wf]
+    q["bf"] = [int(round(v / (s2 * swf))) for v in model["fc.bias"]]
+    q["logit_scale"] = s2 * swf
+    return q
+
+
+# ---------------------------------------------------------------- 模型来源
+def random_model(seed):
+    r = random.Random(seed)
+
+    def conv(o, i):
+        bound = 1.0 / math.sqrt(i * KERNEL * KERNEL)
+        return [[[[r.uniform(-bound, bound) for _ in range(KERNEL)] for _ in range(KERNEL)]
+                 for _ in range(i)] for _ in range(o)]
+
+    return {
+        "conv1.weight": conv(C1, 1), "conv1.bias": [r.uniform(-0.1, 0.1) for _ in range(C1)],
+        "conv2.weight": conv(C2, C1), "conv2.bias": [r.uniform(-0.1, 0.1) for _ in range(C2)],
+        "fc.weight": [[r.uniform(-0.25, 0.25) for _ in range(C2)] for _ in range(CLASSES)],
+        "fc.bias": [0.0] * CLASSES,
+    }
+
+
+def synthetic_images(count, seed):
+    """无校准数据时使用：亮赛道+暗背景的简单合成图"""
+    r = random.Random(seed)
+    images = []
+    for _ in range(count):
+        left = r.randint(0, 20)
+        right = r.randint(27, IN_W)
+        images.append([min(255, max(0, (200 if left <= x < right else 40) + r.randint(-20, 20)))
+                       for y in range(IN_H) for x in range(IN_W)])
+    return images
+
+
+def load_calib(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    size = IN_W * IN_H
+    return [list(data[i:i + size]) for i in range(0, len(data) - size + 1, size)]
+
+
+# ---------------------------------------------------------------- 生成头文件
+def c_table(values, per_line=16):
+    lines = []
+    for i in range(0, len(values), per_line):
+        lines.append("    " + ", ".join("%d" % v for v in values[i:i + per_line]))
+    return ",\n".join(lines)
+
+
+def emit_header(path, q, info, test_input, test_logits):
+    t = []
+    t.append("#ifndef _ELEMENT_CNN_WEIGHTS_H_")
+    t.append("#define _ELEMENT_CNN_WEIGHTS_H_")
+    t.append("")
+    t.append("// 本文件由 tools/export_element_cnn.py 生成，请勿手工修改")
+    t.append("// %s" % info)
+    t.append("")
+    t.append("#define ELEMENT_CNN_CONV1_MULT      %d" % q["m1"])
+    t.append("#define ELEMENT_CNN_CONV1_SHIFT     %d" % q["s1"])
+    t.append("#define ELEMENT_CNN_CONV2_MULT      %d" % q["m2"])
+    t.append("#define ELEMENT_CNN_CONV2_SHIFT     %d" % q["s2"])
+    t.append("#define ELEMENT_CNN_LOGIT_SCALE     %.9gf       // logit实际值 = 整数logit * 该系数" % q["logit_scale"])
+    t.append("")
+    for name, ctype, key, size in (
+            ("conv1_weight", "int8", "w1", "ELEMENT_CNN_C1 * 9"),
+            ("conv1_bias", "int32", "b1", "ELEMENT_CNN_C1"),
+            ("conv2_weight", "int8", "w2", "ELEMENT_CNN_C2 * 9 * ELEMENT_CNN_C1"),
+            ("conv2_bias", "int32", "b2", "ELEMENT_CNN_C2"),
+            ("fc_weight", "int8", "wf", "ELEMENT_CNN_CLASSES * ELEMENT_CNN_C2"),
+            ("fc_bias", "int32", "bf", "ELEMENT_CNN_CLASSES")):
+        t.append("static const %s element_cnn_%s[%s] =" % (ctype, name, size))
+        t.append("{")
+        t.append(c_table(q[key], 16 if ctype == "int8" else 8))
+        t.append("};")
+        t.append("")
+    t.append("#ifdef ELEMENT_CNN_HOST")
+    t.append("// 上位机验证用测试向量")
+    t.append("static const uint8 element_cnn_test_input[ELEMENT_CNN_IN_BYTES] =")
+    t.append("{")
+    t.append(c_table(test_input, 24))
+    t.append("};")
+    t.append("")
+    t.append("static const int32 element_cnn_test_logits[ELEMENT_CNN_CLASSES] =")
+    t.append("{")
+    t.append(c_table(test_logits, 9))
+    t.append("};")
+    t.append("#endif")
+    t.append("")
+    t.append("#endif // _ELEMENT_CNN_WEIGHTS_H_")
+    t.append("")
+    with open(path, "w", encoding="gbk", newline="\n") as f:
+        f.write("\n".join(t))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="量化元素识别CNN并生成C权重数组")
+    parser.add_argument("model", nargs="?", help="浮点模型JSON")
+    parser.add_argument("--calib", help="校准图像二进制文件（47x30 uint8 拼接）")
+    parser.add_argument("--random", type=int, metavar="SEED", help="生成随机权重模型（仅用于基准测试）")
+    parser.add_argument("--out", default="code/element_cnn_weights.h", help="输出头文件")
+    args = parser.parse_args()
+
+    if args.random is not None:
+        model = random_model(args.random)
+        info = "随机权重（种子 %d），未经训练，仅用于耗时测试" % args.random
+    elif args.model:
+        with open(args.model, "r", encoding="utf-8") as f:
+            model = json.load(f)
+        info = "模型 %s" % args.model
+    else:
+        parser.error("需要模型文件或 --random")
+
+    if len(model["fc.bias"]) != CLASSES:
+        print("fc output size %d != %d classes" % (len(model["fc.bias"]), CLASSES), file=sys.stderr)
+        return 1
+
+    calib = load_calib(args.calib) if args.calib else synthetic_images(16, 7)
+    if not calib:
+        print("empty calibration set", file=sys.stderr)
+        return 1
+    q = quantize(model, calib)
+
+    agree = 0
+    for image in calib:
+        logits_f = forward_float(model, image)[2]
+        logits_q = forward_int(q, image)
+        agree += logits_f.index(max(logits_f)) == logits_q.index(max(logits_q))
+    print("calibration images: %d, float/int8 top-1 agreement: %d/%d" % (len(calib), agree, len(calib)))
+    print("conv1 mult %d shift %d, conv2 mult %d shift %d" % (q["m1"], q["s1"], q["m2"], q["s2"]))
+
+    test_input = calib[0]
+    emit_header(args.out, q, info, test_input, forward_int(q, test_input))
+    print("wrote %s" % args.out)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,209 @@
+/*
+ * λһԼ
+ *
+ * 룺gcc -std=c99 -O2 -DPID_HOST -Icode tools/fixed_point_check.c code/fixed_point.c code/pid_control.c -lm -o fixed_point_check
+ * У./fixed_point_check
+ *
+ * 1. tantanfڡ45ڵ
+ * 2. pid_calculate_q16()pid_calculate()ͬµٶ/PIDл
+ * 3. ӳ븡ӳ䣨룩ռձһ
+ * 4. 븡ٵٶȲ
+ * 5. λʱԱ
+ *
+ *  motor_control.h / smart_car.h һ£ -std=c99 룺POSIXͷļеpid_tPIDṹͬ
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "pid_control.h"
+#include "fixed_point.h"
+#include "car_params.h"
+
+#define SERVO_CENTER_DUTY   715
+#define SERVO_RIGHT_MAX     800
+
+static int failures = 0;
+
+static void check(int ok, const char *name)
+{
+    printf("%-44s %s\n", name, ok ? "OK" : "FAIL");
+    if (!ok)
+        failures++;
+}
+
+static double now_ns(void)
+{
+    return (double)clock() * 1e9 / CLOCKS_PER_SEC;
+}
+
+// 1. tan
+static void test_tan(void)
+{
+    double worst = 0.0;
+
+    for (int i = -4500; i <= 4500; i++)
+    {
+        float deg = i * 0.01f;
+        double ref = tan(deg * 3.14159265358979 / 180.0);
+        double got = fixed_tan_deg(Q16_FROM_FLOAT(deg)) / 65536.0;
+        if (fabs(got - ref) > worst)
+            worst = fabs(got - ref);
+    }
+    printf("  tan LUT max error %.2e\n", worst);
+    check(worst < 1e-4, "fixed_tan_deg() vs tan()");
+}
+
+// 2. PID
+static double pid_compare(float kp, float ki, float kd, float limit, int range, int scene_switch)
+{
+    pid_t ref, fix;
+    double worst = 0.0;
+
+    pid_init(&ref, kp, ki, kd, limit, -limit);
+    pid_init(&fix, kp, ki, kd, limit, -limit);
+
+    for (int k = 0; k < 20000; k++)
+    {
+        int target = (k / 500) % 2 ? range / 2 : -range / 3;
+        int current = rand() % (2 * range + 1) - range;
+
+        if (scene_switch && k % 1000 == 999)
+        {
+            float scale = 0.5f + (float)rand() / RAND_MAX;
+            pid_set_params_bumpless(&ref, kp * scale, ki * scale, kd * scale);
+            pid_set_params_bumpless(&fix, kp * scale, ki * scale, kd * scale);
+        }
+
+        pid_set_target(&ref, (float)target);
+        float out_ref = pid_calculate(&ref, (float)current);
+        float out_fix = Q16_TO_FLOAT(pid_calculate_q16(&fix, target, current));
+        double diff = fabs((double)out_ref - out_fix);
+        if (diff > worst)
+            worst = diff;
+    }
+    return worst;
+}
+
+static void test_pid(void)
+{
+    // ٶPIDsmart_car.h 3008000
+    static const float speed_gains[][3] =
+    {
+        {3.0f, 0.0f, 0.0f}, {60.0f, 2.5f, 6.0f}, {45.0f, 1.8f, 4.5f}, {12.3f, 0.37f, 1.1f},
+    };
+    // PIDӾƫ9445
+    static const float direction_gains[][3] =
+    {
+        {0.5f, 0.0f, 0.1f}, {0.33f, 0.01f, 0.27f}, {1.2f, 0.0f, 0.8f},
+    };
+    double worst_speed = 0.0, worst_direction = 0.0;
+
+    for (unsigned i = 0; i < sizeof(speed_gains) / sizeof(speed_gains[0]); i++)
+    {
+        double d = pid_compare(speed_gains[i][0], speed_gains[i][1], speed_gains[i][2], 8000.0f, 300, 1);
+        if (d > worst_speed)
+            worst_speed = d;
+    }
+    for (unsigned i = 0; i < sizeof(direction_gains) / sizeof(direction_gains[0]); i++)
+    {
+        double d = pid_compare(direction_gains[i][0], direction_gains[i][1], direction_gains[i][2], 45.0f, 94, 1);
+        if (d > worst_direction)
+            worst_direction = d;
+    }
+    printf("  speed PID max diff %.4f duty, direction PID max diff %.5f deg\n", worst_speed, worst_direction);
+    check(worst_speed < 0.5 && worst_direction < 0.01, "pid_calculate_q16() vs pid_calculate()");
+}
+
+// 3. ӳ
+static void test_servo(void)
+{
+    int mismatch = 0;
+
+    for (int i = -4500; i <= 4500; i++)
+    {
+        float deg = i * 0.01f;
+        int ref = SERVO_CENTER_DUTY + (int)lround((SERVO_RIGHT_MAX - SERVO_CENTER_DUTY) * deg / 45.0);
+        int got = SERVO_CENTER_DUTY + fixed_round_div((SERVO_RIGHT_MAX - SERVO_CENTER_DUTY) * Q16_FROM_FLOAT(deg),
+                                                      Q16_FROM_INT(45));
+        if (ref != got)
+            mismatch++;
+    }
+    printf("  servo duty mismatches %d / 9001 (0.01 deg steps)\n", mismatch);
+    check(mismatch <= 9, "servo Q16 mapping vs float");
+}
+
+// 4. 
+static void test_differential(void)
+{
+    int worst = 0;
+
+    for (int base = -300; base <= 300; base += 7)
+    {
+        for (int angle = -45; angle <= 45; angle++)
+        {
+            float ratio = CAR_TRACK_WIDTH * tanf(angle * 3.14159f / 180.0f) / (2.0f * CAR_WHEELBASE);
+            int ref_l = (int16)(base * (1.0f - ratio));
+            int ref_r = (int16)(base * (1.0f + ratio));
+
+            q16_t ratio_q = fixed_tan_deg(Q16_FROM_INT(angle)) * CAR_TRACK_WIDTH / (2 * CAR_WHEELBASE);
+            int got_l = (int16)(fixed_mul(Q16_FROM_INT(base), Q16_ONE - ratio_q) / Q16_ONE);
+            int got_r = (int16)(fixed_mul(Q16_FROM_INT(base), Q16_ONE + ratio_q) / Q16_ONE);
+
+            if (abs(ref_l - got_l) > worst)
+                worst = abs(ref_l - got_l);
+            if (abs(ref_r - got_r) > worst)
+                worst = abs(ref_r - got_r);
+        }
+    }
+    printf("  differential max diff %d counts\n", worst);
+    check(worst <= 1, "Q16 differential vs float");
+}
+
+// 5. ʱ
+static void bench(void)
+{
+    enum { RUNS = 2000000 };
+    pid_t a, b;
+    volatile float sink_f = 0.0f;
+    volatile int32 sink_q = 0;
+
+    pid_init(&a, 60.0f, 2.5f, 6.0f, 8000.0f, -8000.0f);
+    pid_init(&b, 60.0f, 2.5f, 6.0f, 8000.0f, -8000.0f);
+
+    double t0 = now_ns();
+    for (int k = 0; k < RUNS; k++)
+    {
+        pid_set_target(&a, 100.0f);
+        sink_f += pid_calculate(&a, (float)(k & 255));
+    }
+    double t1 = now_ns();
+    for (int k = 0; k < RUNS; k++)
+        sink_q += pid_calculate_q16(&b, 100, k & 255);
+    double t2 = now_ns();
+    for (int k = 0; k < RUNS; k++)
+        sink_f += tanf((float)(k % 90 - 45) * 3.14159f / 180.0f);
+    double t3 = now_ns();
+    for (int k = 0; k < RUNS; k++)
+        sink_q += fixed_tan_deg(Q16_FROM_INT(k % 90 - 45));
+    double t4 = now_ns();
+
+    printf("host timing (ns/call): pid float %.1f, pid q16 %.1f, tanf %.1f, tan LUT %.1f\n",
+           (t1 - t0) / RUNS, (t2 - t1) / RUNS, (t3 - t2) / RUNS, (t4 - t3) / RUNS);
+    (void)sink_f;
+    (void)sink_q;
+}
+
+int main(void)
+{
+    srand(1);
+
+    test_tan();
+    test_pid();
+    test_servo();
+    test_differential();
+    bench();
+
+    printf("%s\n", failures ? "FAILED" : "ALL OK");
+    return failures ? 1 : 0;
+}
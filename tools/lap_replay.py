@@ -0,0 +1,199 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+圈记忆回放工具
+
+从串口日志中读取小车停车后输出的圈记忆（lap_memory_dump()）：
+    LAPMEM <分段数> <分段长度mm> <圈长mm> <生成耗时us>
+    LAPBIN <序号> <曲率x1000> <车速mm/s> <元素> <曲线速度mm/s>
+用与 lap_memory_compute_profile() 相同的算法重新生成速度曲线，可在车外调整横向加速度、
+加减速度与元素速度系数，比较第一圈实际用时与按曲线行驶的估计用时。
+
+默认参数与 lap_memory.h / speed_planner.h 一致，此时还会检查车上生成的曲线与本工具结果是否一致。
+
+用法：
+    python3 tools/lap_replay.py run1.log
+    python3 tools/lap_replay.py run1.log --lat-accel 5 --decel 7 --csv profile.csv
+    python3 tools/lap_replay.py --demo                  # 用合成赛道演示
+"""
+
+import argparse
+import math
+import sys
+
+# 与 element_type_enum 顺序一致
+ELEMENT_NAMES = [
+    "NONE", "CROSS", "CIRCLE", "RAMP", "OBSTACLE", "PARKING", "ZEBRA", "SPEED_BUMP", "FORK",
+]
+
+# 与 lap_memory.h / speed_planner.h 默认值一致
+DEFAULTS = {
+    "max_speed": 3.0,
+    "min_speed": 0.8,
+    "lat_accel": 4.0,
+    "accel": 3.0,
+    "decel": 6.0,
+    "element_gain": 1.1,
+}
+
+
+# ---------------------------------------------------------------- 日志解析
+def load_laps(paths):
+    laps = []
+    for path in paths:
+        lap = None
+        with open(path, "r", encoding="utf-8", errors="ignore") as f:
+            for line in f:
+                fields = line.split()
+                if not fields:
+                    continue
+                try:
+                    if fields[0] == "LAPMEM" and len(fields) >= 4:
+                        lap = {
+                            "source": path,
+                            "count": int(fields[1]),
+                            "bin_mm": int(fields[2]),
+                            "length_mm": int(fields[3]),
+                            "compute_us": int(fields[4]) if len(fields) > 4 else 0,
+                            "bins": [],
+                        }
+                        laps.append(lap)
+                    elif fields[0] == "LAPBIN" and lap is not None and len(fields) >= 6:
+                        _, curvature, speed, element, profile = (int(v) for v in fields[1:6])
+                        lap["bins"].append((curvature, speed, element, profile))
+                except ValueError:
+                    continue
+    complete = []
+    for lap in laps:
+        if len(lap["bins"]) != lap["count"]:
+            print("skip incomplete lap in %s (%d/%d bins)" % (lap["source"], len(lap["bins"]), lap["count"]),
+                  file=sys.stderr)
+            continue
+        complete.append(lap)
+    return complete
+
+
+def demo_lap():
+    """合成赛道：两条直道+两个半径0.8m的半圆弯，其中一段直道上有坡道"""
+    bin_mm = 100
+    segments = [(6000, 0.0), (int(math.pi * 800), 1 / 0.8), (6000, 0.0), (int(math.pi * 800), 1 / 0.8)]
+    bins = []
+    for length, kappa in segments:
+        for _ in range(length // bin_mm):
+            bins.append([int(kappa * 1000), 0, 0, 0])
+    for i in range(20, 28):
+        bins[i][2] = 3      # RAMP
+    # 第一圈保守行驶：直道1.8m/s，弯道1.2m/s
+    for b in bins:
+        b[1] = 1200 if b[0] else 1800
+    bins = [tuple(b) for b in bins]
+    return {"source": "demo", "count": len(bins), "bin_mm": bin_mm, "length_mm": len(bins) * bin_mm,
+            "compute_us": 0, "bins": bins}
+
+
+# ---------------------------------------------------------------- 速度曲线（与lap_memory_compute_profile()一致）
+def compute_profile(lap, p):
+    n = lap["count"]
+    ds = lap["bin_mm"] / 1000.0
+    v = []
+    for curvature, speed, element, _ in lap["bins"]:
+        kappa = curvature / 1000.0
+        limit = p["max_speed"]
+        if kappa > 1e-3:
+            limit = min(limit, math.sqrt(p["lat_accel"] / kappa))
+        if element != 0:
+            limit = min(limit, speed / 1000.0 * p["element_gain"])
+        v.append(max(limit, p["min_speed"]))
+
+    for k in range(1, 2 * n):
+        i, prev = k % n, (k - 1) % n
+        v[i] = min(v[i], math.sqrt(v[prev] ** 2 + 2.0 * p["accel"] * ds))
+    for k in range(2 * n - 1, 0, -1):
+        i, nxt = (k - 1) % n, k % n
+        v[i] = min(v[i], math.sqrt(v[nxt] ** 2 + 2.0 * p["decel"] * ds))
+
+    return [int(x * 1000.0 + 0.5) for x in v]
+
+
+def lap_time(speeds_mm_s, bin_mm):
+    return sum(bin_mm / max(s, 1) for s in speeds_mm_s)
+
+
+# ---------------------------------------------------------------- 报告
+def report(index, lap, profile, p, check, verbose):
+    bins = lap["bins"]
+    recorded = [b[1] for b in bins]
+    t_rec = lap_time(recorded, lap["bin_mm"])
+    t_pro = lap_time(profile, lap["bin_mm"])
+
+    print("lap %d (%s): %d bins x %d mm, %.2f m, on-car compute %d us"
+          % (index, lap["source"], lap["count"], lap["bin_mm"], lap["length_mm"] / 1000.0, lap["compute_us"]))
+    print("  recorded lap-1 time %.2f s, profile time %.2f s (%+.1f%%)"
+          % (t_rec, t_pro, (t_pro - t_rec) / t_rec * 100.0 if t_rec else 0.0))
+    print("  profile speed min %.2f max %.2f mean %.2f m/s"
+          % (min(profile) / 1000.0, max(profile) / 1000.0, sum(profile) / len(profile) / 1000.0))
+
+    elements = []
+    for i, b in enumerate(bins):
+        if b[2] and (i == 0 or bins[i - 1][2] != b[2]):
+            elements.append("%s@%.1fm" % (ELEMENT_NAMES[b[2]] if b[2] < len(ELEMENT_NAMES) else b[2],
+                                          i * lap["bin_mm"] / 1000.0))
+    if elements:
+        print("  elements: " + " ".join(elements))
+
+    if check:
+        diff = max(abs(a - b[3]) for a, b in zip(profile, bins))
+        print("  on-car profile check: %s (max diff %d mm/s)" % ("OK" if diff <= 2 else "MISMATCH", diff))
+
+    if verbose:
+        print("   bin   dist(m)  kappa  lap1(m/s)  profile(m/s)  element")
+        for i, (b, v) in enumerate(zip(bins, profile)):
+            print("  %4d  %7.2f  %5.2f  %9.2f  %12.2f  %s"
+                  % (i, i * lap["bin_mm"] / 1000.0, b[0] / 1000.0, b[1] / 1000.0, v / 1000.0,
+                     ELEMENT_NAMES[b[2]] if b[2] and b[2] < len(ELEMENT_NAMES) else ""))
+
+
+def write_csv(path, laps, profiles):
+    with open(path, "w", encoding="utf-8") as f:
+        f.write("lap,bin,distance_m,curvature,lap1_speed,element,onboard_profile,profile\n")
+        for index, (lap, profile) in enumerate(zip(laps, profiles)):
+            for i, (b, v) in enumerate(zip(lap["bins"], profile)):
+                f.write("%d,%d,%.3f,%.3f,%.3f,%d,%.3f,%.3f\n"
+                        % (index, i, i * lap["bin_mm"] / 1000.0, b[0] / 1000.0, b[1] / 1000.0, b[2],
+                           b[3] / 1000.0, v / 1000.0))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="圈记忆回放与速度曲线调参")
+    parser.add_argument("logs", nargs="*", help="串口日志文件")
+    parser.add_argument("--demo", action="store_true", help="使用合成赛道")
+    parser.add_argument("--max-speed", type=float, default=DEFAULTS["max_speed"])
+    parser.add_argument("--min-speed", type=float, default=DEFAULTS["min_speed"])
+    parser.add_argument("--lat-accel", type=float, default=DEFAULTS["lat_accel"])
+    parser.add_argument("--accel", type=float, default=DEFAULTS["accel"])
+    parser.add_argument("--decel", type=float, default=DEFAULTS["decel"])
+    parser.add_argument("--element-gain", type=float, default=DEFAULTS["element_gain"])
+    parser.add_argument("--csv", help="输出逐分段CSV")
+    parser.add_argument("-v", "--verbose", action="store_true", help="打印逐分段表格")
+    args = parser.parse_args()
+
+    laps = [demo_lap()] if args.demo else load_laps(args.logs)
+    if not laps:
+        parser.error("no LAPMEM/LAPBIN records found (give log files or --demo)")
+
+    p = {k: getattr(args, k) for k in DEFAULTS}
+    check = not args.demo and p == DEFAULTS
+
+    profiles = []
+    for index, lap in enumerate(laps):
+        profile = compute_profile(lap, p)
+        profiles.append(profile)
+        report(index, lap, profile, p, check, args.verbose)
+
+    if args.csv:
+        write_csv(args.csv, laps, profiles)
+        print("wrote %s" % args.csv)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,270 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+横向卡尔曼滤波仿真
+
+在 steer_predict_sim.py 的运动学模型上（同一摄像头成像、图像延迟与舵机滞后），按 lateral_kf.c 的算法
+以1ms陀螺仪与车速预测、每帧中线拟合修正，比较：
+    估计误差   滤波横向偏移/航向误差与真值之差，对比"保持上一帧量测"的误差（现有做法）
+    闭环误差   方向PID输入分别为图像偏差（丢线时沿用上一次）与滤波等效偏差时的弯道横向误差
+可加入随机丢帧、连续丢帧与陀螺仪零偏。
+
+参数默认值与 lateral_kf.h / steer_predict.h / pure_pursuit.h 一致。
+
+用法：
+    python3 tools/lateral_kf_sim.py
+    python3 tools/lateral_kf_sim.py --drop 0.3 --burst 150 --gyro-bias 0.05 --speed 2.5
+"""
+
+import argparse
+import math
+import os
+import random
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import steer_predict_sim as sim  # noqa: E402
+
+# lateral_kf.h
+HISTORY = 64
+Q = (1e-4, 2e-3, 1e-6)
+Q_HEADING_STRAIGHT = 1e-5
+R = (2e-4, 1e-3)
+P0 = (0.01, 0.05, 3e-3)
+MAX_OFFSET_VAR = 0.0025
+STRAIGHT_CURVATURE = 0.1
+BIAS_MAX_YAW_RATE = 0.2
+BIAS_SETTLE_DISTANCE = 1.2
+CAMERA_OFFSET = 0.0             # 仿真中摄像头位于后轴（steer_predict_sim 的成像原点即车辆参考点）
+
+
+class LateralKf:
+    """lateral_kf.c"""
+
+    def __init__(self):
+        self.x = [0.0, 0.0, 0.0]
+        self.P = [[P0[0], 0, 0], [0, P0[1], 0], [0, 0, P0[2]]]
+        self.curvature = 0.0
+        self.distance = 0.0
+        self.history = []       # 最新在前：(offset, heading, bias, distance)
+        self.initialized = False
+        self.yaw_rate = 0.0     # 扣除零偏估计后的角速度
+        self.curve_distance = -BIAS_SETTLE_DISTANCE    # 最近一次弯道量测或转弯时的里程
+        self.straight = True
+        self.ppm = self.ppr = self.ppk = 0.0
+
+    def shift_history(self, d):
+        dt = 0.001
+        total = 0.0
+        for age, h in enumerate(self.history):
+            s = self.distance - h[3]
+            t = age * dt
+            m = total - h[3] * t
+            self.history[age] = (h[0] + d[0] - s * d[1] + (m - s * t) * d[2], h[1] + d[1] + t * d[2], h[2] + d[2], h[3])
+            total += h[3] * dt
+
+    def correct(self, age, z_off, z_head, curvature):
+        dt = 0.001
+        age = min(age, len(self.history) - 1)
+        total = sum(self.history[i][3] * dt for i in range(age))
+        h = self.history[age]
+        s = self.distance - h[3]
+        t = age * dt
+        m = total - h[3] * t
+        self.curvature = 0.0 if abs(curvature) < STRAIGHT_CURVATURE else curvature
+        if self.curvature != 0.0 or abs(self.yaw_rate) > BIAS_MAX_YAW_RATE:
+            self.curve_distance = self.distance
+        self.straight = self.distance - self.curve_distance >= BIAS_SETTLE_DISTANCE
+        if not self.initialized:
+            b = self.x[2]
+            d = [z_off + s * z_head - m * b - self.x[0], z_head - t * b - self.x[1], 0.0]
+            self.x = [self.x[i] + d[i] for i in range(3)]
+            self.shift_history(d)
+            self.initialized = True
+            return
+        H = [[1.0, -s, m - s * t], [0.0, 1.0, t]]
+        r = [z_off - h[0], z_head - h[1]]
+        P = self.P
+        pht = [[sum(P[i][j] * H[k][j] for j in range(3)) for k in range(2)] for i in range(3)]
+        sm = [[sum(H[k][j] * pht[j][l] for j in range(3)) for l in range(2)] for k in range(2)]
+        sm[0][0] += R[0]
+        sm[1][1] += R[1]
+        det = sm[0][0] * sm[1][1] - sm[0][1] * sm[1][0]
+        inv = [[sm[1][1] / det, -sm[0][1] / det], [-sm[1][0] / det, sm[0][0] / det]]
+        K = [[pht[i][0] * inv[0][l] + pht[i][1] * inv[1][l] for l in range(2)] for i in range(3)]
+        hold = not self.straight
+        if hold:
+            K[2] = [0.0, 0.0]
+        d = [K[i][0] * r[0] + K[i][1] * r[1] for i in range(3)]
+        P = [[P[i][j] - (K[i][0] * pht[j][0] + K[i][1] * pht[j][1]) for j in range(3)] for i in range(3)]
+        if hold:
+            # 零偏不修正时只有第2列正确，第2行照抄第2列
+            for i in range(2):
+                P[2][i] = P[i][2]
+        self.P = [[0.5 * (P[i][j] + P[j][i]) for j in range(3)] for i in range(3)]
+        self.x = [self.x[i] + d[i] for i in range(3)]
+        self.shift_history(d)
+
+    def predict(self, v, omega):
+        dt = 0.001
+        self.yaw_rate = omega - self.x[2]
+        self.x[0] += v * dt * self.x[1]
+        self.x[1] += (omega - self.x[2] + v * self.curvature) * dt
+        F = [[1, v * dt, 0], [0, 1, -dt], [0, 0, 1]]
+        P = self.P
+        fp = [[sum(F[i][k] * P[k][j] for k in range(3)) for j in range(3)] for i in range(3)]
+        q = (Q[0], Q_HEADING_STRAIGHT if self.straight else Q[1], Q[2])
+        self.P = [[sum(fp[i][k] * F[j][k] for k in range(3)) + (q[i] * dt if i == j else 0.0)
+                   for j in range(3)] for i in range(3)]
+        self.distance += v * dt
+        self.history.insert(0, (self.x[0], self.x[1], self.x[2], self.distance))
+        del self.history[HISTORY:]
+
+    def valid(self):
+        return self.initialized and self.P[0][0] < MAX_OFFSET_VAR
+
+    def deviation(self):
+        off = self.x[0] + CAMERA_OFFSET * self.x[1]
+        dev = off * self.ppm + self.x[1] * self.ppr + self.curvature * self.ppk
+        return int(round(max(-80.0, min(80.0, dev))))
+
+
+def measurement(rows):
+    """lateral_kf_measure()：二次拟合外推到后轴"""
+    info = sim.frame_info(rows)
+    if not info["fit"]:
+        return None, info
+    b, c, _ = info["fit"]
+    # frame_info 只返回 b、c，a 由拟合点重新求
+    pts = [(sim.ROW_DIST[r], (int(col) - (sim.IMAGE_W - 1) * 0.5) * sim.ROW_SCALE[r]) for r, col in rows.items()
+           if 0 < sim.ROW_DIST[r] <= sim.FIT_MAX_DIST]
+    a = sum(x - b * y - c * y * y for y, x in pts) / len(pts)
+    y = -CAMERA_OFFSET
+    off = a + b * y + c * y * y
+    slope = b + 2 * c * y
+    q = 1 + slope * slope
+    return (off / math.sqrt(q), math.atan(slope), 2 * c / (q * math.sqrt(q))), info
+
+
+def truth(track, x, y, h):
+    """真值：车在中线左侧为正的横向偏移、车头相对赛道逆时针为正的航向误差"""
+    i = min(range(len(track) - 1), key=lambda k: (track[k][0] - x) ** 2 + (track[k][1] - y) ** 2)
+    (x0, y0), (x1, y1) = track[i], track[i + 1]
+    th = math.atan2(y1 - y0, x1 - x0)
+    off = -math.sin(th) * (x - x0) + math.cos(th) * (y - y0)
+    err = (h - th + math.pi) % (2 * math.pi) - math.pi
+    return off, err
+
+
+def run(track, args, use_kf, rng):
+    camera = sim.Camera(track)
+    kf = LateralKf()
+    x, y, h, steer = 0.0, 0.0, 0.0, 0.0
+    frames = []
+    command = 0.0
+    last_dev = 0
+    last_error = 0.0
+    held = None
+    est_err = {"kf": [], "hold": []}
+    cross = []
+    arc_start = args.straight
+    arc_end = args.straight + math.radians(args.arc) * args.radius
+    burst_start = args.straight + 0.5 * (arc_end - arc_start)
+    s = 0.0
+    t_ms = 0
+    yaw_rate = 0.0
+    straight_bias = None
+    while s < arc_end + 0.5:
+        if t_ms % args.frame_ms == 0:
+            dropped = rng.random() < args.drop or (burst_start <= s < burst_start + args.burst * 0.001 * args.speed)
+            if not dropped:
+                frames.append((t_ms + args.latency, t_ms, {r: int(c) for r, c in camera.centerline((x, y, h)).items()}))
+        # 图像处理完成：写量测
+        ready = [f for f in frames if f[0] <= t_ms]
+        for f in sorted(ready, key=lambda f: f[1]):
+            meas, info = measurement(f[2])
+            dev = sim.deviation(f[2])
+            if dev is not None:
+                last_dev = dev
+            if meas:
+                kf.ppm, kf.ppr, kf.ppk = info["ppm"], info["ppr"], info["ppk"]
+                kf.correct(t_ms - f[1], *meas)
+                held = meas
+        frames = [f for f in frames if f[0] > t_ms]
+        if t_ms % sim.CONTROL_MS == 0:
+            dev = kf.deviation() if use_kf and kf.valid() else last_dev
+            error = -dev
+            pid = args.kp * error + args.kd * (error - last_error)
+            last_error = error
+            command = max(-sim.MAX_ANGLE, min(sim.MAX_ANGLE, pid))
+        steer += (command - steer) * sim.SIM_DT / args.servo_tau
+        yaw_rate = args.speed * math.tan(math.radians(steer)) / sim.WHEELBASE
+        h += yaw_rate * sim.SIM_DT
+        x += args.speed * math.cos(h) * sim.SIM_DT
+        y += args.speed * math.sin(h) * sim.SIM_DT
+        s += args.speed * sim.SIM_DT
+        t_ms += 1
+        kf.predict(args.speed, yaw_rate + args.gyro_bias)
+        if straight_bias is None and s >= arc_start:
+            straight_bias = kf.x[2]
+        if arc_start - 0.5 <= s <= arc_end and t_ms % 5 == 0:
+            off, head = truth(track, x, y, h)
+            cross.append(abs(off))
+            if kf.initialized:
+                est_err["kf"].append((kf.x[0] - off, kf.x[1] - head))
+            if held:
+                est_err["hold"].append((held[0] - off, held[1] - head))
+    rms = {}
+    for k, e in est_err.items():
+        n = max(len(e), 1)
+        rms[k] = (math.sqrt(sum(a * a for a, _ in e) / n), math.sqrt(sum(b * b for _, b in e) / n))
+    return rms, max(cross), math.sqrt(sum(c * c for c in cross) / len(cross)), (straight_bias, kf.x[2])
+
+
+def main():
+    parser = argparse.ArgumentParser(description="横向卡尔曼滤波仿真")
+    parser.add_argument("--speed", type=float, default=2.0, help="车速 (m/s)")
+    parser.add_argument("--radius", type=float, default=0.8, help="弯道半径 (m)")
+    parser.add_argument("--arc", type=float, default=120.0, help="弯道角度 (度)")
+    parser.add_argument("--straight", type=float, default=3.0, help="入弯前直道长度 (m)，零偏在直道上收敛，过短时检查失败")
+    parser.add_argument("--latency", type=int, default=30, help="曝光到图像可用的延迟 (ms)")
+    parser.add_argument("--frame-ms", type=int, default=10, help="帧间隔 (ms)")
+    parser.add_argument("--servo-tau", type=float, default=0.03, help="舵机时间常数 (s)")
+    parser.add_argument("--kp", type=float, default=1.0, help="方向PID Kp (度/像素)")
+    parser.add_argument("--kd", type=float, default=0.0, help="方向PID Kd")
+    parser.add_argument("--drop", type=float, default=0.2, help="随机丢帧比例")
+    parser.add_argument("--burst", type=int, default=100, help="弯道中段连续丢帧时长 (ms)")
+    parser.add_argument("--gyro-bias", type=float, default=0.02, help="陀螺仪残余零偏 (rad/s)")
+    parser.add_argument("--bias-tol", type=float, default=0.008, help="零偏估计误差容限 (rad/s)，超过时返回1")
+    parser.add_argument("--seed", type=int, default=1)
+    args = parser.parse_args()
+
+    track = sim.make_track(args.straight, args.radius, args.arc)
+    results = {}
+    for name, use_kf in (("vision", False), ("kf", True)):
+        results[name] = run(track, args, use_kf, random.Random(args.seed))
+
+    rms = results["kf"][0]
+    print("estimate RMS (offset mm / heading deg), PID on KF estimate:")
+    print("  hold last frame   %6.1f / %5.2f" % (rms["hold"][0] * 1000, math.degrees(rms["hold"][1])))
+    print("  kalman filter     %6.1f / %5.2f" % (rms["kf"][0] * 1000, math.degrees(rms["kf"][1])))
+    straight_bias, end_bias = results["kf"][3]
+    print("gyro bias estimate (rad/s, true %.4f): end of straight %.4f, after curve %.4f"
+          % (args.gyro_bias, straight_bias, end_bias))
+    print("closed-loop cross-track max/rms (mm), %.1f m/s, %.0f%% drop, %d ms burst:"
+          % (args.speed, args.drop * 100, args.burst))
+    for name in ("vision", "kf"):
+        print("  %-8s %7.1f / %6.1f" % (name, results[name][1] * 1000, results[name][2] * 1000))
+
+    # 零偏须在入弯前的直道内收敛，且弯道中不被曲率误差带偏
+    failed = False
+    for label, bias in (("end of straight", straight_bias), ("after curve", end_bias)):
+        if abs(bias - args.gyro_bias) > args.bias_tol:
+            print("FAIL: gyro bias error %s %.4f rad/s exceeds %.4f" % (label, bias - args.gyro_bias, args.bias_tol))
+            failed = True
+    if failed:
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
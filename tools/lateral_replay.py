@@ -0,0 +1,314 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+横向控制离线评估工具（像素偏差方向PID 与 纯跟踪）
+
+从串口日志中读取停车后输出的帧日志（pure_pursuit_log_dump()）：
+    PPLOG <帧数> <首行> <行数> <摄像头偏移mm>
+    PPFRAME <序号> <时刻ms> <车速mm/s> <角速度mrad/s> <舵机0.1度> <纯跟踪0.1度> <方式> <截止行> <各行中线十六进制>
+对每一帧分别用 vision_get_deviation() + 方向PID 与 pure_pursuit.c 的算法重新计算转角，
+以车辆实际走过的曲率对应的转角 δ = atan(L·ω/v) 为参考，按车速分段统计两种方法的RMS误差与帧间抖动。
+默认参数时还会检查本工具的纯跟踪结果与车上记录的转角是否一致。
+
+--demo 不读日志，在 steer_predict_sim.py 的运动学模型上闭环对比两种方法在各车速下的弯道横向误差，
+并把纯跟踪闭环运行的帧按日志格式回放一遍。
+
+参数默认值与 pure_pursuit.h / vision_track.h / smart_car.h(NORMAL场景) 一致。
+
+用法：
+    python3 tools/lateral_replay.py run1.log
+    python3 tools/lateral_replay.py run1.log --lookahead-time 0.25 --kp 1.5 --kd 4
+    python3 tools/lateral_replay.py --demo
+"""
+
+import argparse
+import math
+import os
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import steer_predict_sim as sim  # noqa: E402
+
+# pure_pursuit.h
+DEFAULTS = {
+    "lookahead_min": 0.35,
+    "lookahead_max": 1.00,
+    "lookahead_time": 0.20,
+    "gain": 1.0,
+}
+PP_SIGN = -1
+PP_ROW_STEP = 2
+PP_MAX_POINTS = 45
+SPEED_BANDS = [0.0, 1.0, 1.5, 2.0, 2.5, 3.0, 99.0]
+
+
+# ---------------------------------------------------------------- 日志解析
+def load_frames(paths):
+    frames = []
+    for path in paths:
+        header = None
+        with open(path, "r", encoding="utf-8", errors="ignore") as f:
+            for line in f:
+                fields = line.split()
+                if not fields:
+                    continue
+                try:
+                    if fields[0] == "PPLOG" and len(fields) >= 5:
+                        header = {"row_top": int(fields[2]), "rows": int(fields[3]), "offset": int(fields[4]) / 1000.0}
+                    elif fields[0] == "PPFRAME" and header and len(fields) >= 10:
+                        hexs = fields[9]
+                        rows = {}
+                        for i in range(min(header["rows"], len(hexs) // 2)):
+                            col = int(hexs[2 * i:2 * i + 2], 16)
+                            if col != 0xFF:
+                                rows[header["row_top"] + i] = col
+                        frames.append({
+                            "source": path,
+                            "ts": int(fields[2]),
+                            "speed": int(fields[3]) / 1000.0,
+                            "yaw_rate": int(fields[4]) / 1000.0,
+                            "steer": int(fields[5]) / 10.0,
+                            "logged_pp": int(fields[6]) / 10.0,
+                            "mode": int(fields[7]),
+                            "stop_line": int(fields[8]),
+                            "offset": header["offset"],
+                            "rows": rows,
+                        })
+                except ValueError:
+                    continue
+    return frames
+
+
+# ---------------------------------------------------------------- 纯跟踪（与 pure_pursuit.c 相同）
+def pp_path(rows, stop_line, offset):
+    """pure_pursuit_update()：中线采样并换算到后轴坐标系 (x右, y前)"""
+    top_row = sim.IMAGE_H - stop_line
+    path = []
+    row = sim.IMAGE_H - 1
+    while row >= max(top_row, 0) and len(path) < PP_MAX_POINTS:
+        if sim.ROW_DIST[row] <= 0.0:
+            break
+        if row in rows:
+            x = (rows[row] - (sim.IMAGE_W - 1) * 0.5) * sim.ROW_SCALE[row]
+            path.append((x, sim.ROW_DIST[row] + offset))
+        row -= PP_ROW_STEP
+    return path
+
+
+def pp_lookahead(speed, p):
+    return min(p.lookahead_max, p.lookahead_min + p.lookahead_time * abs(speed))
+
+
+def pp_track(path, lookahead, dx=0.0, dy=0.0, dpsi=0.0):
+    """pure_pursuit_track()：返回经过预瞄点的曲率 (1/m)，向右弯为正"""
+    c, s = math.cos(dpsi), math.sin(dpsi)
+    last_x = last_y = last_r = 0.0
+    for i, (px, py) in enumerate(path):
+        forward, left = py - dx, -px - dy
+        y = c * forward + s * left
+        x = -(-s * forward + c * left)
+        r = math.hypot(x, y)
+        if r >= lookahead:
+            if i > 0 and r > last_r:
+                t = (lookahead - last_r) / (r - last_r)
+                x, y = last_x + (x - last_x) * t, last_y + (y - last_y) * t
+            last_x, last_y = x, y
+            break
+        last_x, last_y, last_r = x, y, r
+    d2 = last_x * last_x + last_y * last_y
+    return 0.0 if d2 < 1e-4 else 2.0 * last_x / d2
+
+
+def pp_steer(curvature, p):
+    delta = math.degrees(math.atan(sim.WHEELBASE * curvature)) * p.gain * PP_SIGN
+    return max(-sim.MAX_ANGLE, min(sim.MAX_ANGLE, delta))
+
+
+class DirectionPid:
+    """方向PID（位置式，目标为0，与 pid_calculate() 的P/D部分一致）"""
+
+    def __init__(self, kp, ki, kd):
+        self.kp, self.ki, self.kd = kp, ki, kd
+        self.integral = 0.0
+        self.last_error = 0.0
+
+    def step(self, dev):
+        error = -dev
+        self.integral = max(-0.8 * sim.MAX_ANGLE, min(0.8 * sim.MAX_ANGLE, self.integral + error))
+        out = self.kp * error + self.ki * self.integral + self.kd * (error - self.last_error)
+        self.last_error = error
+        return max(-sim.MAX_ANGLE, min(sim.MAX_ANGLE, out))
+
+
+# ---------------------------------------------------------------- 离线评估
+def evaluate(frames, p):
+    pid = DirectionPid(p.kp, p.ki, p.kd)
+    bands = {}
+    mismatch = 0.0
+    last = None
+    for frame in frames:
+        dev = sim.deviation(frame["rows"])
+        path = pp_path(frame["rows"], frame["stop_line"], frame["offset"])
+        if dev is None or not path:
+            last = None
+            continue
+        pid_out = pid.step(dev)
+        pp_out = pp_steer(pp_track(path, pp_lookahead(frame["speed"], p)), p)
+        mismatch = max(mismatch, abs(pp_out - frame["logged_pp"]))
+        if frame["speed"] < 0.2:
+            last = None
+            continue
+        ref = math.degrees(math.atan(sim.WHEELBASE * frame["yaw_rate"] / frame["speed"]))
+
+        band = next(i for i in range(len(SPEED_BANDS) - 1) if frame["speed"] < SPEED_BANDS[i + 1])
+        b = bands.setdefault(band, {"n": 0, "pid": 0.0, "pp": 0.0, "pid_j": 0.0, "pp_j": 0.0, "j": 0})
+        b["n"] += 1
+        b["pid"] += (pid_out - ref) ** 2
+        b["pp"] += (pp_out - ref) ** 2
+        if last:
+            b["j"] += 1
+            b["pid_j"] += (pid_out - last[0]) ** 2
+            b["pp_j"] += (pp_out - last[1]) ** 2
+        last = (pid_out, pp_out)
+    return bands, mismatch
+
+
+def report(frames, p, check):
+    bands, mismatch = evaluate(frames, p)
+    modes = sum(1 for f in frames if f["mode"] == 1)
+    print("%d frames (%d under pure pursuit, %d under PID)" % (len(frames), modes, len(frames) - modes))
+    print("speed(m/s)   frames   RMS vs yaw-rate ref (deg)   frame-to-frame jitter (deg)")
+    print("                        PID        pursuit          PID        pursuit")
+    for i in sorted(bands):
+        b = bands[i]
+        j = max(b["j"], 1)
+        hi = "+" if SPEED_BANDS[i + 1] > 10 else "%.1f" % SPEED_BANDS[i + 1]
+        print("  %.1f-%-4s   %5d     %6.2f     %6.2f          %6.2f     %6.2f"
+              % (SPEED_BANDS[i], hi, b["n"], math.sqrt(b["pid"] / b["n"]), math.sqrt(b["pp"] / b["n"]),
+                 math.sqrt(b["pid_j"] / j), math.sqrt(b["pp_j"] / j)))
+    if check:
+        status = "OK" if mismatch <= 0.15 else "MISMATCH"
+        print("pure pursuit vs on-car frame_output: max diff %.2f deg %s" % (mismatch, status))
+
+
+# ---------------------------------------------------------------- 闭环演示
+def run_pursuit(track, speed, args, p, log=None):
+    """与 steer_predict_sim.run() 相同的车辆、摄像头与延迟，横向改用纯跟踪（含位姿延迟补偿）"""
+    camera = sim.Camera(track)
+    x, y, h, steer = 0.0, 0.0, 0.0, 0.0
+    history = []
+    frames = []
+    command = 0.0
+    errors = []
+    arc_start = args.straight
+    arc_end = args.straight + math.radians(args.arc) * args.radius
+    s = 0.0
+    t_ms = 0
+    while s < arc_end + 0.5:
+        if t_ms % args.frame_ms == 0:
+            rows = {r: int(c) for r, c in camera.centerline((x, y, h)).items()}
+            frames.append((t_ms + args.latency, t_ms, rows))
+            if log is not None and history:
+                curvature = pp_track(pp_path(rows, sim.IMAGE_H, 0.0), pp_lookahead(speed, p))
+                log.append({"ts": t_ms, "speed": speed, "yaw_rate": history[-1][4], "steer": steer,
+                            "logged_pp": round(pp_steer(curvature, p), 1), "mode": 1,
+                            "stop_line": sim.IMAGE_H, "offset": 0.0,
+                            "rows": rows})
+        if t_ms % sim.CONTROL_MS == 0:
+            ready = [f for f in frames if f[0] <= t_ms]
+            if ready:
+                latest = max(ready, key=lambda f: f[1])
+                _, exposure, rows = latest
+                frames = [latest] + [f for f in frames if f[0] > t_ms]
+                path = pp_path(rows, sim.IMAGE_H, 0.0)
+                if path and history:
+                    then = min(history, key=lambda e: abs(e[0] - (exposure - sim.EXPOSURE_MS)))
+                    c0, s0 = math.cos(then[3]), math.sin(then[3])
+                    wx, wy = x - then[1], y - then[2]
+                    dx, dy, dpsi = c0 * wx + s0 * wy, -s0 * wx + c0 * wy, h - then[3]
+                    lead = sim.LEAD_MS / 1000.0
+                    yaw_rate = history[-1][4]
+                    mid = dpsi + yaw_rate * lead * 0.5
+                    dx += speed * lead * math.cos(mid)
+                    dy += speed * lead * math.sin(mid)
+                    dpsi += yaw_rate * lead
+                    command = pp_steer(pp_track(path, pp_lookahead(speed, p), dx, dy, dpsi), p)
+        steer += (command - steer) * sim.SIM_DT / args.servo_tau
+        yaw_rate = speed * math.tan(math.radians(steer)) / sim.WHEELBASE
+        h += yaw_rate * sim.SIM_DT
+        x += speed * math.cos(h) * sim.SIM_DT
+        y += speed * math.sin(h) * sim.SIM_DT
+        s += speed * sim.SIM_DT
+        t_ms += 1
+        history.append((t_ms, x, y, h, yaw_rate))
+        if len(history) > 200:
+            history.pop(0)
+        if arc_start <= s <= arc_end and t_ms % 5 == 0:
+            errors.append(sim.cross_track(track, x, y))
+    if not errors:
+        return float("inf"), float("inf")
+    return max(errors), math.sqrt(sum(e * e for e in errors) / len(errors))
+
+
+def demo(args):
+    p = args
+    track = sim.make_track(args.straight, args.radius, args.arc)
+    speeds = [0.8 + 0.4 * i for i in range(9)]
+    best = {"pid": 0.0, "pursuit": 0.0}
+    passing = {"pid": True, "pursuit": True}
+    log = []
+
+    print("closed loop, radius %.2f m, latency %d ms" % (args.radius, args.latency))
+    print("speed(m/s)   PID+ff max/rms (mm)   pursuit max/rms (mm)")
+    for v in speeds:
+        pid_worst, pid_rms = sim.run(track, v, args, True)
+        pp_worst, pp_rms = run_pursuit(track, v, args, p, log)
+        for name, worst in (("pid", pid_worst), ("pursuit", pp_worst)):
+            passing[name] = passing[name] and worst <= args.limit
+            if passing[name]:
+                best[name] = v
+        print("  %4.1f      %7.1f / %6.1f      %7.1f / %6.1f"
+              % (v, pid_worst * 1000, pid_rms * 1000, pp_worst * 1000, pp_rms * 1000))
+    print("max speed with cross-track error <= %.0f mm: PID+ff %.1f m/s, pursuit %.1f m/s"
+          % (args.limit * 1000, best["pid"], best["pursuit"]))
+    print()
+    print("offline replay of the pure-pursuit runs:")
+    report(log, p, True)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="横向控制离线评估（方向PID 与 纯跟踪）")
+    parser.add_argument("logs", nargs="*", help="串口日志文件")
+    parser.add_argument("--demo", action="store_true", help="在运动学模型上闭环对比")
+    parser.add_argument("--lookahead-min", type=float, default=DEFAULTS["lookahead_min"], help="最小预瞄距离 (m)")
+    parser.add_argument("--lookahead-max", type=float, default=DEFAULTS["lookahead_max"], help="最大预瞄距离 (m)")
+    parser.add_argument("--lookahead-time", type=float, default=DEFAULTS["lookahead_time"], help="预瞄时间 (s)")
+    parser.add_argument("--gain", type=float, default=DEFAULTS["gain"], help="纯跟踪转角系数")
+    parser.add_argument("--kp", type=float, default=1.0, help="方向PID Kp (度/像素)")
+    parser.add_argument("--ki", type=float, default=0.0, help="方向PID Ki")
+    parser.add_argument("--kd", type=float, default=0.0, help="方向PID Kd")
+    # --demo 的赛道与车辆参数，含义同 steer_predict_sim.py
+    parser.add_argument("--radius", type=float, default=0.8, help="弯道半径 (m)")
+    parser.add_argument("--arc", type=float, default=120.0, help="弯道角度 (度)")
+    parser.add_argument("--straight", type=float, default=1.5, help="入弯前直道长度 (m)")
+    parser.add_argument("--latency", type=int, default=30, help="曝光到图像可用的延迟 (ms)")
+    parser.add_argument("--frame-ms", type=int, default=10, help="帧间隔 (ms)")
+    parser.add_argument("--servo-tau", type=float, default=0.03, help="舵机时间常数 (s)")
+    parser.add_argument("--limit", type=float, default=0.10, help="允许的最大横向误差 (m)")
+    args = parser.parse_args()
+
+    check = all(getattr(args, k) == v for k, v in DEFAULTS.items())
+    if args.demo:
+        demo(args)
+        return
+    if not args.logs:
+        parser.error("需要日志文件或 --demo")
+    frames = load_frames(args.logs)
+    if not frames:
+        print("no PPFRAME records found")
+        sys.exit(1)
+    report(frames, args, check)
+
+
+if __name__ == "__main__":
+    main()
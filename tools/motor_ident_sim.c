@@ -0,0 +1,229 @@
+/*
+ * Ծʶģǰλ
+ *
+ * 룺gcc -std=c99 -O2 -DPID_HOST -Icode tools/motor_ident_sim.c code/motor_ident.c code/pid_control.c -lm -o motor_ident_sim
+ * У./motor_ident_sim [ʱ䳣s] [ռձȿسmm/s] [Ħռձ] [ִӳms]
+ *
+ * ֱģ tools/speed_autotune_sim.c ͬһסĦִӳ٣
+ * 1.  motor_ident_wheel_step() нԾвϣ桢ʱ䳣ӳֵ
+ * 2. ٶPIDSTRAIGHT/ӱʶģǰʱĽԾʱ볬
+ *    ǰʱPIDĿΪģͲο٣ motor_model_reference() һ£
+ * 3. ʱ䳣ӳһΧڱ仯ʱıʶ
+ *
+ *  -std=c99 룺POSIXͷļеpid_tPIDṹͬ
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "pid_control.h"
+#include "motor_ident.h"
+#include "car_params.h"
+
+#define SIM_DT              0.0001              // 沽 (s)
+#define COUNT_PER_METER     5000                // ENCODER_COUNT_PER_METER
+#define PWM_DUTY_MAX        10000
+#define DELAY_MAX           500                 // ִӳ (沽)
+#define CONTROL_MS          20                  //  (ms)
+#define FF_MIN_SPEED        20.0f               // MOTOR_MODEL_FF_MIN_SPEED
+
+#define PID_KP              60.0f               // SPEED_PID_KP_STRAIGHT
+#define PID_KI              2.5f
+#define PID_KD              6.0f
+
+typedef struct
+{
+    double gain;                                // ÿռձȳ (mm/s)
+    double tau;                                 // еʱ䳣 (s)
+    double friction;                            // Ħ (ռձ)
+    int delay;                                  // ִӳ (沽)
+    double v;                                   //  (mm/s)
+    double x;                                   //  (mm)
+    double queue[DELAY_MAX];                    // ӳٶ
+    int head;
+    int32 last_counts;
+} sim_motor_t;
+
+static int failures = 0;
+
+static void check(int ok, const char *name)
+{
+    printf("%-52s %s\n", name, ok ? "OK" : "FAIL");
+    if (!ok)
+        failures++;
+}
+
+static void sim_motor_init(sim_motor_t *m, double tau, double no_load, double friction, double delay_ms)
+{
+    m->gain = no_load / PWM_DUTY_MAX;
+    m->tau = tau;
+    m->friction = friction;
+    m->delay = (int)(delay_ms * 0.001 / SIM_DT + 0.5);
+    if (m->delay >= DELAY_MAX)
+        m->delay = DELAY_MAX - 1;
+    m->v = 0.0;
+    m->x = 0.0;
+    for (int i = 0; i < DELAY_MAX; i++)
+        m->queue[i] = 0.0;
+    m->head = 0;
+    m->last_counts = 0;
+}
+
+// ռձdutyperiod_msر
+static int32 sim_motor_run(sim_motor_t *m, double duty, int period_ms)
+{
+    int steps = (int)(period_ms * 0.001 / SIM_DT + 0.5);
+    for (int i = 0; i < steps; i++)
+    {
+        m->queue[m->head] = duty;
+        double drive = m->queue[(m->head + DELAY_MAX - m->delay) % DELAY_MAX];
+        m->head = (m->head + 1) % DELAY_MAX;
+        
+        if (fabs(drive) <= m->friction && fabs(m->v) < 1.0)
+            drive = 0.0;
+        else
+            drive -= copysign(m->friction, fabs(m->v) >= 1.0 ? m->v : drive);
+        m->v += (m->gain * drive - m->v) / m->tau * SIM_DT;
+        m->x += m->v * SIM_DT;
+    }
+    int32 counts = (int32)floor(m->x * COUNT_PER_METER / 1000.0);
+    int32 delta = counts - m->last_counts;
+    m->last_counts = counts;
+    return delta;
+}
+
+// 1. Ծʶɹ1
+static int run_ident(sim_motor_t *m, motor_ident_wheel_t *wheel)
+{
+    float speed = 0.0f;
+    
+    motor_ident_wheel_reset(wheel);
+    while (wheel->phase == MOTOR_IDENT_RUN)
+    {
+        int32 duty = motor_ident_wheel_step(wheel, speed);
+        int32 counts = sim_motor_run(m, duty, MOTOR_IDENT_SAMPLE_MS);
+        speed = counts * 1000.0f / COUNT_PER_METER / (MOTOR_IDENT_SAMPLE_MS * 0.001f);
+    }
+    return motor_ident_wheel_fit(wheel);
+}
+
+// ģǰ motor_model_feedforward() һ£ٶΪ0
+static float feedforward(const motor_model_t *model, float speed)
+{
+    float duty = speed / model->gain;
+    if (speed > FF_MIN_SPEED)
+        duty += model->deadband;
+    else if (speed < -FF_MIN_SPEED)
+        duty -= model->deadband;
+    return duty;
+}
+
+// 2. ٶPIDԾstarttarget (mm/s)5%ʱ (ms) (%)
+static double step_settle(sim_motor_t *m, const motor_model_t *model, float start, float target, double *overshoot)
+{
+    pid_t pid;
+    int32 counts = 0;
+    int settle = 0;
+    double peak = start;
+    float target_counts = target * CONTROL_MS * COUNT_PER_METER / 1e6f;
+    float start_counts = start * CONTROL_MS * COUNT_PER_METER / 1e6f;
+    
+    pid_init(&pid, PID_KP, PID_KI, PID_KD, MOTOR_MAX_DUTY, -MOTOR_MAX_DUTY);
+    // ȶʼ
+    pid_set_target(&pid, (int16)start_counts);
+    for (int k = 0; k < 2000 / CONTROL_MS; k++)
+    {
+        double duty = pid_calculate(&pid, counts) + (model ? feedforward(model, start) : 0.0f);
+        counts = sim_motor_run(m, duty, CONTROL_MS);
+    }
+    float reference = start;
+    for (int k = 1; k <= 2000 / CONTROL_MS; k++)
+    {
+        if (model)
+        {
+            // ģͲοPIDģԤĳ٣ֻв
+            reference += (target - reference) * (1.0f - expf(-CONTROL_MS * 0.001f / model->tau));
+            pid_set_target(&pid, reference * CONTROL_MS * COUNT_PER_METER / 1e6f);
+        }
+        else
+        {
+            pid_set_target(&pid, (int16)target_counts);
+        }
+        double duty = pid_calculate(&pid, counts) + (model ? feedforward(model, target) : 0.0f);
+        counts = sim_motor_run(m, duty, CONTROL_MS);
+        if ((target - start) * (m->v - peak) > 0.0)
+            peak = m->v;
+        if (fabs(m->v - target) > 0.05 * fabs(target - start))
+            settle = k;
+    }
+    *overshoot = (peak - target) / (target - start) * 100.0;
+    return settle * CONTROL_MS;
+}
+
+static int evaluate(double tau, double no_load, double friction, double delay, int verbose)
+{
+    sim_motor_t m;
+    motor_ident_wheel_t wheel;
+    
+    sim_motor_init(&m, tau, no_load, friction, delay);
+    if (!run_ident(&m, &wheel))
+    {
+        printf("tau=%.3f no_load=%.0f delay=%.0f: ident failed (%d)\n", tau, no_load, delay, wheel.error);
+        return 0;
+    }
+    
+    double gain = no_load / PWM_DUTY_MAX;
+    double e_gain = fabs(wheel.model.gain - gain) / gain * 100.0;
+    double e_tau = fabs(wheel.model.tau - tau) / tau * 100.0;
+    double e_dead = fabs(wheel.model.deadtime * 1000.0 - delay);
+    double e_band = fabs(wheel.model.deadband - friction);
+    printf("tau=%.3f no_load=%.0f delay=%2.0f: gain %.4f (%4.1f%%) tau %.3f (%4.1f%%) deadtime %4.1f ms (%+4.1f) deadband %5.0f (%+4.0f) rms %4.0f mm/s\n",
+           tau, no_load, delay, wheel.model.gain, e_gain, wheel.model.tau, e_tau, wheel.model.deadtime * 1000.0,
+           wheel.model.deadtime * 1000.0 - delay, wheel.model.deadband, wheel.model.deadband - friction, wheel.fit_rms);
+    
+    int ok = e_gain < 5.0 && e_tau < 15.0 && e_dead < 5.0 && e_band < 100.0;
+    if (verbose)
+    {
+        check(ok, "gain < 5%, tau < 15%, deadtime < 5 ms, deadband < 100");
+        
+        static const float steps[][2] = {{0.0f, 1000.0f}, {1000.0f, 2000.0f}, {2000.0f, 800.0f}};
+        double sum_pid = 0.0, sum_ff = 0.0;
+        for (int i = 0; i < 3; i++)
+        {
+            double os_pid, os_ff;
+            sim_motor_init(&m, tau, no_load, friction, delay);
+            double t_pid = step_settle(&m, NULL, steps[i][0], steps[i][1], &os_pid);
+            sim_motor_init(&m, tau, no_load, friction, delay);
+            double t_ff = step_settle(&m, &wheel.model, steps[i][0], steps[i][1], &os_ff);
+            printf("step %4.0f -> %4.0f mm/s: PID settle %4.0f ms OS %5.1f%%   PID+FF settle %4.0f ms OS %5.1f%%\n",
+                   steps[i][0], steps[i][1], t_pid, os_pid, t_ff, os_ff);
+            sum_pid += t_pid;
+            sum_ff += t_ff;
+        }
+        check(sum_ff < 0.7 * sum_pid, "model feedforward cuts settling time by > 30%");
+    }
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    double tau = argc > 1 ? atof(argv[1]) : 0.10;
+    double no_load = argc > 2 ? atof(argv[2]) : 4000.0;
+    double friction = argc > 3 ? atof(argv[3]) : 300.0;
+    double delay = argc > 4 ? atof(argv[4]) : 5.0;
+    
+    printf("levels %d ms x %d, sample %d ms\n", MOTOR_IDENT_HOLD_MS, MOTOR_IDENT_SEGMENTS, MOTOR_IDENT_SAMPLE_MS);
+    check(evaluate(tau, no_load, friction, delay, 1), "identification on nominal motor");
+    
+    printf("\nparameter sweep:\n");
+    int ok = 1;
+    const double taus[] = {0.05, 0.10, 0.08};
+    const double loads[] = {3000.0, 4000.0, 6000.0};
+    const double delays[] = {2.0, 10.0, 20.0};
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++)
+            ok &= evaluate(taus[i], loads[j], friction + 100.0 * (j - 1), delays[(i + j) % 3], 0);
+    check(ok, "identification within tolerance across sweep");
+    
+    printf("\n%s\n", failures ? "FAILED" : "ALL OK");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,268 @@
+/*
+ * PIDλ׼
+ *
+ * 룺gcc -std=c99 -O2 -ffp-contract=off -DPID_HOST -Icode tools/pid_batch_bench.c code/pid_batch.c code/pid_control.c -lm -o pid_batch_bench
+ * У./pid_batch_bench [] []
+ *
+ * 1. Ĭpid_calculate()λһ£롢/ֱͣ
+ * 2. ʱʽλʽһ
+ * 3. Բֵ΢ʱĿԾ΢ֳ
+ * 4. 㿹˱ʱ
+ * 5. ΢˲Ͳ
+ * 6. Npid_tһĺʱԱ
+ *
+ *  -std=c99 룺POSIXͷļеpid_tPIDṹͬ
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "pid_control.h"
+#include "pid_batch.h"
+
+static int failures = 0;
+
+static void check(int ok, const char *name)
+{
+    printf("%-40s %s\n", name, ok ? "OK" : "FAIL");
+    if (!ok)
+        failures++;
+}
+
+static float frand(float lo, float hi)
+{
+    return lo + (hi - lo) * (float)rand() / (float)RAND_MAX;
+}
+
+static double now_ns(void)
+{
+    return (double)clock() * 1e9 / CLOCKS_PER_SEC;
+}
+
+// 1. Ĭλһ
+static void test_equivalence(int steps)
+{
+    pid_t pid[PID_BATCH_MAX];
+    pid_batch_t batch;
+    int mismatch = 0;
+
+    pid_batch_init(&batch);
+    for (int i = 0; i < PID_BATCH_MAX; i++)
+    {
+        float kp = frand(0.0f, 80.0f), ki = frand(0.0f, 5.0f), kd = frand(0.0f, 10.0f);
+        float max = frand(100.0f, 8000.0f);
+        pid_init(&pid[i], kp, ki, kd, max, -max);
+        pid_batch_add(&batch, kp, ki, kd, max, -max);
+    }
+
+    for (int k = 0; k < steps; k++)
+    {
+        for (int i = 0; i < PID_BATCH_MAX; i++)
+        {
+            float target = frand(-300.0f, 300.0f);
+            float current = frand(-300.0f, 300.0f);
+            pid_set_target(&pid[i], target);
+            pid_calculate(&pid[i], current);
+            batch.target[i] = target;
+            batch.measurement[i] = current;
+        }
+        pid_batch_calculate(&batch);
+        for (int i = 0; i < PID_BATCH_MAX; i++)
+        {
+            if (batch.output[i] != pid[i].output || batch.integral[i] != pid[i].integral)
+                mismatch++;
+        }
+    }
+    check(mismatch == 0, "default config == pid_calculate()");
+}
+
+// һ׶ y += (Ku - y)aڱջ
+static float plant(float y, float u)
+{
+    return y + (0.5f * u - y) * 0.1f;
+}
+
+// 2. ʽλʽһ£ͣ
+static void test_incremental(void)
+{
+    pid_batch_t batch;
+    float worst = 0.0f;
+
+    pid_batch_init(&batch);
+    pid_batch_add(&batch, 1.2f, 0.05f, 0.4f, 1e6f, -1e6f);
+    pid_batch_add(&batch, 1.2f, 0.05f, 0.4f, 1e6f, -1e6f);
+    pid_batch_set_integral_limit(&batch, 0, 1e9f);
+    pid_batch_set_mode(&batch, 1, PID_BATCH_INCREMENTAL);
+    pid_batch_set_derivative(&batch, 0, 1, 0.3f);
+    pid_batch_set_derivative(&batch, 1, 1, 0.3f);
+
+    float y0 = 0.0f, y1 = 0.0f;
+    for (int k = 0; k < 2000; k++)
+    {
+        float target = (k / 200) % 2 ? 100.0f : -50.0f;
+        float ff = 0.3f * target;
+        batch.target[0] = batch.target[1] = target;
+        batch.feedforward[0] = batch.feedforward[1] = ff;
+        batch.measurement[0] = y0;
+        batch.measurement[1] = y1;
+        pid_batch_calculate(&batch);
+        y0 = plant(y0, batch.output[0]);
+        y1 = plant(y1, batch.output[1]);
+        float diff = fabsf(batch.output[0] - batch.output[1]);
+        if (diff > worst)
+            worst = diff;
+    }
+    printf("  incremental vs positional max diff %.2e\n", worst);
+    check(worst < 1e-2f, "incremental == positional (unsaturated)");
+}
+
+// 3. Բֵ΢Ŀ
+static void test_derivative_kick(void)
+{
+    pid_batch_t batch;
+
+    pid_batch_init(&batch);
+    pid_batch_add(&batch, 1.0f, 0.0f, 50.0f, 1e6f, -1e6f);
+    pid_batch_add(&batch, 1.0f, 0.0f, 50.0f, 1e6f, -1e6f);
+    pid_batch_set_derivative(&batch, 1, 1, 1.0f);
+
+    for (int k = 0; k < 3; k++)
+    {
+        batch.target[0] = batch.target[1] = (k == 2) ? 10.0f : 0.0f;
+        batch.measurement[0] = batch.measurement[1] = 0.0f;
+        pid_batch_calculate(&batch);
+    }
+    printf("  step 10: d-on-error output %.1f, d-on-measurement output %.1f\n", batch.output[0], batch.output[1]);
+    check(batch.output[0] == 510.0f && batch.output[1] == 10.0f, "derivative on measurement: no kick");
+}
+
+// 4. 㿹
+static int windup_recovery(float kt)
+{
+    pid_batch_t batch;
+    float y = 0.0f;
+
+    pid_batch_init(&batch);
+    pid_batch_add(&batch, 2.0f, 0.2f, 0.0f, 100.0f, -100.0f);
+    pid_batch_set_integral_limit(&batch, 0, 1e6f);
+    pid_batch_set_antiwindup(&batch, 0, kt);
+
+    // ĿԶʱ䱥
+    for (int k = 0; k < 300; k++)
+    {
+        batch.target[0] = 200.0f;
+        batch.measurement[0] = y;
+        pid_batch_calculate(&batch);
+        y = plant(y, batch.output[0]);
+    }
+    // Ŀ꽵ɴֵͳ˳
+    for (int k = 0; k < 5000; k++)
+    {
+        batch.target[0] = 20.0f;
+        batch.measurement[0] = y;
+        pid_batch_calculate(&batch);
+        y = plant(y, batch.output[0]);
+        if (batch.output[0] < 100.0f)
+            return k;
+    }
+    return 5000;
+}
+
+static void test_antiwindup(void)
+{
+    int clamp = windup_recovery(0.0f);
+    int back = windup_recovery(1.0f);
+    printf("  saturation recovery: clamp only %d cycles, back-calculation %d cycles\n", clamp, back);
+    check(back < clamp, "back-calculation anti-windup");
+}
+
+// 5. ΢˲
+static void test_filter(void)
+{
+    pid_batch_t batch;
+    double sum_sq[2] = {0.0, 0.0};
+
+    pid_batch_init(&batch);
+    pid_batch_add(&batch, 1.0f, 0.0f, 5.0f, 1e6f, -1e6f);
+    pid_batch_add(&batch, 1.0f, 0.0f, 5.0f, 1e6f, -1e6f);
+    pid_batch_set_derivative(&batch, 0, 1, 1.0f);
+    pid_batch_set_derivative(&batch, 1, 1, 0.2f);
+
+    for (int k = 0; k < 5000; k++)
+    {
+        float noise = frand(-1.0f, 1.0f);
+        batch.target[0] = batch.target[1] = 0.0f;
+        batch.measurement[0] = batch.measurement[1] = noise;
+        pid_batch_calculate(&batch);
+        sum_sq[0] += batch.output[0] * batch.output[0];
+        sum_sq[1] += batch.output[1] * batch.output[1];
+    }
+    printf("  output rms with noise: unfiltered %.2f, alpha 0.2 %.2f\n", sqrt(sum_sq[0] / 5000), sqrt(sum_sq[1] / 5000));
+    check(sum_sq[1] < sum_sq[0] * 0.5, "derivative low-pass filter");
+}
+
+// 6. ׼
+static void bench(int n, int steps)
+{
+    static pid_t pid[PID_BATCH_MAX];
+    static pid_batch_t batch;
+    static float input[1024];
+    volatile float sink = 0.0f;
+
+    for (int k = 0; k < 1024; k++)
+        input[k] = frand(-100.0f, 100.0f);
+
+    pid_batch_init(&batch);
+    for (int i = 0; i < n; i++)
+    {
+        pid_init(&pid[i], 30.0f, 1.0f, 3.0f, 8000.0f, -8000.0f);
+        pid_batch_add(&batch, 30.0f, 1.0f, 3.0f, 8000.0f, -8000.0f);
+    }
+
+    double t0 = now_ns();
+    for (int k = 0; k < steps; k++)
+    {
+        for (int i = 0; i < n; i++)
+        {
+            pid_set_target(&pid[i], 10.0f);
+            sink += pid_calculate(&pid[i], input[(k + i) & 1023]);
+        }
+    }
+    double t1 = now_ns();
+    for (int k = 0; k < steps; k++)
+    {
+        for (int i = 0; i < n; i++)
+        {
+            batch.target[i] = 10.0f;
+            batch.measurement[i] = input[(k + i) & 1023];
+        }
+        pid_batch_calculate(&batch);
+        sink += batch.output[0];
+    }
+    double t2 = now_ns();
+
+    printf("benchmark: %d controllers x %d cycles\n", n, steps);
+    printf("  pid_calculate()       %.1f ns/controller\n", (t1 - t0) / steps / n);
+    printf("  pid_batch_calculate() %.1f ns/controller\n", (t2 - t1) / steps / n);
+    (void)sink;
+}
+
+int main(int argc, char **argv)
+{
+    int n = argc > 1 ? atoi(argv[1]) : 4;
+    int steps = argc > 2 ? atoi(argv[2]) : 1000000;
+
+    if (n < 1 || n > PID_BATCH_MAX)
+        n = PID_BATCH_MAX;
+    srand(1);
+
+    test_equivalence(20000);
+    test_incremental();
+    test_derivative_kick();
+    test_antiwindup();
+    test_filter();
+    bench(n, steps);
+
+    printf("%s\n", failures ? "FAILED" : "ALL OK");
+    return failures ? 1 : 0;
+}
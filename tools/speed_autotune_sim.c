@@ -0,0 +1,238 @@
+/*
+ * ٶPID̵λ
+ *
+ * 룺gcc -std=c99 -O2 -DPID_HOST -Icode tools/speed_autotune_sim.c code/speed_autotune.c code/pid_control.c -lm -o speed_autotune_sim
+ * У./speed_autotune_sim [ʱ䳣s] [ռձȿسmm/s] [Ħռձ] [ִӳms]
+ *
+ * ֱģ tools/speed_loop_sim.py ͬһסĦִӳ٣
+ * 1.  speed_autotune_relay_step() ̵ڳʱɣKu/Tu
+ * 2.  Kp = 0.8Ku ʱŶ˥ˮƽ1.6Ku ʱ񵴣֤KuͻʹKuƫС
+ * 3.  STRAIGHT ֵڿٶPIDµĽԾӦʱ䡢ʱ䣩
+ * 4. ʱ䳣һΧڱ仯ʱջ
+ *
+ *  speed_autotune.h / motor_control.h / smart_car.h һ£ -std=c99 룺POSIXͷļеpid_tPIDṹͬ
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "pid_control.h"
+#include "speed_autotune.h"
+#include "car_params.h"
+
+#define SIM_DT              0.0001              // 沽 (s)
+#define COUNT_PER_METER     5000                // ENCODER_COUNT_PER_METER
+#define PWM_DUTY_MAX        10000
+#define DELAY_MAX           100                 // ִӳ (沽)
+
+#define OLD_KP              60.0f               // SPEED_PID_KP_STRAIGHT
+#define OLD_KI              2.5f
+#define OLD_KD              6.0f
+
+typedef struct
+{
+    double gain;                                // ÿռձȳ (mm/s)
+    double tau;                                 // еʱ䳣 (s)
+    double friction;                            // Ħ (ռձ)
+    int delay;                                  // ִӳ (沽)
+    double v;                                   //  (mm/s)
+    double x;                                   //  (mm)
+    double queue[DELAY_MAX];                    // ӳٶ
+    int head;
+    int32 last_counts;
+} motor_model_t;
+
+static int failures = 0;
+
+static void check(int ok, const char *name)
+{
+    printf("%-52s %s\n", name, ok ? "OK" : "FAIL");
+    if (!ok)
+        failures++;
+}
+
+static void motor_model_init(motor_model_t *m, double tau, double no_load, double friction, double delay_ms)
+{
+    m->gain = no_load / PWM_DUTY_MAX;
+    m->tau = tau;
+    m->friction = friction;
+    m->delay = (int)(delay_ms * 0.001 / SIM_DT + 0.5);
+    if (m->delay >= DELAY_MAX)
+        m->delay = DELAY_MAX - 1;
+    m->v = 0.0;
+    m->x = 0.0;
+    for (int i = 0; i < DELAY_MAX; i++)
+        m->queue[i] = 0.0;
+    m->head = 0;
+    m->last_counts = 0;
+}
+
+// ռձdutyһڣرڱ
+static int16 motor_model_run(motor_model_t *m, double duty, int period_ms)
+{
+    int steps = (int)(period_ms * 0.001 / SIM_DT + 0.5);
+    for (int i = 0; i < steps; i++)
+    {
+        m->queue[m->head] = duty;
+        double drive = m->queue[(m->head + DELAY_MAX - m->delay) % DELAY_MAX];
+        m->head = (m->head + 1) % DELAY_MAX;
+    
+        if (fabs(drive) <= m->friction && fabs(m->v) < 1.0)
+            drive = 0.0;
+        else
+            drive -= copysign(m->friction, fabs(m->v) >= 1.0 ? m->v : drive);
+        m->v += (m->gain * drive - m->v) / m->tau * SIM_DT;
+        m->x += m->v * SIM_DT;
+    }
+    int32 counts = (int32)floor(m->x * COUNT_PER_METER / 1000.0);
+    int16 delta = (int16)(counts - m->last_counts);
+    m->last_counts = counts;
+    return delta;
+}
+
+// 1. ̵غʱ (ms)ʧܷ-1
+static int run_autotune(motor_model_t *m, speed_autotune_relay_t *relay)
+{
+    int16 speed = 0;
+    int elapsed = 0;
+    
+    speed_autotune_relay_reset(relay);
+    while (elapsed < SPEED_AUTOTUNE_TIMEOUT_MS)
+    {
+        int32 duty = speed_autotune_relay_step(relay, speed);
+        if (relay->phase == SPEED_AUTOTUNE_DONE)
+            return elapsed;
+        if (relay->phase == SPEED_AUTOTUNE_FAILED)
+            return -1;
+        speed = motor_model_run(m, duty, SPEED_AUTOTUNE_PERIOD_MS);
+        elapsed += SPEED_AUTOTUNE_PERIOD_MS;
+    }
+    return -1;
+}
+
+// 2. Ŷ1񵴷ֵ (/ڣʵʳ)ƫռձΧת
+static double p_control_amplitude(double tau, double no_load, double friction, double delay, float kp, float setpoint)
+{
+    motor_model_t m;
+    double amp = 0.0;
+    int16 speed = 0;
+    int samples = 3000 / SPEED_AUTOTUNE_PERIOD_MS;
+    
+    motor_model_init(&m, tau, no_load, friction, delay);
+    for (int k = 0; k < 1500 / SPEED_AUTOTUNE_PERIOD_MS; k++)
+        speed = motor_model_run(&m, SPEED_AUTOTUNE_BIAS_DUTY, SPEED_AUTOTUNE_PERIOD_MS);
+    for (int k = 0; k < samples; k++)
+    {
+        double duty = SPEED_AUTOTUNE_BIAS_DUTY + kp * (setpoint - speed);
+        if (k < 3)
+            duty += SPEED_AUTOTUNE_RELAY_DUTY;      // Ŷ
+        if (duty > MOTOR_MAX_DUTY)
+            duty = MOTOR_MAX_DUTY;
+        else if (duty < -MOTOR_MAX_DUTY)
+            duty = -MOTOR_MAX_DUTY;
+        speed = motor_model_run(&m, duty, SPEED_AUTOTUNE_PERIOD_MS);
+        double v = m.v * SPEED_AUTOTUNE_PERIOD_MS * COUNT_PER_METER / 1e6;
+        if (k >= samples - 1000 / SPEED_AUTOTUNE_PERIOD_MS && fabs(v - setpoint) > amp)
+            amp = fabs(v - setpoint);
+    }
+    return amp;
+}
+
+// 3. ٶPIDԾӦsmart_car_control()һ£ĿͳΪ /ڣ
+static void step_response(motor_model_t *m, float kp, float ki, float kd, int16 target,
+                          double *rise_ms, double *overshoot, double *settle_ms)
+{
+    pid_t pid;
+    int16 speed = 0;
+    int samples = 2000 / SPEED_AUTOTUNE_PERIOD_MS;
+    int t10 = -1, t90 = -1, settle = 0;
+    double peak = 0.0;
+    
+    pid_init(&pid, kp, ki, kd, MOTOR_MAX_DUTY, -MOTOR_MAX_DUTY);
+    pid_set_target(&pid, target);
+    for (int k = 1; k <= samples; k++)
+    {
+        double duty = pid_calculate(&pid, speed);
+        speed = motor_model_run(m, duty, SPEED_AUTOTUNE_PERIOD_MS);
+        double v = m->v * SPEED_AUTOTUNE_PERIOD_MS * COUNT_PER_METER / 1e6;
+        if (t10 < 0 && v >= 0.1 * target)
+            t10 = k;
+        if (t90 < 0 && v >= 0.9 * target)
+            t90 = k;
+        if (v > peak)
+            peak = v;
+        if (fabs(v - target) > 0.05 * target)
+            settle = k;
+    }
+    *rise_ms = (t10 >= 0 && t90 >= 0) ? (t90 - t10) * SPEED_AUTOTUNE_PERIOD_MS : NAN;
+    *overshoot = (peak - target) / target * 100.0;
+    *settle_ms = settle * SPEED_AUTOTUNE_PERIOD_MS;
+}
+
+// ȽϽԾӦǷɹ
+static int evaluate(double tau, double no_load, double friction, double delay, int verbose)
+{
+    motor_model_t m;
+    speed_autotune_relay_t relay;
+    speed_autotune_gains_t gains;
+    double rise, overshoot, settle;
+    
+    motor_model_init(&m, tau, no_load, friction, delay);
+    int elapsed = run_autotune(&m, &relay);
+    if (elapsed < 0)
+    {
+        printf("tau=%.3f no_load=%.0f: autotune failed (%d)\n", tau, no_load, relay.error);
+        return 0;
+    }
+    speed_autotune_gains(relay.ku, relay.tu, &gains);
+    
+    motor_model_init(&m, tau, no_load, friction, delay);
+    step_response(&m, gains.kp, gains.ki, gains.kd, 150, &rise, &overshoot, &settle);
+    printf("tau=%.3f no_load=%.0f: %4d ms  Ku=%6.1f Tu=%5.3f  kp=%6.2f ki=%5.2f kd=%6.2f  rise %4.0f ms  OS %5.1f%%  settle %4.0f ms\n",
+           tau, no_load, elapsed, relay.ku, relay.tu, gains.kp, gains.ki, gains.kd, rise, overshoot, settle);
+    
+    if (verbose)
+    {
+        check(elapsed <= SPEED_AUTOTUNE_TIMEOUT_MS / 2, "autotune finishes in half the timeout");
+        printf("P control amplitude: 0.6Ku %.1f  0.8Ku %.1f  1.25Ku %.1f  1.6Ku %.1f\n",
+               p_control_amplitude(tau, no_load, friction, delay, 0.6f * relay.ku, relay.setpoint),
+               p_control_amplitude(tau, no_load, friction, delay, 0.8f * relay.ku, relay.setpoint),
+               p_control_amplitude(tau, no_load, friction, delay, 1.25f * relay.ku, relay.setpoint),
+               p_control_amplitude(tau, no_load, friction, delay, 1.6f * relay.ku, relay.setpoint));
+        check(p_control_amplitude(tau, no_load, friction, delay, 0.8f * relay.ku, relay.setpoint) < 3.0,
+              "P control at 0.8 Ku settles to quantization level");
+        check(p_control_amplitude(tau, no_load, friction, delay, 1.6f * relay.ku, relay.setpoint) > 10.0,
+              "P control at 1.6 Ku keeps oscillating");
+        check(overshoot < 25.0 && settle < 600.0, "autotuned step: overshoot < 25%, settle < 600 ms");
+    
+        motor_model_init(&m, tau, no_load, friction, delay);
+        step_response(&m, OLD_KP, OLD_KI, OLD_KD, 150, &rise, &overshoot, &settle);
+        printf("hand-tuned STRAIGHT (kp=%.1f ki=%.1f kd=%.1f): rise %4.0f ms  OS %5.1f%%  settle %4.0f ms\n",
+               OLD_KP, OLD_KI, OLD_KD, rise, overshoot, settle);
+    }
+    return 1;
+}
+
+int main(int argc, char **argv)
+{
+    double tau = argc > 1 ? atof(argv[1]) : 0.10;
+    double no_load = argc > 2 ? atof(argv[2]) : 4000.0;
+    double friction = argc > 3 ? atof(argv[3]) : 300.0;
+    double delay = argc > 4 ? atof(argv[4]) : 2.0;
+    
+    printf("rule %d, relay %d +- %d duty, hysteresis %.1f counts, %d ms period\n",
+           SPEED_AUTOTUNE_RULE, SPEED_AUTOTUNE_BIAS_DUTY, SPEED_AUTOTUNE_RELAY_DUTY,
+           SPEED_AUTOTUNE_HYSTERESIS, SPEED_AUTOTUNE_PERIOD_MS);
+    check(evaluate(tau, no_load, friction, delay, 1), "autotune on nominal motor");
+    
+    printf("\nparameter sweep:\n");
+    int ok = 1;
+    const double taus[] = {0.05, 0.10, 0.20};
+    const double loads[] = {3000.0, 4000.0, 6000.0};
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++)
+            ok &= evaluate(taus[i], loads[j], friction, delay, 0);
+    check(ok, "autotune succeeds across sweep");
+    
+    printf("\n%s\n", failures ? "FAILED" : "ALL OK");
+    return failures ? 1 : 0;
+}
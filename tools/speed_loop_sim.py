@@ -0,0 +1,277 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+速度环对比仿真
+
+用一阶直流电机模型（带编码器量化）比较两种速度环：
+    old   控制周期20ms内的速度PID：一个周期的编码器计数差作为车速，STRAIGHT场景参数
+    new   speed_loop.c：1ms跟踪观测器 + 2ms前馈(Kv/Ks/Ka) + PI（pid_batch，反算抗饱和），目标在20ms内线性插值
+输出阶跃响应（上升时间、超调、调节时间）、斜坡跟踪RMS误差、车速估计误差和目标到车速的-3dB带宽。
+
+参数默认值与 motor_control.h / smart_car.h / speed_loop.h 一致；电机模型参数需按实车阶跃测试修改。
+
+用法：
+    python3 tools/speed_loop_sim.py
+    python3 tools/speed_loop_sim.py --tau 0.08 --no-load 4500 --csv step.csv
+"""
+
+import argparse
+import math
+import random
+
+SIM_DT = 0.0001                 # 仿真步长 (s)
+CONTROL_MS = 20                 # 控制周期 (ms)
+COUNT_PER_METER = 5000          # ENCODER_COUNT_PER_METER
+MAX_DUTY = 8000                 # MOTOR_MAX_DUTY
+PWM_DUTY_MAX = 10000
+
+# smart_car.h STRAIGHT 场景（单位：占空比 / (计数/20ms)）
+OLD_KP, OLD_KI, OLD_KD = 60.0, 2.5, 6.0
+
+# speed_loop.h
+NEW = {
+    "period_ms": 2,
+    "observer_hz": 25.0,
+    "zeta": 1.0,
+    "kv": 2.5,
+    "ks": 300.0,
+    "ka": 0.25,
+    "deadband": 20.0,
+    "kp": 8.0,
+    "ki": 0.16,
+    "integral_max": 25000.0,
+    "kt": 0.5,
+}
+
+
+class Pid:
+    """kt=0、无前馈时与 pid_calculate() 一致；否则与 pid_batch_calculate() 位置式一致（前馈参与限幅，反算抗饱和）"""
+
+    def __init__(self, kp, ki, kd, out_max, integral_max, kt=0.0):
+        self.kp, self.ki, self.kd = kp, ki, kd
+        self.out_max = out_max
+        self.integral_max = integral_max
+        self.kt_over_ki = kt / ki if ki > 0 else 0.0
+        self.integral = 0.0
+        self.last_error = 0.0
+
+    def calculate(self, target, current, feedforward=0.0):
+        error = target - current
+        self.integral = max(-self.integral_max, min(self.integral_max, self.integral + error))
+        raw = self.kp * error + self.ki * self.integral + self.kd * (error - self.last_error) + feedforward
+        out = max(-self.out_max, min(self.out_max, raw))
+        self.integral += self.kt_over_ki * (out - raw)
+        self.last_error = error
+        return out
+
+
+class Motor:
+    """一阶电机：dv/dt = (K·duty - v - 摩擦)/τ，摩擦折算为占空比死区"""
+
+    def __init__(self, args):
+        self.gain = args.no_load / PWM_DUTY_MAX
+        self.tau = args.tau
+        self.friction = args.friction
+        self.v = 0.0            # mm/s
+        self.x = 0.0            # mm
+        self.duty = 0.0
+
+    def step(self, dt):
+        drive = self.duty
+        if abs(drive) <= self.friction and abs(self.v) < 1.0:
+            drive = 0.0
+        else:
+            drive -= math.copysign(self.friction, self.v if abs(self.v) >= 1.0 else drive)
+        self.v += (self.gain * drive - self.v) / self.tau * dt
+        self.x += self.v * dt
+
+    def counts(self):
+        return math.floor(self.x * COUNT_PER_METER / 1000.0)
+
+
+class OldLoop:
+    def __init__(self):
+        self.pid = Pid(OLD_KP, OLD_KI, OLD_KD, MAX_DUTY, MAX_DUTY * 0.8)
+        self.last = 0
+        self.speed = 0.0
+
+    def control_tick(self, motor, target_mm_s):
+        counts = motor.counts()
+        delta = counts - self.last
+        self.last = counts
+        self.speed = delta * 1000.0 * 1000.0 / (CONTROL_MS * COUNT_PER_METER)
+        target_counts = int(target_mm_s * CONTROL_MS * COUNT_PER_METER / 1e6)
+        motor.duty = int(self.pid.calculate(target_counts, delta))
+
+    def fast_tick(self, motor, ms):
+        pass
+
+
+class NewLoop:
+    def __init__(self, p):
+        self.p = p
+        w = 2.0 * math.pi * p["observer_hz"]
+        self.okp, self.oki = 2.0 * p["zeta"] * w, w * w
+        self.pid = Pid(p["kp"], p["ki"], 0.0, MAX_DUTY, p["integral_max"], p["kt"])
+        self.last = 0
+        self.err = 0.0
+        self.integ = 0.0
+        self.speed = 0.0
+        self.target = 0.0
+        self.step = 0.0
+        self.steps_left = 0
+        self.divider = 0
+        self.mm_per_count = 1000.0 / COUNT_PER_METER
+
+    def control_tick(self, motor, target_mm_s):
+        steps = CONTROL_MS // self.p["period_ms"]
+        self.step = (target_mm_s - self.target) / steps
+        self.steps_left = steps
+
+    def fast_tick(self, motor, ms):
+        counts = motor.counts()
+        self.err += counts - self.last
+        self.last = counts
+        self.integ += self.oki * self.err * 0.001
+        vel = self.integ + self.okp * self.err
+        self.err -= vel * 0.001
+        self.speed = vel * self.mm_per_count
+
+        self.divider += 1
+        if self.divider < self.p["period_ms"]:
+            return
+        self.divider = 0
+
+        accel = 0.0
+        if self.steps_left > 0:
+            self.target += self.step
+            accel = self.step / (self.p["period_ms"] / 1000.0)
+            self.steps_left -= 1
+        ff = self.p["kv"] * self.target + self.p["ka"] * accel
+        if self.target > self.p["deadband"]:
+            ff += self.p["ks"]
+        elif self.target < -self.p["deadband"]:
+            ff -= self.p["ks"]
+        motor.duty = int(self.pid.calculate(self.target, self.speed, ff))
+
+
+def simulate(loop, args, target_fn, duration, trace=None):
+    """返回 (时间, 目标, 实际车速, 估计车速) 1ms 采样序列"""
+    motor = Motor(args)
+    rng = random.Random(1)
+    sub = int(round(0.001 / SIM_DT))
+    out = []
+    for ms in range(int(duration * 1000)):
+        t = ms / 1000.0
+        target = target_fn(t)
+        if ms % CONTROL_MS == 0:
+            loop.control_tick(motor, target)
+        loop.fast_tick(motor, ms)
+        for _ in range(sub):
+            if args.load_noise:
+                motor.v += rng.gauss(0.0, args.load_noise) * SIM_DT
+            motor.step(SIM_DT)
+        out.append((t, target, motor.v, loop.speed))
+    if trace is not None:
+        trace.extend(out)
+    return out
+
+
+def step_metrics(samples, final):
+    t_10 = t_90 = None
+    peak = 0.0
+    for t, _, v, _ in samples:
+        if t_10 is None and v >= 0.1 * final:
+            t_10 = t
+        if t_90 is None and v >= 0.9 * final:
+            t_90 = t
+        peak = max(peak, v)
+    settle = 0.0
+    for t, _, v, _ in samples:
+        if abs(v - final) > 0.05 * final:
+            settle = t
+    rise = (t_90 - t_10) if t_10 is not None and t_90 is not None else float("nan")
+    return rise, (peak - final) / final * 100.0, settle
+
+
+def rms(values):
+    return math.sqrt(sum(v * v for v in values) / len(values)) if values else 0.0
+
+
+def gain_at(make_loop, args, freq, base, amp):
+    cycles = max(4, int(freq * 1.0))
+    settle = 1.0
+    duration = settle + cycles / freq
+    samples = simulate(make_loop(), args, lambda t: base + amp * math.sin(2 * math.pi * freq * t), duration)
+    s = c = 0.0
+    n = 0
+    for t, _, v, _ in samples:
+        if t < settle:
+            continue
+        s += (v - base) * math.sin(2 * math.pi * freq * t)
+        c += (v - base) * math.cos(2 * math.pi * freq * t)
+        n += 1
+    return 2.0 * math.hypot(s, c) / n / amp
+
+
+def bandwidth(make_loop, args, base, amp):
+    freqs = [0.5 * 1.15 ** k for k in range(40)]
+    prev = None
+    for f in freqs:
+        g = gain_at(make_loop, args, f, base, amp)
+        if g < 1.0 / math.sqrt(2.0):
+            return f if prev is None else prev[0] + (f - prev[0]) * (prev[1] - 0.7071) / (prev[1] - g)
+        prev = (f, g)
+    return float("nan")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="速度环对比仿真（20ms PID vs speed_loop）")
+    parser.add_argument("--tau", type=float, default=0.10, help="电机机械时间常数 (s)")
+    parser.add_argument("--no-load", type=float, default=4000.0, help="满占空比空载车速 (mm/s)")
+    parser.add_argument("--friction", type=float, default=300.0, help="静摩擦 (占空比)")
+    parser.add_argument("--load-noise", type=float, default=2000.0, help="负载扰动加速度噪声 (mm/s^2 标准差)")
+    parser.add_argument("--step", type=float, default=1500.0, help="阶跃目标 (mm/s)")
+    parser.add_argument("--no-bandwidth", action="store_true", help="跳过扫频（较慢）")
+    parser.add_argument("--csv", help="输出阶跃响应CSV")
+    args = parser.parse_args()
+
+    loops = {"old": OldLoop, "new": lambda: NewLoop(NEW)}
+    traces = {}
+
+    print("motor: tau %.3f s, no-load %.0f mm/s, friction %.0f duty" % (args.tau, args.no_load, args.friction))
+    print("%-4s %9s %9s %9s %12s %12s %12s" % ("loop", "rise(ms)", "overshoot", "settle(ms)",
+                                               "ramp rms", "est rms", "bw(Hz)"))
+    for name, make in loops.items():
+        trace = []
+        step = simulate(make(), args, lambda t: 0.0 if t < 0.1 else args.step, 1.5, trace)
+        traces[name] = trace
+        rise, overshoot, settle = step_metrics([s for s in step if s[0] >= 0.1], args.step)
+
+        # 斜坡：3 m/s^2 加速到 2 m/s，保持，再 6 m/s^2 减速
+        def ramp(t):
+            if t < 0.2:
+                return 500.0
+            if t < 0.7:
+                return 500.0 + 3000.0 * (t - 0.2)
+            if t < 1.2:
+                return 2000.0
+            return max(500.0, 2000.0 - 6000.0 * (t - 1.2))
+        samples = simulate(make(), args, ramp, 1.6)
+        ramp_rms = rms([v - tgt for t, tgt, v, _ in samples if t > 0.2])
+        est_rms = rms([est - v for t, _, v, est in samples if t > 0.2])
+
+        bw = float("nan") if args.no_bandwidth else bandwidth(make, args, 1500.0, 200.0)
+        print("%-4s %9.0f %8.1f%% %9.0f %9.0f mm/s %7.0f mm/s %12.2f"
+              % (name, rise * 1000.0, overshoot, (settle - 0.1) * 1000.0, ramp_rms, est_rms, bw))
+
+    if args.csv:
+        with open(args.csv, "w", encoding="utf-8") as f:
+            f.write("t,target,old_speed,old_estimate,new_speed,new_estimate\n")
+            for a, b in zip(traces["old"], traces["new"]):
+                f.write("%.3f,%.1f,%.1f,%.1f,%.1f,%.1f\n" % (a[0], a[1], a[2], a[3], b[2], b[3]))
+        print("wrote %s" % args.csv)
+
+
+if __name__ == "__main__":
+    main()
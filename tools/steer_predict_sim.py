@@ -0,0 +1,273 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+转向曲率前馈与延迟补偿对比仿真
+
+运动学自行车模型（舵机一阶滞后 + 限幅，不含轮胎侧偏）沿"直道 + 圆弧"赛道行驶，摄像头按 vision_track.h 的安装参数成像，
+偏差按 vision_get_deviation() 的行与权重计算，图像到控制存在采集与处理延迟。比较两种转向：
+    old   方向PID直接使用图像偏差
+    new   steer_predict.c：偏差按位姿变化推算到当前时刻（再外推LEAD），叠加 δ = atan(L·κ) 前馈
+输出各车速下弯道段的最大/RMS横向误差，以及横向误差不超过 --limit 的最高车速。
+
+参数默认值与 vision_track.h / motor_control.h / smart_car.h(NORMAL场景) / steer_predict.h 一致；
+舵机时间常数与图像延迟需按实车测量修改。
+
+用法：
+    python3 tools/steer_predict_sim.py
+    python3 tools/steer_predict_sim.py --radius 0.6 --latency 45 --kp 1.5 --kd 4
+"""
+
+import argparse
+import math
+
+SIM_DT = 0.001                  # 仿真步长 (s)
+CONTROL_MS = 20                 # 控制周期 (ms)
+WHEELBASE = 0.200               # CAR_WHEELBASE (m)
+MAX_ANGLE = 45.0                # SERVO_MAX_ANGLE (度)
+
+# vision_track.h
+IMAGE_W, IMAGE_H = 188, 120
+CAMERA_HEIGHT, CAMERA_PITCH, CAMERA_VFOV, CAMERA_HFOV = 0.20, 35.0, 45.0, 60.0
+SCAN_START_ROW, SCAN_END_ROW = 110, 50
+
+# steer_predict.h
+EXPOSURE_MS = 2
+LEAD_MS = 15
+ROW_STEP = 4
+FIT_MIN_POINTS = 6
+FIT_MAX_DIST = 1.2
+
+
+def ground_table():
+    """vision_ground_table_init()"""
+    row_angle = math.radians(CAMERA_VFOV / IMAGE_H)
+    pitch = math.radians(CAMERA_PITCH)
+    half_tan = math.tan(math.radians(CAMERA_HFOV * 0.5))
+    dist, scale = [0.0] * IMAGE_H, [0.0] * IMAGE_H
+    for row in range(IMAGE_H):
+        angle = pitch + (row - (IMAGE_H - 1) * 0.5) * row_angle
+        if angle <= 0.01:
+            continue
+        dist[row] = CAMERA_HEIGHT / math.tan(angle)
+        scale[row] = CAMERA_HEIGHT / math.sin(angle) * 2.0 * half_tan / IMAGE_W
+    return dist, scale
+
+
+ROW_DIST, ROW_SCALE = ground_table()
+
+
+def row_weight(row):
+    """vision_row_weight()"""
+    d = SCAN_START_ROW - row
+    return 3 if d < 30 else (2 if d < 60 else 1)
+
+
+def make_track(straight, radius, arc_deg, step=0.005):
+    """直道后接右转圆弧再接直道，返回折线点 (x前, y左)"""
+    pts = [(i * step, 0.0) for i in range(int(straight / step))]
+    cx, cy = straight, -radius
+    n = int(math.radians(arc_deg) * radius / step)
+    for i in range(n + 1):
+        a = i * step / radius
+        pts.append((cx + radius * math.sin(a), cy + radius * math.cos(a)))
+    a = math.radians(arc_deg)
+    x0, y0 = pts[-1]
+    for i in range(1, int(2.0 / step)):
+        pts.append((x0 + i * step * math.cos(-a), y0 + i * step * math.sin(-a)))
+    return pts
+
+
+class Camera:
+    """按行求中线在图像中的列（只取前向距离与中线相交处），与视觉算法的中线等价"""
+
+    def __init__(self, track):
+        self.track = track
+
+    def centerline(self, pose):
+        x, y, h = pose
+        c, s = math.cos(h), math.sin(h)
+        local = []
+        for px, py in self.track:
+            dx, dy = px - x, py - y
+            if dx * dx + dy * dy < 4.0:
+                local.append((c * dx + s * dy, -s * dx + c * dy))
+        rows = {}
+        for (f0, l0), (f1, l1) in zip(local, local[1:]):
+            if f1 <= f0 or abs(l0) > 1.0:
+                continue
+            for row in range(IMAGE_H - 1, -1, -1):
+                d = ROW_DIST[row]
+                if d <= 0.0 or d >= f1:
+                    break
+                if d >= f0 and row not in rows:
+                    left = l0 + (l1 - l0) * (d - f0) / (f1 - f0)
+                    col = (IMAGE_W - 1) * 0.5 - left / ROW_SCALE[row]
+                    if 0 <= col < IMAGE_W:
+                        rows[row] = col
+        return rows
+
+
+def deviation(rows):
+    """vision_get_deviation()"""
+    sw = sc = 0
+    for row in range(SCAN_START_ROW, SCAN_END_ROW, -1):
+        if row in rows:
+            w = row_weight(row)
+            sw += w
+            sc += int(rows[row]) * w
+    if sw == 0:
+        return None
+    return max(-80, min(80, sc // sw - IMAGE_W // 2 + 1))
+
+
+def frame_info(rows):
+    """steer_predict_update()：偏差灵敏度 + 二次拟合"""
+    sw = ss = st = sc = 0.0
+    for row in range(SCAN_START_ROW, SCAN_END_ROW, -1):
+        if row in rows and ROW_SCALE[row] > 0:
+            w = row_weight(row)
+            sw += w
+            ss += w / ROW_SCALE[row]
+            st += w * ROW_DIST[row] / ROW_SCALE[row]
+            sc += w * ROW_DIST[row] * ROW_DIST[row] * 0.5 / ROW_SCALE[row]
+    info = {"ppm": ss / sw if sw else 0.0, "ppr": st / sw if sw else 0.0, "ppk": sc / sw if sw else 0.0,
+            "fit": None}
+    pts = []
+    for row in range(IMAGE_H - 1, -1, -ROW_STEP):
+        if ROW_DIST[row] <= 0 or ROW_DIST[row] > FIT_MAX_DIST:
+            break
+        if row in rows:
+            pts.append((ROW_DIST[row], (int(rows[row]) - (IMAGE_W - 1) * 0.5) * ROW_SCALE[row]))
+    if len(pts) >= FIT_MIN_POINTS:
+        s = [sum(p[0] ** k for p in pts) for k in range(5)]
+        t = [sum(p[1] * p[0] ** k for p in pts) for k in range(3)]
+        m = [[s[0], s[1], s[2]], [s[1], s[2], s[3]], [s[2], s[3], s[4]]]
+
+        def det3(a):
+            return (a[0][0] * (a[1][1] * a[2][2] - a[1][2] * a[2][1])
+                    - a[0][1] * (a[1][0] * a[2][2] - a[1][2] * a[2][0])
+                    + a[0][2] * (a[1][0] * a[2][1] - a[1][1] * a[2][0]))
+
+        d = det3(m)
+        if abs(d) > 1e-9:
+            coef = []
+            for k in range(3):
+                mk = [row[:] for row in m]
+                for r in range(3):
+                    mk[r][k] = t[r]
+                coef.append(det3(mk) / d)
+            info["fit"] = (coef[1], coef[2], pts[-1][0])
+    return info
+
+
+def cross_track(track, x, y):
+    best = min(track, key=lambda p: (p[0] - x) ** 2 + (p[1] - y) ** 2)
+    return math.hypot(best[0] - x, best[1] - y)
+
+
+def run(track, speed, args, predict):
+    camera = Camera(track)
+    x, y, h, steer = 0.0, 0.0, 0.0, 0.0
+    history = []                # (t_ms, x, y, h, yaw_rate)
+    frames = []                 # (ready_ms, exposure_ms, rows)
+    command = 0.0
+    last_error = 0.0
+    integral = 0.0
+    errors = []
+    arc_start = args.straight
+    arc_end = args.straight + math.radians(args.arc) * args.radius
+    s = 0.0
+    t_ms = 0
+    while s < arc_end + 0.5:
+        if t_ms % args.frame_ms == 0:
+            frames.append((t_ms + args.latency, t_ms, camera.centerline((x, y, h))))
+        if t_ms % CONTROL_MS == 0:
+            ready = [f for f in frames if f[0] <= t_ms]
+            if ready:
+                latest = max(ready, key=lambda f: f[1])
+                _, exposure, rows = latest
+                frames = [latest] + [f for f in frames if f[0] > t_ms]
+                dev = deviation(rows)
+                ff = 0.0
+                if dev is not None and predict:
+                    info = frame_info(rows)
+                    then = min(history, key=lambda e: abs(e[0] - (exposure - EXPOSURE_MS)))
+                    c0, s0 = math.cos(then[3]), math.sin(then[3])
+                    wx, wy = x - then[1], y - then[2]
+                    dx, dy, dpsi = c0 * wx + s0 * wy, -s0 * wx + c0 * wy, h - then[3]
+                    lead = LEAD_MS / 1000.0
+                    yaw_rate = history[-1][4]
+                    mid = dpsi + yaw_rate * lead * 0.5
+                    dx += speed * lead * math.cos(mid)
+                    dy += speed * lead * math.sin(mid)
+                    dpsi += yaw_rate * lead
+                    dev = dev + dy * info["ppm"] + dpsi * info["ppr"]
+                    if info["fit"]:
+                        b, c, far = info["fit"]
+                        dev += dx * (b * info["ppm"] + 2 * c * info["ppr"]) + c * dx * dx * info["ppm"]
+                        yy = max(0.0, min(far, dx))
+                        slope = b + 2 * c * yy
+                        q = 1 + slope * slope
+                        kappa = 2 * c / (q * math.sqrt(q))
+                        ff = -math.degrees(math.atan(WHEELBASE * kappa))
+                        dev -= kappa * info["ppk"]
+                    dev = int(round(max(-80.0, min(80.0, dev))))
+                if dev is not None:
+                    error = -dev
+                    integral = max(-0.8 * MAX_ANGLE, min(0.8 * MAX_ANGLE, integral + error))
+                    pid = args.kp * error + args.ki * integral + args.kd * (error - last_error)
+                    last_error = error
+                    command = max(-MAX_ANGLE, min(MAX_ANGLE, max(-MAX_ANGLE, min(MAX_ANGLE, pid)) + ff))
+        # 舵机一阶滞后；负转角右转（与方向PID符号一致）
+        steer += (command - steer) * SIM_DT / args.servo_tau
+        yaw_rate = speed * math.tan(math.radians(steer)) / WHEELBASE
+        h += yaw_rate * SIM_DT
+        x += speed * math.cos(h) * SIM_DT
+        y += speed * math.sin(h) * SIM_DT
+        s += speed * SIM_DT
+        t_ms += 1
+        history.append((t_ms, x, y, h, yaw_rate))
+        if len(history) > 200:
+            history.pop(0)
+        if arc_start <= s <= arc_end and t_ms % 5 == 0:
+            errors.append(cross_track(track, x, y))
+    if not errors:
+        return float("inf"), float("inf")
+    return max(errors), math.sqrt(sum(e * e for e in errors) / len(errors))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="转向曲率前馈与延迟补偿对比仿真")
+    parser.add_argument("--radius", type=float, default=0.8, help="弯道半径 (m)")
+    parser.add_argument("--arc", type=float, default=120.0, help="弯道角度 (度)")
+    parser.add_argument("--straight", type=float, default=1.5, help="入弯前直道长度 (m)")
+    parser.add_argument("--latency", type=int, default=30, help="曝光到图像可用的延迟 (ms)")
+    parser.add_argument("--frame-ms", type=int, default=10, help="帧间隔 (ms)")
+    parser.add_argument("--servo-tau", type=float, default=0.03, help="舵机时间常数 (s)")
+    parser.add_argument("--kp", type=float, default=1.0, help="方向PID Kp (度/像素)")
+    parser.add_argument("--ki", type=float, default=0.0, help="方向PID Ki")
+    parser.add_argument("--kd", type=float, default=0.0, help="方向PID Kd")
+    parser.add_argument("--limit", type=float, default=0.10, help="允许的最大横向误差 (m)")
+    args = parser.parse_args()
+
+    track = make_track(args.straight, args.radius, args.arc)
+    speeds = [0.8 + 0.2 * i for i in range(17)]
+    best = {"old": 0.0, "new": 0.0}
+    passing = {"old": True, "new": True}
+
+    print("speed(m/s)   old max/rms (mm)     new max/rms (mm)")
+    for v in speeds:
+        row = []
+        for name, predict in (("old", False), ("new", True)):
+            worst, rms = run(track, v, args, predict)
+            row.append("%7.1f / %6.1f" % (worst * 1000, rms * 1000))
+            passing[name] = passing[name] and worst <= args.limit
+            if passing[name]:
+                best[name] = v
+        print("  %4.1f      %s     %s" % (v, row[0], row[1]))
+    print("max speed with cross-track error <= %.0f mm: old %.1f m/s, new %.1f m/s"
+          % (args.limit * 1000, best["old"], best["new"]))
+
+
+if __name__ == "__main__":
+    main()
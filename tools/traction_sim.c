@@ -0,0 +1,194 @@
+/*
+ * ǣ𲽿λ
+ *
+ * 룺gcc -std=c99 -O2 -DPID_HOST -Icode tools/traction_sim.c code/traction_control.c -lm -o traction_sim
+ * У./traction_sim [ֵϵ] [ϵ] [ռձȿسmm/s]
+ *
+ * ָһ׵ģͣ tools/motor_ident_sim.c ͬʱ䳣̥-ϵߣ
+ * ָIMUٶȺƫٺ1ms
+ * 1. 𲽣ӿ/ǣʱﵽ2m/sʱ
+ * 2. Կ·棺һ೵ָϵʱ1m/sż
+ * 3. 䣨ٷת򼸺ΣʱӦ
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "traction_control.h"
+
+#define SIM_DT              0.00001             // 沽 (s)
+#define CONTROL_STEPS       100                 //  (沽) = 1ms
+#define PWM_DUTY_MAX        10000
+#define GRAVITY             9810.0              // mm/s^2
+#define WHEEL_INERTIA       0.15                // ת / ÿֵַ
+#define SLIP_PEAK           0.12                // ϵֵ
+#define SLIP_SLIDE          0.5                 // ʳֵΪϵ
+#define ACC_NOISE           0.02                // IMUٶ (g)
+#define ACC_BIAS            0.02                // IMUƫ (g)
+#define SPEED_NOISE         20.0                //  (mm/s)
+#define PI                  3.14159265358979
+
+typedef struct
+{
+    double mu_peak[2];                          // ֵַϵ
+    double mu_slide[2];                         // ֻϵ
+    double gain;                                // ÿռձȿس (mm/s)
+    double tau;                                 // ʱ䳣 (s)
+    double steer;                               // ת ()
+    double v;                                   //  (mm/s)
+    double w[2];                                //  (mm/s)
+    double a;                                   // ٶ (mm/s^2)
+    double duty[2];                             // ռձ
+    double slip_max;                            // 
+} sim_car_t;
+
+static int failures = 0;
+
+static void check(int ok, const char *name)
+{
+    printf("%-52s %s\n", name, ok ? "OK" : "FAIL");
+    if (!ok)
+        failures++;
+}
+
+static double noise(double amplitude)
+{
+    return amplitude * (2.0 * rand() / RAND_MAX - 1.0);
+}
+
+// -ϵߣֵǰԣ֮Խϵ
+static double tire_mu(double slip, double peak, double slide)
+{
+    double s = fabs(slip);
+    double mu;
+    if (s <= SLIP_PEAK)
+        mu = peak * s / SLIP_PEAK;
+    else if (s >= SLIP_SLIDE)
+        mu = slide;
+    else
+        mu = peak - (peak - slide) * (s - SLIP_PEAK) / (SLIP_SLIDE - SLIP_PEAK);
+    return slip >= 0.0 ? mu : -mu;
+}
+
+static void sim_car_init(sim_car_t *car, double mu_left, double mu_right, double slide_ratio, double no_load, double speed, double steer)
+{
+    car->mu_peak[0] = mu_left;
+    car->mu_peak[1] = mu_right;
+    car->mu_slide[0] = mu_left * slide_ratio;
+    car->mu_slide[1] = mu_right * slide_ratio;
+    car->gain = no_load / PWM_DUTY_MAX;
+    car->tau = 0.10;
+    car->steer = steer;
+    car->v = speed;
+    car->a = 0.0;
+    car->duty[0] = 0.0;
+    car->duty[1] = 0.0;
+    car->slip_max = 0.0;
+    
+    double k = tan(steer * PI / 180.0) * CAR_TRACK_WIDTH / (2.0 * CAR_WHEELBASE) * DIFFERENTIAL_SIGN;
+    car->w[0] = speed * (1.0 - k);
+    car->w[1] = speed * (1.0 + k);
+}
+
+// ռձһ
+static void sim_car_run(sim_car_t *car, const double duty[2])
+{
+    double k = tan(car->steer * PI / 180.0) * CAR_TRACK_WIDTH / (2.0 * CAR_WHEELBASE) * DIFFERENTIAL_SIGN;
+    double ratio[2] = {1.0 - k, 1.0 + k};
+    
+    car->duty[0] = duty[0];
+    car->duty[1] = duty[1];
+    
+    for (int step = 0; step < CONTROL_STEPS; step++)
+    {
+        double accel = 0.0;
+        for (int i = 0; i < 2; i++)
+        {
+            double ground = car->v * ratio[i];
+            double base = fmax(fmax(fabs(car->w[i]), fabs(ground)), 50.0);
+            double slip = (car->w[i] - ground) / base;
+            double tire = tire_mu(slip, car->mu_peak[i], car->mu_slide[i]) * GRAVITY;
+            double drive = (car->gain * duty[i] - car->w[i]) / car->tau;
+            car->w[i] += (drive - tire) / WHEEL_INERTIA * SIM_DT;
+            accel += 0.5 * tire;
+            if (ground > 100.0 && slip > car->slip_max)
+                car->slip_max = slip;
+        }
+        car->a = accel;
+        car->v += accel * SIM_DT;
+    }
+}
+
+// ̶ռձduration_msسٴﵽtargetʱ (ms)δﵽ-1
+// use_tcΪ0ʱӿƣlaunchΪ1ʱ𲽿ƿʼοٴӵǰٿʼ
+static int run(sim_car_t *car, traction_t *tc, int use_tc, int launch, double command, double target, int duration_ms)
+{
+    double duty[2] = {0.0, 0.0};
+    int reached = -1;
+    
+    traction_reset(tc, launch);
+    tc->reference = car->v;
+    for (int t = 1; t <= duration_ms; t++)
+    {
+        duty[0] = command;
+        duty[1] = command;
+        if (use_tc)
+        {
+            double accel = car->a + (noise(ACC_NOISE) + ACC_BIAS) * GRAVITY;
+            traction_estimate(tc, car->w[0] + noise(SPEED_NOISE), car->w[1] + noise(SPEED_NOISE), car->steer, accel);
+            traction_regulate(tc, car->duty[0], car->duty[1]);
+            duty[0] = fmin(command, tc->left.duty_cap);
+            duty[1] = fmin(command, tc->right.duty_cap);
+        }
+        sim_car_run(car, duty);
+        if (reached < 0 && car->v >= target)
+            reached = t;
+    }
+    return reached;
+}
+
+int main(int argc, char **argv)
+{
+    double mu = argc > 1 ? atof(argv[1]) : 0.9;
+    double slide = argc > 2 ? atof(argv[2]) / mu : 0.65;
+    double no_load = argc > 3 ? atof(argv[3]) : 4000.0;
+    sim_car_t car;
+    traction_t tc = {0};
+    
+    srand(1);
+    printf("mu peak %.2f slide %.2f, no-load %.0f mm/s, full duty %d\n", mu, mu * slide, no_load, MOTOR_MAX_DUTY);
+    
+    // 1. 
+    sim_car_init(&car, mu, mu, slide, no_load, 0.0, 0.0);
+    int t_open = run(&car, &tc, 0, 0, MOTOR_MAX_DUTY, 2000.0, 1500);
+    double slip_open = car.slip_max;
+    sim_car_init(&car, mu, mu, slide, no_load, 0.0, 0.0);
+    int t_tc = run(&car, &tc, 1, 1, MOTOR_MAX_DUTY, 2000.0, 1500);
+    printf("launch 0 -> 2000 mm/s:          open %4d ms (slip max %.2f)   launch+TC %4d ms (slip max %.2f, intervention %u ms)\n",
+           t_open, slip_open, t_tc, car.slip_max, tc.intervention_ms);
+    check(t_tc > 0 && (t_open < 0 || t_tc < t_open), "launch control reaches 2 m/s sooner");
+    check(car.slip_max < 0.5 * slip_open, "launch slip below half of open loop");
+    
+    // 2. Կ·棺ڲ೵ָϵ
+    sim_car_init(&car, mu, 0.5 * mu, slide, no_load, 1000.0, 10.0);
+    t_open = run(&car, &tc, 0, 0, MOTOR_MAX_DUTY, 2200.0, 1500);
+    slip_open = car.slip_max;
+    sim_car_init(&car, mu, 0.5 * mu, slide, no_load, 1000.0, 10.0);
+    t_tc = run(&car, &tc, 1, 0, MOTOR_MAX_DUTY, 2200.0, 1500);
+    printf("split-mu exit 1000 -> 2200 mm/s: open %4d ms (slip max %.2f)   TC %4d ms (slip max %.2f)\n",
+           t_open, slip_open, t_tc, car.slip_max);
+    check(t_tc > 0 && (t_open < 0 || t_tc <= t_open * 1.02), "traction control not slower on split-mu exit");
+    check(car.slip_max < slip_open, "traction control reduces slip on split-mu exit");
+    
+    // 3. Ӧ룺1m/sԿس1.4m/sӦռձֱ߼䣨ٶԼ0.4g򻬣
+    double gentle = 1400.0 / (no_load / PWM_DUTY_MAX);
+    sim_car_init(&car, mu, mu, slide, no_load, 1000.0, 0.0);
+    run(&car, &tc, 1, 0, gentle, 1e9, 1000);
+    uint32 straight = tc.intervention_ms;
+    sim_car_init(&car, mu, mu, slide, no_load, 1000.0, 25.0);
+    run(&car, &tc, 1, 0, gentle, 1e9, 1000);
+    printf("duty %.0f: straight intervention %u ms, 25 deg corner intervention %u ms\n", gentle, straight, tc.intervention_ms);
+    check(straight == 0 && tc.intervention_ms == 0, "no intervention without wheelspin");
+    
+    printf("\n%s\n", failures ? "FAILED" : "ALL OK");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,265 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+元素识别决策树训练工具
+
+从串口日志中读取小车输出的特征行（element_classifier_log_features()）：
+    FEAT,<帧号>,<标签>,<规则检测结果>,<决策树结果>,<f0>,...,<f12>
+训练CART决策树（基尼系数），补齐为满二叉树后生成 code/element_tree_model.h，
+供 element_classifier.c 以定长查表方式（无分支）求值。
+
+同时输出训练集/验证集上决策树与现有规则检测器相对人工标签的准确率和混淆矩阵，
+以及日志中的 BENCH 行（目标板上两种前端的耗时统计）。
+
+用法：
+    python3 tools/train_element_tree.py run1.log run2.log --depth 4 --out code/element_tree_model.h
+    python3 tools/train_element_tree.py --empty          # 生成空模型（全部判为无元素）
+"""
+
+import argparse
+import random
+import sys
+
+# 与 element_feature_enum 顺序一致
+FEATURE_NAMES = [
+    "WIDTH_NEAR", "WIDTH_MID", "WIDTH_FAR", "CENTER_SHIFT",
+    "LEFT_LOST", "RIGHT_LOST", "BOTH_LOST",
+    "WHITE_LEFT", "WHITE_RIGHT", "COLUMN_GAP",
+    "TRANSITIONS", "TRACK_DARK", "VALID_ROWS",
+]
+
+# 与 element_type_enum 顺序一致
+ELEMENT_NAMES = [
+    "ELEMENT_NONE", "ELEMENT_CROSS", "ELEMENT_CIRCLE", "ELEMENT_RAMP",
+    "ELEMENT_OBSTACLE", "ELEMENT_PARKING", "ELEMENT_ZEBRA_CROSSING",
+    "ELEMENT_SPEED_BUMP", "ELEMENT_FORK",
+]
+
+MAX_DEPTH = 6
+INT16_MAX = 32767
+
+
+# ---------------------------------------------------------------- 日志解析
+def load_logs(paths):
+    samples = []        # (features, label, rule, tree)
+    bench = []
+    for path in paths:
+        with open(path, "r", encoding="utf-8", errors="ignore") as f:
+            for line in f:
+                line = line.strip()
+                if line.startswith("FEAT,"):
+                    fields = line.split(",")
+                    if len(fields) != 5 + len(FEATURE_NAMES):
+                        continue
+                    try:
+                        values = [int(v) for v in fields[1:]]
+                    except ValueError:
+                        continue
+                    _, label, rule, tree = values[:4]
+                    if label >= len(ELEMENT_NAMES):
+                        continue
+                    samples.append((values[4:], label, rule, tree))
+                elif line.startswith("BENCH"):
+                    bench.append(line)
+    return samples, bench
+
+
+# ---------------------------------------------------------------- CART训练
+def gini(counts, n):
+    if n == 0:
+        return 0.0
+    return 1.0 - sum((c / n) ** 2 for c in counts.values())
+
+
+def class_counts(rows):
+    counts = {}
+    for _, label in rows:
+        counts[label] = counts.get(label, 0) + 1
+    return counts
+
+
+def best_split(rows, min_leaf):
+    n = len(rows)
+    parent = gini(class_counts(rows), n)
+    best = None
+    for feat in range(len(FEATURE_NAMES)):
+        ordered = sorted(rows, key=lambda r: r[0][feat])
+        left = {}
+        right = class_counts(ordered)
+        for i in range(n - 1):
+            label = ordered[i][1]
+            left[label] = left.get(label, 0) + 1
+            right[label] -= 1
+            lo = ordered[i][0][feat]
+            hi = ordered[i + 1][0][feat]
+            nl = i + 1
+            if lo == hi or nl < min_leaf or n - nl < min_leaf:
+                continue
+            score = (nl * gini(left, nl) + (n - nl) * gini(right, n - nl)) / n
+            if score < parent - 1e-9 and (best is None or score < best[0]):
+                # 目标板判定为 feature > threshold 走右子树
+                best = (score, feat, lo)
+    return best
+
+
+def build(rows, depth, max_depth, min_leaf):
+    counts = class_counts(rows)
+    majority = max(counts, key=counts.get)
+    leaf = ("leaf", majority, int(round(100.0 * counts[majority] / len(rows))))
+    if depth >= max_depth or len(counts) == 1:
+        return leaf
+    split = best_split(rows, min_leaf)
+    if split is None:
+        return leaf
+    _, feat, thr = split
+    left = [r for r in rows if r[0][feat] <= thr]
+    right = [r for r in rows if r[0][feat] > thr]
+    return ("node", feat, thr,
+            build(left, depth + 1, max_depth, min_leaf),
+            build(right, depth + 1, max_depth, min_leaf))
+
+
+# ---------------------------------------------------------------- 补齐为满二叉树
+def flatten(tree, depth):
+    nodes = (1 << depth) - 1
+    feature = [0] * nodes
+    threshold = [INT16_MAX] * nodes
+    leaf_class = [0] * (1 << depth)
+    leaf_conf = [0] * (1 << depth)
+
+    def place(sub, index, level):
+        if level == depth:
+            leaf_class[index - nodes] = sub[1]
+            leaf_conf[index - nodes] = sub[2]
+            return
+        if sub[0] == "node":
+            feature[index] = sub[1]
+            threshold[index] = max(-32768, min(INT16_MAX, sub[2]))
+            place(sub[3], 2 * index + 1, level + 1)
+            place(sub[4], 2 * index + 2, level + 1)
+        else:
+            # 提前结束的叶子：阈值取最大值恒走左子树，右子树同样填该叶子
+            place(sub, 2 * index + 1, level + 1)
+            place(sub, 2 * index + 2, level + 1)
+
+    place(tree, 0, 0)
+    return feature, threshold, leaf_class, leaf_conf
+
+
+def predict(model, x, depth):
+    feature, threshold, leaf_class, leaf_conf = model
+    node = 0
+    for _ in range(depth):
+        node = 2 * node + 1 + (1 if x[feature[node]] > threshold[node] else 0)
+    leaf = node - len(feature)
+    return leaf_class[leaf], leaf_conf[leaf]
+
+
+# ---------------------------------------------------------------- 评估
+def report(title, pairs):
+    if not pairs:
+        return
+    n = len(pairs)
+    correct = sum(1 for truth, pred in pairs if truth == pred)
+    print("%s: %d/%d = %.1f%%" % (title, correct, n, 100.0 * correct / n))
+    present = sorted(set(t for t, _ in pairs) | set(p for _, p in pairs))
+    short = [ELEMENT_NAMES[c][8:] if c < len(ELEMENT_NAMES) else str(c) for c in present]
+    print("  %-14s" % "label\\pred" + "".join("%8s" % s[:7] for s in short))
+    for t, name in zip(present, short):
+        row = [sum(1 for a, b in pairs if a == t and b == p) for p in present]
+        print("  %-14s" % name[:14] + "".join("%8d" % v for v in row))
+
+
+# ---------------------------------------------------------------- 生成头文件
+def emit_header(path, model, depth, info):
+    feature, threshold, leaf_class, leaf_conf = model
+
+    def table(values, per_line, width):
+        lines = []
+        for i in range(0, len(values), per_line):
+            lines.append("    " + ", ".join(("%" + str(width) + "s") % v for v in values[i:i + per_line]))
+        return ",\n".join(lines)
+
+    text = []
+    text.append("#ifndef _ELEMENT_TREE_MODEL_H_")
+    text.append("#define _ELEMENT_TREE_MODEL_H_")
+    text.append("")
+    text.append("// 本文件由 tools/train_element_tree.py 生成，请勿手工修改")
+    text.append("// %s" % info)
+    text.append("// 满二叉树按层序存储：节点i判定 feature[i] > threshold[i] 时进入 2i+2，否则进入 2i+1")
+    text.append("")
+    text.append("#define ELEMENT_TREE_DEPTH          %d" % depth)
+    text.append("#define ELEMENT_TREE_NODES          %d" % len(feature))
+    text.append("#define ELEMENT_TREE_LEAVES         %d" % len(leaf_class))
+    text.append("")
+    text.append("static const uint8 element_tree_feature[ELEMENT_TREE_NODES] =")
+    text.append("{")
+    text.append(table(feature, 16, 2))
+    text.append("};")
+    text.append("")
+    text.append("static const int16 element_tree_threshold[ELEMENT_TREE_NODES] =")
+    text.append("{")
+    text.append(table(threshold, 8, 5))
+    text.append("};")
+    text.append("")
+    text.append("static const uint8 element_tree_leaf_class[ELEMENT_TREE_LEAVES] =")
+    text.append("{")
+    text.append(table([ELEMENT_NAMES[c] for c in leaf_class], 4, 1))
+    text.append("};")
+    text.append("")
+    text.append("static const uint8 element_tree_leaf_confidence[ELEMENT_TREE_LEAVES] =")
+    text.append("{")
+    text.append(table(leaf_conf, 16, 3))
+    text.append("};")
+    text.append("")
+    text.append("#endif // _ELEMENT_TREE_MODEL_H_")
+    text.append("")
+
+    with open(path, "w", encoding="gbk", newline="\n") as f:
+        f.write("\n".join(text))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="训练元素识别决策树并生成C查表模型")
+    parser.add_argument("logs", nargs="*", help="包含FEAT行的串口日志")
+    parser.add_argument("--depth", type=int, default=4, help="树深度（补齐为满二叉树，最大%d）" % MAX_DEPTH)
+    parser.add_argument("--min-leaf", type=int, default=5, help="叶子最少样本数")
+    parser.add_argument("--holdout", type=float, default=0.2, help="验证集比例")
+    parser.add_argument("--seed", type=int, default=1, help="划分验证集的随机种子")
+    parser.add_argument("--out", default="code/element_tree_model.h", help="输出头文件")
+    parser.add_argument("--empty", action="store_true", help="生成空模型（全部判为无元素）")
+    args = parser.parse_args()
+
+    depth = max(1, min(MAX_DEPTH, args.depth))
+
+    if args.empty:
+        model = flatten(("leaf", 0, 0), depth)
+        emit_header(args.out, model, depth, "空模型：全部判为无元素，需用实车日志重新训练")
+        print("wrote %s (empty model)" % args.out)
+        return 0
+
+    samples, bench = load_logs(args.logs)
+    if not samples:
+        print("no FEAT lines found", file=sys.stderr)
+        return 1
+
+    random.Random(args.seed).shuffle(samples)
+    n_test = int(len(samples) * args.holdout)
+    test, train = samples[:n_test], samples[n_test:]
+
+    tree = build([(s[0], s[1]) for s in train], 0, depth, args.min_leaf)
+    model = flatten(tree, depth)
+
+    report("tree  train", [(s[1], predict(model, s[0], depth)[0]) for s in train])
+    report("tree  test ", [(s[1], predict(model, s[0], depth)[0]) for s in test])
+    report("rules all  ", [(s[1], s[2]) for s in samples])
+    for line in bench[-5:]:
+        print(line)
+
+    emit_header(args.out, model, depth, "训练样本 %d，验证样本 %d，深度 %d" % (len(train), len(test), depth))
+    print("wrote %s" % args.out)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -51,17 +51,64 @@ int core0_main(void)
     smart_car_init();
     show_speed_init();
     pit_ms_init(CCU60_CH0, 20);
+    pit_ms_init(ODOMETRY_PIT, ODOMETRY_PERIOD_MS);  // 1ms̼ٶڻ
     // ˴дû ʼ
     cpu_wait_event_ready();         // ȴкĳʼ
+#if SERVO_CALIB_ON_BOOT
+    servo_calibrate();              // Ȧ궨תǣ궨
+#endif
+#if MOTOR_IDENT_ON_BOOT
+    motor_ident_run();              // ֱʶֵģͣǰʹãMOTOR_MODEL_*
+#if !SPEED_AUTOTUNE_ON_BOOT
+    system_delay_ms(MOTOR_IDENT_BOOT_DELAY_MS);     // Ż󷢳
+#endif
+#endif
+#if SPEED_AUTOTUNE_ON_BOOT
+    speed_autotune_run();           // ٶPIDд뵱ǰ
+    system_delay_ms(SPEED_AUTOTUNE_BOOT_DELAY_MS);  // Ż󷢳
+#endif
     smart_car_start();
     while (TRUE)
     {
         // ˴дҪѭִеĴ
         if (vision.image_ready)
         {
+            element_cnn_submit_frame();             // ²ύCPU1ELEMENT_CNN_ENABLEʱЧ
             vision_image_process();
+            steer_predict_update();                 // ÿ֡ƫϣתǰӳٲ
+            pure_pursuit_update();                  // ÿ֡߻㵽꣨٣¼֡־
+            lateral_kf_measure();                   // ÿ֡ϻΪ򿨶˲
+            if (smart_car.path_planning_enable || smart_car.scene.auto_enable)
+            {
+                speed_planner_update();             // ÿ֡ʸٶޣԶлҲʹʣ
+            }
+            if (smart_car.element_recognition_enable)
+            {
+                element_recognition_process();      // ÿ֡Ԫʶ𣨺յ߼Ȧ
+            }
             vision_show_image_with_lines_tft180();
         }
+        if (smart_car.state == CAR_STOP && lap_timer.dump_pending)
+        {
+            lap_timer_dump();                       // ͣȦʱ
+        }
+        if (smart_car.state == CAR_STOP && element_sequence.dump_pending)
+        {
+            element_sequence_dump();                // ͣѧԪ
+        }
+        if (smart_car.state == CAR_STOP && lap_memory.dump_pending)
+        {
+            lap_memory_dump();                      // ͣȦ䣨tools/lap_replay.pyطţ
+        }
+        if (smart_car.state == CAR_STOP && pure_pursuit.dump_pending)
+        {
+            pure_pursuit_log_dump();                // ͣ֡־tools/lateral_replay.py
+        }
+        speed_autotune_poll();                      // ٶPIDд뵱ǰ
+        motor_ident_poll();                         // ģͱʶдֵģͲ
+#if CONTROLLER_UART_ENABLE
+        controller_by_uart();                       // λΡƷʽл
+#endif
 
 
 
@@ -34,6 +34,7 @@
 ********************************************************************************************************************/
 
 #include "zf_common_headfile.h"
+#include "element_cnn.h"
 #pragma section all "cpu1_dsram"
 // #pragma section all restore֮ȫֱCPU1RAM
 
@@ -48,7 +49,7 @@ void core1_main(void)
     disable_Watchdog();                     // رտŹ
     interrupt_global_enable(0);             // ȫж
     // ˴дû ʼ
-
+    element_cnn_init();                     // CNNԪطࣨELEMENT_CNN_ENABLEʱڱУ
 
 
     // ˴дû ʼ
@@ -56,7 +57,7 @@ void core1_main(void)
     while (TRUE)
     {
         // ˴дҪѭִеĴ
-
+        element_cnn_task();                 // ͼʱִelement_recog
 
 
         // ˴дҪѭִеĴ
@@ -35,6 +35,7 @@
 
 #include "isr_config.h"
 #include "isr.h"
+#include "car_headfile.h"
 
 // TCϵĬǲ֧жǶ׵ģϣ֧жǶҪжʹ interrupt_global_enable(0); жǶ
 // 򵥵˵ʵϽжϺTCϵеӲԶ interrupt_global_disable(); ܾӦκεжϣҪԼֶ interrupt_global_enable(0); жϵӦ
@@ -57,6 +58,22 @@ IFX_INTERRUPT(cc60_pit_ch0_isr, 0, CCU6_0_CH0_ISR_PRIORITY)
 IFX_INTERRUPT(cc60_pit_ch1_isr, 0, CCU6_0_CH1_ISR_PRIORITY)
 {
     interrupt_global_enable(0);                     // жǶ
+    
+    battery_update();                               // صѹȡ̨ɨȴת
+    yaw_control_sample();                           // Z
+    odometry_update();                              // +̼ƻ
+    speed_loop_observe();                           // ٶȸٹ۲
+    traction_update();                              // 򻬹ƣдռձޣǣ𲽿ƣ
+    brake_update();                                 // ƶ滮ٶʱռձȣ
+    if (smart_car.state == CAR_RUNNING)
+    {
+        speed_loop_control();                       // 2msٶȻڲƵ
+        lateral_kf_update();                        // 򿨶˲Ԥͼ
+        yaw_control_update();                       // 1msǽٶڻ
+    }
+    speed_autotune_update();                        // ٶPIDͣʱ
+    motor_ident_update();                           // ģͱʶͣʶʱ
+    actuator_output_tick();                         // ͳһACTUATOR_SYNC_ENABLEʱͬһPWM߽Ч
     pit_clear_flag(CCU60_CH1);
 
 
@@ -145,6 +162,7 @@ IFX_INTERRUPT(exti_ch3_ch7_isr, 0, EXTI_CH3_CH7_INT_PRIO)
     if(exti_flag_get(ERU_CH3_REQ6_P02_0))           // ͨ3ж
     {
         exti_flag_clear(ERU_CH3_REQ6_P02_0);
+        steer_predict_capture_start();              // ¼ͬʱ̣תӳٲ
         camera_vsync_handler();                     // ͷɼͳһص
     }
     if(exti_flag_get(ERU_CH7_REQ16_P15_1))          // ͨ7ж
@@ -164,6 +182,10 @@ IFX_INTERRUPT(dma_ch5_isr, 0, DMA_INT_PRIO)
 {
     interrupt_global_enable(0);                     // жǶ
     camera_dma_handler();                           // ͷɼͳһص
+    if (mt9v03x_finish_flag)
+    {
+        steer_predict_capture_done();               // 汾֡ͬʱ
+    }
 }
 // **************************** DMAжϺ ****************************
 